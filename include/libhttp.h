@@ -227,12 +227,16 @@ enum {							/*												*/
 							/* struct lh_ctx_t;										*/
 							/* struct lh_con_t;										*/
 							/* struct lh_ip_t;										*/
+							/* struct lh_wsg_t;										*/
+							/* struct lh_mlt_t;										*/
 							/*												*/
 							/* Hidden structures used by the library to store context and connection information		*/
 							/*												*/
 struct lh_ctx_t;					/* Handle for an HTTP context									*/
 struct lh_con_t;					/* Handle for an individual connection								*/
 struct lh_ip_t;						/* Handle for an IPv4/IPv6 ip address								*/
+struct lh_wsg_t;					/* Handle for a group of websocket connections which receive broadcasts				*/
+struct lh_mlt_t;					/* Handle for a set of client transfers which run concurrently					*/
 							/*												*/
 							/************************************************************************************************/
 
@@ -297,6 +301,31 @@ struct lh_clb_t {					/*												*/
 	void		(*init_context)(     struct lh_ctx_t *ctx );									/*		*/
 	void		(*init_thread)(      struct lh_ctx_t *ctx, int thread_type );							/*		*/
 	void		(*exit_context)(     struct lh_ctx_t *ctx );									/*		*/
+	void		(*websocket_drain)(  struct lh_ctx_t *ctx,       struct lh_con_t *conn );					/*		*/
+};							/*												*/
+							/************************************************************************************************/
+
+							/************************************************************************************************/
+							/*												*/
+							/* struct lh_iov_t;										*/
+							/*												*/
+							/* Buffer record passed in an array of buffers to httplib_readv()				*/
+struct lh_iov_t {					/*												*/
+	void *		base;				/* start of the buffer										*/
+	size_t		len;				/* size of the buffer in bytes									*/
+};							/*												*/
+							/************************************************************************************************/
+
+							/************************************************************************************************/
+							/*												*/
+							/* struct lh_mrs_t;										*/
+							/*												*/
+							/* Result of a transfer of a multi handle returned by httplib_multi_read()			*/
+struct lh_mrs_t {					/*												*/
+	void *		user_data;			/* user data which was passed to httplib_multi_add()						*/
+	int		status;				/* HTTP status code of the response, or -1 if the transfer failed				*/
+	char *		body;				/* NUL terminated response body, to be freed with httplib_free(), NULL if the transfer failed	*/
+	size_t		body_len;			/* number of bytes in the response body								*/
 };							/*												*/
 							/************************************************************************************************/
 
@@ -311,6 +340,46 @@ struct lh_opt_t {					/*												*/
 };							/*												*/
 							/************************************************************************************************/
 
+							/************************************************************************************************/
+							/*												*/
+							/* struct lh_req_t;										*/
+							/*												*/
+							/* Request record passed to httplib_pipeline_send() and httplib_multi_add()			*/
+struct lh_req_t {					/*												*/
+	const char *	method;				/* request method, GET if NULL									*/
+	const char *	uri;				/* request URI, / if NULL									*/
+	const char *	host;				/* value of the Host header, no Host header is sent if NULL					*/
+	const char *	headers;			/* additional header lines each ending with CRLF, or NULL					*/
+	const void *	body;				/* request body, or NULL									*/
+	size_t		body_len;			/* number of bytes in the request body								*/
+};							/*												*/
+							/************************************************************************************************/
+
+							/************************************************************************************************/
+							/*												*/
+							/* struct lh_tmo_t										*/
+							/*												*/
+							/* Number of connections of a server which were closed because a deadline expired		*/
+struct lh_tmo_t {					/*												*/
+	uint64_t	header_timeouts;		/* Request headers which did not arrive completely within request_timeout			*/
+	uint64_t	body_timeouts;			/* Request bodies which did not receive data for request_timeout				*/
+	uint64_t	keep_alive_timeouts;		/* Idle keep-alive connections which did not send a new request within keep_alive_timeout	*/
+	uint64_t	websocket_timeouts;		/* Websocket connections which did not receive data for websocket_timeout			*/
+};							/*												*/
+							/************************************************************************************************/
+
+							/************************************************************************************************/
+							/*												*/
+							/* struct lh_wss_t										*/
+							/*												*/
+							/* Counters of the websocket keepalive of a server						*/
+struct lh_wss_t {					/*												*/
+	uint64_t	connections;			/* Number of websocket connections which are currently open					*/
+	uint64_t	pings_sent;			/* Number of keepalive ping frames sent								*/
+	uint64_t	connections_reaped;		/* Number of connections closed because they didn't answer a ping in time			*/
+};							/*												*/
+							/************************************************************************************************/
+
 							/************************************************************************************************/
 							/*												*/
 							/* struct lh_slp_t										*/
@@ -342,6 +411,8 @@ typedef int	(*httplib_websocket_connect_handler)( struct lh_ctx_t *ctx, struct l
 typedef void	(*httplib_websocket_ready_handler)(   struct lh_ctx_t *ctx, struct lh_con_t *conn,                                   void *cbdata );
 typedef int	(*httplib_websocket_data_handler)(    struct lh_ctx_t *ctx, struct lh_con_t *conn, int, char *buffer, size_t buflen, void *cbdata );
 typedef void	(*httplib_websocket_close_handler)(   struct lh_ctx_t *ctx, struct lh_con_t *conn,                                   void *cbdata );
+typedef bool	(*httplib_timer_handler)(             struct lh_ctx_t *ctx,                                                          void *cbdata );
+typedef int	(*httplib_body_handler)(              struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *data, size_t len,     void *cbdata );
 
 typedef LIBHTTP_THREAD_TYPE (LIBHTTP_THREAD_CALLING_CONV *httplib_thread_func_t)(void *arg);
 
@@ -350,6 +421,7 @@ struct httplib_client_options {
 	int port;
 	const char *client_cert;
 	const char *server_cert;
+	int connect_timeout;
 	/* TODO: add more data */
 };
 
@@ -377,10 +449,13 @@ LIBHTTP_API int				httplib_closedir( DIR *dir );
 LIBHTTP_API struct lh_con_t *		httplib_connect_client( struct lh_ctx_t *ctx, const char *host, int port, int use_ssl );
 LIBHTTP_API struct lh_con_t *		httplib_connect_client_secure( struct lh_ctx_t *ctx, const struct httplib_client_options *client_options );
 LIBHTTP_API struct lh_con_t *		httplib_connect_websocket_client( struct lh_ctx_t *ctx, const char *host, int port, int use_ssl, const char *path, const char *origin, httplib_websocket_data_handler data_func, httplib_websocket_close_handler close_func, void *user_data );
+LIBHTTP_API int				httplib_consume_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, size_t len );
 LIBHTTP_API struct lh_ctx_t *		httplib_create_client_context( const struct lh_clb_t *callbacks, const struct lh_opt_t *options );
 LIBHTTP_API void			httplib_cry( enum lh_dbg_t debug_level, struct lh_ctx_t *ctx, const struct lh_con_t *conn, PRINTF_FORMAT_STRING(const char *fmt), ...) PRINTF_ARGS(4, 5);
 LIBHTTP_API void			httplib_destroy_client_context( struct lh_ctx_t *ctx );
 LIBHTTP_API struct lh_con_t *		httplib_download( struct lh_ctx_t *ctx, const char *host, int port, int use_ssl, PRINTF_FORMAT_STRING(const char *request_fmt), ...) PRINTF_ARGS(5, 6);
+LIBHTTP_API int				httplib_end_chunked( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *trailers );
+LIBHTTP_API int				httplib_end_compressed_response( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
 LIBHTTP_API char *			httplib_error_string( int error_code, char *buf, size_t buf_len );
 LIBHTTP_API const char *		httplib_get_builtin_mime_type( const char *file_name );
 LIBHTTP_API int				httplib_get_cookie( const char *cookie, const char *var_name, char *buf, size_t buf_len );
@@ -392,10 +467,12 @@ LIBHTTP_API const struct lh_rqi_t *	httplib_get_request_info( const struct lh_co
 LIBHTTP_API int				httplib_get_response( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int timeout );
 LIBHTTP_API const char *		httplib_get_response_code_text( struct lh_ctx_t *ctx, struct lh_con_t *conn, int response_code );
 LIBHTTP_API int				httplib_get_server_ports( const struct lh_ctx_t *ctx, int size, struct lh_slp_t *ports );
+LIBHTTP_API int				httplib_get_timeout_stats( const struct lh_ctx_t *ctx, struct lh_tmo_t *stats );
 LIBHTTP_API void *			httplib_get_user_connection_data( const struct lh_con_t *conn );
 LIBHTTP_API void *			httplib_get_user_data( const struct lh_ctx_t *ctx );
 LIBHTTP_API int				httplib_get_var( const char *data, size_t data_len, const char *var_name, char *dst, size_t dst_len );
 LIBHTTP_API int				httplib_get_var2( const char *data, size_t data_len, const char *var_name, char *dst, size_t dst_len, size_t occurrence );
+LIBHTTP_API int				httplib_get_websocket_stats( const struct lh_ctx_t *ctx, struct lh_wss_t *stats );
 LIBHTTP_API struct tm *			httplib_gmtime_r( const time_t *clock, struct tm *result );
 LIBHTTP_API int				httplib_handle_form_request( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct httplib_form_data_handler *fdh );
 LIBHTTP_API int				httplib_kill( pid_t pid, int sig_num );
@@ -405,7 +482,14 @@ LIBHTTP_API void			httplib_lock_context( struct lh_ctx_t *ctx );
 LIBHTTP_API char *			httplib_md5( char buf[33], ... );
 LIBHTTP_API int				httplib_mkdir( const char *path, int mode );
 LIBHTTP_API int				httplib_modify_passwords_file( const char *passwords_file_name, const char *domain, const char *user, const char *password );
+LIBHTTP_API int				httplib_multi_add( struct lh_mlt_t *multi, const char *host, int port, int use_ssl, const struct lh_req_t *request, void *user_data );
+LIBHTTP_API struct lh_mlt_t *		httplib_multi_create( struct lh_ctx_t *ctx );
+LIBHTTP_API void			httplib_multi_destroy( struct lh_mlt_t *multi );
+LIBHTTP_API int				httplib_multi_perform( struct lh_mlt_t *multi, int timeout );
+LIBHTTP_API bool			httplib_multi_read( struct lh_mlt_t *multi, struct lh_mrs_t *result );
 LIBHTTP_API DIR *			httplib_opendir( const char *name );
+LIBHTTP_API int				httplib_peek_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char **data, size_t *len );
+LIBHTTP_API int				httplib_pipeline_send( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_req_t *requests, int num_requests );
 LIBHTTP_API int				httplib_poll( struct pollfd *pfd, unsigned int nfds, int timeout );
 LIBHTTP_API int				httplib_printf( const struct lh_ctx_t *ctx, struct lh_con_t *conn, PRINTF_FORMAT_STRING(const char *fmt), ...) PRINTF_ARGS(3, 4);
 LIBHTTP_API int				httplib_pthread_cond_broadcast( pthread_cond_t *cv );
@@ -426,7 +510,9 @@ LIBHTTP_API int				httplib_pthread_mutex_unlock( pthread_mutex_t *mutex );
 LIBHTTP_API pthread_t			httplib_pthread_self( void );
 LIBHTTP_API int				httplib_pthread_setspecific( pthread_key_t key, void *value );
 LIBHTTP_API int				httplib_read( const struct lh_ctx_t *ctx, struct lh_con_t *conn, void *buf, size_t len );
+LIBHTTP_API int64_t			httplib_read_body( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_body_handler handler, void *cbdata );
 LIBHTTP_API struct dirent *		httplib_readdir( DIR *dir );
+LIBHTTP_API int				httplib_readv( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_iov_t *iov, int iovcnt );
 LIBHTTP_API int				httplib_remove( const char *path );
 LIBHTTP_API void			httplib_send_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, const char *mime_type, const char *additional_headers );
 LIBHTTP_API void			httplib_set_alloc_callback_func( httplib_alloc_callback_func log_func );
@@ -436,6 +522,8 @@ LIBHTTP_API void			httplib_set_request_handler( struct lh_ctx_t *ctx, const char
 LIBHTTP_API void			httplib_set_user_connection_data( struct lh_con_t *conn, void *data );
 LIBHTTP_API void			httplib_set_websocket_handler( struct lh_ctx_t *ctx, const char *uri, httplib_websocket_connect_handler connect_handler, httplib_websocket_ready_handler ready_handler, httplib_websocket_data_handler data_handler, httplib_websocket_close_handler close_handler, void *cbdata );
 LIBHTTP_API struct lh_ctx_t *		httplib_start( const struct lh_clb_t *callbacks, void *user_data, const struct lh_opt_t *options );
+LIBHTTP_API int				httplib_start_chunked_response( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers );
+LIBHTTP_API int				httplib_start_compressed_response( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers );
 LIBHTTP_API int				httplib_start_thread( httplib_thread_func_t func, void *param );
 LIBHTTP_API void			httplib_stop( struct lh_ctx_t *ctx );
 LIBHTTP_API int64_t			httplib_store_body( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path );
@@ -447,14 +535,23 @@ LIBHTTP_API int				httplib_strncasecmp( const char *s1, const char *s2, size_t l
 LIBHTTP_API char *			httplib_strndup( const char *str, size_t len );
 LIBHTTP_API int				httplib_system_exit( void );
 LIBHTTP_API int				httplib_system_init( void );
+LIBHTTP_API uint64_t			httplib_timer_add( struct lh_ctx_t *ctx, int delay, int period, httplib_timer_handler handler, void *cbdata );
+LIBHTTP_API int				httplib_timer_cancel( struct lh_ctx_t *ctx, uint64_t timer_id );
 LIBHTTP_API void			httplib_unlock_connection( struct lh_con_t *conn );
 LIBHTTP_API void			httplib_unlock_context( struct lh_ctx_t *ctx );
 LIBHTTP_API int				httplib_url_decode( const char *src, int src_len, char *dst, int dst_len, int is_form_url_encoded );
 LIBHTTP_API int				httplib_url_encode( const char *src, char *dst, size_t dst_len );
 LIBHTTP_API const char *		httplib_version( void );
+LIBHTTP_API int				httplib_websocket_broadcast( const struct lh_ctx_t *ctx, struct lh_wsg_t *group, int opcode, const char *data, size_t data_len );
 LIBHTTP_API int				httplib_websocket_client_write( struct lh_ctx_t *ctx, struct lh_con_t *conn, int opcode, const char *data, size_t data_len );
+LIBHTTP_API int				httplib_websocket_group_add( struct lh_ctx_t *ctx, struct lh_wsg_t *group, struct lh_con_t *conn );
+LIBHTTP_API struct lh_wsg_t *		httplib_websocket_group_create( struct lh_ctx_t *ctx );
+LIBHTTP_API void			httplib_websocket_group_destroy( struct lh_ctx_t *ctx, struct lh_wsg_t *group );
+LIBHTTP_API int				httplib_websocket_group_flush( const struct lh_ctx_t *ctx, struct lh_wsg_t *group );
+LIBHTTP_API int				httplib_websocket_group_remove( struct lh_ctx_t *ctx, struct lh_wsg_t *group, struct lh_con_t *conn );
 LIBHTTP_API int				httplib_websocket_write( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int opcode, const char *data, size_t data_len );
 LIBHTTP_API int				httplib_write( const struct lh_ctx_t *ctx, struct lh_con_t * conn, const void *buf, size_t len );
+LIBHTTP_API int				httplib_write_chunk( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const void *buf, size_t len );
 
 LIBHTTP_API char *			lh_ipt_to_up(  const struct lh_ip_t *in, char *buffwe, size_t buflen, bool compress, bool hybrid );
 LIBHTTP_API char *			lh_ipt_to_ip4( const struct lh_ip_t *in, char *buffer, size_t buflen,                bool hybrid );
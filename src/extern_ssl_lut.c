@@ -72,6 +72,9 @@ struct ssl_func XX_httplib_ssl_sw[] = {
 	{ "SSL_CTX_set_session_id_context",     NULL },
 	{ "SSL_CTX_ctrl",                       NULL },
 	{ "SSL_CTX_set_cipher_list",            NULL },
+	{ "SSL_get1_session",                   NULL },
+	{ "SSL_set_session",                    NULL },
+	{ "SSL_SESSION_free",                   NULL },
 	{ NULL,                                 NULL }
 };
 
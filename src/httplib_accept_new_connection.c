@@ -103,7 +103,13 @@ void XX_httplib_accept_new_connection( const struct socket *listener, struct lh_
 			httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: setsockopt(IPPROTO_TCP TCP_NODELAY) failed: %s", __func__, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
 		}
 
-		if ( ctx->request_timeout > 0 ) XX_httplib_set_sock_timeout( so.sock, ctx->request_timeout );
+		/*
+		 * Reads wait for the deadline of the connection with poll().
+		 * Only SSL connections get a receive timeout, because SSL_read()
+		 * may still block for the rest of a record after poll() returned.
+		 */
+
+		if ( ctx->request_timeout > 0 ) XX_httplib_set_sock_timeout( so.sock, ctx->request_timeout, so.has_ssl );
 
 		XX_httplib_produce_socket( ctx, &so );
 	}
@@ -0,0 +1,51 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_buffer_compact( struct lh_con_t *conn );
+ *
+ * The function XX_httplib_buffer_compact() moves the data in the receive
+ * buffer of a connection back to the start of the buffer, so that the whole
+ * buffer is available again. This is only necessary when a message doesn't
+ * fit in the part of the buffer which is left.
+ */
+
+void XX_httplib_buffer_compact( struct lh_con_t *conn ) {
+
+	char *start;
+
+	if ( conn == NULL  ||  conn->buf_offset == 0 ) return;
+
+	start = conn->buf - conn->buf_offset;
+
+	if ( conn->data_len > 0 ) memmove( start, conn->buf, (size_t)conn->data_len );
+
+	conn->buf        = start;
+	conn->buf_size  += conn->buf_offset;
+	conn->buf_offset = 0;
+
+}  /* XX_httplib_buffer_compact */
@@ -0,0 +1,58 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_buffer_discard( struct lh_con_t *conn, int len );
+ *
+ * The function XX_httplib_buffer_discard() removes a processed message from
+ * the front of the receive buffer of a connection. The data behind it isn't
+ * moved. Instead the start of the buffer is advanced, so that pipelined
+ * messages which are already in the buffer are processed without copying
+ * them. The buffer is moved back to its start when it becomes empty, which
+ * costs nothing, or when less than half of it is left for the next message.
+ */
+
+void XX_httplib_buffer_discard( struct lh_con_t *conn, int len ) {
+
+	if ( conn == NULL  ||  len <= 0 ) return;
+
+	if ( len >= conn->data_len ) {
+
+		conn->data_len = 0;
+		XX_httplib_buffer_compact( conn );
+
+		return;
+	}
+
+	conn->buf        += len;
+	conn->buf_offset += len;
+	conn->buf_size   -= len;
+	conn->data_len   -= len;
+
+	if ( conn->buf_size < conn->buf_offset ) XX_httplib_buffer_compact( conn );
+
+}  /* XX_httplib_buffer_discard */
@@ -0,0 +1,52 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_buffer_grow( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_buffer_grow() is called when a header doesn't fit
+ * in the receive buffer of a connection. A connection without a buffer gets
+ * one with the size of the request_buffer_size option, and the buffer of
+ * other connections is doubled, as long as it is smaller than the size set
+ * with the max_request_size option. False is returned if the buffer can't
+ * grow.
+ */
+
+bool XX_httplib_buffer_grow( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	int size;
+
+	if ( ctx == NULL  ||  conn == NULL ) return false;
+
+	if ( conn->buf == NULL ) return XX_httplib_buffer_resize( ctx, conn, ctx->request_buffer_size );
+
+	size = conn->buf_size + conn->buf_offset;
+	if ( size >= ctx->max_request_size ) return false;
+
+	return XX_httplib_buffer_resize( ctx, conn, 2 * size );
+
+}  /* XX_httplib_buffer_grow */
@@ -0,0 +1,74 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * char *XX_httplib_buffer_pool_get( struct lh_ctx_t *ctx, int *size );
+ *
+ * The function XX_httplib_buffer_pool_get() returns a receive buffer with at
+ * least the size in size. The size is rounded up to the size class of the
+ * buffer and stored back in size. An idle buffer of that class is taken from
+ * the pool of the context if available, otherwise a new buffer is allocated.
+ * The function returns NULL if the size is larger than the largest class or if
+ * no memory is available.
+ */
+
+char *XX_httplib_buffer_pool_get( struct lh_ctx_t *ctx, int *size ) {
+
+	struct lh_bpl_t *pool;
+	char *buf;
+	int cls;
+	int len;
+
+	if ( ctx == NULL  ||  size == NULL  ||  *size > BUFFER_MAX_SIZE ) return NULL;
+
+	len = BUFFER_MIN_SIZE;
+	for (cls=0; len < *size; cls++) len *= 2;
+
+	*size = len;
+	pool  = & ctx->buffer_pool;
+	buf   = NULL;
+
+	if ( pool->initialized ) {
+
+		httplib_pthread_mutex_lock( & pool->mutex );
+
+		buf = pool->first[cls];
+
+		if ( buf != NULL ) {
+
+			memcpy( & pool->first[cls], buf, sizeof(char *) );
+			pool->len[cls]--;
+		}
+
+		httplib_pthread_mutex_unlock( & pool->mutex );
+	}
+
+	if ( buf == NULL ) buf = httplib_malloc( (size_t)len );
+
+	return buf;
+
+}  /* XX_httplib_buffer_pool_get */
@@ -0,0 +1,69 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_buffer_pool_put( struct lh_ctx_t *ctx, char *buf, int size );
+ *
+ * The function XX_httplib_buffer_pool_put() returns a receive buffer which
+ * was taken with XX_httplib_buffer_pool_get() to the pool of the context. The
+ * buffer is freed instead if the list of its size class is already full.
+ */
+
+void XX_httplib_buffer_pool_put( struct lh_ctx_t *ctx, char *buf, int size ) {
+
+	struct lh_bpl_t *pool;
+	int cls;
+	int len;
+
+	if ( buf == NULL ) return;
+
+	len = BUFFER_MIN_SIZE;
+	for (cls=0; len < size; cls++) len *= 2;
+
+	if ( ctx == NULL  ||  ! ctx->buffer_pool.initialized  ||  len != size  ||  cls >= BUFFER_NUM_CLASSES ) {
+
+		buf = httplib_free( buf );
+		return;
+	}
+
+	pool = & ctx->buffer_pool;
+
+	httplib_pthread_mutex_lock( & pool->mutex );
+
+	if ( pool->len[cls] < BUFFER_POOL_MAX ) {
+
+		memcpy( buf, & pool->first[cls], sizeof(char *) );
+		pool->first[cls] = buf;
+		pool->len[cls]++;
+		buf              = NULL;
+	}
+
+	httplib_pthread_mutex_unlock( & pool->mutex );
+
+	if ( buf != NULL ) buf = httplib_free( buf );
+
+}  /* XX_httplib_buffer_pool_put */
@@ -0,0 +1,48 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_buffer_release( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_buffer_release() returns the receive buffer of a
+ * connection to the pool of the context when the connection ends. The data
+ * in the buffer is dropped. A new buffer is taken when the connection reads
+ * its next header.
+ */
+
+void XX_httplib_buffer_release( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	if ( conn == NULL  ||  conn->buf == NULL ) return;
+
+	XX_httplib_buffer_pool_put( ctx, conn->buf - conn->buf_offset, conn->buf_size + conn->buf_offset );
+
+	conn->buf        = NULL;
+	conn->buf_size   = 0;
+	conn->buf_offset = 0;
+	conn->data_len   = 0;
+
+}  /* XX_httplib_buffer_release */
@@ -0,0 +1,60 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_buffer_resize( struct lh_ctx_t *ctx, struct lh_con_t *conn, int size );
+ *
+ * The function XX_httplib_buffer_resize() gives a connection a receive buffer
+ * of the size class for size. The data in the current buffer is moved to the
+ * start of the new buffer and the old buffer goes back to the pool. Pointers
+ * into the old buffer, like those in the request info, are not valid anymore
+ * afterwards. The function returns false if the data doesn't fit or if no
+ * buffer is available, in which case the connection keeps its old buffer.
+ */
+
+bool XX_httplib_buffer_resize( struct lh_ctx_t *ctx, struct lh_con_t *conn, int size ) {
+
+	char *buf;
+	int data_len;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  size < conn->data_len ) return false;
+
+	buf = XX_httplib_buffer_pool_get( ctx, & size );
+	if ( buf == NULL ) return false;
+
+	data_len = conn->data_len;
+	if ( data_len > 0 ) memcpy( buf, conn->buf, (size_t)data_len );
+
+	XX_httplib_buffer_release( ctx, conn );
+
+	conn->buf      = buf;
+	conn->buf_size = size;
+	conn->data_len = data_len;
+
+	return true;
+
+}  /* XX_httplib_buffer_resize */
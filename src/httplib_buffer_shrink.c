@@ -0,0 +1,48 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_buffer_shrink( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_buffer_shrink() gives an idle keep-alive connection
+ * whose receive buffer grew for a large header a buffer with the size of the
+ * request_buffer_size option again, so that a few large requests don't keep
+ * large buffers in use for the lifetime of their connections.
+ */
+
+void XX_httplib_buffer_shrink( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	int size;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->buf == NULL ) return;
+
+	size = BUFFER_MIN_SIZE;
+	while ( size < ctx->request_buffer_size ) size *= 2;
+
+	if ( conn->buf_size + conn->buf_offset > size  &&  conn->data_len <= size ) XX_httplib_buffer_resize( ctx, conn, size );
+
+}  /* XX_httplib_buffer_shrink */
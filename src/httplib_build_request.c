@@ -0,0 +1,90 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * char *XX_httplib_build_request( const struct lh_req_t *req, size_t *len );
+ *
+ * The function XX_httplib_build_request() formats a client request with the
+ * request line, the Host and Content-Length headers, the additional headers
+ * of the caller and the body in one buffer, so that it can be sent with
+ * other requests in one call. The length of the request is returned in len.
+ * The buffer must be freed by the caller. NULL is returned if the request
+ * contains line breaks where they are not allowed, or if no memory is
+ * available.
+ */
+
+char *XX_httplib_build_request( const struct lh_req_t *req, size_t *len ) {
+
+	const char *method;
+	const char *uri;
+	const char *headers;
+	char *buf;
+	size_t size;
+	size_t pos;
+	bool send_len;
+	int n;
+
+	if ( req == NULL  ||  len == NULL ) return NULL;
+
+	method  = ( req->method  != NULL ) ? req->method  : "GET";
+	uri     = ( req->uri     != NULL ) ? req->uri     : "/";
+	headers = ( req->headers != NULL ) ? req->headers : "";
+
+	if ( strpbrk( method, " \r\n" ) != NULL  ||  strpbrk( uri, " \r\n" ) != NULL                  ) return NULL;
+	if ( req->host != NULL  &&  strpbrk( req->host, "\r\n" ) != NULL                               ) return NULL;
+	if ( req->body == NULL  &&  req->body_len > 0                                                  ) return NULL;
+
+	/*
+	 * A body length is sent with every request which has a body and with
+	 * the methods which are expected to have one, so that the server
+	 * doesn't wait for a body until the connection is closed.
+	 */
+
+	send_len = ( req->body_len > 0  ||  ! strcmp( method, "POST" )  ||  ! strcmp( method, "PUT" )  ||  ! strcmp( method, "PATCH" ) );
+
+	size = strlen( method ) + strlen( uri ) + strlen( headers ) + req->body_len + 64;
+	if ( req->host != NULL ) size += strlen( req->host ) + 8;
+
+	buf = httplib_malloc( size );
+	if ( buf == NULL ) return NULL;
+
+	n = snprintf( buf, size, "%s %s HTTP/1.1\r\n", method, uri );
+	pos = (size_t)n;
+
+	if ( req->host != NULL ) { n = snprintf( buf+pos, size-pos, "Host: %s\r\n",                     req->host                ); pos += (size_t)n; }
+	if ( send_len          ) { n = snprintf( buf+pos, size-pos, "Content-Length: %" INT64_FMT "\r\n", (int64_t)req->body_len ); pos += (size_t)n; }
+
+	n = snprintf( buf+pos, size-pos, "%s\r\n", headers );
+	pos += (size_t)n;
+
+	if ( req->body_len > 0 ) memcpy( buf+pos, req->body, req->body_len );
+	pos += req->body_len;
+
+	*len = pos;
+	return buf;
+
+}  /* XX_httplib_build_request */
@@ -47,12 +47,16 @@ unsigned httplib_check_feature( unsigned feature ) {
 #if !defined(NO_CGI)
 	                                    | 0x0004u
 #endif
+#if defined(USE_ZLIB)
+	                                    | 0x0008u
+#endif
+#if defined(USE_BROTLI)
+	                                    | 0x0010u
+#endif
 
 /* Set some extra bits not defined in the API documentation.
  * These bits may change without further notice. */
-#if defined(USE_TIMERS)
 	                                    | 0x0200u
-#endif
 #if !defined(NO_POPEN)
 	                                    | 0x0800u
 #endif
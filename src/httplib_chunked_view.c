@@ -0,0 +1,218 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+static size_t	parse_framing( struct lh_con_t *conn, const char *ptr, size_t avail );
+
+/*
+ * int XX_httplib_chunked_view( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool fill, const char **data, size_t *len );
+ *
+ * The function XX_httplib_chunked_view() runs the decoder of a body which is
+ * received with chunked transfer encoding until decoded chunk data is
+ * available in the connection buffer. The chunk size lines, the CRLF after
+ * each chunk, chunk extensions and trailer fields are processed in place. The
+ * buffer is refilled from the socket when needed, so that many small chunks
+ * can be decoded after one receive call.
+ *
+ * On return data and len describe the chunk data in the buffer. If the fill
+ * flag is false the buffer is never refilled. When all buffered data has been
+ * decoded, len is set to 0 and 1 is returned. If the decoder is then in the
+ * middle of a chunk, the caller can read the chunk data directly from the
+ * socket.
+ *
+ * The function returns 1 if data is available, 0 at the end of the body and
+ * -1 if the body violates the protocol or the connection is closed before the
+ * end of the body.
+ */
+
+int XX_httplib_chunked_view( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool fill, const char **data, size_t *len ) {
+
+	int64_t avail;
+	const char *ptr;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  data == NULL  ||  len == NULL ) return -1;
+
+	*data = NULL;
+	*len  = 0;
+
+	for (;;) {
+
+		if ( conn->chunk_state == CHUNK_STATE_DONE ) {
+
+			conn->is_chunked = 2;
+			return 0;
+		}
+
+		if ( conn->chunk_state == CHUNK_STATE_ERROR ) {
+
+			conn->must_close = true;
+			return -1;
+		}
+
+		avail = (int64_t)conn->data_len - (int64_t)conn->request_len - conn->consumed_content;
+
+		if ( avail <= 0 ) {
+
+			if ( ! fill ) return 1;
+
+			if ( ! XX_httplib_fill_body_buffer( ctx, conn ) ) conn->chunk_state = CHUNK_STATE_ERROR;
+			continue;
+		}
+
+		ptr = conn->buf + conn->request_len + conn->consumed_content;
+
+		if ( conn->chunk_state == CHUNK_STATE_DATA ) {
+
+			*data = ptr;
+			*len  = ( conn->chunk_remainder < (size_t)avail ) ? conn->chunk_remainder : (size_t)avail;
+			return 1;
+		}
+
+		conn->consumed_content += (int64_t)parse_framing( conn, ptr, (size_t)avail );
+		conn->content_len       = conn->consumed_content;
+	}
+
+}  /* XX_httplib_chunked_view */
+
+
+
+/*
+ * static size_t parse_framing( struct lh_con_t *conn, const char *ptr, size_t avail );
+ *
+ * The function parse_framing() processes the chunk size lines, the CRLF
+ * sequences after the chunk data and the trailer section at ptr. It stops at
+ * the start of chunk data, at the end of the body, at a protocol error or when
+ * all avail bytes have been processed. The number of processed bytes is
+ * returned.
+ */
+
+static size_t parse_framing( struct lh_con_t *conn, const char *ptr, size_t avail ) {
+
+	size_t i;
+	int digit;
+	char c;
+
+	for (i=0; i<avail; i++) {
+
+		c = ptr[i];
+
+		switch ( conn->chunk_state ) {
+
+			case CHUNK_STATE_SIZE :
+
+				if      ( c >= '0'  &&  c <= '9' ) digit = c - '0';
+				else if ( c >= 'a'  &&  c <= 'f' ) digit = c - 'a' + 10;
+				else if ( c >= 'A'  &&  c <= 'F' ) digit = c - 'A' + 10;
+				else                               digit = -1;
+
+				if ( digit >= 0 ) {
+
+					/*
+					 * Reject chunk sizes which don't fit in a size_t
+					 */
+
+					if ( conn->chunk_remainder > (SIZE_MAX >> 4)  ||  conn->chunk_line_len >= CHUNK_LINE_MAX ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+
+					conn->chunk_remainder = (conn->chunk_remainder << 4) | (size_t)digit;
+				}
+
+				else if ( conn->chunk_line_len == 0 ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+				else if ( c == '\r'                 ) conn->chunk_state = CHUNK_STATE_SIZE_LF;
+				else if ( c == ';'  ||  c == ' '  ||  c == '\t' ) conn->chunk_state = CHUNK_STATE_EXT;
+				else                                  { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+
+				conn->chunk_line_len++;
+				break;
+
+			case CHUNK_STATE_EXT :
+
+				if ( ++conn->chunk_line_len > CHUNK_LINE_MAX ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+				if ( c == '\r' ) conn->chunk_state = CHUNK_STATE_SIZE_LF;
+				break;
+
+			case CHUNK_STATE_SIZE_LF :
+
+				if ( c != '\n' ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+
+				conn->chunk_line_len = 0;
+
+				if ( conn->chunk_remainder == 0 ) conn->chunk_state = CHUNK_STATE_TRAILER;
+
+				else {
+					conn->chunk_state = CHUNK_STATE_DATA;
+					return i+1;
+				}
+				break;
+
+			case CHUNK_STATE_DATA_CR :
+
+				if ( c != '\r' ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+				conn->chunk_state = CHUNK_STATE_DATA_LF;
+				break;
+
+			case CHUNK_STATE_DATA_LF :
+
+				if ( c != '\n' ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+				conn->chunk_state = CHUNK_STATE_SIZE;
+				break;
+
+			case CHUNK_STATE_TRAILER :
+
+				if ( c == '\r' ) conn->chunk_state = CHUNK_STATE_END_LF;
+
+				else {
+					conn->chunk_state    = CHUNK_STATE_TRAILER_LINE;
+					conn->chunk_line_len = 1;
+				}
+				break;
+
+			case CHUNK_STATE_TRAILER_LINE :
+
+				if ( ++conn->chunk_line_len > CHUNK_LINE_MAX ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+				if ( c == '\r' ) conn->chunk_state = CHUNK_STATE_TRAILER_LF;
+				break;
+
+			case CHUNK_STATE_TRAILER_LF :
+
+				if ( c != '\n' ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+				conn->chunk_state = CHUNK_STATE_TRAILER;
+				break;
+
+			case CHUNK_STATE_END_LF :
+
+				if ( c != '\n' ) { conn->chunk_state = CHUNK_STATE_ERROR; return i; }
+				conn->chunk_state = CHUNK_STATE_DONE;
+				return i+1;
+
+			default :
+				return i;
+		}
+	}
+
+	return avail;
+
+}  /* parse_framing */
@@ -0,0 +1,63 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_client_pool_free( struct lh_ctx_t *ctx );
+ *
+ * The function XX_httplib_client_pool_free() closes all idle connections in
+ * the connection pool of a client context and releases the resources of the
+ * pool. It is called when the client context is destroyed.
+ */
+
+void XX_httplib_client_pool_free( struct lh_ctx_t *ctx ) {
+
+	struct lh_cpl_t *pool;
+	struct lh_con_t *conn;
+
+	if ( ctx == NULL  ||  ! ctx->client_pool.initialized ) return;
+
+	pool = & ctx->client_pool;
+
+	httplib_pthread_mutex_lock( & pool->mutex );
+
+	conn           = pool->first;
+	pool->first    = NULL;
+	pool->num_idle = 0;
+
+	httplib_pthread_mutex_unlock( & pool->mutex );
+
+	while ( conn != NULL ) {
+
+		pool->first = conn->pool_next;
+		XX_httplib_free_client_connection( ctx, conn );
+		conn = pool->first;
+	}
+
+	httplib_pthread_mutex_destroy( & pool->mutex );
+	pool->initialized = false;
+
+}  /* XX_httplib_client_pool_free */
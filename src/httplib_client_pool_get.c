@@ -0,0 +1,172 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+#include "httplib_ssl.h"
+
+static struct lh_con_t *	pool_take( struct lh_ctx_t *ctx, const char *host, int port, bool use_ssl );
+static bool			pool_alive( const struct lh_con_t *conn );
+
+/*
+ * struct lh_con_t *XX_httplib_client_pool_get( struct lh_ctx_t *ctx, const char *host, int port, bool use_ssl );
+ *
+ * The function XX_httplib_client_pool_get() takes an idle connection to the
+ * given host, port and protocol from the connection pool of a client context.
+ * Connections on which the peer closed the connection or sent unexpected data
+ * while they were parked are discarded, as well as connections which were
+ * idle longer than the idle timeout of the pool. NULL is returned if no usable
+ * connection was found and a new connection must be opened.
+ */
+
+struct lh_con_t *XX_httplib_client_pool_get( struct lh_ctx_t *ctx, const char *host, int port, bool use_ssl ) {
+
+	struct lh_con_t *conn;
+
+	if ( ctx == NULL  ||  host == NULL  ||  ! ctx->client_pool.initialized ) return NULL;
+
+	while ( (conn = pool_take( ctx, host, port, use_ssl )) != NULL ) {
+
+		if ( pool_alive( conn ) ) {
+
+			XX_httplib_reset_per_request_attributes( conn );
+			XX_httplib_deadline_set( conn, DEADLINE_NONE, 0 );
+
+			conn->data_len        = 0;
+			conn->request_timeout = ctx->request_timeout;
+			conn->pool_reused     = true;
+
+			XX_httplib_buffer_compact( conn );
+			return conn;
+		}
+
+		XX_httplib_free_client_connection( ctx, conn );
+	}
+
+	return NULL;
+
+}  /* XX_httplib_client_pool_get */
+
+
+
+/*
+ * static struct lh_con_t *pool_take( struct lh_ctx_t *ctx, const char *host, int port, bool use_ssl );
+ *
+ * The function pool_take() unlinks the most recently parked connection which
+ * matches the host, port and protocol from the pool. Connections which passed
+ * the idle timeout are unlinked on the way and freed after the lock of the
+ * pool has been released.
+ */
+
+static struct lh_con_t *pool_take( struct lh_ctx_t *ctx, const char *host, int port, bool use_ssl ) {
+
+	struct lh_cpl_t *pool;
+	struct lh_con_t *conn;
+	struct lh_con_t *next;
+	struct lh_con_t *prev;
+	struct lh_con_t *found;
+	struct lh_con_t *stale;
+	int64_t now;
+	bool expired;
+
+	pool  = & ctx->client_pool;
+	found = NULL;
+	stale = NULL;
+	prev  = NULL;
+	now   = XX_httplib_monotonic_msec();
+
+	httplib_pthread_mutex_lock( & pool->mutex );
+
+	for (conn=pool->first; conn != NULL; conn=next) {
+
+		next    = conn->pool_next;
+		expired = ( ctx->client_pool_idle_timeout > 0  &&  now - conn->pool_idle_since >= ctx->client_pool_idle_timeout );
+
+		if ( ! expired  &&  ( found != NULL  ||  conn->pool_port != port  ||  conn->client.has_ssl != use_ssl  ||  httplib_strcasecmp( conn->pool_host, host ) ) ) {
+
+			prev = conn;
+			continue;
+		}
+
+		if ( prev == NULL ) pool->first     = next;
+		else                prev->pool_next = next;
+
+		pool->num_idle--;
+
+		if ( expired ) {
+
+			conn->pool_next = stale;
+			stale           = conn;
+		}
+
+		else {
+			conn->pool_next = NULL;
+			found           = conn;
+		}
+	}
+
+	if ( found != NULL ) pool->num_reused++;
+
+	httplib_pthread_mutex_unlock( & pool->mutex );
+
+	while ( stale != NULL ) {
+
+		conn  = stale;
+		stale = conn->pool_next;
+
+		XX_httplib_free_client_connection( ctx, conn );
+	}
+
+	return found;
+
+}  /* pool_take */
+
+
+
+/*
+ * static bool pool_alive( const struct lh_con_t *conn );
+ *
+ * The function pool_alive() checks if a parked connection can still be used.
+ * Nothing may be readable on an idle connection. If data is readable the
+ * peer has either closed the connection or sent data which doesn't belong to
+ * any request, and in both cases the connection can't be used anymore.
+ */
+
+static bool pool_alive( const struct lh_con_t *conn ) {
+
+	struct pollfd pfd;
+
+	if ( conn->client.sock == INVALID_SOCKET ) return false;
+
+#ifndef NO_SSL
+	if ( conn->ssl != NULL  &&  SSL_pending( conn->ssl ) > 0 ) return false;
+#endif  /* NO_SSL */
+
+	pfd.fd      = conn->client.sock;
+	pfd.events  = POLLIN;
+	pfd.revents = 0;
+
+	return ( httplib_poll( &pfd, 1, 0 ) == 0 );
+
+}  /* pool_alive */
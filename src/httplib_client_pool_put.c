@@ -0,0 +1,166 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static bool			pool_reusable( const struct lh_ctx_t *ctx, const struct lh_con_t *conn );
+
+/*
+ * bool XX_httplib_client_pool_put( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_client_pool_put() parks a client connection which
+ * the application closed in the connection pool of the client context, so
+ * that it can be used again for a following request to the same host. The
+ * function returns true if the connection was parked. If false is returned,
+ * the connection can't be reused and the caller must free it.
+ *
+ * When the pool already holds the maximum number of connections, the
+ * connection which has been idle for the longest time is closed to make room.
+ * A receive buffer which grew for a large response header shrinks before the
+ * connection is parked.
+ */
+
+bool XX_httplib_client_pool_put( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	struct lh_cpl_t *pool;
+	struct lh_con_t *walk;
+	struct lh_con_t *prev;
+	struct lh_con_t *evict;
+	int num_host;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  ! ctx->client_pool.initialized ) return false;
+	if ( ! pool_reusable( ctx, conn )                                        ) return false;
+
+	pool     = & ctx->client_pool;
+	evict    = NULL;
+	num_host = 0;
+
+	/*
+	 * The response was read completely, so the data in the receive buffer
+	 * isn't needed anymore.
+	 */
+
+	conn->data_len = 0;
+	XX_httplib_buffer_shrink( ctx, conn );
+
+	httplib_pthread_mutex_lock( & pool->mutex );
+
+	for (walk=pool->first; walk != NULL; walk=walk->pool_next) {
+
+		if ( walk->pool_port == conn->pool_port  &&  walk->client.has_ssl == conn->client.has_ssl  &&  ! httplib_strcasecmp( walk->pool_host, conn->pool_host ) ) num_host++;
+	}
+
+	if ( num_host >= ctx->client_pool_max_per_host ) {
+
+		httplib_pthread_mutex_unlock( & pool->mutex );
+		return false;
+	}
+
+	/*
+	 * The list is ordered from the most to the least recently parked
+	 * connection, so the last connection is the one to evict.
+	 */
+
+	if ( pool->num_idle >= ctx->client_pool_max_idle ) {
+
+		prev = NULL;
+		for (walk=pool->first; walk->pool_next != NULL; walk=walk->pool_next) prev = walk;
+
+		if ( prev == NULL ) pool->first     = NULL;
+		else                prev->pool_next = NULL;
+
+		evict = walk;
+		pool->num_idle--;
+	}
+
+	conn->pool_idle_since = XX_httplib_monotonic_msec();
+	conn->pool_reused     = false;
+	conn->pool_next       = pool->first;
+	pool->first           = conn;
+	pool->num_idle++;
+
+	httplib_pthread_mutex_unlock( & pool->mutex );
+
+	if ( evict != NULL ) XX_httplib_free_client_connection( ctx, evict );
+
+	return true;
+
+}  /* XX_httplib_client_pool_put */
+
+
+
+/*
+ * static bool pool_reusable( const struct lh_ctx_t *ctx, const struct lh_con_t *conn );
+ *
+ * The function pool_reusable() returns true if a client connection is in a
+ * state where another request can be sent over it. This is only the case if
+ * the response was read completely, no bytes beyond the response were
+ * received and the server didn't announce that it will close the connection.
+ */
+
+static bool pool_reusable( const struct lh_ctx_t *ctx, const struct lh_con_t *conn ) {
+
+	const char *http_version;
+	const char *status;
+	const char *header;
+
+	if ( conn->pool_host == NULL  ||  conn->ws_client                                  ) return false;
+	if ( ctx->client_pool_max_idle <= 0  ||  ctx->client_pool_max_per_host <= 0        ) return false;
+	if ( conn->must_close  ||  conn->deadline.expired                                  ) return false;
+	if ( conn->client.sock == INVALID_SOCKET  ||  conn->request_len <= 0               ) return false;
+	if ( conn->chunk_out != NULL  ||  conn->compress != NULL                           ) return false;
+
+	/*
+	 * Informational responses like "101 Switching Protocols" hand the
+	 * connection over to another protocol.
+	 */
+
+	status = conn->request_info.request_uri;
+	if ( status == NULL  ||  status[0] == '1'                                          ) return false;
+
+	if ( conn->is_chunked ) {
+
+		if ( conn->is_chunked != 2                                                 ) return false;
+	}
+
+	else if ( conn->content_len < 0  ||  conn->consumed_content < conn->content_len   ) return false;
+
+	if ( (int64_t)conn->data_len - (int64_t)conn->request_len > conn->consumed_content ) return false;
+
+	/*
+	 * In a parsed response the protocol is stored as the request method
+	 * and the status code as the request URI.
+	 */
+
+	http_version = conn->request_info.request_method;
+	header       = httplib_get_header( conn, "Connection" );
+
+	if ( http_version == NULL  ||  httplib_strncasecmp( http_version, "HTTP/", 5 )     ) return false;
+	if ( header != NULL  &&  XX_httplib_header_has_option( header, "close" )          ) return false;
+	if ( strcmp( http_version+5, "1.1" )  &&  ( header == NULL  ||  ! XX_httplib_header_has_option( header, "keep-alive" ) ) ) return false;
+
+	return true;
+
+}  /* pool_reusable */
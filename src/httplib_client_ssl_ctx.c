@@ -0,0 +1,131 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+#if !defined(NO_SSL)
+
+#include "httplib_main.h"
+#include "httplib_pthread.h"
+#include "httplib_ssl.h"
+
+static SSL_CTX *		client_ssl_new( struct lh_ctx_t *ctx );
+
+/*
+ * SSL_CTX *XX_httplib_client_ssl_ctx( struct lh_ctx_t *ctx );
+ *
+ * The function XX_httplib_client_ssl_ctx() returns the SSL context which is
+ * shared by the secure connections of a client context. The SSL libraries are
+ * loaded and the context is created and configured when the function is
+ * called for the first time. NULL is returned if an error occured.
+ */
+
+SSL_CTX *XX_httplib_client_ssl_ctx( struct lh_ctx_t *ctx ) {
+
+	SSL_CTX *ssl_ctx;
+
+	if ( ctx == NULL  ||  ! ctx->client_ssl.initialized ) return NULL;
+
+	httplib_pthread_mutex_lock( & ctx->client_ssl.mutex );
+
+	if ( ctx->client_ssl.ssl_ctx == NULL ) ctx->client_ssl.ssl_ctx = client_ssl_new( ctx );
+	ssl_ctx = ctx->client_ssl.ssl_ctx;
+
+	httplib_pthread_mutex_unlock( & ctx->client_ssl.mutex );
+
+	return ssl_ctx;
+
+}  /* XX_httplib_client_ssl_ctx */
+
+
+
+/*
+ * static SSL_CTX *client_ssl_new( struct lh_ctx_t *ctx );
+ *
+ * The function client_ssl_new() creates the SSL context of a client context.
+ * The certificate in the option ssl_certificate is presented to servers which
+ * ask for a client certificate, and the certificate of the server is verified
+ * with the ssl_ca_file and ssl_ca_path options if ssl_verify_peer is set.
+ */
+
+static SSL_CTX *client_ssl_new( struct lh_ctx_t *ctx ) {
+
+	SSL_CTX *ssl_ctx;
+
+	if ( ! XX_httplib_initialize_ssl( ctx ) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: SSL is not initialized", __func__ );
+		return NULL;
+	}
+
+	ssl_ctx = SSL_CTX_new( SSLv23_client_method() );
+	if ( ssl_ctx == NULL ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: SSL_CTX_new (client) error: %s", __func__, XX_httplib_ssl_error() );
+		XX_httplib_uninitialize_ssl( ctx );
+		return NULL;
+	}
+
+	SSL_CTX_clear_options( ssl_ctx, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3 | SSL_OP_NO_TLSv1 | SSL_OP_NO_TLSv1_1 );
+	SSL_CTX_set_options(   ssl_ctx, XX_httplib_ssl_get_protocol( ctx->ssl_protocol_version ) );
+
+	if ( ctx->ssl_certificate != NULL  &&  ! XX_httplib_ssl_use_pem_file( ctx, ssl_ctx, ctx->ssl_certificate ) ) {
+
+		SSL_CTX_free( ssl_ctx );
+		XX_httplib_uninitialize_ssl( ctx );
+		return NULL;
+	}
+
+	if ( ctx->ssl_verify_peer ) {
+
+		if ( ( ctx->ssl_ca_file != NULL  ||  ctx->ssl_ca_path != NULL )  &&  SSL_CTX_load_verify_locations( ssl_ctx, ctx->ssl_ca_file, ctx->ssl_ca_path ) != 1 ) {
+
+			httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: SSL_CTX_load_verify_locations error: %s", __func__, XX_httplib_ssl_error() );
+			SSL_CTX_free( ssl_ctx );
+			XX_httplib_uninitialize_ssl( ctx );
+			return NULL;
+		}
+
+		if ( ctx->ssl_verify_paths  &&  SSL_CTX_set_default_verify_paths( ssl_ctx ) != 1 ) {
+
+			httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: SSL_CTX_set_default_verify_paths error: %s", __func__, XX_httplib_ssl_error() );
+			SSL_CTX_free( ssl_ctx );
+			XX_httplib_uninitialize_ssl( ctx );
+			return NULL;
+		}
+
+		SSL_CTX_set_verify(       ssl_ctx, SSL_VERIFY_PEER, NULL );
+		SSL_CTX_set_verify_depth( ssl_ctx, ctx->ssl_verify_depth );
+	}
+
+	else SSL_CTX_set_verify( ssl_ctx, SSL_VERIFY_NONE, NULL );
+
+	if ( ctx->ssl_cipher_list != NULL  &&  SSL_CTX_set_cipher_list( ssl_ctx, ctx->ssl_cipher_list ) != 1 ) {
+
+		httplib_cry( LH_DEBUG_WARNING, ctx, NULL, "%s: SSL_CTX_set_cipher_list error: %s", __func__, XX_httplib_ssl_error() );
+	}
+
+	return ssl_ctx;
+
+}  /* client_ssl_new */
+
+#endif /* !NO_SSL */
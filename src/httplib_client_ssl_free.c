@@ -0,0 +1,70 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+#if !defined(NO_SSL)
+
+#include "httplib_main.h"
+#include "httplib_pthread.h"
+#include "httplib_ssl.h"
+
+/*
+ * void XX_httplib_client_ssl_free( struct lh_ctx_t *ctx );
+ *
+ * The function XX_httplib_client_ssl_free() frees the cached TLS sessions and
+ * the shared SSL context of a client context. It is called when the client
+ * context is destroyed, after the idle connections in the connection pool
+ * were closed.
+ */
+
+void XX_httplib_client_ssl_free( struct lh_ctx_t *ctx ) {
+
+	struct lh_tss_t *entry;
+
+	if ( ctx == NULL  ||  ! ctx->client_ssl.initialized ) return;
+
+	while ( ctx->client_ssl.first != NULL ) {
+
+		entry                 = ctx->client_ssl.first;
+		ctx->client_ssl.first = entry->next;
+
+		SSL_SESSION_free( entry->session );
+		entry->host = httplib_free( entry->host );
+		entry       = httplib_free( entry       );
+	}
+
+	ctx->client_ssl.num_sessions = 0;
+
+	if ( ctx->client_ssl.ssl_ctx != NULL ) {
+
+		SSL_CTX_free( ctx->client_ssl.ssl_ctx );
+		ctx->client_ssl.ssl_ctx = NULL;
+		XX_httplib_uninitialize_ssl( ctx );
+	}
+
+	httplib_pthread_mutex_destroy( & ctx->client_ssl.mutex );
+	ctx->client_ssl.initialized = false;
+
+}  /* XX_httplib_client_ssl_free */
+
+#endif /* !NO_SSL */
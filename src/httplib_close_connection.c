@@ -50,9 +50,24 @@ void XX_httplib_close_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn )
 
 	conn->must_close = true;
 
+	XX_httplib_compress_free( conn );
+	XX_httplib_websocket_deflate_free( conn );
+
+	XX_httplib_websocket_queue_free( conn );
+
+	if ( conn->chunk_out != NULL ) conn->chunk_out = httplib_free( conn->chunk_out );
+
 #ifndef NO_SSL
 	if ( conn->ssl != NULL ) {
 
+		/*
+		 * Keep the session of a secure client connection, which may have
+		 * been renewed by the server after the handshake, for the next
+		 * connection to the same host.
+		 */
+
+		if ( conn->pool_host != NULL ) XX_httplib_ssl_session_put( ctx, conn );
+
 		/*
 		 * Run SSL_shutdown twice to ensure completly close SSL connection
 		 */
@@ -87,49 +102,59 @@ void XX_httplib_close_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn )
  * The function httplib_close_connection() closes the connection passed as a
  * parameter to this function. The function does not return a success or
  * failure value.
+ *
+ * A connection of a client context is parked in the connection pool of the
+ * context instead, if its response was read completely and the server allows
+ * the connection to stay open. The websocket client thread of a websocket
+ * client connection is stopped before the connection is freed. The client
+ * context itself stays valid and can be used for other connections.
  */
 
 void httplib_close_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
 
-	struct lh_ctx_t *client_ctx;
 	int i;
 
 	if ( ctx == NULL  ||  conn == NULL ) return;
 
-	if ( ctx->ctx_type == CTX_TYPE_CLIENT ) {
-
-		client_ctx  = ctx;
-		ctx->status = CTX_STATUS_STOPPING;
-	}
-
-	else client_ctx = NULL;
+	if ( ctx->ctx_type != CTX_TYPE_CLIENT ) {
 
 #ifndef NO_SSL
-	if ( conn->client_ssl_ctx != NULL ) {
-		
-		SSL_CTX_free( (SSL_CTX *)conn->client_ssl_ctx );
-		conn->client_ssl_ctx = NULL;
-	}
+		if ( conn->client_ssl_ctx != NULL ) {
+
+			SSL_CTX_free( (SSL_CTX *)conn->client_ssl_ctx );
+			conn->client_ssl_ctx = NULL;
+		}
 #endif
-	XX_httplib_close_connection( ctx, conn );
+		XX_httplib_close_connection( ctx, conn );
+		return;
+	}
 
-	if ( client_ctx != NULL ) {
+	if ( conn->ws_client ) {
 
 		/*
-		 * join worker thread and free context
+		 * Wake up the websocket client thread which is blocked reading the
+		 * socket and wait until it has finished with the connection.
 		 */
 
-		for (i=0; i<client_ctx->num_threads; i++) {
+		ctx->status = CTX_STATUS_STOPPING;
+
+		if ( conn->client.sock != INVALID_SOCKET ) shutdown( conn->client.sock, SHUTDOWN_BOTH );
 
-			if ( client_ctx->workerthreadids[i] != 0 ) httplib_pthread_join( client_ctx->workerthreadids[i], NULL );
+		for (i=0; i<ctx->num_threads; i++) {
+
+			if ( ctx->workerthreadids[i] != 0 ) httplib_pthread_join( ctx->workerthreadids[i], NULL );
 		}
 
-		client_ctx->workerthreadids = httplib_free( client_ctx->workerthreadids );
-		client_ctx                  = httplib_free( client_ctx                  );
+		ctx->workerthreadids = httplib_free( ctx->workerthreadids );
+		ctx->num_threads     = 0;
+		ctx->user_data       = NULL;
 
-		httplib_pthread_mutex_destroy( & conn->mutex );
+		XX_httplib_free_client_connection( ctx, conn );
 
-		conn = httplib_free( conn );
+		ctx->status = CTX_STATUS_RUNNING;
+		return;
 	}
 
+	if ( ! XX_httplib_client_pool_put( ctx, conn ) ) XX_httplib_free_client_connection( ctx, conn );
+
 }  /* httplib_close_connection */
@@ -88,7 +88,7 @@ void XX_httplib_close_socket_gracefully( struct lh_ctx_t *ctx, struct lh_con_t *
 	 */
 
 	do {
-		n = XX_httplib_pull( ctx, NULL, conn, buf, sizeof(buf), 1E-10 /* TODO: allow 0 as timeout */ );
+		n = recv( conn->client.sock, buf, (int)sizeof(buf), 0 );
 	} while ( n > 0 );
 #endif
 
@@ -0,0 +1,58 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_compress_free( struct lh_con_t *conn );
+ *
+ * The function XX_httplib_compress_free() releases the compressor and all
+ * other resources which are used for on the fly compression of the response
+ * on a connection. Data which has not been sent yet is discarded.
+ */
+
+void XX_httplib_compress_free( struct lh_con_t *conn ) {
+
+	struct lh_cmp_t *cmp;
+
+	if ( conn == NULL  ||  conn->compress == NULL ) return;
+
+	cmp            = conn->compress;
+	conn->compress = NULL;
+
+#if defined(USE_ZLIB)
+	if ( cmp->zstream_init ) deflateEnd( & cmp->zstream );
+#endif  /* USE_ZLIB */
+
+#if defined(USE_BROTLI)
+	if ( cmp->brotli != NULL ) BrotliEncoderDestroyInstance( cmp->brotli );
+#endif  /* USE_BROTLI */
+
+	httplib_free( cmp->headers );
+	httplib_free( cmp->pending );
+	httplib_free( cmp );
+
+}  /* XX_httplib_compress_free */
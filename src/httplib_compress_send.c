@@ -0,0 +1,276 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+static bool	send_headers( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp );
+static bool	flush_out( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, bool last );
+static bool	store_plain( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len );
+#if defined(USE_ZLIB)
+static bool	store_zlib( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len, bool finish );
+#endif  /* USE_ZLIB */
+#if defined(USE_BROTLI)
+static bool	store_brotli( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len, bool finish );
+#endif  /* USE_BROTLI */
+
+/*
+ * bool XX_httplib_compress_send( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len, bool finish );
+ *
+ * The function XX_httplib_compress_send() passes a block of body data through
+ * the compressor of a compressed response. The response headers are sent
+ * first if that has not been done yet. Compressed data is collected in the out
+ * buffer of the connection which is only sent when it is full, or when the
+ * finish flag is set to indicate that this is the last block of the body. The
+ * function returns false if an error occured.
+ */
+
+bool XX_httplib_compress_send( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len, bool finish ) {
+
+	struct lh_cmp_t *cmp;
+	bool retval;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->compress == NULL ) return false;
+
+	cmp = conn->compress;
+	if ( cmp->error ) return false;
+
+	if ( ! cmp->headers_sent  &&  ! send_headers( ctx, conn, cmp ) ) {
+
+		cmp->error       = true;
+		conn->must_close = true;
+		return false;
+	}
+
+	if ( cmp->no_body ) return true;
+
+	if ( buf == NULL ) len = 0;
+	if ( len == 0  &&  ! finish ) return true;
+
+	switch ( cmp->encoding ) {
+
+#if defined(USE_ZLIB)
+		case COMPRESS_GZIP    :
+		case COMPRESS_DEFLATE :
+			retval = store_zlib( ctx, conn, cmp, buf, len, finish );
+			break;
+#endif  /* USE_ZLIB */
+
+#if defined(USE_BROTLI)
+		case COMPRESS_BR :
+			retval = store_brotli( ctx, conn, cmp, buf, len, finish );
+			break;
+#endif  /* USE_BROTLI */
+
+		default :
+			retval = store_plain( ctx, conn, cmp, buf, len );
+			break;
+	}
+
+	if ( retval  &&  finish ) {
+
+		retval = flush_out( ctx, conn, cmp, true );
+	}
+
+	if ( ! retval ) {
+
+		cmp->error       = true;
+		conn->must_close = true;
+	}
+
+	return retval;
+
+}  /* XX_httplib_compress_send */
+
+
+
+/*
+ * static bool send_headers( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp );
+ *
+ * The function send_headers() completes the response headers which were
+ * prepared by httplib_start_compressed_response() with the headers which
+ * describe the encoding of the body, and sends them in one write.
+ */
+
+static bool send_headers( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp ) {
+
+	int len;
+
+	len = snprintf( cmp->headers + cmp->headers_len, 96, "%s%s%s%s\r\n",
+			(cmp->encoding != COMPRESS_IDENTITY) ? "Content-Encoding: "                        : "",
+			(cmp->encoding != COMPRESS_IDENTITY) ? XX_httplib_compress_name[cmp->encoding]     : "",
+			(cmp->encoding != COMPRESS_IDENTITY) ? "\r\n"                                      : "",
+			(cmp->chunked                      ) ? "Transfer-Encoding: chunked\r\n"            : "" );
+
+	if ( len < 0  ||  len >= 96 ) return false;
+
+	cmp->headers_len += (size_t)len;
+	cmp->headers_sent = true;
+
+	return ( XX_httplib_write_raw( ctx, conn, cmp->headers, cmp->headers_len ) == (int)cmp->headers_len );
+
+}  /* send_headers */
+
+
+
+/*
+ * static bool flush_out( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, bool last );
+ *
+ * The function flush_out() sends the contents of the out buffer, as one chunk
+ * if chunked transfer encoding is used. When the last flag is set, the last
+ * chunk which ends the body is sent in the same write.
+ */
+
+static bool flush_out( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, bool last ) {
+
+	size_t len;
+
+	len          = cmp->out_len;
+	cmp->out_len = 0;
+
+	if ( cmp->chunked ) return XX_httplib_send_chunk( ctx, conn, cmp->out + CHUNK_HDR_LEN, len, last );
+
+	return ( len == 0  ||  XX_httplib_write_raw( ctx, conn, cmp->out + CHUNK_HDR_LEN, len ) == (int)len );
+
+}  /* flush_out */
+
+
+
+/*
+ * static bool store_plain( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len );
+ *
+ * The function store_plain() copies uncompressed data to the out buffer. This
+ * is used when the client doesn't accept any of the available compression
+ * methods. Small writes are in that case still combined in larger chunks.
+ */
+
+static bool store_plain( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len ) {
+
+	size_t part;
+
+	while ( len > 0 ) {
+
+		part = COMPRESS_BUF_LEN - cmp->out_len;
+		if ( part > len ) part = len;
+
+		memcpy( cmp->out + CHUNK_HDR_LEN + cmp->out_len, buf, part );
+		cmp->out_len += part;
+		buf          += part;
+		len          -= part;
+
+		if ( cmp->out_len == COMPRESS_BUF_LEN  &&  ! flush_out( ctx, conn, cmp, false ) ) return false;
+	}
+
+	return true;
+
+}  /* store_plain */
+
+
+
+#if defined(USE_ZLIB)
+/*
+ * static bool store_zlib( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len, bool finish );
+ *
+ * The function store_zlib() compresses data with zlib in the gzip or deflate
+ * format to the out buffer.
+ */
+
+static bool store_zlib( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len, bool finish ) {
+
+	z_stream *zs;
+	size_t part;
+	int retval;
+	bool last;
+
+	zs = & cmp->zstream;
+
+	/*
+	 * The avail_in field is an unsigned int, so very large blocks are fed to
+	 * the compressor in several parts.
+	 */
+
+	do {
+		part = ( len > UINT_MAX ) ? UINT_MAX : len;
+		last = finish  &&  part == len;
+
+		zs->next_in  = (const Bytef *)buf;
+		zs->avail_in = (uInt)part;
+
+		do {
+			zs->next_out  = (Bytef *)( cmp->out + CHUNK_HDR_LEN + cmp->out_len );
+			zs->avail_out = (uInt)( COMPRESS_BUF_LEN - cmp->out_len );
+
+			retval = deflate( zs, (last) ? Z_FINISH : Z_NO_FLUSH );
+			if ( retval == Z_STREAM_ERROR ) return false;
+
+			cmp->out_len = COMPRESS_BUF_LEN - zs->avail_out;
+
+			if ( cmp->out_len == COMPRESS_BUF_LEN  &&  ! flush_out( ctx, conn, cmp, false ) ) return false;
+
+		} while ( zs->avail_in > 0  ||  ( last  &&  retval != Z_STREAM_END ) );
+
+		buf += part;
+		len -= part;
+
+	} while ( len > 0 );
+
+	return true;
+
+}  /* store_zlib */
+#endif  /* USE_ZLIB */
+
+
+
+#if defined(USE_BROTLI)
+/*
+ * static bool store_brotli( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len, bool finish );
+ *
+ * The function store_brotli() compresses data with brotli to the out buffer.
+ */
+
+static bool store_brotli( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_cmp_t *cmp, const char *buf, size_t len, bool finish ) {
+
+	const uint8_t *next_in;
+	uint8_t *next_out;
+	size_t avail_out;
+
+	next_in = (const uint8_t *)buf;
+
+	do {
+		next_out  = (uint8_t *)( cmp->out + CHUNK_HDR_LEN + cmp->out_len );
+		avail_out = COMPRESS_BUF_LEN - cmp->out_len;
+
+		if ( ! BrotliEncoderCompressStream( cmp->brotli, (finish) ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_PROCESS, & len, & next_in, & avail_out, & next_out, NULL ) ) return false;
+
+		cmp->out_len = COMPRESS_BUF_LEN - avail_out;
+
+		if ( cmp->out_len == COMPRESS_BUF_LEN  &&  ! flush_out( ctx, conn, cmp, false ) ) return false;
+
+	} while ( len > 0  ||  BrotliEncoderHasMoreOutput( cmp->brotli )  ||  ( finish  &&  ! BrotliEncoderIsFinished( cmp->brotli ) ) );
+
+	return true;
+
+}  /* store_brotli */
+#endif  /* USE_BROTLI */
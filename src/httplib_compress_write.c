@@ -0,0 +1,90 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int XX_httplib_compress_write( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len );
+ *
+ * The function XX_httplib_compress_write() is called by httplib_write() when
+ * the response of a connection is compressed on the fly. As long as less than
+ * compression_min_size bytes have been written, the data is collected in the
+ * pending buffer. Once that size is reached, the headers and the collected
+ * data are sent and from then on all data is passed directly to the
+ * compressor.
+ *
+ * The function returns the number of bytes processed, or 0 if an error
+ * occured.
+ */
+
+int XX_httplib_compress_write( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len ) {
+
+	struct lh_cmp_t *cmp;
+	size_t new_size;
+	char *new_buf;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->compress == NULL  ||  buf == NULL  ||  len == 0  ||  len > INT_MAX ) return 0;
+
+	cmp = conn->compress;
+	if ( cmp->error ) return 0;
+
+	if ( cmp->headers_sent ) return ( XX_httplib_compress_send( ctx, conn, buf, len, false ) ) ? (int)len : 0;
+
+	if ( cmp->pending_len + len < cmp->min_size ) {
+
+		if ( cmp->pending_len + len > cmp->pending_size ) {
+
+			new_size = ( cmp->pending_size == 0 ) ? MG_BUF_LEN : cmp->pending_size * 2;
+			while ( new_size < cmp->pending_len + len ) new_size *= 2;
+			if ( new_size > cmp->min_size ) new_size = cmp->min_size;
+
+			new_buf = httplib_realloc( cmp->pending, new_size );
+			if ( new_buf == NULL ) return 0;
+
+			cmp->pending      = new_buf;
+			cmp->pending_size = new_size;
+		}
+
+		memcpy( cmp->pending + cmp->pending_len, buf, len );
+		cmp->pending_len += len;
+
+		return (int)len;
+	}
+
+	/*
+	 * The body is large enough to be compressed. The data collected so far
+	 * is sent first and the pending buffer is no longer needed.
+	 */
+
+	if ( ! XX_httplib_compress_send( ctx, conn, cmp->pending, cmp->pending_len, false ) ) return 0;
+
+	cmp->pending      = httplib_free( cmp->pending );
+	cmp->pending_len  = 0;
+	cmp->pending_size = 0;
+
+	return ( XX_httplib_compress_send( ctx, conn, buf, len, false ) ) ? (int)len : 0;
+
+}  /* XX_httplib_compress_write */
@@ -70,7 +70,15 @@ struct lh_con_t *httplib_connect_client( struct lh_ctx_t *ctx, const char *host,
  * static struct lh_con_t *httplib_connect_client_impl( struct lh_ctx_t *ctx, const struct httplib_client_options *client_options, int use_ssl );
  *
  * The function httplib_connect_client_impl() is the background function doing the
- * heavy lifting to make connections as a client to remote servers.
+ * heavy lifting to make connections as a client to remote servers. An idle
+ * connection from the connection pool of a client context is used if one is
+ * available for the host, port and protocol. Connections with certificate
+ * options are never pooled, because the certificates are part of the SSL
+ * context of the connection.
+ *
+ * All other secure connections of a client context share the SSL context of
+ * the client context, and offer the TLS session of an earlier connection to
+ * the same host and port to the server, so that the handshake can be resumed.
  */
 
 static struct lh_con_t *httplib_connect_client_impl( struct lh_ctx_t *ctx, const struct httplib_client_options *client_options, int use_ssl ) {
@@ -81,19 +89,43 @@ static struct lh_con_t *httplib_connect_client_impl( struct lh_ctx_t *ctx, const
 	socklen_t len;
 	struct sockaddr *psa;
 	char error_string[ERROR_STRING_LEN];
+	int timeout;
+	bool poolable;
+#ifndef NO_SSL
+	SSL_CTX *ssl_ctx;
+	SSL_SESSION *session;
+	int ssl_ok;
+#endif  /* NO_SSL */
 
 	if ( ctx == NULL ) return NULL;
 
-	if ( ! XX_httplib_connect_socket( ctx, client_options->host, client_options->port, use_ssl, &sock, &sa ) ) return NULL;
+	poolable = ( ctx->client_pool.initialized  &&  client_options->host != NULL  &&  client_options->client_cert == NULL  &&  client_options->server_cert == NULL );
+
+	if ( poolable  &&  (conn = XX_httplib_client_pool_get( ctx, client_options->host, client_options->port, use_ssl )) != NULL ) return conn;
+
+#ifndef NO_SSL
+	/*
+	 * The shared SSL context of a client context is also created for
+	 * connections with their own SSL context, because it loads the SSL
+	 * libraries.
+	 */
+
+	ssl_ctx = NULL;
+	if ( use_ssl  &&  ctx->client_ssl.initialized  &&  (ssl_ctx = XX_httplib_client_ssl_ctx( ctx )) == NULL ) return NULL;
+#endif  /* NO_SSL */
+
+	timeout = ( client_options->connect_timeout > 0 ) ? client_options->connect_timeout : ctx->connect_timeout;
+
+	if ( ! XX_httplib_connect_socket( ctx, client_options->host, client_options->port, use_ssl, timeout, &sock, &sa ) ) return NULL;
 	
-	if ( (conn = httplib_calloc( 1, sizeof(*conn) + MAX_REQUEST_SIZE )) == NULL ) {
+	if ( (conn = httplib_calloc( 1, sizeof(*conn) )) == NULL ) {
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: calloc(): %s", __func__, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
 		closesocket( sock );
 	}
 #ifndef NO_SSL
 	
-	else if ( use_ssl  &&  (conn->client_ssl_ctx = SSL_CTX_new(SSLv23_client_method())) == NULL ) {
+	else if ( use_ssl  &&  ( ssl_ctx == NULL  ||  ! poolable )  &&  (conn->client_ssl_ctx = SSL_CTX_new(SSLv23_client_method())) == NULL ) {
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: SSL_CTX_new error", __func__ );
 		closesocket( sock );
@@ -106,57 +138,63 @@ static struct lh_con_t *httplib_connect_client_impl( struct lh_ctx_t *ctx, const
 		len = (sa.sa.sa_family == AF_INET) ? sizeof(conn->client.rsa.sin)               : sizeof(conn->client.rsa.sin6);
 		psa = (sa.sa.sa_family == AF_INET) ? (struct sockaddr *)&(conn->client.rsa.sin) : (struct sockaddr *)&(conn->client.rsa.sin6);
 
-		conn->buf_size    = MAX_REQUEST_SIZE;
-		conn->buf         = (char *)(conn + 1);
-		conn->client.sock = sock;
-		conn->client.lsa  = sa;
+		conn->client.sock     = sock;
+		conn->client.lsa      = sa;
+		conn->request_timeout = ctx->request_timeout;
 
 		if ( getsockname( sock, psa, &len ) != 0 ) httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: getsockname() failed: %s", __func__, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
 
 		conn->client.has_ssl = (use_ssl) ? true : false;
+		conn->pool_port      = client_options->port;
+		if ( poolable ) conn->pool_host = httplib_strdup( client_options->host );
 		httplib_pthread_mutex_init( &conn->mutex, &XX_httplib_pthread_mutex_attr );
 
 #ifndef NO_SSL
 		if ( use_ssl ) {
 
-			ctx->ssl_ctx = conn->client_ssl_ctx;
+			session = NULL;
 
-			/*
-			 * TODO: Check ssl_verify_peer and ssl_ca_path here.
-			 * SSL_CTX_set_verify call is needed to switch off server
-			 * certificate checking, which is off by default in OpenSSL and
-			 * on in yaSSL.
-			 *
-			 * TODO: SSL_CTX_set_verify(conn->client_ssl_ctx,
-			 * SSL_VERIFY_PEER, verify_ssl_server);
-			 */
+			if ( conn->client_ssl_ctx != NULL ) {
 
-			if ( client_options->client_cert ) {
+				ssl_ctx = conn->client_ssl_ctx;
 
-				if ( ! XX_httplib_ssl_use_pem_file( ctx, client_options->client_cert ) ) {
+				if ( client_options->client_cert  &&  ! XX_httplib_ssl_use_pem_file( ctx, ssl_ctx, client_options->client_cert ) ) {
 
 					httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: can not use SSL client certificate", __func__ );
 					SSL_CTX_free( conn->client_ssl_ctx );
 					closesocket( sock );
-					conn = httplib_free( conn );
+					httplib_pthread_mutex_destroy( & conn->mutex );
+					conn->pool_host = httplib_free( conn->pool_host );
+					conn            = httplib_free( conn            );
+					return NULL;
 				}
-			}
 
-			if ( client_options->server_cert ) {
+				if ( client_options->server_cert ) {
+
+					SSL_CTX_load_verify_locations( ssl_ctx, client_options->server_cert, NULL );
+					SSL_CTX_set_verify( ssl_ctx, SSL_VERIFY_PEER, NULL );
+				}
 
-				SSL_CTX_load_verify_locations( conn->client_ssl_ctx, client_options->server_cert, NULL );
-				SSL_CTX_set_verify( conn->client_ssl_ctx, SSL_VERIFY_PEER, NULL );
+				else SSL_CTX_set_verify( ssl_ctx, SSL_VERIFY_NONE, NULL );
 			}
-			
-			else SSL_CTX_set_verify( conn->client_ssl_ctx, SSL_VERIFY_NONE, NULL );
 
-			if ( ! XX_httplib_sslize( ctx, conn, conn->client_ssl_ctx, SSL_connect ) ) {
+			else if ( conn->pool_host != NULL ) session = XX_httplib_ssl_session_take( ctx, conn->pool_host, conn->pool_port );
+
+			ssl_ok = XX_httplib_sslize( ctx, conn, ssl_ctx, session, SSL_connect );
+
+			if ( session != NULL ) SSL_SESSION_free( session );
+
+			if ( ! ssl_ok ) {
 
 				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: SSL connection error", __func__ );
-				SSL_CTX_free( conn->client_ssl_ctx );
+				if ( conn->client_ssl_ctx != NULL ) SSL_CTX_free( conn->client_ssl_ctx );
 				closesocket( sock );
-				conn = httplib_free( conn );
+				httplib_pthread_mutex_destroy( & conn->mutex );
+				conn->pool_host = httplib_free( conn->pool_host );
+				conn            = httplib_free( conn            );
 			}
+
+			else if ( conn->pool_host != NULL ) XX_httplib_ssl_session_put( ctx, conn );
 		}
 #endif
 	}
@@ -0,0 +1,259 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static int	interleave_families( const union usa *addrs, int num_addrs, int *order );
+static SOCKET	start_attempt( const union usa *addr, int *error );
+
+/*
+ * bool XX_httplib_connect_race( const struct lh_ctx_t *ctx, const union usa *addrs, int num_addrs, int timeout, SOCKET *sock, int *winner, int *error );
+ *
+ * The function XX_httplib_connect_race() connects to one of the addresses of
+ * a host with the Happy Eyeballs algorithm of RFC 8305. The addresses are
+ * tried with IPv6 and IPv4 addresses alternating, starting with the family of
+ * the first address. A new attempt is started when the previous attempts
+ * didn't succeed within HAPPY_EYEBALLS_DELAY milliseconds or when they all
+ * failed, without cancelling the attempts which are still running. The first
+ * attempt which succeeds wins and the others are closed. An address which
+ * doesn't answer therefore delays the connection only briefly.
+ *
+ * All attempts are given up when no connection was established within the
+ * timeout in milliseconds. A timeout of zero or less waits until the
+ * operating system gives up.
+ *
+ * On success the function returns true with the connected socket in blocking
+ * mode and the index of the address in winner. Otherwise false is returned
+ * with the error of the last failed attempt, or ETIMEDOUT.
+ */
+
+bool XX_httplib_connect_race( const struct lh_ctx_t *ctx, const union usa *addrs, int num_addrs, int timeout, SOCKET *sock, int *winner, int *error ) {
+
+	struct pollfd pfd[RESOLVER_MAX_ADDRS];
+	int index[RESOLVER_MAX_ADDRS];
+	int order[RESOLVER_MAX_ADDRS];
+	int num_order;
+	int num_active;
+	int next;
+	int a;
+	int n;
+	int wait;
+	int err;
+	socklen_t len;
+	int64_t now;
+	int64_t deadline;
+	int64_t next_start;
+
+	if ( ctx == NULL  ||  addrs == NULL  ||  sock == NULL  ||  winner == NULL  ||  error == NULL ) return false;
+
+	*sock   = INVALID_SOCKET;
+	*winner = -1;
+	*error  = 0;
+
+	num_order  = interleave_families( addrs, num_addrs, order );
+	num_active = 0;
+	next       = 0;
+	now        = XX_httplib_monotonic_msec();
+	deadline   = ( timeout > 0 ) ? now + timeout : 0;
+	next_start = now;
+
+	while ( *sock == INVALID_SOCKET ) {
+
+		now = XX_httplib_monotonic_msec();
+
+		if ( deadline > 0  &&  now >= deadline ) {
+
+			*error = ETIMEDOUT;
+			break;
+		}
+
+		/*
+		 * Start the next attempt when the running attempts had their
+		 * head start, or immediately when none is running anymore.
+		 */
+
+		if ( next < num_order  &&  ( num_active == 0  ||  now >= next_start ) ) {
+
+			a = order[next++];
+			pfd[num_active].fd = start_attempt( & addrs[a], error );
+
+			if ( pfd[num_active].fd == INVALID_SOCKET ) continue;
+
+			pfd[num_active].events  = POLLOUT;
+			pfd[num_active].revents = 0;
+			index[num_active]       = a;
+			num_active++;
+			next_start              = now + HAPPY_EYEBALLS_DELAY;
+
+			continue;
+		}
+
+		if ( num_active == 0 ) break;
+
+		wait = -1;
+		if ( next     < num_order                                     ) wait = (int)(next_start - now);
+		if ( deadline > 0  &&  ( wait < 0  ||  deadline - now < wait ) ) wait = (int)(deadline - now);
+
+		n = httplib_poll( pfd, (unsigned int)num_active, wait );
+
+		if ( n < 0 ) {
+
+			if ( ERRNO == EINTR ) continue;
+
+			*error = ERRNO;
+			break;
+		}
+
+		for (a=0; a<num_active; a++) {
+
+			if ( pfd[a].revents == 0 ) continue;
+
+			err = 0;
+			len = sizeof(err);
+
+			if ( getsockopt( pfd[a].fd, SOL_SOCKET, SO_ERROR, (char *)&err, &len ) != 0 ) err = ERRNO;
+
+			if ( err == 0 ) {
+
+				*sock   = pfd[a].fd;
+				*winner = index[a];
+				break;
+			}
+
+			/*
+			 * The attempt failed. The next address is tried right
+			 * away instead of after the delay.
+			 */
+
+			*error = err;
+			closesocket( pfd[a].fd );
+
+			num_active--;
+			pfd[a]     = pfd[num_active];
+			index[a]   = index[num_active];
+			next_start = now;
+			a--;
+		}
+	}
+
+	for (a=0; a<num_active; a++) {
+
+		if ( pfd[a].fd != *sock ) closesocket( pfd[a].fd );
+	}
+
+	if ( *sock == INVALID_SOCKET ) return false;
+
+	XX_httplib_set_blocking_mode( *sock );
+
+	return true;
+
+}  /* XX_httplib_connect_race */
+
+
+
+/*
+ * static int interleave_families( const union usa *addrs, int num_addrs, int *order );
+ *
+ * The function interleave_families() fills an array with the indices of the
+ * addresses in the order in which they are tried. The relative order of the
+ * addresses of one family is kept, and the families alternate starting with
+ * the family of the first address. The number of indices is returned.
+ */
+
+static int interleave_families( const union usa *addrs, int num_addrs, int *order ) {
+
+	int first[RESOLVER_MAX_ADDRS];
+	int other[RESOLVER_MAX_ADDRS];
+	int num_first;
+	int num_other;
+	int num_order;
+	int a;
+
+	num_first = 0;
+	num_other = 0;
+	num_order = 0;
+
+	if ( num_addrs > RESOLVER_MAX_ADDRS ) num_addrs = RESOLVER_MAX_ADDRS;
+
+	for (a=0; a<num_addrs; a++) {
+
+		if ( addrs[a].sa.sa_family == addrs[0].sa.sa_family ) first[num_first++] = a;
+		else                                                  other[num_other++] = a;
+	}
+
+	for (a=0; a<num_first  ||  a<num_other; a++) {
+
+		if ( a < num_first ) order[num_order++] = first[a];
+		if ( a < num_other ) order[num_order++] = other[a];
+	}
+
+	return num_order;
+
+}  /* interleave_families */
+
+
+
+/*
+ * static SOCKET start_attempt( const union usa *addr, int *error );
+ *
+ * The function start_attempt() creates a non-blocking socket and starts to
+ * connect it to an address. The socket is returned while the connection is
+ * in progress or when it was established immediately. INVALID_SOCKET is
+ * returned with the error if the attempt failed right away.
+ */
+
+static SOCKET start_attempt( const union usa *addr, int *error ) {
+
+	SOCKET sock;
+	socklen_t len;
+
+	if ( addr->sa.sa_family == AF_INET ) {
+
+		sock = socket( PF_INET, SOCK_STREAM, 0 );
+		len  = sizeof(addr->sin);
+	}
+
+	else {
+		sock = socket( PF_INET6, SOCK_STREAM, 0 );
+		len  = sizeof(addr->sin6);
+	}
+
+	if ( sock == INVALID_SOCKET ) {
+
+		*error = ERRNO;
+		return INVALID_SOCKET;
+	}
+
+	XX_httplib_set_close_on_exec(     sock );
+	XX_httplib_set_non_blocking_mode( sock );
+
+	if ( connect( sock, & addr->sa, len ) == 0  ||  ERRNO == EINPROGRESS  ||  ERRNO == EWOULDBLOCK ) return sock;
+
+	*error = ERRNO;
+	closesocket( sock );
+
+	return INVALID_SOCKET;
+
+}  /* start_attempt */
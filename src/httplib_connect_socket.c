@@ -36,20 +36,32 @@
  * The context structure may be NULL. The output socket and the socket address
  * may not be null for this function to succeed.
  *
+ * The host can be a literal IPv4 or IPv6 address or a host name. Host names
+ * are resolved through the resolver cache of the context. When a name has
+ * several addresses, they are raced against each other with the Happy
+ * Eyeballs algorithm. The connection must be established within the timeout
+ * in milliseconds. A timeout of zero or less waits until the operating system
+ * gives up.
+ *
  * The function returns false if an error occured, and true if the connection
  * has been established.
  */
 
-bool XX_httplib_connect_socket( struct lh_ctx_t *ctx, const char *host, int port, int use_ssl, SOCKET *sock, union usa *sa ) {
+bool XX_httplib_connect_socket( struct lh_ctx_t *ctx, const char *host, int port, int use_ssl, int timeout, SOCKET *sock, union usa *sa ) {
 
-	int ip_ver;
+	union usa addrs[RESOLVER_MAX_ADDRS];
+	int num_addrs;
+	int a;
+	int winner;
+	int error;
 	char error_string[ERROR_STRING_LEN];
 
 	if ( ctx == NULL ) return false;
 
-	ip_ver = 0;
-	*sock  = INVALID_SOCKET;
-	memset( sa, 0, sizeof(*sa) );
+	num_addrs = 0;
+	*sock     = INVALID_SOCKET;
+	memset( sa,    0, sizeof(*sa)    );
+	memset( addrs, 0, sizeof(addrs) );
 
 	if ( host == NULL ) {
 
@@ -74,17 +86,8 @@ bool XX_httplib_connect_socket( struct lh_ctx_t *ctx, const char *host, int port
 	UNUSED_PARAMETER(use_ssl);
 #endif  /*NO_SSL */
 
-	if (XX_httplib_inet_pton(AF_INET, host, &sa->sin, sizeof(sa->sin))) {
-
-		sa->sin.sin_port = htons((uint16_t)port);
-		ip_ver = 4;
-	}
-	
-	else if ( XX_httplib_inet_pton( AF_INET6, host, &sa->sin6, sizeof(sa->sin6) ) ) {
-
-		sa->sin6.sin6_port = htons( (uint16_t)port );
-		ip_ver = 6;
-	}
+	if      ( XX_httplib_inet_pton( AF_INET,  host, &addrs[0].sin,  sizeof(addrs[0].sin)  ) ) num_addrs = 1;
+	else if ( XX_httplib_inet_pton( AF_INET6, host, &addrs[0].sin6, sizeof(addrs[0].sin6) ) ) num_addrs = 1;
 	
 	else if ( host[0] == '[' ) {
 
@@ -100,43 +103,41 @@ bool XX_httplib_connect_socket( struct lh_ctx_t *ctx, const char *host, int port
 
 			h[l-1] = 0;
 
-			if ( XX_httplib_inet_pton( AF_INET6, h, &sa->sin6, sizeof(sa->sin6) ) ) {
-
-				sa->sin6.sin6_port = htons( (uint16_t)port );
-				ip_ver = 6;
-			}
+			if ( XX_httplib_inet_pton( AF_INET6, h, &addrs[0].sin6, sizeof(addrs[0].sin6) ) ) num_addrs = 1;
 			h = httplib_free( h );
 		}
 	}
 
-	if ( ip_ver == 0 ) {
+	else {
+		num_addrs = XX_httplib_resolve( ctx, host, addrs, RESOLVER_MAX_ADDRS );
 
-		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: host not found", __func__ );
-		return false;
-	}
+		if ( num_addrs < 0 ) {
 
-	if      ( ip_ver == 4 ) *sock = socket( PF_INET,  SOCK_STREAM, 0 );
-	else if ( ip_ver == 6 ) *sock = socket( PF_INET6, SOCK_STREAM, 0 );
+			httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: timeout resolving %s", __func__, host );
+			return false;
+		}
+	}
 
-	if ( *sock == INVALID_SOCKET ) {
+	if ( num_addrs == 0 ) {
 
-		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: socket(): %s", __func__, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
+		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: host not found", __func__ );
 		return false;
 	}
 
-	XX_httplib_set_close_on_exec( *sock );
+	for (a=0; a<num_addrs; a++) {
 
-	if ( ip_ver == 4  &&  connect( *sock, (struct sockaddr *)&sa->sin,  sizeof(sa->sin)  ) == 0 ) return true;
-	if ( ip_ver == 6  &&  connect( *sock, (struct sockaddr *)&sa->sin6, sizeof(sa->sin6) ) == 0 ) return true;
+		if ( addrs[a].sa.sa_family == AF_INET ) addrs[a].sin.sin_port   = htons( (uint16_t)port );
+		else                                    addrs[a].sin6.sin6_port = htons( (uint16_t)port );
+	}
+
+	if ( ! XX_httplib_connect_race( ctx, addrs, num_addrs, timeout, sock, &winner, &error ) ) {
 
-	/*
-	 * Not connected
-	 */
+		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: connect(%s:%d): %s", __func__, host, port, httplib_error_string( error, error_string, ERROR_STRING_LEN ) );
+		return false;
+	}
 
-	httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: connect(%s:%d): %s", __func__, host, port, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
-	closesocket( *sock );
-	*sock = INVALID_SOCKET;
+	*sa = addrs[winner];
 
-	return false;
+	return true;
 
 }  /* XX_httplib_connect_socket */
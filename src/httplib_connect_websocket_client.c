@@ -41,12 +41,13 @@ struct lh_con_t *httplib_connect_websocket_client( struct lh_ctx_t *ctx, const c
 	struct websocket_client_thread_data *thread_data;
 	static const char *magic = "x3JJHMbDL1EzLkh9GBhXDw==";
 	const char *handshake_req;
+	const char *extensions;
 
 	if ( ctx == NULL ) return NULL;
 
-	if ( ctx->status != CTX_STATUS_TERMINATED ) {
+	if ( ctx->workerthreadids != NULL ) {
 
-		httplib_cry( LH_DEBUG_CRASH, ctx, NULL, "%s: client context not in terminated state", __func__ );
+		httplib_cry( LH_DEBUG_CRASH, ctx, NULL, "%s: client context already has a websocket connection", __func__ );
 		return NULL;
 	}
 
@@ -57,6 +58,7 @@ struct lh_con_t *httplib_connect_websocket_client( struct lh_ctx_t *ctx, const c
 		                "Sec-WebSocket-Key: %s\r\n"
 		                "Sec-WebSocket-Version: 13\r\n"
 		                "Origin: %s\r\n"
+		                "%s"
 		                "\r\n";
 	
 	else handshake_req = "GET %s HTTP/1.1\r\n"
@@ -65,13 +67,25 @@ struct lh_con_t *httplib_connect_websocket_client( struct lh_ctx_t *ctx, const c
 		                "Connection: Upgrade\r\n"
 		                "Sec-WebSocket-Key: %s\r\n"
 		                "Sec-WebSocket-Version: 13\r\n"
+		                "%s"
 		                "\r\n";
 
 	/*
-	 * Establish the client connection and request upgrade
+	 * Offer permessage-deflate with the maximum window in both directions
 	 */
 
-	conn = httplib_download( ctx, host, port, use_ssl, handshake_req, path, host, magic, origin );
+	extensions = "";
+#if defined(USE_ZLIB)
+	if ( ctx->enable_websocket_compression  &&  ctx->compression_level > 0 ) extensions = "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n";
+#endif  /* USE_ZLIB */
+
+	/*
+	 * Establish the client connection and request upgrade.
+	 */
+
+	if ( origin != NULL ) conn = httplib_download( ctx, host, port, use_ssl, handshake_req, path, host, magic, origin, extensions );
+	else                  conn = httplib_download( ctx, host, port, use_ssl, handshake_req, path, host, magic,         extensions );
+
 	if ( conn == NULL ) {
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: init of download failed", __func__ );
@@ -82,7 +96,15 @@ struct lh_con_t *httplib_connect_websocket_client( struct lh_ctx_t *ctx, const c
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: unexpected server reply \"%s\"", __func__, conn->request_info.request_uri );
 
-		conn = httplib_free( conn );
+		httplib_close_connection( ctx, conn );
+		return NULL;
+	}
+
+	if ( ! XX_httplib_websocket_deflate_accept( ctx, conn, httplib_get_header( conn, "Sec-WebSocket-Extensions" ) ) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: invalid websocket extension in server reply", __func__ );
+
+		XX_httplib_free_client_connection( ctx, conn );
 		return NULL;
 	}
 
@@ -97,7 +119,8 @@ struct lh_con_t *httplib_connect_websocket_client( struct lh_ctx_t *ctx, const c
 
 		ctx->num_threads = 0;
 		ctx->user_data   = NULL;
-		conn             = httplib_free( conn );
+
+		XX_httplib_free_client_connection( ctx, conn );
 
 		return NULL;
 	}
@@ -111,11 +134,14 @@ struct lh_con_t *httplib_connect_websocket_client( struct lh_ctx_t *ctx, const c
 		ctx->workerthreadids = httplib_free( ctx->workerthreadids );
 		ctx->num_threads     = 0;
 		ctx->user_data       = NULL;
-		conn                 = httplib_free( conn );
+
+		XX_httplib_free_client_connection( ctx, conn );
 
 		return NULL;
 	}
 
+	conn->ws_client            = true;
+
 	thread_data->ctx           = ctx;
 	thread_data->conn          = conn;
 	thread_data->data_handler  = data_func;
@@ -133,11 +159,12 @@ struct lh_con_t *httplib_connect_websocket_client( struct lh_ctx_t *ctx, const c
 		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: thread failed to start", __func__ );
 
 		thread_data          = httplib_free( thread_data          );
-		conn                 = httplib_free( conn                 );
 		ctx->workerthreadids = httplib_free( ctx->workerthreadids );
 		ctx->num_threads     = 0;
 		ctx->user_data       = NULL;
 
+		XX_httplib_free_client_connection( ctx, conn );
+
 		return NULL;
 	}
 
@@ -0,0 +1,68 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_consume_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, size_t len );
+ *
+ * The function httplib_consume_body() removes len bytes from the start of the
+ * body data returned by httplib_peek_body(). Only bytes which are available in
+ * the connection buffer can be consumed. The function returns 0 if successful
+ * and -1 if more bytes are consumed than available.
+ */
+
+int httplib_consume_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, size_t len ) {
+
+	int64_t avail;
+
+	if ( ctx == NULL  ||  conn == NULL ) return -1;
+	if ( len  == 0    ) return 0;
+
+	avail = (int64_t)conn->data_len - (int64_t)conn->request_len - conn->consumed_content;
+
+	if ( conn->is_chunked ) {
+
+		if ( conn->chunk_state != CHUNK_STATE_DATA  ||  len > conn->chunk_remainder ) return -1;
+	}
+
+	else if ( avail > conn->content_len - conn->consumed_content ) avail = conn->content_len - conn->consumed_content;
+
+	if ( avail < 0  ||  (uint64_t)len > (uint64_t)avail ) return -1;
+
+	conn->consumed_content += (int64_t)len;
+
+	if ( conn->is_chunked ) {
+
+		conn->content_len      = conn->consumed_content;
+		conn->chunk_remainder -= len;
+
+		if ( conn->chunk_remainder == 0 ) conn->chunk_state = CHUNK_STATE_DATA_CR;
+	}
+
+	return 0;
+
+}  /* httplib_consume_body */
@@ -31,15 +31,20 @@
 #define QUEUE_SIZE(ctx) ((int)(ARRAY_SIZE(ctx->queue)))
 
 /*
- * int XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, int thread_index );
+ * int XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, struct lh_wsx_t **wsx, int thread_index );
  *
  * The function XX_httplib_consume_socket() takes an accepted socket from the
- * queue for further processing.
+ * queue for further processing. When no socket is waiting, a websocket
+ * connection of the reactor which has messages for its data handler is taken
+ * from the ready list instead and returned in wsx. The parameter wsx is set
+ * to NULL when a socket was taken.
  */
 
 #if defined(ALTERNATIVE_QUEUE)
 
-int XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, int thread_index ) {
+int XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, struct lh_wsx_t **wsx, int thread_index ) {
+
+	*wsx = NULL;
 
 	ctx->client_socks[thread_index].in_use = 0;
 	event_wait( ctx->client_wait_events[thread_index] );
@@ -52,17 +57,37 @@ int XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, int thre
 #else /* ALTERNATIVE_QUEUE */
 
 /* Worker threads take accepted socket from the queue */
-int XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, int thread_index ) {
+int XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, struct lh_wsx_t **wsx, int thread_index ) {
 
 	UNUSED_PARAMETER(thread_index);
 
+	*wsx = NULL;
+
 	httplib_pthread_mutex_lock( & ctx->thread_mutex );
 
 	/*
 	 * If the queue is empty, wait. We're idle at this point.
 	 */
 
-	while ( ctx->sq_head == ctx->sq_tail  &&  ctx->status == CTX_STATUS_RUNNING ) httplib_pthread_cond_wait( & ctx->sq_full, & ctx->thread_mutex );
+	while ( ctx->sq_head == ctx->sq_tail  &&  ctx->ws_ready_first == NULL  &&  ctx->status == CTX_STATUS_RUNNING ) httplib_pthread_cond_wait( & ctx->sq_full, & ctx->thread_mutex );
+
+	/*
+	 * New connections go first, because the master thread may be waiting
+	 * for room in the queue.
+	 */
+
+	if ( ctx->sq_head == ctx->sq_tail  &&  ctx->ws_ready_first != NULL  &&  ctx->status == CTX_STATUS_RUNNING ) {
+
+		*wsx                = ctx->ws_ready_first;
+		ctx->ws_ready_first = (*wsx)->ready_next;
+		(*wsx)->ready_next  = NULL;
+
+		if ( ctx->ws_ready_first == NULL ) ctx->ws_ready_last = NULL;
+
+		httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+		return 1;
+	}
 
 	/*
 	 * If we're stopping, sq_head may be equal to sq_tail.
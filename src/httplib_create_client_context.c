@@ -29,6 +29,10 @@
  * for one simultaneous client connection. It is not possible to use one client
  * context for multiple connections at the same time, because the contect
  * contains SSL context information which is specific for one connection.
+ *
+ * Connections which are closed after their response was read completely are
+ * kept open in a pool in the context, and are reused by following requests
+ * to the same host and port.
  */
 
 struct lh_ctx_t *httplib_create_client_context( const struct lh_clb_t *callbacks, const struct lh_opt_t *options ) {
@@ -54,7 +58,29 @@ struct lh_ctx_t *httplib_create_client_context( const struct lh_clb_t *callbacks
 
 	ctx->callbacks.exit_context = exit_callback;
 	ctx->ctx_type               = CTX_TYPE_CLIENT;
-	ctx->status                 = CTX_STATUS_TERMINATED;
+	ctx->status                 = CTX_STATUS_RUNNING;
+	ctx->num_threads            = 0;
+
+	httplib_pthread_mutex_init( & ctx->client_pool.mutex, NULL );
+	ctx->client_pool.initialized = true;
+
+	httplib_pthread_mutex_init( & ctx->buffer_pool.mutex, NULL );
+	ctx->buffer_pool.initialized = true;
+
+#if !defined(NO_SSL)
+	httplib_pthread_mutex_init( & ctx->client_ssl.mutex, NULL );
+	ctx->client_ssl.initialized = true;
+#endif  /* NO_SSL */
+
+	/*
+	 * The condition variables on Windows need thread local storage which
+	 * only exists while a server context is running. Client contexts on
+	 * Windows therefore look up host names directly without cache.
+	 */
+
+#if !defined(_WIN32)
+	XX_httplib_resolver_init( ctx );
+#endif  /* _WIN32 */
 
 	return ctx;
 
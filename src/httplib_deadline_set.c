@@ -0,0 +1,67 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_deadline_set( struct lh_con_t *conn, enum deadline_t kind, int timeout );
+ *
+ * The function XX_httplib_deadline_set() sets the deadline for the blocking
+ * reads of a connection. Header and keep-alive deadlines are absolute and
+ * expire timeout milliseconds from now, body and websocket deadlines are idle
+ * deadlines which give every read timeout milliseconds to receive data. A
+ * timeout of zero or less removes the deadline, but the kind is remembered.
+ */
+
+void XX_httplib_deadline_set( struct lh_con_t *conn, enum deadline_t kind, int timeout ) {
+
+	if ( conn == NULL ) return;
+
+	conn->deadline.kind    = kind;
+	conn->deadline.expires = 0;
+	conn->deadline.idle    = 0;
+	conn->deadline.expired = false;
+
+	if ( timeout <= 0 ) return;
+
+	switch ( kind ) {
+
+		case DEADLINE_HEADER     :
+		case DEADLINE_KEEP_ALIVE :
+
+			conn->deadline.expires = XX_httplib_monotonic_msec() + timeout;
+			break;
+
+		case DEADLINE_BODY      :
+		case DEADLINE_WEBSOCKET :
+
+			conn->deadline.idle = timeout;
+			break;
+
+		default :
+			break;
+	}
+
+}  /* XX_httplib_deadline_set */
@@ -0,0 +1,90 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int XX_httplib_deadline_wait( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_deadline_wait() waits until data can be read from
+ * the socket of a connection, or until the deadline of the connection has
+ * expired. This is done with one call to poll() with the time left until
+ * the deadline, so that no receive timeouts on the socket and no retry loops
+ * are needed. The clock is only read for absolute deadlines. A connection
+ * without a deadline waits until data arrives.
+ *
+ * The function returns 1 if the socket is readable, 0 if the deadline has
+ * expired and -1 if an error occured. Expired deadlines are counted per kind
+ * in the context. The connection is closed after the request, and later reads
+ * return immediately until a new deadline is set.
+ */
+
+int XX_httplib_deadline_wait( const struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	struct pollfd pfd;
+	int64_t left;
+	int wait;
+	int n;
+	union {
+		const volatile int *	con;
+		volatile int *		var;
+	} ptr;
+
+	if ( ctx == NULL  ||  conn == NULL ) return -1;
+	if ( conn->deadline.expired        ) return 0;
+
+	pfd.fd     = conn->client.sock;
+	pfd.events = POLLIN;
+
+	do {
+		if ( conn->deadline.expires > 0 ) {
+
+			left = conn->deadline.expires - XX_httplib_monotonic_msec();
+
+			if      ( left <= 0       ) wait = 0;
+			else if ( left >  INT_MAX ) wait = INT_MAX;
+			else                        wait = (int)left;
+		}
+
+		else if ( conn->deadline.idle > 0 ) wait = conn->deadline.idle;
+		else                                wait = -1;
+
+		pfd.revents = 0;
+		n           = httplib_poll( & pfd, 1, wait );
+
+	} while ( n < 0  &&  ERRNO == EINTR  &&  ctx->status == CTX_STATUS_RUNNING );
+
+	if ( n > 0 ) return 1;
+	if ( n < 0 ) return -1;
+
+	ptr.con = & ctx->num_timeouts[conn->deadline.kind];
+	httplib_atomic_inc( ptr.var );
+
+	conn->deadline.expired = true;
+	conn->must_close       = true;
+
+	return 0;
+
+}  /* XX_httplib_deadline_wait */
@@ -21,6 +21,7 @@
  */
 
 #include "httplib_main.h"
+#include "httplib_ssl.h"
 
 /*
  * void httplib_destroy_client_context( struct lh_ctx_t *ctx );
@@ -36,6 +37,12 @@ void httplib_destroy_client_context( struct lh_ctx_t *ctx ) {
 
 	if ( ctx->callbacks.exit_context != NULL ) ctx->callbacks.exit_context( ctx );
 
+	XX_httplib_client_pool_free(    ctx );
+#if !defined(NO_SSL)
+	XX_httplib_client_ssl_free(     ctx );
+#endif  /* NO_SSL */
+	XX_httplib_buffer_pool_free(    ctx );
+	XX_httplib_resolver_free(       ctx );
 	XX_httplib_free_config_options( ctx );
 
 	ctx->workerthreadids = httplib_free( ctx->workerthreadids );
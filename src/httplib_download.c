@@ -32,30 +32,51 @@
  *
  * The function httplib_download() is used to download a file from a remote location
  * and returns a pointer to the connection on success, or NULL on error.
+ *
+ * When a connection from the connection pool of the context turns out to be
+ * closed by the server before it sent any part of the response, the request
+ * is sent again over a new connection. This is safe because the server did
+ * not process the request on the stale connection.
  */
 
 struct lh_con_t *httplib_download( struct lh_ctx_t *ctx, const char *host, int port, int use_ssl, const char *fmt, ... ) {
 
 	struct lh_con_t *conn;
 	va_list ap;
+	va_list aq;
 	int i;
 	int reqerr;
+	bool reused;
+	bool ok;
 
 	if ( ctx == NULL ) return NULL;
 
 	va_start( ap, fmt );
 
-	conn = httplib_connect_client( ctx, host, port, use_ssl );
+	do {
+		ok   = false;
+		conn = httplib_connect_client( ctx, host, port, use_ssl );
 
-	if ( conn != NULL ) {
+		if ( conn == NULL ) break;
 
-		i = XX_httplib_vprintf( ctx, conn, fmt, ap );
+		reused = conn->pool_reused;
 
-		if ( i <= 0 ) httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: error sending request", __func__ );
-		
-		else {
-			XX_httplib_getreq( ctx, conn, &reqerr );
+		va_copy( aq, ap );
+		i = XX_httplib_vprintf( ctx, conn, fmt, aq );
+		va_end( aq );
+
+		if ( i > 0 ) ok = XX_httplib_getreq( ctx, conn, &reqerr );
+
+		if ( ! ok  &&  reused  &&  conn->data_len == 0 ) {
+
+			XX_httplib_free_client_connection( ctx, conn );
+			continue;
+		}
+
+		if      ( i <= 0 ) httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: error sending request",   __func__ );
+		else if ( ! ok   ) httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: error reading response", __func__ );
 
+		else {
 			/*
 			 * TODO: 1) uri is deprecated;
 			 *       2) here, ri.uri is the http response code
@@ -63,17 +84,18 @@ struct lh_con_t *httplib_download( struct lh_ctx_t *ctx, const char *host, int p
 
 			conn->request_info.uri = conn->request_info.request_uri;
 		}
-	}
 
-	else i = 0;
+		break;
+
+	} while ( true );
 
 	/*
 	 * if an error occured, close the connection
 	 */
 
-	if ( i <= 0  &&  conn != NULL ) {
+	if ( ! ok  &&  conn != NULL ) {
 
-		httplib_close_connection( ctx, conn );
+		XX_httplib_free_client_connection( ctx, conn );
 		conn = NULL;
 	}
 
@@ -0,0 +1,91 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_end_chunked( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *trailers );
+ *
+ * The function httplib_end_chunked() finishes a response which was started
+ * with httplib_start_chunked_response(). The data which is still buffered is
+ * sent, followed by the last chunk. Trailer fields can be sent after the last
+ * chunk with the trailers parameter, which must be either NULL or a string
+ * with one or more CRLF terminated header lines. Trailers are silently
+ * dropped for HTTP/1.0 clients.
+ *
+ * The function returns 0 when successful and -1 if an error occured.
+ */
+
+int httplib_end_chunked( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *trailers ) {
+
+	struct lh_chk_t *chk;
+	size_t tlen;
+	bool ok;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->chunk_out == NULL ) return -1;
+
+	chk             = conn->chunk_out;
+	conn->chunk_out = NULL;
+	tlen            = ( trailers != NULL ) ? strlen( trailers ) : 0;
+
+	if      ( chk->error   ) ok = false;
+	else if ( chk->no_body ) ok = true;
+
+	else if ( ! chk->framing ) ok = ( chk->len == 0  ||  XX_httplib_write_raw( ctx, conn, chk->buf + CHUNK_HDR_LEN, chk->len ) == (int)chk->len );
+
+	else if ( tlen == 0 ) ok = XX_httplib_send_chunk( ctx, conn, chk->buf + CHUNK_HDR_LEN, chk->len, true );
+
+	else {
+		/*
+		 * The trailers replace the empty line after the last chunk. The
+		 * buffered data is sent first, after which the buffer is reused
+		 * for the last chunk and the trailers if they fit.
+		 */
+
+		ok = XX_httplib_send_chunk( ctx, conn, chk->buf + CHUNK_HDR_LEN, chk->len, false );
+
+		if ( ok ) {
+
+			if ( tlen + 5 <= sizeof(chk->buf) ) {
+
+				memcpy( chk->buf,          "0\r\n",  3    );
+				memcpy( chk->buf + 3,      trailers, tlen );
+				memcpy( chk->buf + 3+tlen, "\r\n",   2    );
+
+				ok = ( XX_httplib_write_raw( ctx, conn, chk->buf, tlen+5 ) == (int)(tlen+5) );
+			}
+
+			else ok = ( XX_httplib_write_raw( ctx, conn, "0\r\n", 3 ) == 3  &&  XX_httplib_write_raw( ctx, conn, trailers, tlen ) == (int)tlen  &&  XX_httplib_write_raw( ctx, conn, "\r\n", 2 ) == 2 );
+		}
+	}
+
+	if ( ! ok ) conn->must_close = true;
+
+	httplib_free( chk );
+
+	return (ok) ? 0 : -1;
+
+}  /* httplib_end_chunked */
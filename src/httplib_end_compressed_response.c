@@ -0,0 +1,81 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_end_compressed_response( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function httplib_end_compressed_response() finishes a response which was
+ * started with httplib_start_compressed_response(). Data still held by the
+ * compressor is sent, followed by the last chunk of the chunked transfer
+ * encoding. If less than compression_min_size bytes were written to the
+ * response, it is sent uncompressed with a Content-Length header instead.
+ * After the call the connection is back in its normal state.
+ *
+ * The function returns 0 when successful and -1 if an error occured.
+ */
+
+int httplib_end_compressed_response( const struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	struct lh_cmp_t *cmp;
+	bool ok;
+	int len;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->compress == NULL ) return -1;
+
+	cmp = conn->compress;
+
+	if ( cmp->error ) ok = false;
+
+	else if ( cmp->headers_sent ) ok = XX_httplib_compress_send( ctx, conn, NULL, 0, true );
+
+	else {
+		/*
+		 * The whole body is available in the pending buffer and too
+		 * small to be compressed. The headers can therefore contain its
+		 * exact length and the connection may be kept alive.
+		 */
+
+		len = snprintf( cmp->headers + cmp->headers_len, 96, "Content-Length: %lu\r\n\r\n", (unsigned long)cmp->pending_len );
+		ok  = ( len > 0  &&  len < 96 );
+
+		if ( ok ) {
+
+			cmp->headers_len += (size_t)len;
+			ok                = ( XX_httplib_write_raw( ctx, conn, cmp->headers, cmp->headers_len ) == (int)cmp->headers_len );
+		}
+
+		if ( ok  &&  cmp->pending_len > 0 ) ok = ( XX_httplib_write_raw( ctx, conn, cmp->pending, cmp->pending_len ) == (int)cmp->pending_len );
+	}
+
+	if ( ! ok ) conn->must_close = true;
+
+	XX_httplib_compress_free( conn );
+
+	return (ok) ? 0 : -1;
+
+}  /* httplib_end_compressed_response */
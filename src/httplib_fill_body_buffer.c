@@ -0,0 +1,73 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_fill_body_buffer( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_fill_body_buffer() is called when all body data in
+ * the connection buffer has been processed. The body part of the buffer after
+ * the request headers is reset and as much data as the socket delivers with
+ * one receive call is read into it. The request headers in front of the body
+ * are left untouched because the request info points into them.
+ *
+ * The body bytes are counted in consumed_content relative to the start of the
+ * body part of the buffer. Resetting the buffer therefore also shifts
+ * content_len, so that content_len - consumed_content remains the number of
+ * bytes still to be read for a body with a known length. For a body with a
+ * known length no data beyond the end of the body is read, because that data
+ * belongs to the next request on the connection. A body without a length
+ * which ends when the connection is closed is marked with a content_len of
+ * INT64_MAX which is not shifted.
+ *
+ * The function returns false if no data could be read.
+ */
+
+bool XX_httplib_fill_body_buffer( const struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	int64_t room;
+	int n;
+
+	if ( ctx == NULL  ||  conn == NULL ) return false;
+
+	if ( conn->content_len != INT64_MAX ) conn->content_len -= conn->consumed_content;
+
+	conn->consumed_content  = 0;
+	conn->data_len          = conn->request_len;
+
+	room = conn->buf_size - conn->data_len;
+	if ( ! conn->is_chunked  &&  room > conn->content_len ) room = conn->content_len;
+	if ( room <= 0 ) return false;
+
+	n = XX_httplib_pull( ctx, NULL, conn, conn->buf + conn->data_len, (int)room );
+	if ( n <= 0 ) return false;
+
+	conn->data_len += n;
+
+	return true;
+
+}  /* XX_httplib_fill_body_buffer */
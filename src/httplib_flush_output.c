@@ -0,0 +1,76 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int64_t XX_httplib_flush_output( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len );
+ *
+ * The function XX_httplib_flush_output() sends the responses which were held
+ * back on a connection, followed by an optional block of data, with one
+ * call. On plain connections this is one writev(). The function returns the
+ * number of bytes of the block which were sent, or -1 if the held back data
+ * couldn't be sent completely, in which case the connection must be closed.
+ */
+
+int64_t XX_httplib_flush_output( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len ) {
+
+	struct lh_out_t out[2];
+	int64_t held;
+	int64_t n;
+
+	if ( ctx == NULL  ||  conn == NULL ) return -1;
+
+	if ( buf == NULL ) len = 0;
+
+	held          = (int64_t)conn->out_len;
+	conn->out_len = 0;
+
+	if ( held == 0 ) return ( len > 0 ) ? XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, buf, (int64_t)len ) : 0;
+
+	if ( conn->ssl == NULL ) {
+
+		out[0].base = conn->out_buf;
+		out[0].len  = (size_t)held;
+		out[1].base = buf;
+		out[1].len  = len;
+
+		n = XX_httplib_sendv( ctx, conn->client.sock, out, ( len > 0 ) ? 2 : 1, true );
+	}
+
+	else {
+		n = XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, conn->out_buf, held );
+		if ( n == held  &&  len > 0 ) n += XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, buf, (int64_t)len );
+	}
+
+	if ( n < held ) {
+
+		conn->must_close = true;
+		return -1;
+	}
+
+	return n - held;
+
+}  /* XX_httplib_flush_output */
@@ -0,0 +1,57 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_form_boundary_init( struct lh_fbd_t *fb, const char *boundary, size_t len );
+ *
+ * The function XX_httplib_form_boundary_init() prepares the search for the
+ * delimiter between the parts of a multipart body with the boundary of len
+ * bytes. The delimiter consists of a CRLF, two dashes and the boundary. For
+ * every byte value the skip table gets the distance between the last
+ * occurence of that byte in the delimiter, not counting the last position,
+ * and the end of the delimiter. Bytes which don't occur get the full length.
+ *
+ * The function returns false if the boundary is empty or too long.
+ */
+
+bool XX_httplib_form_boundary_init( struct lh_fbd_t *fb, const char *boundary, size_t len ) {
+
+	size_t a;
+
+	if ( fb == NULL  ||  boundary == NULL  ||  len == 0  ||  len + 4 > FORM_DELIM_LEN ) return false;
+
+	memcpy( fb->delim,     "\r\n--",  4   );
+	memcpy( fb->delim + 4, boundary,  len );
+	fb->len = len + 4;
+
+	for (a=0; a<256; a++) fb->skip[a] = fb->len;
+	for (a=0; a<fb->len-1; a++) fb->skip[(unsigned char)fb->delim[a]] = fb->len - 1 - a;
+
+	return true;
+
+}  /* XX_httplib_form_boundary_init */
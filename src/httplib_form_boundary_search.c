@@ -0,0 +1,119 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * const char *XX_httplib_form_boundary_search( const struct lh_fbd_t *fb, const char *buf, size_t len, size_t *safe );
+ *
+ * The function XX_httplib_form_boundary_search() searches a block of len
+ * bytes of a multipart body for the delimiter prepared with
+ * XX_httplib_form_boundary_init(). The block may contain binary data.
+ *
+ * Each delimiter starts with a CR. Candidate positions are therefore found
+ * with memchr() which is vectorized by the C library, so that runs of binary
+ * data without a CR are passed at memory speed. At a candidate position the
+ * last byte of the window is checked first. If it doesn't match, the skip
+ * table tells how far the window can be moved before the next CR must be
+ * searched. The full delimiter is only compared when the last byte matches.
+ *
+ * When no complete delimiter is found, the end of the block is checked for
+ * the start of a delimiter which continues in the next block. The number of
+ * bytes before such a partial delimiter, or before the delimiter which was
+ * found, is returned in safe. These bytes belong to the current part and
+ * never have to be searched again. The function returns a pointer to the
+ * delimiter, or NULL if the block doesn't contain a complete delimiter.
+ */
+
+const char *XX_httplib_form_boundary_search( const struct lh_fbd_t *fb, const char *buf, size_t len, size_t *safe ) {
+
+	const char *ptr;
+	const char *end;
+	const char *last;
+	unsigned char c;
+	size_t m;
+
+	if ( safe != NULL ) *safe = 0;
+	if ( fb == NULL  ||  buf == NULL  ||  safe == NULL ) return NULL;
+
+	m   = fb->len;
+	ptr = buf;
+	end = buf + len;
+
+	if ( len >= m ) {
+
+		/*
+		 * last is the last position where a complete delimiter can start
+		 */
+
+		last = end - m;
+
+		while ( ptr <= last ) {
+
+			ptr = memchr( ptr, '\r', (size_t)(last - ptr) + 1 );
+			if ( ptr == NULL ) break;
+
+			c = (unsigned char)ptr[m-1];
+
+			if ( c == (unsigned char)fb->delim[m-1]  &&  memcmp( ptr, fb->delim, m-1 ) == 0 ) {
+
+				*safe = (size_t)(ptr - buf);
+				return ptr;
+			}
+
+			ptr += fb->skip[c];
+		}
+
+		/*
+		 * Positions which were passed with the skip table can't be the
+		 * start of a partial delimiter either.
+		 */
+
+		if ( ptr == NULL ) ptr = last + 1;
+	}
+
+	/*
+	 * Check the tail of the block for the start of a delimiter
+	 */
+
+	while ( ptr < end ) {
+
+		ptr = memchr( ptr, '\r', (size_t)(end - ptr) );
+		if ( ptr == NULL ) break;
+
+		if ( memcmp( ptr, fb->delim, (size_t)(end - ptr) ) == 0 ) {
+
+			*safe = (size_t)(ptr - buf);
+			return NULL;
+		}
+
+		ptr++;
+	}
+
+	*safe = len;
+	return NULL;
+
+}  /* XX_httplib_form_boundary_search */
@@ -32,23 +32,25 @@
  *
  * The function XX_httplib_forward_body_data() forwards body data to the
  * client. The function returns true if successful, and false otherwise.
+ *
+ * The data is sent directly from the connection buffer, without copying it
+ * to an intermediate buffer first. Bodies which are received with chunked
+ * transfer encoding are forwarded decoded. Data for a file is written with
+ * XX_httplib_receive_body() which can move it from the socket to the file
+ * without passing user space.
  */
 
 bool XX_httplib_forward_body_data( struct lh_ctx_t *ctx, struct lh_con_t *conn, FILE *fp, SOCKET sock, SSL *ssl ) {
 
 	const char *expect;
-	const char *body;
-	char buf[MG_BUF_LEN];
-	int to_read;
-	int nread;
+	const char *data;
+	size_t data_len;
+	int retval;
 	bool success;
-	int64_t buffered_len;
-	double timeout;
 
 	if ( ctx == NULL  ||  conn == NULL ) return false;
 
 	success = false;
-	timeout = ((double)ctx->request_timeout) / 1000.0;
 	expect  = httplib_get_header( conn, "Expect" );
 
 	if ( fp == NULL ) {
@@ -86,37 +88,24 @@ bool XX_httplib_forward_body_data( struct lh_ctx_t *ctx, struct lh_con_t *conn,
 		
 		else conn->status_code = 200;
 
-		buffered_len = (int64_t)(conn->data_len) - (int64_t)conn->request_len - conn->consumed_content;
-
-		if ( buffered_len < 0  ||  conn->consumed_content != 0 ) {
+		if ( conn->consumed_content != 0 ) {
 
 			XX_httplib_send_http_error( ctx, conn, 500, "%s", "Error: Size mismatch" );
 			return false;
 		}
 
-		if ( buffered_len > 0 ) {
+		if ( sock == INVALID_SOCKET  &&  ssl == NULL ) success = ( XX_httplib_receive_body( ctx, conn, fp ) >= 0 );
 
-			if ((int64_t)buffered_len > conn->content_len) buffered_len = (int)conn->content_len;
-
-			body = conn->buf + conn->request_len + conn->consumed_content;
-			XX_httplib_push_all( ctx, fp, sock, ssl, body, (int64_t)buffered_len );
-			conn->consumed_content += buffered_len;
-		}
+		else {
+			while ( (retval = httplib_peek_body( ctx, conn, & data, & data_len )) > 0 ) {
 
-		nread = 0;
+				if ( XX_httplib_push_all( ctx, fp, sock, ssl, data, (int64_t)data_len ) != (int64_t)data_len ) break;
+				httplib_consume_body( ctx, conn, data_len );
+			}
 
-		while ( conn->consumed_content < conn->content_len ) {
-
-			to_read = sizeof(buf);
-			if ( (int64_t)to_read > conn->content_len - conn->consumed_content ) to_read = (int)(conn->content_len - conn->consumed_content);
-
-			nread = XX_httplib_pull( ctx, NULL, conn, buf, to_read, timeout );
-			if ( nread <= 0  ||  XX_httplib_push_all( ctx, fp, sock, ssl, buf, nread ) != nread ) break;
-			conn->consumed_content += nread;
+			success = ( retval == 0 );
 		}
 
-		if ( conn->consumed_content == conn->content_len ) success = (nread >= 0);
-
 		/*
 		 * Each error code path in this function must send an error
 		 */
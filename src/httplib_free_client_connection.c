@@ -0,0 +1,57 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+#include "httplib_pthread.h"
+#include "httplib_ssl.h"
+
+/*
+ * void XX_httplib_free_client_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_free_client_connection() closes a connection which
+ * was opened as a client and frees all memory associated with it.
+ */
+
+void XX_httplib_free_client_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	if ( ctx == NULL  ||  conn == NULL ) return;
+
+	XX_httplib_close_connection( ctx, conn );
+
+#ifndef NO_SSL
+	if ( conn->client_ssl_ctx != NULL ) {
+
+		SSL_CTX_free( conn->client_ssl_ctx );
+		conn->client_ssl_ctx = NULL;
+	}
+#endif  /* NO_SSL */
+
+	httplib_pthread_mutex_destroy( & conn->mutex );
+	XX_httplib_buffer_release( ctx, conn );
+
+	conn->pool_host = httplib_free( conn->pool_host );
+	conn            = httplib_free( conn            );
+
+}  /* XX_httplib_free_client_connection */
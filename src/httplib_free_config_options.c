@@ -45,6 +45,7 @@ void XX_httplib_free_config_options( struct lh_ctx_t *ctx ) {
 	ctx->extra_mime_types            = httplib_free( ctx->extra_mime_types            );
 	ctx->global_auth_file            = httplib_free( ctx->global_auth_file            );
 	ctx->hide_file_pattern           = httplib_free( ctx->hide_file_pattern           );
+	ctx->hosts_file                  = httplib_free( ctx->hosts_file                  );
 	ctx->index_files                 = httplib_free( ctx->index_files                 );
 	ctx->listening_ports             = httplib_free( ctx->listening_ports             );
 	ctx->protect_uri                 = httplib_free( ctx->protect_uri                 );
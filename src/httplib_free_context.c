@@ -40,6 +40,8 @@
 void XX_httplib_free_context( struct lh_ctx_t *ctx ) {
 
 	struct httplib_handler_info *tmp_rh;
+	struct lh_wsz_t *zs;
+	int i;
 
 	if ( ctx == NULL ) return;
 
@@ -69,10 +71,59 @@ void XX_httplib_free_context( struct lh_ctx_t *ctx ) {
 	 */
 
 	httplib_pthread_mutex_destroy( & ctx->nonce_mutex );
+	httplib_pthread_mutex_destroy( & ctx->encoding_cache_mutex );
 
-#if defined(USE_TIMERS)
-	timers_exit( ctx );
-#endif
+	/*
+	 * Destroy the idle zlib streams of permessage-deflate websockets
+	 */
+
+	while ( ctx->ws_zstream_pool.streams != NULL ) {
+
+		zs                           = ctx->ws_zstream_pool.streams;
+		ctx->ws_zstream_pool.streams = zs->next;
+		ctx->ws_zstream_pool.len--;
+
+		XX_httplib_websocket_zstream_put( NULL, zs );
+	}
+
+	httplib_pthread_mutex_destroy( & ctx->ws_zstream_pool.mutex );
+	httplib_pthread_mutex_destroy( & ctx->ws_keepalive.mutex    );
+
+	/*
+	 * Free the idle receive buffers of connections
+	 */
+
+	XX_httplib_buffer_pool_free( ctx );
+
+	/*
+	 * Close the event queue of the websocket reactor
+	 */
+
+	if ( ctx->ws_reactor_buf != NULL ) {
+
+		ctx->ws_reactor_buf = httplib_free( ctx->ws_reactor_buf );
+#if defined(USE_WEBSOCKET_REACTOR)
+		if ( ctx->ws_epoll_fd >= 0 ) close( ctx->ws_epoll_fd );
+#endif  /* USE_WEBSOCKET_REACTOR */
+	}
+
+	/*
+	 * Stop the timer service and release its timers
+	 */
+
+	if ( ctx->timers.initialized ) {
+
+		XX_httplib_timer_stop( ctx );
+
+		ctx->timers.slots       = httplib_free( ctx->timers.slots );
+		ctx->timers.heap        = httplib_free( ctx->timers.heap  );
+		ctx->timers.initialized = false;
+
+		httplib_pthread_cond_destroy(  & ctx->timers.cond  );
+		httplib_pthread_mutex_destroy( & ctx->timers.mutex );
+	}
+
+	XX_httplib_resolver_free( ctx );
 
 	XX_httplib_free_config_options( ctx );
 
@@ -103,6 +154,16 @@ void XX_httplib_free_context( struct lh_ctx_t *ctx ) {
 
 #endif /* !NO_SSL */
 
+	/*
+	 * Deallocate the cache with precompressed static file information
+	 */
+
+	if ( ctx->encoding_cache != NULL ) {
+
+		for (i=0; i<ENCODING_CACHE_SIZE; i++) ctx->encoding_cache[i].path = httplib_free( ctx->encoding_cache[i].path );
+		ctx->encoding_cache = httplib_free( ctx->encoding_cache );
+	}
+
 	/*
 	 * Deallocate worker thread ID array
 	 */
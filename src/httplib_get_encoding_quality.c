@@ -0,0 +1,142 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static int		parse_quality( const char *ptr );
+
+/*
+ * int XX_httplib_get_encoding_quality( const char *accept_encoding, const char *coding );
+ *
+ * The function XX_httplib_get_encoding_quality() returns how much a client
+ * prefers a content coding based on the value of the Accept-Encoding header
+ * of the request, as described in RFC 7231 section 5.3.4. The quality is
+ * returned in thousandths in the range 0..1000. A value of 0 means that the
+ * client does not accept the coding.
+ *
+ * Codings which are not mentioned in the header get the quality of the "*"
+ * entry if present. Without such an entry only the identity coding is
+ * acceptable, with the lowest possible quality so that every coding which
+ * the client asked for explicitly is preferred. If the client did not send
+ * an Accept-Encoding header at all, only the identity coding is used.
+ */
+
+int XX_httplib_get_encoding_quality( const char *accept_encoding, const char *coding ) {
+
+	const char *ptr;
+	const char *name;
+	size_t name_len;
+	size_t coding_len;
+	int quality;
+	int match_quality;
+	int star_quality;
+	bool is_identity;
+
+	if ( coding == NULL ) return 0;
+
+	is_identity = ( httplib_strcasecmp( coding, "identity" ) == 0 );
+
+	if ( accept_encoding == NULL ) return ( is_identity ) ? 1000 : 0;
+
+	coding_len    = strlen( coding );
+	match_quality = -1;
+	star_quality  = -1;
+	ptr           = accept_encoding;
+
+	while ( *ptr != '\0' ) {
+
+		while ( *ptr == ' '  ||  *ptr == '\t'  ||  *ptr == ',' ) ptr++;
+		if ( *ptr == '\0' ) break;
+
+		name = ptr;
+		while ( *ptr != '\0'  &&  *ptr != ','  &&  *ptr != ';'  &&  *ptr != ' '  &&  *ptr != '\t' ) ptr++;
+		name_len = (size_t)(ptr - name);
+		quality  = 1000;
+
+		/*
+		 * Walk the parameters of this entry. Only the q parameter has a
+		 * meaning for content codings, other parameters are ignored.
+		 */
+
+		while ( *ptr != '\0'  &&  *ptr != ',' ) {
+
+			if ( *ptr == ';' ) {
+
+				ptr++;
+				while ( *ptr == ' '  ||  *ptr == '\t' ) ptr++;
+
+				if ( ( *ptr == 'q'  ||  *ptr == 'Q' )  &&  ptr[1] == '=' ) quality = parse_quality( ptr+2 );
+			}
+
+			else ptr++;
+		}
+
+		if      ( name_len == 1  &&  *name == '*' ) star_quality = quality;
+		else if ( name_len == coding_len  &&  ! httplib_strncasecmp( name, coding, name_len ) ) match_quality = quality;
+		else if ( name_len == 6  &&  ! httplib_strncasecmp( name, "x-gzip", 6 )  &&  ! httplib_strcasecmp( coding, "gzip" ) ) match_quality = quality;
+	}
+
+	if ( match_quality >= 0 ) return match_quality;
+	if ( star_quality  >= 0 ) return star_quality;
+
+	return ( is_identity ) ? 1 : 0;
+
+}  /* XX_httplib_get_encoding_quality */
+
+
+
+/*
+ * static int parse_quality( const char *ptr );
+ *
+ * The function parse_quality() converts a qvalue in the format "0", "0.5" or
+ * "1.000" to an integer in thousandths. Malformed values are interpreted as
+ * a quality of 0 which makes the coding unacceptable.
+ */
+
+static int parse_quality( const char *ptr ) {
+
+	int quality;
+	int scale;
+
+	if ( *ptr == '1' ) return 1000;
+	if ( *ptr != '0' ) return 0;
+
+	ptr++;
+	if ( *ptr != '.' ) return 0;
+
+	ptr++;
+	quality = 0;
+	scale   = 100;
+
+	while ( scale > 0  &&  isdigit( *ptr ) ) {
+
+		quality += scale * (*ptr - '0');
+		scale   /= 10;
+		ptr++;
+	}
+
+	return quality;
+
+}  /* parse_quality */
@@ -49,21 +49,39 @@ const char *httplib_get_option( const struct lh_ctx_t *ctx, const char *name, ch
 	if ( ! httplib_strcasecmp( name, "cgi_environment"             ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->cgi_environment             );
 	if ( ! httplib_strcasecmp( name, "cgi_interpreter"             ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->cgi_interpreter             );
 	if ( ! httplib_strcasecmp( name, "cgi_pattern"                 ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->cgi_pattern                 );
+	if ( ! httplib_strcasecmp( name, "client_pipeline_depth"       ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->client_pipeline_depth       );
+	if ( ! httplib_strcasecmp( name, "client_pool_idle_timeout"    ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->client_pool_idle_timeout    );
+	if ( ! httplib_strcasecmp( name, "client_pool_max_idle"        ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->client_pool_max_idle        );
+	if ( ! httplib_strcasecmp( name, "client_pool_max_per_host"    ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->client_pool_max_per_host    );
+	if ( ! httplib_strcasecmp( name, "compression_level"           ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->compression_level           );
+	if ( ! httplib_strcasecmp( name, "compression_min_size"        ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->compression_min_size        );
+	if ( ! httplib_strcasecmp( name, "connect_timeout"             ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->connect_timeout             );
 	if ( ! httplib_strcasecmp( name, "decode_url"                  ) ) return (ctx == NULL) ? buffer : store_bool( buffer, buflen, ctx->decode_url                  );
 	if ( ! httplib_strcasecmp( name, "document_root"               ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->document_root               );
 	if ( ! httplib_strcasecmp( name, "enable_directory_listing"    ) ) return (ctx == NULL) ? buffer : store_bool( buffer, buflen, ctx->enable_directory_listing    );
 	if ( ! httplib_strcasecmp( name, "enable_keep_alive"           ) ) return (ctx == NULL) ? buffer : store_bool( buffer, buflen, ctx->enable_keep_alive           );
+	if ( ! httplib_strcasecmp( name, "enable_websocket_compression") ) return (ctx == NULL) ? buffer : store_bool( buffer, buflen, ctx->enable_websocket_compression);
+	if ( ! httplib_strcasecmp( name, "enable_websocket_reactor"    ) ) return (ctx == NULL) ? buffer : store_bool( buffer, buflen, ctx->enable_websocket_reactor    );
+	if ( ! httplib_strcasecmp( name, "encoding_cache_ttl"          ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->encoding_cache_ttl          );
 	if ( ! httplib_strcasecmp( name, "error_log_file"              ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->error_log_file              );
 	if ( ! httplib_strcasecmp( name, "error_pages"                 ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->error_pages                 );
 	if ( ! httplib_strcasecmp( name, "extra_mime_types"            ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->extra_mime_types            );
 	if ( ! httplib_strcasecmp( name, "global_auth_file"            ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->global_auth_file            );
 	if ( ! httplib_strcasecmp( name, "hide_file_pattern"           ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->hide_file_pattern           );
+	if ( ! httplib_strcasecmp( name, "hosts_file"                  ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->hosts_file                  );
 	if ( ! httplib_strcasecmp( name, "index_files"                 ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->index_files                 );
+	if ( ! httplib_strcasecmp( name, "keep_alive_timeout"          ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->keep_alive_timeout          );
 	if ( ! httplib_strcasecmp( name, "listening_ports"             ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->listening_ports             );
+	if ( ! httplib_strcasecmp( name, "max_request_size"            ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->max_request_size            );
 	if ( ! httplib_strcasecmp( name, "num_threads"                 ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->num_threads                 );
 	if ( ! httplib_strcasecmp( name, "protect_uri"                 ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->protect_uri                 );
 	if ( ! httplib_strcasecmp( name, "put_delete_auth_file"        ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->put_delete_auth_file        );
+	if ( ! httplib_strcasecmp( name, "request_buffer_size"         ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->request_buffer_size         );
 	if ( ! httplib_strcasecmp( name, "request_timeout"             ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->request_timeout             );
+	if ( ! httplib_strcasecmp( name, "resolver_cache_ttl"          ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->resolver_cache_ttl          );
+	if ( ! httplib_strcasecmp( name, "resolver_negative_ttl"       ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->resolver_negative_ttl       );
+	if ( ! httplib_strcasecmp( name, "resolver_threads"            ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->resolver_threads            );
+	if ( ! httplib_strcasecmp( name, "resolver_timeout"            ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->resolver_timeout            );
 	if ( ! httplib_strcasecmp( name, "run_as_user"                 ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->run_as_user                 );
 	if ( ! httplib_strcasecmp( name, "ssi_include_depth"           ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->ssi_include_depth           );
 	if ( ! httplib_strcasecmp( name, "ssi_pattern"                 ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->ssi_pattern                 );
@@ -81,6 +99,12 @@ const char *httplib_get_option( const struct lh_ctx_t *ctx, const char *name, ch
 	if ( ! httplib_strcasecmp( name, "tcp_nodelay"                 ) ) return (ctx == NULL) ? buffer : store_bool( buffer, buflen, ctx->tcp_nodelay                 );
 	if ( ! httplib_strcasecmp( name, "url_rewrite_patterns"        ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->url_rewrite_patterns        );
 	if ( ! httplib_strcasecmp( name, "websocket_root"              ) ) return (ctx == NULL) ? buffer : store_str(  buffer, buflen, ctx->websocket_root              );
+	if ( ! httplib_strcasecmp( name, "websocket_max_message_size"  ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->websocket_max_message_size  );
+	if ( ! httplib_strcasecmp( name, "websocket_ping_interval"     ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->websocket_ping_interval     );
+	if ( ! httplib_strcasecmp( name, "websocket_pong_timeout"      ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->websocket_pong_timeout      );
+	if ( ! httplib_strcasecmp( name, "websocket_send_queue_drop"   ) ) return (ctx == NULL) ? buffer : store_bool( buffer, buflen, ctx->websocket_send_queue_drop   );
+	if ( ! httplib_strcasecmp( name, "websocket_send_queue_high"   ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->websocket_send_queue_high   );
+	if ( ! httplib_strcasecmp( name, "websocket_send_queue_low"    ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->websocket_send_queue_low    );
 	if ( ! httplib_strcasecmp( name, "websocket_timeout"           ) ) return (ctx == NULL) ? buffer : store_int(  buffer, buflen, ctx->websocket_timeout           );
 
 	return NULL;
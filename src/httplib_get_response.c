@@ -31,42 +31,68 @@
  * int httplib_get_response( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int timeout );
  *
  * The function httplib_get_response() tries to get a response from a remote
- * peer. This function does some dirty action by temporarily replacing the
- * context of the connection with a copy. The only thing which is changed in
- * the copy is the timeout value which is set according to the timeout as it
- * was passed as a parameter to the function call. After the call to the
- * function XX_httplib_getreq() has finished, the old context is put back in
- * place.
+ * peer. The timeout is stored in the connection, where it limits the time
+ * until the response header has arrived and afterwards the time every read
+ * of the body may wait for data. A negative timeout waits without limit.
+ *
+ * The previous response on the connection is removed from the buffer first,
+ * so that responses to requests which were pipelined with
+ * httplib_pipeline_send() can be read one after the other. The body of the
+ * previous response must have been read completely at that point.
  */
 
 int httplib_get_response( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int timeout ) {
 
 	int err;
 	int ret;
-	struct lh_ctx_t rctx;
+	int status;
+	bool no_body;
+	union {
+		const struct lh_ctx_t *	con;
+		struct lh_ctx_t *	var;
+	} ptr;
 
 	if ( ctx == NULL  ||  conn == NULL ) return -1;
 
+	conn->request_timeout = ( timeout >= 0 ) ? timeout : 0;
+
 	/*
-	 * Replace the connection context with a copy of it where the timeout
-	 * value is changed to a parameter passed value.
+	 * The response header must arrive within the timeout, and the body
+	 * may be read afterwards with the same timeout between two reads.
 	 */
 
-	rctx = *ctx;
+	XX_httplib_shift_message( conn );
+	XX_httplib_deadline_set( conn, DEADLINE_HEADER, conn->request_timeout );
 
-	if ( timeout >= 0 ) {
+	ptr.con = ctx;
+	ret     = XX_httplib_getreq( ptr.var, conn, &err );
 
-		rctx.request_timeout = timeout;
-		XX_httplib_set_sock_timeout( conn->client.sock, timeout );
-	}
-	
-	else rctx.request_timeout = 0;
+	XX_httplib_deadline_set( conn, DEADLINE_BODY, conn->request_timeout );
 
-	ret = XX_httplib_getreq( &rctx, conn, &err );
+	if ( ret ) {
 
-	/*
-	 * End of dirty context swap code.
-	 */
+		/*
+		 * Interim responses don't answer a pipelined request. Responses to
+		 * HEAD requests, interim responses and the status codes 204 and
+		 * 304 never have a body, whatever their headers say.
+		 */
+
+		status  = atoi( conn->request_info.request_uri );
+		no_body = false;
+
+		if ( conn->pipeline_pending > 0  &&  ( status >= 200  ||  status == 101 ) ) {
+
+			no_body                  = ( ( conn->pipeline_no_body & 1 ) != 0 );
+			conn->pipeline_no_body >>= 1;
+			conn->pipeline_pending--;
+		}
+
+		if ( no_body  ||  ( status >= 100  &&  status < 200 )  ||  status == 204  ||  status == 304 ) {
+
+			conn->content_len = 0;
+			conn->is_chunked  = 0;
+		}
+	}
 
 	/*
 	 * TODO: 1) uri is deprecated;
@@ -0,0 +1,48 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_get_timeout_stats( const struct lh_ctx_t *ctx, struct lh_tmo_t *stats );
+ *
+ * The function httplib_get_timeout_stats() copies the number of expired
+ * connection deadlines of a server context to a structure provided by the
+ * caller. Every kind of deadline is counted separately. The function returns
+ * 0 on success and -1 if an error occured.
+ */
+
+int httplib_get_timeout_stats( const struct lh_ctx_t *ctx, struct lh_tmo_t *stats ) {
+
+	if ( ctx == NULL  ||  stats == NULL  ||  ctx->ctx_type != CTX_TYPE_SERVER ) return -1;
+
+	stats->header_timeouts     = (uint64_t)ctx->num_timeouts[DEADLINE_HEADER    ];
+	stats->body_timeouts       = (uint64_t)ctx->num_timeouts[DEADLINE_BODY      ];
+	stats->keep_alive_timeouts = (uint64_t)ctx->num_timeouts[DEADLINE_KEEP_ALIVE];
+	stats->websocket_timeouts  = (uint64_t)ctx->num_timeouts[DEADLINE_WEBSOCKET ];
+
+	return 0;
+
+}  /* httplib_get_timeout_stats */
@@ -0,0 +1,59 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_get_websocket_stats( const struct lh_ctx_t *ctx, struct lh_wss_t *stats );
+ *
+ * The function httplib_get_websocket_stats() copies the counters of the
+ * websocket keepalive of a server context to a structure provided by the
+ * caller. The function returns 0 on success and -1 if an error occured.
+ */
+
+int httplib_get_websocket_stats( const struct lh_ctx_t *ctx, struct lh_wss_t *stats ) {
+
+	union {
+		const void *	con;
+		void *		var;
+	} ptr;
+	struct lh_wka_t *ka;
+
+	if ( ctx == NULL  ||  stats == NULL  ||  ctx->ctx_type != CTX_TYPE_SERVER ) return -1;
+
+	ptr.con = & ctx->ws_keepalive;
+	ka      = ptr.var;
+
+	httplib_pthread_mutex_lock( & ka->mutex );
+
+	stats->connections        = ka->num_conns;
+	stats->pings_sent         = ka->num_pings;
+	stats->connections_reaped = ka->num_reaped;
+
+	httplib_pthread_mutex_unlock( & ka->mutex );
+
+	return 0;
+
+}  /* httplib_get_websocket_stats */
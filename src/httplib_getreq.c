@@ -31,6 +31,10 @@
  * bool XX_httplib_getreq( struct lh_ctx_t *ctx, struct lh_con_t *conn, int *err );
  *
  * The function XX_httplib_getreq() processes a request from a remote client.
+ *
+ * The receive buffer of the connection is taken from the buffer pool when
+ * the first header is read, and grows while a header doesn't fit in it, up
+ * to the size set with the max_request_size option.
  */
 
 bool XX_httplib_getreq( struct lh_ctx_t *ctx, struct lh_con_t *conn, int *err ) {
@@ -59,8 +63,27 @@ bool XX_httplib_getreq( struct lh_ctx_t *ctx, struct lh_con_t *conn, int *err )
 
 	clock_gettime( CLOCK_MONOTONIC, &conn->req_time );
 
+	if ( conn->buf == NULL  &&  ! XX_httplib_buffer_grow( ctx, conn ) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: cannot allocate receive buffer, OOM", __func__ );
+		*err = 500;
+		return false;
+	}
+
+	/*
+	 * A message which is only partly in the buffer may need the whole
+	 * buffer. Complete messages are parsed where they are.
+	 */
+
+	if ( conn->buf_offset > 0  &&  XX_httplib_get_request_len( conn->buf, conn->data_len ) == 0 ) XX_httplib_buffer_compact( conn );
+
 	conn->request_len = XX_httplib_read_request( ctx, NULL, conn, conn->buf, conn->buf_size, &conn->data_len );
 
+	while ( conn->request_len == 0  &&  conn->data_len == conn->buf_size  &&  XX_httplib_buffer_grow( ctx, conn ) ) {
+
+		conn->request_len = XX_httplib_read_request( ctx, NULL, conn, conn->buf, conn->buf_size, &conn->data_len );
+	}
+
 	remote_ip = XX_httplib_get_remote_ip( conn );
 	snprintf( remote_ip_str, 16, "%d.%d.%d.%d", (remote_ip>>24), (remote_ip>>16)&0xff, (remote_ip>>8)&0xff, remote_ip&0xff );
 
@@ -140,7 +163,8 @@ bool XX_httplib_getreq( struct lh_ctx_t *ctx, struct lh_con_t *conn, int *err )
 		
 		else if ( (cl = XX_httplib_get_header( &conn->request_info, "Transfer-Encoding" )) != NULL  &&  ! httplib_strcasecmp( cl, "chunked" ) ) {
 
-			conn->is_chunked = 1;
+			conn->is_chunked  = 1;
+			conn->content_len = 0;
 		}
 		
 		else if ( ! httplib_strcasecmp( conn->request_info.request_method, "POST" )  ||  ! httplib_strcasecmp( conn->request_info.request_method, "PUT" ) ) {
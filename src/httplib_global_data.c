@@ -53,3 +53,39 @@ const struct uriprot_tp XX_httplib_abs_uri_protocols[] = {
 
 };  /* XX_httplib_abs_uri_protocols */
 
+
+/*
+ * File name extensions and Content-Encoding tokens of the precompressed
+ * siblings of static files, indexed by enum file_encoding_t.
+ */
+
+const char * const XX_httplib_encoding_ext[] = {
+
+	"",
+	".gz",
+	".br"
+
+};  /* XX_httplib_encoding_ext */
+
+const char * const XX_httplib_encoding_name[] = {
+
+	"identity",
+	"gzip",
+	"br"
+
+};  /* XX_httplib_encoding_name */
+
+
+/*
+ * Content-Encoding tokens of the codings which can be used to compress
+ * dynamically generated responses, indexed by enum compress_encoding_t.
+ */
+
+const char * const XX_httplib_compress_name[] = {
+
+	"identity",
+	"gzip",
+	"deflate",
+	"br"
+
+};  /* XX_httplib_compress_name */
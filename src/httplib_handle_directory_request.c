@@ -26,16 +26,13 @@
  */
 
 #include "httplib_main.h"
-#include "httplib_utils.h"
 
 void XX_httplib_handle_directory_request( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *dir ) {
 
 	unsigned int i;
 	int sort_direction;
 	struct dir_scan_data data = { NULL, 0, 128 };
-	char date[64];
 	char error_string[ERROR_STRING_LEN];
-	time_t curtime;
 
 	if ( ctx == NULL  ||  conn == NULL )                                                                                 return;
 	if ( dir  == NULL ) { XX_httplib_send_http_error( ctx, conn, 500, "Internal server error\nOpening NULL directory" ); return; }
@@ -46,16 +43,26 @@ void XX_httplib_handle_directory_request( struct lh_ctx_t *ctx, struct lh_con_t
 		return;
 	}
 
-	curtime = time( NULL );
-	XX_httplib_gmt_time_string( date, sizeof(date), &curtime );
-
 	sort_direction = ( conn->request_info.query_string != NULL  &&  conn->request_info.query_string[1] == 'd' ) ? 'a' : 'd';
 
-	conn->must_close = true;
+	/*
+	 * The size of the listing is not known in advance. It is therefore
+	 * sent with chunked transfer encoding which allows the connection to
+	 * stay alive after the response.
+	 */
+
+	if ( ! XX_httplib_start_chunked( ctx, conn, 200, "text/html; charset=utf-8", NULL, true ) ) {
+
+		XX_httplib_send_http_error( ctx, conn, 500, "%s", httplib_get_response_code_text( ctx, conn, 500 ) );
 
-	httplib_printf( ctx, conn, "HTTP/1.1 200 OK\r\n" );
-	XX_httplib_send_static_cache_header( ctx, conn );
-	httplib_printf( ctx, conn, "Date: %s\r\n" "Connection: close\r\n" "Content-Type: text/html; charset=utf-8\r\n\r\n", date );
+		if ( data.entries != NULL ) {
+
+			for (i=0; i<data.num_entries; i++) httplib_free( data.entries[i].file_name );
+			httplib_free( data.entries );
+		}
+
+		return;
+	}
 
 	conn->num_bytes_sent += httplib_printf( ctx, conn,
 	              "<html><head><title>Index of %s</title>"
@@ -102,6 +109,7 @@ void XX_httplib_handle_directory_request( struct lh_ctx_t *ctx, struct lh_con_t
 	}
 
 	conn->num_bytes_sent += httplib_printf( ctx, conn, "%s", "</table></body></html>" );
-	conn->status_code     = 200;
+
+	httplib_end_chunked( ctx, conn, NULL );
 
 }  /* XX_httplib_handle_directory_request */
@@ -68,11 +68,20 @@ void XX_httplib_handle_file_based_request( struct lh_ctx_t *ctx, struct lh_con_t
 		XX_httplib_handle_ssi_file_request( ctx, conn, path, file );
 	}
 	
-	else if ( ctx->static_file_max_age > 0  &&  ! conn->in_error_handler  &&  XX_httplib_is_not_modified( ctx, conn, file ) ) {
+	else {
+		/*
+		 * Static files may have precompressed siblings which are
+		 * preferred if the client accepts their encoding.
+		 */
+
+		XX_httplib_negotiate_encoding( ctx, conn, path, file, true );
 
-		XX_httplib_handle_not_modified_static_file_request( ctx, conn, file );
+		if ( ctx->static_file_max_age > 0  &&  ! conn->in_error_handler  &&  XX_httplib_is_not_modified( ctx, conn, file ) ) {
+
+			XX_httplib_handle_not_modified_static_file_request( ctx, conn, file );
+		}
+
+		else XX_httplib_handle_static_file_request( ctx, conn, path, file, NULL, NULL );
 	}
-	
-	else XX_httplib_handle_static_file_request( ctx, conn, path, file, NULL, NULL );
 
 }  /* XX_httplib_handle_file_based_request */
@@ -136,23 +136,301 @@ static int field_stored( const struct lh_con_t *conn, const char *path, int64_t
 }
 
 
-static const char * search_boundary(const char *buf, size_t buf_len, const char *boundary, size_t boundary_len) {
+/*
+ * static int form_fill( struct lh_ctx_t *ctx, struct lh_con_t *conn, char *buf, size_t *pos, size_t *fill );
+ *
+ * The function form_fill() moves the unprocessed data starting at pos to the
+ * front of the multipart buffer and appends as much new body data as one
+ * read returns. The buffer is kept NUL terminated for the header parser. The
+ * function returns the number of bytes read, 0 at the end of the body or if
+ * the buffer is full, and a negative value if an error occured.
+ */
 
-	/*
-	 * We must do a binary search here, not a string search, since the buffer
-	 * may contain '\x00' bytes, if binary data is transferred.
-	 */
+static int form_fill( struct lh_ctx_t *ctx, struct lh_con_t *conn, char *buf, size_t *pos, size_t *fill ) {
+
+	int r;
+
+	if ( *pos > 0 ) {
+
+		memmove( buf, buf + *pos, *fill - *pos );
+		*fill -= *pos;
+		*pos   = 0;
+	}
+
+	if ( *fill >= FORM_BUF_LEN - 1 ) return 0;
+
+	r = httplib_read( ctx, conn, buf + *fill, FORM_BUF_LEN - 1 - *fill );
+	if ( r > 0 ) *fill += (size_t)r;
+
+	buf[*fill] = 0;
+
+	return r;
+
+}  /* form_fill */
+
+
+/*
+ * static int multipart_form_request( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct httplib_form_data_handler *fdh, const struct lh_fbd_t *fb, char *buf );
+ *
+ * The function multipart_form_request() processes a multipart/form-data
+ * body in one pass. The body is read in blocks of FORM_BUF_LEN bytes. The
+ * data of each part is passed to the field_get callback, or stored in a file,
+ * as soon as it is known that it isn't part of the delimiter which ends the
+ * part. Only a partial delimiter at the end of a block is kept in the buffer
+ * and searched again after the next read. The body is preceded with a CRLF in
+ * the buffer, so that the first boundary can be found with the same search
+ * as all other delimiters.
+ *
+ * The function returns the number of fields processed, or -1 if the body is
+ * malformed or could not be read.
+ */
 
-	int clen = (int)buf_len - (int)boundary_len - 4;
-	int i;
+static int multipart_form_request( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct httplib_form_data_handler *fdh, const struct lh_fbd_t *fb, char *buf ) {
 
-	for (i = 0; i <= clen; i++) {
-		if (!memcmp(buf + i, "\r\n--", 4)) {
-			if (!memcmp(buf + i + 4, boundary, boundary_len)) return buf+i;
+	char path[512];
+	char name[1024];
+	size_t name_len;
+	size_t pos;
+	size_t fill;
+	size_t safe;
+	size_t n;
+	int field_count;
+	int field_storage;
+	int get_block;
+	int r;
+	int64_t file_size;
+	struct file fstore = STRUCT_FILE_INITIALIZER;
+	struct lh_rqi_t part_header;
+	char *hbuf;
+	char *hend;
+	char *fbeg;
+	char *fend;
+	char *nbeg;
+	char *nend;
+	const char *content_disp;
+	const char *next;
+
+	field_count = 0;
+	file_size   = 0;
+	pos         = 0;
+	fill        = 2;
+	buf[0]      = '\r';
+	buf[1]      = '\n';
+	buf[2]      = 0;
+
+	for (;;) {
+
+		/*
+		 * The delimiter must be followed by a CRLF if another part
+		 * follows, or by two dashes at the end of the body.
+		 */
+
+		while ( fill - pos < fb->len + 2 ) {
+
+			r = form_fill( ctx, conn, buf, & pos, & fill );
+			if ( r <= 0 ) return -1; /* read error or truncated body */
 		}
+
+		if ( memcmp( buf + pos, fb->delim, fb->len ) ) return -1; /* Malformed request */
+
+		pos += fb->len;
+
+		if ( buf[pos] == '-'  &&  buf[pos+1] == '-' ) break; /* End of the request */
+
+		if ( buf[pos] != '\r'  ||  buf[pos+1] != '\n' ) return -1; /* Malformed request */
+
+		pos += 2;
+
+		/*
+		 * Next, we need to get the part header: Read until \r\n\r\n
+		 */
+
+		while ( (hend = strstr( buf + pos, "\r\n\r\n" )) == NULL ) {
+
+			r = form_fill( ctx, conn, buf, & pos, & fill );
+			if ( r <= 0 ) return -1; /* Malformed request or header too large */
+		}
+
+		memset( & part_header, 0, sizeof(part_header) );
+
+		hbuf = buf + pos;
+		XX_httplib_parse_http_headers( &hbuf, &part_header );
+		if ( (hend + 2) != hbuf ) return -1; /* Malformed request */
+
+		/*
+		 * Skip \r\n\r\n
+		 */
+
+		hend += 4;
+		pos   = (size_t)(hend - buf);
+
+		/*
+		 * According to the RFC, every part has to have a header field like:
+		 * Content-Disposition: form-data; name="..."
+		 */
+
+		content_disp = XX_httplib_get_header( & part_header, "Content-Disposition" );
+		if ( content_disp == NULL ) return -1; /* Malformed request */
+
+		/*
+		 * Get the mandatory name="..." part of the Content-Disposition
+		 * header.
+		 */
+
+		nbeg = strstr( content_disp, "name=\"" );
+		if ( nbeg == NULL ) return -1; /* Malformed request */
+
+		nbeg += 6;
+		nend = strchr(nbeg, '\"');
+
+		if ( nend == NULL ) return -1; /* Malformed request */
+
+		/*
+		 * The name is passed with the first block of a field value.
+		 * It is copied because the part header is overwritten when
+		 * the buffer is refilled.
+		 */
+
+		name_len = (size_t)(nend - nbeg);
+		if ( name_len >= sizeof(name) ) return -1; /* Malformed request */
+
+		memcpy( name, nbeg, name_len );
+		name[name_len] = 0;
+
+		/*
+		 * Get the optional filename="..." part of the Content-Disposition
+		 * header.
+		 */
+
+		fbeg = strstr( content_disp, "filename=\"" );
+
+		if ( fbeg != NULL ) {
+
+			fbeg += 10;
+			fend  = strchr(fbeg, '\"');
+
+			if ( fend == NULL ) {
+
+				/*
+				 * Malformed request (the filename field is optional, but if
+				 * it exists, it needs to be terminated correctly).
+				 */
+
+				return -1;
+			}
+
+			/*
+			 * TODO: check Content-Type
+			 * Content-Type: application/octet-stream
+			 */
+
+		} else fend = fbeg;
+
+		memset( path, 0, sizeof(path) );
+		field_count++;
+		field_storage = url_encoded_field_found( ctx, conn, nbeg, (size_t)(nend - nbeg), fbeg, (size_t)(fend - fbeg), path, sizeof(path) - 1, fdh );
+
+		if ( field_storage == FORM_FIELD_STORAGE_STORE ) {
+
+			/*
+			 * Store the content to a file
+			 */
+
+			if ( XX_httplib_fopen( ctx, conn, path, "wb", &fstore ) == 0 ) fstore.fp = NULL;
+			file_size = 0;
+
+			if ( ! fstore.fp ) httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Cannot create file %s", __func__, path );
+		}
+
+		/*
+		 * Pass the value of the field on block by block until the
+		 * delimiter at the end of the part is found.
+		 */
+
+		get_block = 0;
+
+		for (;;) {
+
+			next = XX_httplib_form_boundary_search( fb, buf + pos, fill - pos, & safe );
+
+			if ( field_storage == FORM_FIELD_STORAGE_GET  &&  ( safe > 0  ||  next != NULL ) ) {
+
+				unencoded_field_get(conn,
+				                    ((get_block > 0) ? NULL : name),
+				                    ((get_block > 0) ? 0    : name_len),
+				                    buf + pos,
+				                    safe,
+				                    fdh);
+				get_block++;
+			}
+
+			if ( fstore.fp  &&  safe > 0 ) {
+
+				n = (size_t)fwrite( buf + pos, 1, safe, fstore.fp );
+
+				if ( n != safe  ||  ferror( fstore.fp ) ) {
+
+					httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Cannot write file %s", __func__, path );
+					fclose( fstore.fp );
+					fstore.fp = NULL;
+					XX_httplib_remove_bad_file( ctx, conn, path );
+				}
+
+				file_size += (int64_t)n;
+			}
+
+			pos += safe;
+
+			if ( next != NULL ) break;
+
+			/*
+			 * Read new data
+			 */
+
+			r = form_fill( ctx, conn, buf, & pos, & fill );
+
+			if ( r <= 0 ) {
+
+				if ( fstore.fp ) {
+
+					fclose( fstore.fp );
+					fstore.fp = NULL;
+					XX_httplib_remove_bad_file( ctx, conn, path );
+				}
+
+				return -1; /* read error or truncated body */
+			}
+		}
+
+		if ( fstore.fp ) {
+
+			r = fclose( fstore.fp );
+			if ( r == 0 ) {
+
+				/*
+				 * stored successfully
+				 */
+
+				field_stored( conn, path, file_size, fdh );
+			}
+
+			else {
+				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Error saving file %s", __func__, path );
+				XX_httplib_remove_bad_file( ctx, conn, path );
+			}
+			fstore.fp = NULL;
+		}
+
+		if ( (field_storage & FORM_FIELD_STORAGE_ABORT) == FORM_FIELD_STORAGE_ABORT ) break; /* Stop parsing the request */
 	}
-	return NULL;
-}
+
+	/*
+	 * All parts handled
+	 */
+
+	return field_count;
+
+}  /* multipart_form_request */
 
 
 int httplib_handle_form_request( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct httplib_form_data_handler *fdh ) {
@@ -523,18 +801,8 @@ int httplib_handle_form_request( struct lh_ctx_t *ctx, struct lh_con_t *conn, st
 
 		const char *boundary;
 		size_t bl;
-		ptrdiff_t used;
-		struct lh_rqi_t part_header;
-		char *hbuf;
-		char *hend;
-		char *fbeg;
-		char *fend;
-		char *nbeg;
-		char *nend;
-		const char *content_disp;
-		const char *next;
-
-		memset( & part_header, 0, sizeof(part_header) );
+		struct lh_fbd_t fb;
+		char *mbuf;
 
 		/*
 		 * Skip all spaces between MULTIPART/FORM-DATA; and BOUNDARY=
@@ -575,272 +843,19 @@ int httplib_handle_form_request( struct lh_ctx_t *ctx, struct lh_con_t *conn, st
 			return -1;
 		}
 
-		for (;;) {
-
-			size_t towrite;
-			size_t n;
-			int get_block;
-
-			r = httplib_read( ctx, conn, buf + (size_t)buf_fill, sizeof(buf) - 1 - (size_t)buf_fill );
-			if ( r < 0 ) return -1; /* read error */
-
-			buf_fill     += r;
-			buf[buf_fill] = 0;
-
-			if ( buf_fill < 1 ) return -1; /* No data */
-
-			if ( buf[0] != '-'  ||  buf[1] != '-' ) return -1; /* Malformed request */
+		if ( ! XX_httplib_form_boundary_init( & fb, boundary, bl ) ) return -1;
 
-			if ( strncmp( buf + 2, boundary, bl ) ) return -1; /* Malformed request */
+		mbuf = httplib_malloc( FORM_BUF_LEN );
 
-			if ( buf[bl + 2] != '\r'  ||  buf[bl + 3] != '\n' ) {
+		if ( mbuf == NULL ) {
 
-				/*
-				 * Every part must end with \r\n, if there is another part.
-				 * The end of the request has an extra --
-				 */
-
-				if (((size_t)buf_fill != (size_t)(bl + 6)) || (strncmp(buf + bl + 2, "--\r\n", 4))) return -1; /* Malformed request */
-
-				/*
-				 * End of the request
-				 */
-
-				break;
-			}
-
-			/*
-			 * Next, we need to get the part header: Read until \r\n\r\n
-			 */
-
-			hbuf = buf + bl + 4;
-			hend = strstr(hbuf, "\r\n\r\n");
-			if ( hend == NULL ) return -1; /* Malformed request */
-
-			XX_httplib_parse_http_headers( &hbuf, &part_header );
-			if ( (hend + 2) != hbuf ) return -1; /* Malformed request */
-
-			/*
-			 * Skip \r\n\r\n
-			 */
-
-			hend += 4;
-
-			/*
-			 * According to the RFC, every part has to have a header field like:
-			 * Content-Disposition: form-data; name="..."
-			 */
-
-			content_disp = XX_httplib_get_header( & part_header, "Content-Disposition" );
-			if ( ! content_disp ) return -1; /* Malformed request */
-
-			/*
-			 * Get the mandatory name="..." part of the Content-Disposition
-			 * header.
-			 */
-
-			nbeg = strstr( content_disp, "name=\"" );
-			if ( nbeg == NULL ) return -1; /* Malformed request */
-
-			nbeg += 6;
-			nend = strchr(nbeg, '\"');
-
-			if ( nend == NULL ) return -1; /* Malformed request */
-
-			/*
-			 * Get the optional filename="..." part of the Content-Disposition
-			 * header.
-			 */
-
-			fbeg = strstr( content_disp, "filename=\"" );
-
-			if ( fbeg != NULL ) {
-
-				fbeg += 10;
-				fend  = strchr(fbeg, '\"');
-
-				if ( fend == NULL ) {
-
-					/*
-					 * Malformed request (the filename field is optional, but if
-					 * it exists, it needs to be terminated correctly).
-					 */
-
-					return -1;
-				}
-
-				/*
-				 * TODO: check Content-Type
-				 * Content-Type: application/octet-stream
-				 */
-
-			} else fend = fbeg;
-
-			memset( path, 0, sizeof(path) );
-			field_count++;
-			field_storage = url_encoded_field_found( ctx, conn, nbeg, (size_t)(nend - nbeg), fbeg, (size_t)(fend - fbeg), path, sizeof(path) - 1, fdh );
-
-			/*
-			 * If the boundary is already in the buffer, get the address,
-			 * otherwise next will be NULL.
-			 */
-
-			next = search_boundary( hbuf, (size_t)((buf - hbuf) + buf_fill), boundary, bl );
-
-			if ( field_storage == FORM_FIELD_STORAGE_STORE ) {
-
-				/*
-				 * Store the content to a file
-				 */
-
-				if ( XX_httplib_fopen( ctx, conn, path, "wb", &fstore ) == 0 ) fstore.fp = NULL;
-				file_size = 0;
-
-				if ( ! fstore.fp ) httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Cannot create file %s", __func__, path );
-			}
-
-			get_block = 0;
-
-			while ( ! next ) {
-
-				/*
-				 * Set "towrite" to the number of bytes available
-				 * in the buffer
-				 */
-
-				towrite = (size_t)(buf - hend + buf_fill);
-
-				/*
-				 * Subtract the boundary length, to deal with
-				 * cases the boundary is only partially stored
-				 * in the buffer.
-				 */
-
-				towrite -= bl + 4;
-
-				if (field_storage == FORM_FIELD_STORAGE_GET) {
-					unencoded_field_get(conn,
-					                    ((get_block > 0) ? NULL : nbeg),
-					                    ((get_block > 0) ? 0    : (size_t)(nend - nbeg)),
-					                    hend,
-					                    towrite,
-					                    fdh);
-					get_block++;
-				}
-
-				if ( field_storage == FORM_FIELD_STORAGE_STORE ) {
-
-					if (fstore.fp) {
-
-						/*
-						 * Store the content of the buffer.
-						 */
-
-						n = (size_t)fwrite( hend, 1, towrite, fstore.fp );
-
-						if ( n != towrite  ||  ferror( fstore.fp ) ) {
-
-							httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Cannot write file %s", __func__, path );
-							fclose( fstore.fp );
-							fstore.fp = NULL;
-							XX_httplib_remove_bad_file( ctx, conn, path );
-						}
-
-						file_size += (int64_t)n;
-					}
-				}
-
-				memmove( buf, hend + towrite, bl + 4 );
-				buf_fill = (int)(bl + 4);
-				hend = buf;
-
-				/*
-				 * Read new data
-				 */
-
-				r = httplib_read( ctx, conn, buf + (size_t)buf_fill, sizeof(buf) - 1 - (size_t)buf_fill );
-				if ( r < 0 ) return -1; /* read error */
-
-				buf_fill     += r;
-				buf[buf_fill] = 0;
-				if (buf_fill < 1) return -1; /* No data */
-
-				/*
-				 * Find boundary
-				 */
-
-				next = search_boundary( buf, (size_t)buf_fill, boundary, bl );
-			}
-
-			towrite = (size_t)(next - hend);
-
-			if ( field_storage == FORM_FIELD_STORAGE_GET ) {
-
-				/*
-				 * Call callback
-				 */
-
-				unencoded_field_get(conn,
-				                    ((get_block > 0) ? NULL : nbeg),
-				                    ((get_block > 0) ? 0    : (size_t)(nend - nbeg)),
-				                    hend,
-				                    towrite,
-				                    fdh);
-			}
-
-			if ( field_storage == FORM_FIELD_STORAGE_STORE ) {
-
-				if ( fstore.fp ) {
-
-					n = (size_t)fwrite( hend, 1, towrite, fstore.fp );
-
-					if ( n != towrite  ||  ferror( fstore.fp ) ) {
-
-						httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Cannot write file %s", __func__, path );
-						fclose( fstore.fp );
-						fstore.fp = NULL;
-						XX_httplib_remove_bad_file( ctx, conn, path );
-					}
-					file_size += (int64_t)n;
-				}
-			}
-
-			if ( field_storage == FORM_FIELD_STORAGE_STORE ) {
-
-				if ( fstore.fp ) {
-
-					r = fclose( fstore.fp );
-					if ( r == 0 ) {
-
-						/*
-						 * stored successfully
-						 */
-
-						field_stored( conn, path, file_size, fdh );
-					}
-					
-					else {
-						httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Error saving file %s", __func__, path );
-						XX_httplib_remove_bad_file( ctx, conn, path );
-					}
-					fstore.fp = NULL;
-				}
-			}
-
-			if ( (field_storage & FORM_FIELD_STORAGE_ABORT) == FORM_FIELD_STORAGE_ABORT ) break; /* Stop parsing the request */
-
-			/*
-			 * Remove from the buffer
-			 */
-
-			used = next - buf + 2;
-			memmove(buf, buf + (size_t)used, sizeof(buf) - (size_t)used);
-			buf_fill -= (int)used;
+			httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Not enough memory (required: %lu)", __func__, (unsigned long)FORM_BUF_LEN );
+			return -1;
 		}
 
-		/*
-		 * All parts handled
-		 */
+		field_count = multipart_form_request( ctx, conn, fdh, & fb, mbuf );
+		mbuf        = httplib_free( mbuf );
+
 		return field_count;
 	}
 
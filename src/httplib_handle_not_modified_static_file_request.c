@@ -54,6 +54,6 @@ void XX_httplib_handle_not_modified_static_file_request( struct lh_ctx_t *ctx, s
 
 	httplib_printf( ctx, conn, "HTTP/1.1 %d %s\r\n" "Date: %s\r\n", conn->status_code, httplib_get_response_code_text( ctx, conn, conn->status_code ), date );
 	XX_httplib_send_static_cache_header( ctx, conn );
-	httplib_printf( ctx, conn, "Last-Modified: %s\r\n" "Etag: %s\r\n" "Connection: %s\r\n" "\r\n", lm, etag, XX_httplib_suggest_connection_header( ctx, conn ) );
+	httplib_printf( ctx, conn, "Last-Modified: %s\r\n" "Etag: %s\r\n" "%s" "Connection: %s\r\n" "\r\n", lm, etag, (filep->has_variants) ? "Vary: Accept-Encoding\r\n" : "", XX_httplib_suggest_connection_header( ctx, conn ) );
 
 }  /* XX_httplib_handle_not_modified_static_file_request */
@@ -98,22 +98,17 @@ static void print_dav_dir_entry( struct lh_ctx_t *ctx, struct de *de, void *data
 void XX_httplib_handle_propfind( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, struct file *filep ) {
 
 	const char *depth;
-	char date[64];
-	time_t curtime;
 
 	if ( ctx == NULL  ||  conn == NULL  ||  path == NULL  ||  filep == NULL ) return;
 	if ( ctx->document_root == NULL ) return;
 
-	depth   = httplib_get_header( conn, "Depth" );
-	curtime = time( NULL );
+	depth = httplib_get_header( conn, "Depth" );
 
-	XX_httplib_gmt_time_string( date, sizeof(date), &curtime );
+	if ( ! XX_httplib_start_chunked( ctx, conn, 207, "text/xml; charset=utf-8", NULL, true ) ) {
 
-	conn->must_close  = true;
-	conn->status_code = 207;
-	httplib_printf( ctx, conn, "HTTP/1.1 207 Multi-Status\r\n" "Date: %s\r\n", date );
-	XX_httplib_send_static_cache_header( ctx, conn );
-	httplib_printf( ctx, conn, "Connection: %s\r\n" "Content-Type: text/xml; charset=utf-8\r\n\r\n", XX_httplib_suggest_connection_header( ctx, conn ) );
+		XX_httplib_send_http_error( ctx, conn, 500, "%s", httplib_get_response_code_text( ctx, conn, 500 ) );
+		return;
+	}
 
 	conn->num_bytes_sent += httplib_printf( ctx, conn, "<?xml version=\"1.0\" encoding=\"utf-8\"?>" "<d:multistatus xmlns:d='DAV:'>\n" );
 
@@ -134,4 +129,6 @@ void XX_httplib_handle_propfind( struct lh_ctx_t *ctx, struct lh_con_t *conn, co
 
 	conn->num_bytes_sent += httplib_printf( ctx, conn, "%s\n", "</d:multistatus>" );
 
+	httplib_end_chunked( ctx, conn, NULL );
+
 }  /* XX_httplib_handle_propfind */
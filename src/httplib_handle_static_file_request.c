@@ -44,15 +44,24 @@ void XX_httplib_handle_static_file_request( struct lh_ctx_t *ctx, struct lh_con_
 	const char *msg;
 	const char *hdr;
 	time_t curtime;
+	time_t last_modified;
 	int64_t cl;
 	int64_t r1;
 	int64_t r2;
 	struct vec mime_vec;
+#if !defined(_WIN32)
+	struct stat st;
+#endif  /* _WIN32 */
 	int n;
+	int encoding;
+	int has_variants;
 	bool truncated;
-	char gz_path[PATH_MAX];
+	char encoded_path[PATH_MAX];
 	char error_string[ERROR_STRING_LEN];
-	const char *encoding;
+	const char *enc1;
+	const char *enc2;
+	const char *enc3;
+	const char *vary;
 	const char *cors1;
 	const char *cors2;
 	const char *cors3;
@@ -61,7 +70,10 @@ void XX_httplib_handle_static_file_request( struct lh_ctx_t *ctx, struct lh_con_
 
 	msg      = "OK";
 	curtime  = time( NULL );
-	encoding = "";
+	enc1     = "";
+	enc2     = "";
+	enc3     = "";
+	vary     = ( filep->has_variants ) ? "Vary: Accept-Encoding\r\n" : "";
 
 	if ( mime_type == NULL ) XX_httplib_get_mime_type( ctx, path, &mime_vec );
 	
@@ -70,32 +82,41 @@ void XX_httplib_handle_static_file_request( struct lh_ctx_t *ctx, struct lh_con_
 		mime_vec.len = strlen( mime_type );
 	}
 
-	if ( filep->size > INT64_MAX ) XX_httplib_send_http_error( ctx, conn, 500, "Error: File size is too large to send\n%" INT64_FMT, filep->size );
-
-	cl                = (int64_t)filep->size;
 	conn->status_code = 200;
 	range[0]          = '\0';
 
 	/*
-	 * if this file is in fact a pre-gzipped file, rewrite its filename
-	 * it's important to rewrite the filename after resolving
+	 * if this file is in fact a precompressed sibling, rewrite its
+	 * filename it's important to rewrite the filename after resolving
 	 * the mime type from it, to preserve the actual file's type
 	 */
 
-	if ( filep->gzipped ) {
+	if ( filep->encoding != FILE_ENCODING_IDENTITY ) {
 
-		XX_httplib_snprintf( ctx, conn, &truncated, gz_path, sizeof(gz_path), "%s.gz", path );
+		XX_httplib_snprintf( ctx, conn, &truncated, encoded_path, sizeof(encoded_path), "%s%s", path, XX_httplib_encoding_ext[filep->encoding] );
 
 		if ( truncated ) {
 
-			XX_httplib_send_http_error( ctx, conn, 500, "Error: Path of zipped file too long (%s)", path );
+			XX_httplib_send_http_error( ctx, conn, 500, "Error: Path of compressed file too long (%s)", path );
 			return;
 		}
 
-		path     = gz_path;
-		encoding = "Content-Encoding: gzip\r\n";
+		path = encoded_path;
+		enc1 = "Content-Encoding: ";
+		enc2 = XX_httplib_encoding_name[filep->encoding];
+		enc3 = "\r\n";
 	}
 
+	/*
+	 * Opening the file resets the file structure. The information from
+	 * the earlier stat and content negotiation is therefore restored
+	 * after the file has been opened.
+	 */
+
+	encoding      = filep->encoding;
+	has_variants  = filep->has_variants;
+	last_modified = filep->last_modified;
+
 	if ( ! XX_httplib_fopen( ctx, conn, path, "rb", filep ) ) {
 
 		XX_httplib_send_http_error( ctx, conn, 500, "Error: Cannot open file\nfopen(%s): %s", path, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
@@ -104,6 +125,29 @@ void XX_httplib_handle_static_file_request( struct lh_ctx_t *ctx, struct lh_con_
 
 	XX_httplib_fclose_on_exec( ctx, filep, conn );
 
+	filep->encoding      = encoding;
+	filep->has_variants  = has_variants;
+	filep->last_modified = last_modified;
+
+	/*
+	 * The size is taken from the opened file and not from the stat()
+	 * before. The negotiation cache only checks the original file, so a
+	 * precompressed sibling may have changed since it was cached.
+	 */
+
+#if !defined(_WIN32)
+	if ( filep->fp != NULL  &&  fstat( fileno( filep->fp ), &st ) == 0 ) filep->size = (uint64_t)st.st_size;
+#endif  /* _WIN32 */
+
+	if ( filep->size > INT64_MAX ) {
+
+		XX_httplib_send_http_error( ctx, conn, 500, "Error: File size is too large to send\n%" INT64_FMT, filep->size );
+		XX_httplib_fclose( filep );
+		return;
+	}
+
+	cl = (int64_t)filep->size;
+
 	/*
 	 * If Range: header specified, act accordingly
 	 */
@@ -115,13 +159,13 @@ void XX_httplib_handle_static_file_request( struct lh_ctx_t *ctx, struct lh_con_
 	if ( hdr != NULL  &&  (n = XX_httplib_parse_range_header( hdr, &r1, &r2 )) > 0  &&  r1 >= 0  &&  r2 >= 0 ) {
 
 		/*
-		 * actually, range requests don't play well with a pre-gzipped
+		 * actually, range requests don't play well with a precompressed
 		 * file (since the range is specified in the uncompressed space)
 		 */
 
-		if ( filep->gzipped ) {
+		if ( filep->encoding != FILE_ENCODING_IDENTITY ) {
 
-			XX_httplib_send_http_error( ctx, conn, 501, "%s", "Error: Range requests in gzipped files are not supported"); XX_httplib_fclose(filep);
+			XX_httplib_send_http_error( ctx, conn, 501, "%s", "Error: Range requests in compressed files are not supported"); XX_httplib_fclose(filep);
 			return;
 		}
 		conn->status_code = 206;
@@ -178,7 +222,7 @@ void XX_httplib_handle_static_file_request( struct lh_ctx_t *ctx, struct lh_con_
 	                "Content-Length: %" INT64_FMT "\r\n"
 	                "Connection: %s\r\n"
 	                "Accept-Ranges: bytes\r\n"
-	                "%s%s",
+	                "%s%s%s%s%s",
 	                lm,
 	                etag,
 	                (int)mime_vec.len,
@@ -186,7 +230,10 @@ void XX_httplib_handle_static_file_request( struct lh_ctx_t *ctx, struct lh_con_
 	                cl,
 	                XX_httplib_suggest_connection_header( ctx, conn ),
 	                range,
-	                encoding );
+	                enc1,
+	                enc2,
+	                enc3,
+	                vary );
 
 	/*
 	 * The previous code must not add any header starting with X- to make
@@ -164,7 +164,15 @@ void XX_httplib_handle_websocket_request( struct lh_ctx_t *ctx, struct lh_con_t
 	}
 
 	/*
-	 * Step 6: Call the ready handler
+	 * Step 6: Hand the connection over to the websocket reactor if it is
+	 * running. The reactor calls the ready handler itself and the worker
+	 * thread becomes available for other connections.
+	 */
+
+	if ( is_callback_resource  &&  XX_httplib_websocket_reactor_add( ctx, conn, ws_ready_handler, ws_data_handler, ws_close_handler, cbData ) ) return;
+
+	/*
+	 * Step 7: Call the ready handler
 	 */
 
 	if ( is_callback_resource ) {
@@ -173,13 +181,19 @@ void XX_httplib_handle_websocket_request( struct lh_ctx_t *ctx, struct lh_con_t
 	}
 
 	/*
-	 * Step 7: Enter the read loop
+	 * Step 8: Enter the read loop. The connection is in the keepalive list
+	 * while it is read, so that idle peers are pinged.
 	 */
 
-	if (is_callback_resource) XX_httplib_read_websocket( ctx, conn, ws_data_handler, cbData );
+	if (is_callback_resource) {
+
+		XX_httplib_websocket_keepalive_add( ctx, conn );
+		XX_httplib_read_websocket( ctx, conn, ws_data_handler, cbData );
+		XX_httplib_websocket_keepalive_remove( ctx, conn );
+	}
 
 	/*
-	 * Step 8: Call the close handler
+	 * Step 9: Call the close handler
 	 */
 
 	if ( ws_close_handler != NULL ) ws_close_handler( ctx, conn, cbData );
@@ -40,6 +40,7 @@ int XX_httplib_inet_pton( int af, const char *src, void *dst, size_t dstlen ) {
 
 	memset( & hints, 0, sizeof(struct addrinfo) );
 	hints.ai_family = af;
+	hints.ai_flags  = AI_NUMERICHOST;
 
 	gai_ret = getaddrinfo( src, NULL, &hints, &res );
 
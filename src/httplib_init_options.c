@@ -43,22 +43,40 @@ bool XX_httplib_init_options( struct lh_ctx_t *ctx ) {
 	ctx->cgi_environment             = NULL;
 	ctx->cgi_interpreter             = NULL;
 	ctx->cgi_pattern                 = NULL;
+	ctx->client_pipeline_depth       = 8;
+	ctx->client_pool_idle_timeout    = 10000;
+	ctx->client_pool_max_idle        = 16;
+	ctx->client_pool_max_per_host    = 4;
+	ctx->compression_level           = 6;
+	ctx->compression_min_size        = 1024;
+	ctx->connect_timeout             = 10000;
 	ctx->debug_level                 = LH_DEBUG_WARNING;
 	ctx->decode_url                  = true;
 	ctx->document_root               = NULL;
 	ctx->enable_directory_listing    = true;
 	ctx->enable_keep_alive           = false;
+	ctx->enable_websocket_compression = true;
+	ctx->enable_websocket_reactor    = false;
+	ctx->encoding_cache_ttl          = 60;
 	ctx->error_log_file              = NULL;
 	ctx->error_pages                 = NULL;
 	ctx->extra_mime_types            = NULL;
 	ctx->global_auth_file            = NULL;
 	ctx->hide_file_pattern           = NULL;
+	ctx->hosts_file                  = NULL;
 	ctx->index_files                 = NULL;
+	ctx->keep_alive_timeout          = 30000;
 	ctx->listening_ports             = NULL;
+	ctx->max_request_size            = MAX_REQUEST_SIZE;
 	ctx->num_threads                 = 50;
 	ctx->protect_uri                 = NULL;
 	ctx->put_delete_auth_file        = NULL;
+	ctx->request_buffer_size         = 4096;
 	ctx->request_timeout             = 30000;
+	ctx->resolver_cache_ttl          = 60;
+	ctx->resolver_negative_ttl       = 5;
+	ctx->resolver_threads            = 2;
+	ctx->resolver_timeout            = 10000;
 	ctx->run_as_user                 = NULL;
 	ctx->ssi_include_depth           = 10;
 	ctx->ssi_pattern                 = NULL;
@@ -76,6 +94,12 @@ bool XX_httplib_init_options( struct lh_ctx_t *ctx ) {
 	ctx->tcp_nodelay                 = false;
 	ctx->url_rewrite_patterns        = NULL;
 	ctx->websocket_root              = NULL;
+	ctx->websocket_max_message_size  = 16777216;
+	ctx->websocket_ping_interval     = 0;
+	ctx->websocket_pong_timeout      = 10000;
+	ctx->websocket_send_queue_drop   = false;
+	ctx->websocket_send_queue_high   = 1048576;
+	ctx->websocket_send_queue_low    = 262144;
 	ctx->websocket_timeout           = 30000;
 
 	if ( (ctx->access_control_allow_origin = httplib_strdup( "*" )) == NULL ) {
@@ -40,6 +40,7 @@ int XX_httplib_cryptolib_users = 0; /* Reference counter for crypto library. */
 
 #if !defined(NO_SSL_DL)
 static void *cryptolib_dll_handle; /* Store the crypto library handle. */
+static void *ssllib_dll_handle;    /* Store the ssl library handle.    */
 #endif  /* NO_SSL_DL */
 
 
@@ -48,7 +49,10 @@ static void *cryptolib_dll_handle; /* Store the crypto library handle. */
  * int XX_httplib_initialize_ssl( struct lh_ctx_t *ctx );
  *
  * The function XX_httplib_initialize_ssl() initializes the use of SSL
- * encrypted communication on the given context.
+ * encrypted communication on the given context. The crypto and SSL libraries
+ * are loaded the first time the function is called, either by a server
+ * context with SSL ports or by a client context making its first secure
+ * connection.
  */
 
 int XX_httplib_initialize_ssl( struct lh_ctx_t *ctx ) {
@@ -62,8 +66,17 @@ int XX_httplib_initialize_ssl( struct lh_ctx_t *ctx ) {
 		cryptolib_dll_handle = XX_httplib_load_dll( ctx, CRYPTO_LIB, XX_httplib_crypto_sw );
 		if ( ! cryptolib_dll_handle ) return 0;
 	}
+
+	if ( ! ssllib_dll_handle ) {
+
+		ssllib_dll_handle = XX_httplib_load_dll( ctx, SSL_LIB, XX_httplib_ssl_sw );
+		if ( ! ssllib_dll_handle ) return 0;
+	}
 #endif /* NO_SSL_DL */
 
+	SSL_library_init();
+	SSL_load_error_strings();
+
 	if ( httplib_atomic_inc( & XX_httplib_cryptolib_users ) > 1 ) return 1;
 
 	/*
@@ -82,7 +95,12 @@ int XX_httplib_initialize_ssl( struct lh_ctx_t *ctx ) {
 		return 0;
 	}
 
-	for (i=0; i<CRYPTO_num_locks(); i++) httplib_pthread_mutex_init( & XX_httplib_ssl_mutexes[i], &XX_httplib_pthread_mutex_attr);
+	/*
+	 * The global mutex attributes only exist after a server context was
+	 * started. Client contexts use the default attributes.
+	 */
+
+	for (i=0; i<CRYPTO_num_locks(); i++) httplib_pthread_mutex_init( & XX_httplib_ssl_mutexes[i], ( ctx->ctx_type == CTX_TYPE_SERVER ) ? &XX_httplib_pthread_mutex_attr : NULL );
 
 	CRYPTO_set_locking_callback( & XX_httplib_ssl_locking_callback );
 	CRYPTO_set_id_callback(      & XX_httplib_ssl_id_callback      );
@@ -54,8 +54,6 @@ void XX_httplib_interpret_uri( struct lh_ctx_t *ctx, struct lh_con_t *conn, char
 	struct vec a;
 	struct vec b;
 	int match_len;
-	char gz_path[PATH_MAX];
-	char const *accept_encoding;
 	bool truncated;
 #if !defined(NO_CGI)
 	char *p;
@@ -155,37 +153,21 @@ void XX_httplib_interpret_uri( struct lh_ctx_t *ctx, struct lh_con_t *conn, char
 	}
 
 	/*
-	 * If we can't find the actual file, look for the file
-	 * with the same name but a .gz extension. If we find it,
-	 * use that and set the gzipped flag in the file struct
-	 * to indicate that the response need to have the content-
-	 * encoding: gzip header.
-	 * We can only do this if the browser declares support.
+	 * If we can't find the actual file, look for a precompressed
+	 * sibling with a .br or .gz extension which is accepted by the
+	 * browser. If we find it, use that and set the encoding in the file
+	 * struct to indicate that the response needs to have the proper
+	 * Content-Encoding header.
 	 */
 
-	if ( (accept_encoding = httplib_get_header( conn, "Accept-Encoding" )) != NULL ) {
+	if ( XX_httplib_negotiate_encoding( ctx, conn, filename, filep, false ) ) {
 
-		if ( strstr( accept_encoding, "gzip" ) != NULL ) {
-
-			XX_httplib_snprintf( ctx, conn, &truncated, gz_path, sizeof(gz_path), "%s.gz", filename );
-
-			if ( truncated ) goto interpret_cleanup;
-
-			if ( XX_httplib_stat( ctx, conn, gz_path, filep ) ) {
-
-				if ( filep ) {
-
-					filep->gzipped = 1;
-					*is_found      = true;
-				}
-
-				/*
-				 * Currently gz files can not be scripts.
-				 */
+		/*
+		 * Currently precompressed files can not be scripts.
+		 */
 
-				return;
-			}
-		}
+		*is_found = true;
+		return;
 	}
 
 #if !defined(NO_CGI)
@@ -294,6 +294,7 @@ typedef DWORD clockid_t;
 
 #include <sys/wait.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/time.h>
@@ -303,6 +304,16 @@ typedef DWORD clockid_t;
 #include <netinet/tcp.h>
 typedef const void *SOCK_OPT_TYPE;
 
+#if defined(__linux__)  &&  !defined(ALTERNATIVE_QUEUE)  &&  !defined(NO_WEBSOCKET_REACTOR)
+#if !defined(USE_WEBSOCKET_REACTOR)
+#define USE_WEBSOCKET_REACTOR
+#endif  /* USE_WEBSOCKET_REACTOR */
+#endif  /* __linux__  &&  !ALTERNATIVE_QUEUE  &&  !NO_WEBSOCKET_REACTOR */
+
+#if defined(USE_WEBSOCKET_REACTOR)
+#include <sys/epoll.h>
+#endif  /* USE_WEBSOCKET_REACTOR */
+
 #if defined(ANDROID)
 typedef unsigned short int in_port_t;
 #endif
@@ -378,6 +389,11 @@ typedef int SOCKET;
 #define MGSQLEN (20)
 #endif
 
+/*
+ * Default of the max_request_size option, the largest receive buffer for the
+ * header of a request or response
+ */
+
 #ifndef MAX_REQUEST_SIZE
 #define MAX_REQUEST_SIZE (16384)
 #endif
@@ -416,10 +432,45 @@ enum uri_type_t {
 	URI_TYPE_ABS_PORT
 };
 
+/*
+ * enum deadline_t
+ *
+ * The kind of the deadline of a connection. The kind decides which timeout
+ * counter of the context is incremented when the deadline expires.
+ */
+
+enum deadline_t {
+	DEADLINE_NONE,
+	DEADLINE_HEADER,
+	DEADLINE_BODY,
+	DEADLINE_KEEP_ALIVE,
+	DEADLINE_WEBSOCKET,
+	DEADLINE_NUM_KINDS
+};
+
+/*
+ * struct lh_ddl_t;
+ *
+ * The deadline for reading from a connection. An absolute deadline ends at a
+ * fixed moment, like the end of the time in which all request headers must
+ * have been received. An idle deadline gives every read the same amount of
+ * time to receive data, like the time between two parts of a request body.
+ * Deadlines are not timers of the timer service. The thread which reads from
+ * the connection checks the deadline itself when it waits for data.
+ */
+
+struct lh_ddl_t {
+	int64_t		expires;	/* Monotonic time in ms when an absolute deadline expires, 0 if not absolute		*/
+	int		idle;		/* Milliseconds a read may wait with an idle deadline, 0 if not idle			*/
+	enum deadline_t	kind;		/* Kind of the deadline									*/
+	bool		expired;	/* true, if the deadline has expired and the connection must be closed			*/
+};
+
 #if defined(NO_SSL)
 
 typedef struct SSL SSL; /* dummy for SSL argument to push/pull */
 typedef struct SSL_CTX SSL_CTX;
+typedef struct SSL_SESSION SSL_SESSION;
 
 #else  /* NO_SSL */
 
@@ -440,6 +491,7 @@ struct ssl_func;
 typedef struct ssl_st SSL;
 typedef struct ssl_method_st SSL_METHOD;
 typedef struct ssl_ctx_st SSL_CTX;
+typedef struct ssl_session_st SSL_SESSION;
 typedef struct x509_store_ctx_st X509_STORE_CTX;
 // typedef struct x509_name X509_NAME;
 typedef struct asn1_integer ASN1_INTEGER;
@@ -450,6 +502,15 @@ typedef struct x509_name X509_NAMEX;
 #endif  /* NO_SSL_DL */
 #endif  /* NO_SSL */
 
+#if defined(USE_ZLIB)
+#define ZLIB_CONST
+#include <zlib.h>
+#endif  /* USE_ZLIB */
+
+#if defined(USE_BROTLI)
+#include <brotli/encode.h>
+#endif  /* USE_BROTLI */
+
 struct httplib_workerTLS {
 	unsigned long thread_idx;
 #if defined(_WIN32)
@@ -463,10 +524,17 @@ extern CRITICAL_SECTION			global_log_file_lock;
 #endif
 
 #define PASSWORDS_FILE_NAME		".htpasswd"
+#define UPLOAD_FILE_PREFIX		".libhttp-upload."
 #define CGI_ENVIRONMENT_SIZE		(4096)
 #define MAX_CGI_ENVIR_VARS		(256)
 #define MG_BUF_LEN			(8192)
 #define ERROR_STRING_LEN		(256)
+#define READV_MAX_IOV			(16)
+#define SENDV_MAX_IOV			(64)
+#define OUT_BATCH_SIZE			(16384)
+#define SPLICE_BLOCK_LEN		(65536)
+#define WEBSOCKET_COPY_MAX		(4096)
+#define WEBSOCKET_MASK_BLOCK		(16384)
 
 /*
  * TODO: LJB: Move to test functions
@@ -518,6 +586,300 @@ struct httplib_handler_info {
 	struct httplib_handler_info *next;
 };
 
+/*
+ * struct lh_wsz_t;
+ *
+ * A zlib stream for the permessage-deflate websocket extension. Streams which
+ * are not in use are kept in a pool in the server context, so that they can
+ * be reused without a new allocation of the compression state. This matters
+ * most when no context takeover is negotiated, because then a stream is only
+ * taken from the pool for the time needed to process one message.
+ */
+
+#define WEBSOCKET_ZSTREAM_POOL_MAX	(64)
+
+struct lh_wsz_t {
+	struct lh_wsz_t *	next;			/* Next stream in the pool						*/
+	bool			deflate;		/* true for a compressor, false for a decompressor			*/
+	int			window_bits;		/* Base two logarithm of the window size of a compressor		*/
+#if defined(USE_ZLIB)
+	z_stream		zstream;		/* The zlib stream							*/
+#endif  /* USE_ZLIB */
+};
+
+struct lh_wzp_t {
+	struct lh_wsz_t *	streams;		/* Linked list of idle streams						*/
+	int			len;			/* Number of streams in the list					*/
+	pthread_mutex_t		mutex;			/* Protects the list							*/
+};
+
+/*
+ * struct lh_bpl_t;
+ *
+ * The receive buffers of connections have sizes which are powers of two,
+ * from BUFFER_MIN_SIZE up to BUFFER_MAX_SIZE. A buffer which is no longer
+ * used by a connection is kept in a pool in the context, with one list for
+ * every size class, so that a connection which needs a buffer of that size
+ * doesn't have to allocate a new one. The first bytes of an idle buffer hold
+ * the pointer to the next buffer in its list.
+ */
+
+#define BUFFER_MIN_SIZE			(1024)
+#define BUFFER_NUM_CLASSES		(12)
+#define BUFFER_MAX_SIZE			(BUFFER_MIN_SIZE << (BUFFER_NUM_CLASSES-1))
+#define BUFFER_POOL_MAX			(32)
+
+struct lh_bpl_t {
+	char *			first[BUFFER_NUM_CLASSES];	/* Linked lists of idle buffers, one for every size class		*/
+	int			len[BUFFER_NUM_CLASSES];	/* Number of buffers in every list					*/
+	pthread_mutex_t		mutex;				/* Protects the lists							*/
+	bool			initialized;			/* true, if the mutex was initialized					*/
+};
+
+/*
+ * struct lh_tmr_t;
+ *
+ * A timer of the timer service of a context. Timers are kept in an array of
+ * slots which is reused, and the identifier of a timer combines the index of
+ * its slot with a generation number which changes every time the slot is
+ * reused, so that an outdated identifier never cancels another timer.
+ */
+
+#define TIMER_NONE		(UINT32_MAX)
+#define TIMER_HEAP_ARITY	(4)
+
+struct lh_tmr_t {
+	int64_t			due;			/* Monotonic time in ms when the timer fires				*/
+	int64_t			period;			/* Period in ms of a repeating timer, 0 for a single shot		*/
+	httplib_timer_handler	handler;		/* Function which is called when the timer fires			*/
+	void *			cbdata;			/* Callback data of the handler						*/
+	uint32_t		generation;		/* Generation of the slot, part of the identifier of the timer		*/
+	uint32_t		heap_pos;		/* Position of the timer in the heap, TIMER_NONE if not scheduled	*/
+	uint32_t		next_free;		/* Next free slot, if the slot is not in use				*/
+	bool			in_use;			/* true, if the slot holds a timer					*/
+};
+
+/*
+ * struct lh_tms_t;
+ *
+ * The timer service of a context. The timers which are scheduled are kept in
+ * a 4-ary min-heap ordered on the time they fire, so that the next timer is
+ * found immediately and a timer is added or cancelled in logarithmic time
+ * with few cache misses. One thread sleeps on a condition variable until the
+ * first timer is due, and is woken up early only when a timer is added which
+ * fires before that. The server uses it for the websocket keepalive check.
+ * Request and keep-alive timeouts are checked by the threads which read the
+ * connections instead.
+ */
+
+struct lh_tms_t {
+	pthread_mutex_t		mutex;			/* Protects all fields of the timer service				*/
+	pthread_cond_t		cond;			/* Signaled when the first timer changed or a handler returned	*/
+	pthread_t		threadid;		/* The timer thread ID							*/
+	struct httplib_workerTLS *	tls;		/* Thread local storage of the timer thread				*/
+	struct lh_tmr_t *	slots;			/* Array with all timer slots						*/
+	uint32_t *		heap;			/* Heap with the indices of the scheduled timers			*/
+	uint32_t		num_slots;		/* Allocated number of slots						*/
+	uint32_t		heap_len;		/* Number of timers in the heap						*/
+	uint32_t		free_slot;		/* First free slot, TIMER_NONE if none					*/
+	uint32_t		running;		/* Slot of which the handler is running, TIMER_NONE if none		*/
+	bool			started;		/* true, if the timer thread was started				*/
+	bool			stop;			/* true, if the timer thread must stop					*/
+	bool			initialized;		/* true, if the mutex and condition variable were initialized		*/
+};
+
+/*
+ * struct lh_wka_t;
+ *
+ * The keepalive list of a server context with all websocket connections
+ * which are open on the server. A repeating timer walks the list when the
+ * earliest deadline of the connections has passed, sends a ping frame to
+ * connections which have been idle for the ping interval and shuts down
+ * connections which did not answer a ping within the pong timeout.
+ */
+
+#define WEBSOCKET_KEEPALIVE_TICK	(100)
+
+struct lh_wka_t {
+	pthread_mutex_t		mutex;			/* Protects the list, the deadline and the counters			*/
+	struct lh_con_t *	first;			/* First connection in the list						*/
+	int64_t			next_check;		/* Monotonic time in ms when the list must be checked again		*/
+	uint64_t		num_conns;		/* Number of connections in the list					*/
+	uint64_t		num_pings;		/* Number of ping frames sent						*/
+	uint64_t		num_reaped;		/* Number of connections closed because a pong was missed		*/
+};
+
+/*
+ * struct lh_cpl_t;
+ *
+ * The pool with idle keep-alive connections of a client context. A connection
+ * which is closed by the application after its response was read completely
+ * is parked in the pool, and the next connection to the same host, port and
+ * protocol takes it out again instead of doing a new TCP and TLS handshake.
+ * The list is ordered with the most recently used connection first.
+ */
+
+struct lh_cpl_t {
+	pthread_mutex_t		mutex;			/* Protects the list and the counters					*/
+	struct lh_con_t *	first;			/* Most recently parked connection					*/
+	int			num_idle;		/* Number of connections in the pool					*/
+	uint64_t		num_reused;		/* Number of connections taken from the pool				*/
+	bool			initialized;		/* true, if the mutex was initialized					*/
+};
+
+/*
+ * struct lh_mxf_t;
+ *
+ * A transfer of a multi handle. The request is stored as it is sent, with
+ * the request line, the headers and the body in one buffer. A transfer is
+ * first queued in the multi handle, then it is in the list of transfers which
+ * were sent on a connection and wait for their response, and finally it is
+ * in the list of finished transfers until the application reads the result.
+ */
+
+#define PIPELINE_MAX_REQUESTS	64
+
+struct lh_mxf_t {
+	struct lh_mxf_t *	next;			/* Next transfer in the same list					*/
+	char *			host;			/* Host the request is sent to						*/
+	int			port;			/* Port the request is sent to						*/
+	bool			use_ssl;		/* true, if the request is sent over a secure connection		*/
+	char *			data;			/* The complete request							*/
+	size_t			data_len;		/* Number of bytes in the request					*/
+	bool			no_body;		/* true, if the response has no body, like for a HEAD request		*/
+	bool			idempotent;		/* true, if the request may be pipelined and sent again			*/
+	int			attempts;		/* Number of times the request was sent					*/
+	void *			user_data;		/* User data passed back with the result				*/
+	int			status;			/* HTTP status code, or -1 if the transfer failed			*/
+	char *			body;			/* Received response body						*/
+	size_t			body_len;		/* Number of bytes in the response body					*/
+	size_t			body_size;		/* Allocated size of the body buffer					*/
+};
+
+/*
+ * struct lh_mcn_t;
+ *
+ * A client connection of a multi handle with the transfers which were sent
+ * on it, in the order the responses are expected.
+ */
+
+struct lh_mcn_t {
+	struct lh_mcn_t *	next;			/* Next connection of the multi handle					*/
+	struct lh_con_t *	conn;			/* The client connection						*/
+	struct lh_mxf_t *	first;			/* Transfer of which the response is received next			*/
+	struct lh_mxf_t *	last;			/* Transfer which was sent last						*/
+	bool			in_body;		/* true, if the headers of the response were parsed			*/
+	int64_t			last_rx;		/* Monotonic time in ms when data was received for the last time	*/
+};
+
+/*
+ * struct lh_mlt_t;
+ *
+ * A multi handle runs many client transfers concurrently from the thread of
+ * the application. Requests to the same host and port are pipelined on one
+ * keep-alive connection, and the responses of all connections are received
+ * as they arrive.
+ */
+
+struct lh_mlt_t {
+	struct lh_ctx_t *	ctx;			/* Client context of the connections					*/
+	struct lh_mxf_t *	queue_first;		/* First transfer which has not been sent yet				*/
+	struct lh_mxf_t *	queue_last;		/* Last transfer which has not been sent yet				*/
+	struct lh_mcn_t *	conns;			/* Connections with transfers waiting for their response		*/
+	struct lh_mxf_t *	done_first;		/* First finished transfer						*/
+	struct lh_mxf_t *	done_last;		/* Last finished transfer						*/
+	int			num_running;		/* Number of transfers which have not finished				*/
+};
+
+/*
+ * struct lh_tss_t;
+ *
+ * A TLS session which was negotiated with a host and port by a client
+ * connection. The next connection to the same host and port offers the
+ * session to the server, which allows an abbreviated handshake without the
+ * key exchange and the certificate chain.
+ */
+
+#define SSL_SESSION_CACHE_MAX	64
+
+struct lh_tss_t {
+	struct lh_tss_t *	next;			/* Next session in the cache, most recently stored first		*/
+	char *			host;			/* Host the session was negotiated with					*/
+	int			port;			/* Port the session was negotiated with					*/
+	SSL_SESSION *		session;		/* The session								*/
+};
+
+/*
+ * struct lh_csl_t;
+ *
+ * The SSL state shared by the client connections of a client context. The SSL
+ * context is created and configured with the certificate and verification
+ * options of the client context when the first secure connection is made. It
+ * lives as long as the client context, because sessions can only be resumed
+ * with the SSL context which negotiated them.
+ */
+
+struct lh_csl_t {
+	pthread_mutex_t		mutex;			/* Protects the SSL context, the sessions and the counters		*/
+	SSL_CTX *		ssl_ctx;		/* Shared SSL context, NULL until the first secure connection		*/
+	struct lh_tss_t *	first;			/* First session in the cache						*/
+	int			num_sessions;		/* Number of sessions in the cache					*/
+	uint64_t		num_offered;		/* Number of handshakes which offered a cached session			*/
+	bool			initialized;		/* true, if the mutex was initialized					*/
+};
+
+/*
+ * struct lh_dns_t;
+ *
+ * A host name in the resolver cache of a context with the addresses it
+ * resolved to. An entry without addresses caches a failed lookup. An entry is
+ * pending while a resolver thread looks the name up, and it is not removed
+ * from the cache while callers wait for it.
+ */
+
+#define RESOLVER_MAX_ADDRS	8
+#define HAPPY_EYEBALLS_DELAY	250
+#define RESOLVER_MAX_ENTRIES	256
+#define RESOLVER_MAX_THREADS	8
+
+struct lh_dns_t {
+	struct lh_dns_t *	next;			/* Next entry in the cache, most recently used first			*/
+	struct lh_dns_t *	queue_next;		/* Next entry in the queue of lookups					*/
+	char *			host;			/* The host name							*/
+	union usa		addrs[RESOLVER_MAX_ADDRS];	/* Resolved addresses without port number				*/
+	int			num_addrs;		/* Number of resolved addresses, 0 if the name was not found		*/
+	int			refs;			/* Number of callers waiting for the entry				*/
+	int64_t			expires;		/* Monotonic time in ms when the entry must be looked up again		*/
+	bool			pending;		/* true, if the name is being looked up					*/
+};
+
+/*
+ * struct lh_rsv_t;
+ *
+ * The resolver of a context. Host names are looked up by a small pool of
+ * threads, so that a caller can give up waiting for a slow name server, and
+ * callers which need the same name at the same time wait for one lookup.
+ * Results are cached for a fixed time because the system resolver doesn't
+ * return the time to live of the records.
+ */
+
+struct lh_rsv_t {
+	pthread_mutex_t		mutex;			/* Protects all fields of the resolver					*/
+	pthread_cond_t		work;			/* Signaled when a lookup is queued or the threads must stop		*/
+	pthread_cond_t		done;			/* Signaled when a lookup has finished					*/
+	struct lh_dns_t *	first;			/* First entry in the cache						*/
+	struct lh_dns_t *	queue_first;		/* First entry waiting for a resolver thread				*/
+	struct lh_dns_t *	queue_last;		/* Last entry waiting for a resolver thread				*/
+	pthread_t		threadids[RESOLVER_MAX_THREADS];	/* The resolver thread IDs					*/
+	int			num_threads;		/* Number of resolver threads which were started			*/
+	int			num_idle;		/* Number of resolver threads waiting for work				*/
+	int			num_entries;		/* Number of entries in the cache					*/
+	uint64_t		num_hits;		/* Number of lookups answered from the cache				*/
+	uint64_t		num_misses;		/* Number of lookups passed to a resolver thread			*/
+	bool			stop;			/* true, if the resolver threads must stop				*/
+	bool			initialized;		/* true, if the mutex and condition variables were initialized		*/
+};
+
 /*
  * struct lh_ctx_t;
  */
@@ -557,12 +919,30 @@ struct lh_ctx_t {
 
 	char *systemName;			/* What operating system is running							*/
 
+	struct encoding_cache_t *encoding_cache;/* Cached existence of precompressed static files					*/
+	pthread_mutex_t encoding_cache_mutex;	/* Protects encoding_cache								*/
+
+	struct lh_wzp_t ws_zstream_pool;	/* Idle zlib streams for permessage-deflate websockets					*/
+	struct lh_wka_t ws_keepalive;		/* Websocket connections which are checked with ping frames				*/
+
+	int ws_epoll_fd;			/* Event queue of the websocket reactor							*/
+	char *ws_reactor_buf;			/* Receive buffer of the websocket reactor						*/
+	pthread_t ws_reactor_threadid;		/* The websocket reactor thread ID							*/
+	struct lh_wsx_t *ws_reactor_conns;	/* All websocket connections handled by the reactor, protected by thread_mutex		*/
+	struct lh_wsx_t *ws_ready_first;	/* First connection with work for a worker thread, protected by thread_mutex		*/
+	struct lh_wsx_t *ws_ready_last;		/* Last connection with work for a worker thread					*/
+
 	/* linked list of uri handlers */
 	struct httplib_handler_info *handlers;
 
-#ifdef USE_TIMERS
-	struct ttimers *timers;
-#endif
+	struct lh_tms_t timers;			/* Timer service of the context								*/
+
+	volatile int num_timeouts[DEADLINE_NUM_KINDS];	/* Number of expired connection deadlines per kind			*/
+
+	struct lh_bpl_t buffer_pool;		/* Idle receive buffers of connections, one list per size class				*/
+	struct lh_cpl_t client_pool;		/* Idle keep-alive connections of a client context					*/
+	struct lh_rsv_t resolver;		/* Cache and threads for host name lookups						*/
+	struct lh_csl_t client_ssl;		/* Shared SSL context and session cache of a client context				*/
 
 	enum lh_dbg_t	debug_level;
 
@@ -579,6 +959,7 @@ struct lh_ctx_t {
 	char *	extra_mime_types;
 	char *	global_auth_file;
 	char *	hide_file_pattern;
+	char *	hosts_file;
 	char *	index_files;
 	char *	listening_ports;
 	char *	protect_uri;
@@ -593,22 +974,45 @@ struct lh_ctx_t {
 	char *	url_rewrite_patterns;
 	char *	websocket_root;
 
+	int	client_pipeline_depth;
+	int	client_pool_idle_timeout;
+	int	client_pool_max_idle;
+	int	client_pool_max_per_host;
+	int	compression_level;
+	int	compression_min_size;
+	int	connect_timeout;
+	int	encoding_cache_ttl;
+	int	keep_alive_timeout;
+	int	max_request_size;
 	int	num_threads;
+	int	request_buffer_size;
 	int	request_timeout;
+	int	resolver_cache_ttl;
+	int	resolver_negative_ttl;
+	int	resolver_threads;
+	int	resolver_timeout;
 	int	ssi_include_depth;
 	int	ssl_protocol_version;
 	int	ssl_verify_depth;
 	int	static_file_max_age;
+	int	websocket_max_message_size;
+	int	websocket_ping_interval;
+	int	websocket_pong_timeout;
+	int	websocket_send_queue_high;
+	int	websocket_send_queue_low;
 	int	websocket_timeout;
 
 	bool	allow_sendfile_call;
 	bool	decode_url;
 	bool	enable_directory_listing;
 	bool	enable_keep_alive;
+	bool	enable_websocket_compression;
+	bool	enable_websocket_reactor;
 	bool	ssl_short_trust;
 	bool	ssl_verify_paths;
 	bool	ssl_verify_peer;
 	bool	tcp_nodelay;
+	bool	websocket_send_queue_drop;
 };
 
 /*
@@ -623,23 +1027,53 @@ struct lh_con_t {					/*												*/
 	struct socket	client;				/* Connected client										*/
 	time_t		conn_birth_time;		/* Time (wall clock) when connection was established						*/
 	struct timespec	req_time;			/* Time (since system start) when the request was received					*/
+	struct lh_ddl_t	deadline;			/* Deadline for the blocking reads of the connection						*/
+	int		request_timeout;		/* Timeout in ms for the header and for every read of the body, 0 if reads wait forever		*/
 	int64_t		num_bytes_sent;			/* Total bytes sent to client									*/
 	int64_t		content_len;			/* Content-Length header value									*/
 	int64_t		consumed_content;		/* How many bytes of content have been read							*/
 	int		is_chunked;			/* Transfer-Encoding is chunked: 0=no, 1=yes: data available, 2: all data read			*/
 	size_t		chunk_remainder;		/* Unread data from the last chunk								*/
+	int		chunk_state;			/* State of the decoder of a chunked body, one of enum chunk_state_t				*/
+	size_t		chunk_line_len;			/* Length of the chunk size or trailer line which is parsed					*/
 	char *		buf;				/* Buffer for received data									*/
 	char *		path_info;			/* PATH_INFO part of the URL									*/
 	bool		must_close;			/* true, if connection must be closed								*/
 	bool		in_error_handler;		/* true, if in handler for user defined error pages						*/
-	int		buf_size;			/* Buffer size											*/
+	int		buf_size;			/* Size of the buffer which starts at buf							*/
+	int		buf_offset;			/* Offset of buf in the receive buffer, the data before it was processed already		*/
 	int		request_len;			/* Size of the request + headers in a buffer							*/
 	int		data_len;			/* Total size of data in a buffer								*/
+	char *		out_buf;			/* Responses which are held back to be sent together with the next ones				*/
+	size_t		out_len;			/* Number of bytes in out_buf									*/
+	bool		out_hold;			/* true, if responses are held back because the next request is buffered			*/
 	int		status_code;			/* HTTP reply status code, e.g. 200								*/
 	time_t		last_throttle_time;		/* Last time throttled data was sent								*/
 	int64_t		throttle;			/* Throttling, bytes/sec. <= 0 means no throttle						*/
 	int64_t		last_throttle_bytes;		/* Bytes sent this second									*/
 	pthread_mutex_t	mutex;				/* Used by httplib_(un)lock_connection to ensure atomic transmissions for websockets		*/
+	struct lh_cmp_t *compress;			/* State of a response which is compressed on the fly, NULL if not active			*/
+	struct lh_chk_t *chunk_out;			/* State of a response with chunked transfer encoding, NULL if not active			*/
+	struct lh_pmd_t *ws_deflate;			/* State of the permessage-deflate websocket extension, NULL if not negotiated			*/
+	struct lh_wsq_t *ws_queue;			/* Websocket frames which could not be sent yet, NULL if none					*/
+	struct lh_wsq_t *ws_queue_last;			/* Last frame in the websocket send queue							*/
+	size_t		ws_queue_off;			/* Number of bytes of the first queued frame already sent					*/
+	size_t		ws_queued;			/* Number of bytes in the websocket send queue which have not been sent yet			*/
+	bool		ws_queue_full;			/* true, if the send queue reached the high watermark since it was last drained			*/
+	struct lh_wsx_t *ws_reactor;			/* Reactor state of the websocket connection, NULL if it is served by a worker thread		*/
+	struct lh_con_t *ws_ka_prev;			/* Previous connection in the websocket keepalive list						*/
+	struct lh_con_t *ws_ka_next;			/* Next connection in the websocket keepalive list						*/
+	volatile int64_t ws_last_rx;			/* Monotonic time in ms when websocket data was received for the last time			*/
+	int64_t		ws_ping_sent;			/* Monotonic time in ms when the last keepalive ping was sent, 0 if none			*/
+	bool		ws_keepalive;			/* true, if the connection is in the websocket keepalive list					*/
+	bool		ws_client;			/* true, if the connection is read by the websocket client thread				*/
+	char *		pool_host;			/* Host of a client connection which may be pooled, NULL if it may not				*/
+	int		pool_port;			/* Port of a client connection which may be pooled						*/
+	bool		pool_reused;			/* true, if the client connection was taken from the connection pool				*/
+	int64_t		pool_idle_since;		/* Monotonic time in ms when the connection was parked in the connection pool			*/
+	struct lh_con_t *pool_next;			/* Next connection in the connection pool							*/
+	int		pipeline_pending;		/* Number of pipelined requests of which the response was not received yet			*/
+	uint64_t	pipeline_no_body;		/* Bit per pending pipelined request, set if its response has no body				*/
 	int		thread_index;			/* Thread index within ctx									*/
 };							/*												*/
 							/************************************************************************************************/
@@ -679,16 +1113,398 @@ struct uriprot_tp {
 	unsigned	default_port;
 };
 
+/*
+ * enum file_encoding_t;
+ *
+ * Static files can be present on disk in precompressed form next to the
+ * original file, for example app.js.br and app.js.gz next to app.js. The
+ * enumeration identifies which of these siblings is served. If two siblings
+ * are equally acceptable to the client and have the same size, the one with
+ * the highest value is preferred.
+ */
+
+enum file_encoding_t {
+	FILE_ENCODING_IDENTITY,
+	FILE_ENCODING_GZIP,
+	FILE_ENCODING_BR,
+	FILE_ENCODING_NUM
+};
+
 struct file {
 	uint64_t	size;
 	time_t		last_modified;
 	FILE *		fp;
 	const char *	membuf; /* Non-NULL if file data is in memory */
 	int		is_directory;
-	int		gzipped; /* set to 1 if the content is gzipped in which case we need a content-encoding: gzip header */
+	int		encoding; /* FILE_ENCODING_IDENTITY, or the precompressed sibling which must be sent with a Content-Encoding header */
+	int		has_variants; /* set to 1 if precompressed siblings exist and a Vary: Accept-Encoding header is needed */
+};
+
+#define STRUCT_FILE_INITIALIZER    { (uint64_t)0, (time_t)0, NULL, NULL, 0, FILE_ENCODING_IDENTITY, 0 } 
+
+/*
+ * struct encoding_cache_t;
+ *
+ * Result of the stat() calls on a static file and its precompressed siblings.
+ * The entries are kept in a small direct mapped table in the context so that
+ * negotiating the content encoding of a popular file does not need any extra
+ * system calls until the entry expires or the original file changes.
+ */
+
+#define ENCODING_CACHE_SIZE		(256)
+
+struct encoding_variant_t {
+	bool		exists;
+	uint64_t	size;
+	time_t		last_modified;
+};
+
+struct encoding_cache_t {
+	char *				path;				/* Path of the original file, NULL if the slot is unused	*/
+	uint32_t			hash;				/* Hash value of the path					*/
+	time_t				expires;			/* Time after which the entry must be refreshed			*/
+	struct encoding_variant_t	variant[FILE_ENCODING_NUM];	/* Stat results of the siblings and the original file		*/
+};
+
+/*
+ * enum chunk_state_t;
+ *
+ * States of the decoder of a request or response body which is received with
+ * chunked transfer encoding. The decoder works on the data in the connection
+ * buffer and can stop and resume in any state when the buffer runs empty.
+ * Chunk size lines and trailer lines longer than CHUNK_LINE_MAX are rejected.
+ * Chunk data which isn't buffered yet is read directly into the buffer of the
+ * caller if at least CHUNK_DIRECT_READ_MIN bytes of it are requested.
+ */
+
+enum chunk_state_t {
+	CHUNK_STATE_SIZE,				/* Reading the hexadecimal chunk size				*/
+	CHUNK_STATE_EXT,				/* Skipping a chunk extension up to the CR			*/
+	CHUNK_STATE_SIZE_LF,				/* Expecting the LF at the end of the chunk size line		*/
+	CHUNK_STATE_DATA,				/* Passing chunk_remainder bytes of chunk data			*/
+	CHUNK_STATE_DATA_CR,				/* Expecting the CR after the chunk data			*/
+	CHUNK_STATE_DATA_LF,				/* Expecting the LF after the chunk data			*/
+	CHUNK_STATE_TRAILER,				/* At the start of a trailer line or the final empty line	*/
+	CHUNK_STATE_TRAILER_LINE,			/* Skipping a trailer line up to the CR				*/
+	CHUNK_STATE_TRAILER_LF,				/* Expecting the LF at the end of a trailer line		*/
+	CHUNK_STATE_END_LF,				/* Expecting the LF of the final empty line			*/
+	CHUNK_STATE_DONE,				/* The whole body has been read					*/
+	CHUNK_STATE_ERROR				/* The body violates the protocol				*/
+};
+
+#define CHUNK_LINE_MAX			(1024)
+#define CHUNK_DIRECT_READ_MIN		(4096)
+
+/*
+ * struct lh_fbd_t;
+ *
+ * Precomputed search data for the delimiter "\r\n--boundary" which separates
+ * the parts of a multipart/form-data body. The skip table contains for every
+ * byte value the distance the search window can be moved when that byte is
+ * the last byte of a window which doesn't match. The multipart parser reads
+ * the body in blocks of FORM_BUF_LEN bytes.
+ */
+
+#define FORM_DELIM_LEN			(256)
+#define FORM_BUF_LEN			(65536)
+
+struct lh_fbd_t {
+	size_t			len;			/* Length of the delimiter						*/
+	size_t			skip[256];		/* Window shift per value of the last byte in the window		*/
+	char			delim[FORM_DELIM_LEN];	/* The delimiter "\r\n--" followed by the boundary			*/
+};
+
+/*
+ * struct lh_wsr_t;
+ *
+ * Receive state of a websocket connection. Incoming data is read into a ring
+ * buffer of WEBSOCKET_RING_LEN bytes, which must be a power of two. The head
+ * and tail are running byte counts, and the offset in the ring is found by
+ * masking them with the ring size. Frames which lie completely in one piece
+ * in the ring are unmasked in place and passed to the data handler without
+ * copying. Other frames and the fragments of a message which is being
+ * reassembled are collected in the arena, which grows when needed and is
+ * reused for the following messages of the connection. Data which arrived
+ * with the upgrade request and does not fit in the ring is kept in extra and
+ * is read before new data from the socket.
+ */
+
+#define WEBSOCKET_RING_LEN		(65536)
+#define WEBSOCKET_HEADER_MAX		(14)
+
+struct lh_wsr_t {
+	char *			ring;			/* The ring buffer with received data					*/
+	uint64_t		head;			/* Number of bytes taken from the ring					*/
+	uint64_t		tail;			/* Number of bytes put in the ring					*/
+	char *			arena;			/* Buffer for frames which can't be passed from the ring		*/
+	size_t			arena_size;		/* Allocated size of the arena						*/
+	size_t			msg_len;		/* Length of the fragmented message in the arena so far			*/
+	unsigned char		msg_op;			/* Opcode of the first frame of the fragmented message			*/
+	bool			fragmented;		/* true, if a fragmented message is being reassembled			*/
+	char *			extra;			/* Frames of the upgrade request which did not fit in the ring		*/
+	size_t			extra_len;		/* Number of bytes in extra						*/
+	size_t			extra_off;		/* Number of bytes taken from extra					*/
 };
 
-#define STRUCT_FILE_INITIALIZER    { (uint64_t)0, (time_t)0, NULL, NULL, 0, 0 } 
+/*
+ * struct lh_pmp_t;
+ *
+ * The parameters of one permessage-deflate extension offer or response in a
+ * Sec-WebSocket-Extensions header. A window size of zero means that the
+ * parameter is absent, and -1 that it is present without a value.
+ */
+
+struct lh_pmp_t {
+	bool			server_no_context_takeover;	/* The server resets its compressor after each message		*/
+	bool			client_no_context_takeover;	/* The client resets its compressor after each message		*/
+	int			server_max_window_bits;		/* Maximum window bits of the compressor of the server		*/
+	int			client_max_window_bits;		/* Maximum window bits of the compressor of the client		*/
+};
+
+/*
+ * struct lh_pmd_t;
+ *
+ * State of the permessage-deflate extension on a websocket connection. The
+ * compressor is used for outgoing messages and the decompressor for incoming
+ * messages with the RSV1 bit set. Both have their own output buffer, which is
+ * reused for every message, because messages are received and sent by
+ * different threads. Streams are taken from the pool of the server context,
+ * or allocated directly for client connections which have no pool. Messages
+ * smaller than WEBSOCKET_DEFLATE_MIN bytes are sent uncompressed.
+ */
+
+#define WEBSOCKET_RSV1			(0x40)
+#define WEBSOCKET_DEFLATE_MIN		(32)
+
+struct lh_pmd_t {
+	bool			deflate_no_context_takeover;	/* Reset the compressor after each message			*/
+	bool			inflate_no_context_takeover;	/* Reset the decompressor after each message			*/
+	int			deflate_window_bits;		/* Window bits of the compressor				*/
+	int			level;				/* Compression level of the compressor				*/
+	struct lh_wzp_t *	pool;				/* Pool of the server context, NULL for client connections	*/
+	struct lh_wsz_t *	deflate;			/* The compressor, or NULL if not in use			*/
+	struct lh_wsz_t *	inflate;			/* The decompressor, or NULL if not in use			*/
+	char *			deflate_buf;			/* Output buffer of the compressor				*/
+	size_t			deflate_size;			/* Allocated size of the compressor output buffer		*/
+	char *			inflate_buf;			/* Output buffer of the decompressor				*/
+	size_t			inflate_size;			/* Allocated size of the decompressor output buffer		*/
+};
+
+/*
+ * struct lh_wsf_t;
+ *
+ * A websocket frame which is broadcast to the connections of a group or
+ * waits in the send queue of a connection. The frame header and the payload
+ * are stored in one piece directly after the structure, so that the frame is
+ * built only once and can be sent with a single call per connection.
+ * Connections on which the frame could not be sent completely keep a
+ * reference to it until the rest has been sent, and the frame is freed when
+ * the last reference is released.
+ */
+
+struct lh_wsf_t {
+	volatile int		refcount;		/* Number of references to the frame					*/
+	size_t			len;			/* Length of the frame including the header				*/
+};
+
+/*
+ * struct lh_wsq_t;
+ *
+ * An entry in the send queue of a websocket connection. The queue is
+ * protected by the mutex of the connection. Only the first frame in the
+ * queue can have been sent partly.
+ */
+
+struct lh_wsq_t {
+	struct lh_wsq_t *	next;			/* Next frame in the queue						*/
+	struct lh_wsf_t *	frame;			/* The frame which waits to be sent					*/
+};
+
+/*
+ * struct lh_wsi_t;
+ *
+ * An iteration over the connections of a websocket group. The connections
+ * are copied when the iteration starts, so that the group is only locked
+ * while the next connection is taken and not while it is written to.
+ * Connections which are removed from the group meanwhile are cleared in the
+ * copy, and httplib_websocket_group_remove() waits until the connection
+ * which is in use by an iteration has been released.
+ */
+
+struct lh_wsi_t {
+	struct lh_wsi_t *	next;			/* Next iteration over the same group					*/
+	struct lh_con_t **	conns;			/* Copy of the connections of the group					*/
+	size_t			num_conns;		/* Number of connections in the copy					*/
+	size_t			pos;			/* Index of the next connection in the copy				*/
+	struct lh_con_t *	cur;			/* Connection which is in use, or NULL					*/
+	bool			removed;		/* true, if cur was removed from the group				*/
+};
+
+/*
+ * struct lh_wsg_t;
+ *
+ * A group of websocket connections which receive the same broadcast frames.
+ * The array of connections grows when needed. Connections must be removed
+ * from the group by the application before they are closed. The mutex of the
+ * group is never held while waiting for the lock of a connection, so that
+ * threads which hold the lock of a connection can add and remove it.
+ */
+
+struct lh_wsg_t {
+	pthread_mutex_t		mutex;			/* Protects the array of connections and the iterations			*/
+	pthread_cond_t		released;		/* Signaled when an iteration released a connection			*/
+	struct lh_con_t **	conns;			/* The connections in the group						*/
+	size_t			num_conns;		/* Number of connections in the group					*/
+	size_t			size;			/* Allocated number of entries in the array				*/
+	struct lh_wsi_t *	iters;			/* Iterations which are running over the group				*/
+};
+
+/*
+ * struct lh_wsm_t;
+ *
+ * A complete websocket message which has been received by the reactor and
+ * waits to be passed to the data handler by a worker thread. The payload is
+ * stored directly after the structure and followed by a NUL character.
+ */
+
+struct lh_wsm_t {
+	struct lh_wsm_t *	next;			/* Next message of the connection					*/
+	size_t			len;			/* Length of the payload						*/
+	int			opcode;			/* Flags and opcode as passed to the data handler			*/
+};
+
+/*
+ * struct lh_wsx_t;
+ *
+ * State of a websocket connection which is served by the reactor instead of
+ * a worker thread. The reactor thread reads from the socket when it becomes
+ * readable and collects the data of incomplete frames in the input buffer,
+ * which is freed again when it is empty so that idle connections use as
+ * little memory as possible. Complete messages are queued and the connection
+ * is put in the ready list of the context, from which one worker thread at a
+ * time takes it to pass the messages to the data handler. Reading is paused
+ * while more than WEBSOCKET_REACTOR_QUEUE_MAX bytes are queued. Frames which
+ * could not be sent immediately wait in the send queue of the connection and
+ * the reactor sends them when the socket becomes writable. When the
+ * connection is closed, the worker thread which handles the last work of the
+ * connection calls the close handler and frees it. All fields from the
+ * message queue on are protected by the thread mutex of the context.
+ */
+
+#define WEBSOCKET_REACTOR_BUF_LEN	(65536)
+#define WEBSOCKET_REACTOR_QUEUE_MAX	(1048576)
+#define WEBSOCKET_REACTOR_EVENTS	(256)
+#define WEBSOCKET_REACTOR_DRAIN		(-1)
+
+struct lh_wsx_t {
+	struct lh_ctx_t *	ctx;			/* The context of the reactor						*/
+	struct lh_con_t *	conn;			/* The connection							*/
+	httplib_websocket_data_handler	data_handler;	/* Handler for received messages				*/
+	httplib_websocket_close_handler	close_handler;	/* Handler called when the connection is closed			*/
+	void *			cbdata;			/* Callback data of the handlers					*/
+	char *			in;			/* Data of an incomplete frame, NULL if none				*/
+	size_t			in_len;			/* Number of bytes in the input buffer					*/
+	size_t			in_size;		/* Allocated size of the input buffer					*/
+	size_t			need;			/* Length of the incomplete frame, if its header is complete		*/
+	char *			msg;			/* Fragments of a message which is being reassembled			*/
+	size_t			msg_len;		/* Length of the reassembled fragments so far				*/
+	size_t			msg_size;		/* Allocated size of the reassembly buffer				*/
+	unsigned char		msg_op;			/* Opcode of the first frame of the fragmented message			*/
+	bool			fragmented;		/* true, if a fragmented message is being reassembled			*/
+	time_t			last_read;		/* Time when data was received for the last time			*/
+	struct lh_wsm_t *	first;			/* First queued message							*/
+	struct lh_wsm_t *	last;			/* Last queued message							*/
+	size_t			queued;			/* Number of payload bytes in queued messages				*/
+	struct lh_wsx_t *	prev;			/* Previous connection of the reactor					*/
+	struct lh_wsx_t *	next;			/* Next connection of the reactor					*/
+	struct lh_wsx_t *	ready_next;		/* Next connection in the ready list					*/
+	uint32_t		events;			/* Events for which the socket is watched, 0 if it is not watched	*/
+	bool			scheduled;		/* true, if the connection is in the ready list or being handled	*/
+	bool			paused;			/* true, if the reactor doesn't read from the socket at the moment	*/
+	bool			writing;		/* true, if the reactor waits for the socket to become writable		*/
+	bool			starting;		/* true, while the connection is handed over to the reactor		*/
+	bool			closed;			/* true, if the reactor has stopped reading from the connection		*/
+};
+
+/*
+ * struct lh_out_t;
+ *
+ * A buffer with data which is sent together with other buffers in one call
+ * with XX_httplib_sendv().
+ */
+
+struct lh_out_t {
+	const void *		base;			/* Start of the data							*/
+	size_t			len;			/* Number of bytes							*/
+};
+
+/*
+ * struct lh_chk_t;
+ *
+ * State of a response which is sent with chunked transfer encoding through
+ * httplib_write_chunk(). Small writes are collected in the buffer and sent as
+ * one chunk when the buffer is full. Room is reserved in front of the data
+ * for the chunk size line, and after the data for the CRLF which ends the
+ * chunk and the last chunk which ends the body, so that every chunk including
+ * the last one can be sent with a single write.
+ */
+
+#define CHUNK_BUF_LEN			(8192)
+#define CHUNK_HDR_LEN			(16)
+#define CHUNK_TAIL_LEN			(7)
+
+struct lh_chk_t {
+	bool			framing;		/* true, if chunk framing is used, false for HTTP/1.0 clients		*/
+	bool			no_body;		/* true, if the body must be discarded, like for HEAD requests		*/
+	bool			error;			/* true, if sending data failed						*/
+	size_t			len;			/* Number of bytes of data in the buffer				*/
+	char			buf[CHUNK_HDR_LEN+CHUNK_BUF_LEN+CHUNK_TAIL_LEN];	/* Chunk buffer, see above		*/
+};
+
+/*
+ * struct lh_cmp_t;
+ *
+ * State of a response which is compressed on the fly while a request handler
+ * writes it with httplib_write() or httplib_printf(). The body is held back
+ * until compression_min_size bytes have been written, so that small responses
+ * can still be sent uncompressed with a Content-Length header. Larger bodies
+ * are compressed into the out buffer which is sent as one chunk of a chunked
+ * transfer encoding each time it fills up. The same room is reserved around
+ * the data in the out buffer as in the buffer of struct lh_chk_t.
+ */
+
+enum compress_encoding_t {
+	COMPRESS_IDENTITY,
+	COMPRESS_GZIP,
+	COMPRESS_DEFLATE,
+	COMPRESS_BR
+};
+
+#define COMPRESS_BUF_LEN		(16384)
+
+struct lh_cmp_t {
+	int			encoding;		/* The COMPRESS_xxx content coding of the response body			*/
+	int			level;			/* Compression level, 1 (fastest) to 9 (best)				*/
+	char *			headers;		/* Response headers, except for the headers describing the body		*/
+	size_t			headers_len;		/* Length of the headers string						*/
+	char *			pending;		/* Body data held back until compression_min_size is reached		*/
+	size_t			pending_len;		/* Number of bytes in the pending buffer				*/
+	size_t			pending_size;		/* Allocated size of the pending buffer					*/
+	size_t			min_size;		/* Minimum size of a body before it is compressed			*/
+	bool			headers_sent;		/* true, if the headers have been sent and the body is streamed		*/
+	bool			chunked;		/* true, if chunked transfer encoding is used for the body		*/
+	bool			no_body;		/* true, if the body must be discarded, like for HEAD requests		*/
+	bool			error;			/* true, if sending data failed						*/
+#if defined(USE_ZLIB)
+	bool			zstream_init;		/* true, if zstream has been initialized by deflateInit2()		*/
+	z_stream		zstream;		/* State of the gzip or deflate compressor				*/
+#endif  /* USE_ZLIB */
+#if defined(USE_BROTLI)
+	BrotliEncoderState *	brotli;			/* State of the brotli compressor					*/
+#endif  /* USE_BROTLI */
+	size_t			out_len;		/* Number of bytes of compressed data in the out buffer			*/
+	char			out[CHUNK_HDR_LEN+COMPRESS_BUF_LEN+CHUNK_TAIL_LEN];	/* Output buffer, see above		*/
+};
 
 /* Describes a string (chunk of memory). */
 struct vec {
@@ -808,29 +1624,55 @@ void			SHA1Update( SHA1_CTX *context, const unsigned char *data, uint32_t len );
 struct lh_ctx_t *	XX_httplib_abort_start( struct lh_ctx_t *ctx, PRINTF_FORMAT_STRING(const char *fmt), ...) PRINTF_ARGS(2, 3);
 void			XX_httplib_accept_new_connection( const struct socket *listener, struct lh_ctx_t *ctx );
 bool			XX_httplib_authorize( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct file *filep );
+void			XX_httplib_buffer_compact( struct lh_con_t *conn );
+void			XX_httplib_buffer_discard( struct lh_con_t *conn, int len );
+bool			XX_httplib_buffer_grow( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+void			XX_httplib_buffer_pool_free( struct lh_ctx_t *ctx );
+char *			XX_httplib_buffer_pool_get( struct lh_ctx_t *ctx, int *size );
+void			XX_httplib_buffer_pool_put( struct lh_ctx_t *ctx, char *buf, int size );
+void			XX_httplib_buffer_release( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+bool			XX_httplib_buffer_resize( struct lh_ctx_t *ctx, struct lh_con_t *conn, int size );
+void			XX_httplib_buffer_shrink( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+char *			XX_httplib_build_request( const struct lh_req_t *req, size_t *len );
 const char *		XX_httplib_builtin_mime_ext( int index );
 const char *		XX_httplib_builtin_mime_type( int index );
 int			XX_httplib_check_acl( struct lh_ctx_t *ctx, uint32_t remote_ip );
 bool			XX_httplib_check_authorization( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path );
 bool			XX_httplib_check_password( const char *method, const char *ha1, const char *uri, const char *nonce, const char *nc, const char *cnonce, const char *qop, const char *response );
+int			XX_httplib_chunked_view( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool fill, const char **data, size_t *len );
+void			XX_httplib_client_pool_free( struct lh_ctx_t *ctx );
+struct lh_con_t *	XX_httplib_client_pool_get( struct lh_ctx_t *ctx, const char *host, int port, bool use_ssl );
+bool			XX_httplib_client_pool_put( struct lh_ctx_t *ctx, struct lh_con_t *conn );
 void			XX_httplib_close_all_listening_sockets( struct lh_ctx_t *ctx );
 void			XX_httplib_close_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn );
 void			XX_httplib_close_socket_gracefully( struct lh_ctx_t *ctx, struct lh_con_t *conn );
 int WINCDECL		XX_httplib_compare_dir_entries( const void *p1, const void *p2 );
-bool			XX_httplib_connect_socket( struct lh_ctx_t *ctx, const char *host, int port, int use_ssl, SOCKET *sock, union usa *sa );
+void			XX_httplib_compress_free( struct lh_con_t *conn );
+bool			XX_httplib_compress_send( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len, bool finish );
+int			XX_httplib_compress_write( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len );
+bool			XX_httplib_connect_race( const struct lh_ctx_t *ctx, const union usa *addrs, int num_addrs, int timeout, SOCKET *sock, int *winner, int *error );
+bool			XX_httplib_connect_socket( struct lh_ctx_t *ctx, const char *host, int port, int use_ssl, int timeout, SOCKET *sock, union usa *sa );
 void			XX_httplib_construct_etag( struct lh_ctx_t *ctx, char *buf, size_t buf_len, const struct file *filep );
-int			XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, int thread_index );
+int			XX_httplib_consume_socket( struct lh_ctx_t *ctx, struct socket *sp, struct lh_wsx_t **wsx, int thread_index );
+void			XX_httplib_deadline_set( struct lh_con_t *conn, enum deadline_t kind, int timeout );
+int			XX_httplib_deadline_wait( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
 void			XX_httplib_delete_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path );
 void			XX_httplib_dir_scan_callback( struct lh_ctx_t *ctx, struct de *de, void *data );
 void			XX_httplib_discard_unread_request_data( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
 int			XX_httplib_fclose( struct file *filep );
 void			XX_httplib_fclose_on_exec( struct lh_ctx_t *ctx, struct file *filep, struct lh_con_t *conn );
 const char *		XX_httplib_fgets( char *buf, size_t size, struct file *filep, char **p );
+bool			XX_httplib_fill_body_buffer( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
 bool			XX_httplib_fopen( struct lh_ctx_t *ctx, const struct lh_con_t *conn, const char *path, const char *mode, struct file *filep );
+bool			XX_httplib_form_boundary_init( struct lh_fbd_t *fb, const char *boundary, size_t len );
+const char *		XX_httplib_form_boundary_search( const struct lh_fbd_t *fb, const char *buf, size_t len, size_t *safe );
+int64_t			XX_httplib_flush_output( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len );
 bool			XX_httplib_forward_body_data( struct lh_ctx_t *ctx, struct lh_con_t *conn, FILE *fp, SOCKET sock, SSL *ssl );
+void			XX_httplib_free_client_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn );
 void			XX_httplib_free_config_options( struct lh_ctx_t *ctx );
 void			XX_httplib_free_context( struct lh_ctx_t *ctx );
 const char *		XX_httplib_get_header( const struct lh_rqi_t *ri, const char *name );
+int			XX_httplib_get_encoding_quality( const char *accept_encoding, const char *coding );
 void			XX_httplib_get_mime_type( const struct lh_ctx_t *ctx, const char *path, struct vec *vec );
 const char *		XX_httplib_get_rel_url_at_current_server( const struct lh_ctx_t *ctx, const char *uri, const struct lh_con_t *conn );
 uint32_t		XX_httplib_get_remote_ip( const struct lh_con_t *conn );
@@ -868,9 +1710,16 @@ void			XX_httplib_log_access( struct lh_ctx_t *ctx, const struct lh_con_t *conn
 LIBHTTP_THREAD		XX_httplib_master_thread( void *thread_func_param );
 int			XX_httplib_match_prefix(const char *pattern, size_t pattern_len, const char *str);
 void			XX_httplib_mkcol( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path );
+int64_t			XX_httplib_monotonic_msec( void );
+void			XX_httplib_multi_close( struct lh_mlt_t *multi, struct lh_mcn_t *mcn, bool failed );
+void			XX_httplib_multi_done( struct lh_mlt_t *multi, struct lh_mxf_t *xfer, int status );
+bool			XX_httplib_multi_receive( struct lh_mlt_t *multi, struct lh_mcn_t *mcn );
+void			XX_httplib_multi_start( struct lh_mlt_t *multi );
 bool			XX_httplib_must_hide_file( const struct lh_ctx_t *ctx, const char *path );
 const char *		XX_httplib_next_option( const char *list, struct vec *val, struct vec *eq_val );
+bool			XX_httplib_negotiate_encoding( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, struct file *filep, bool is_found );
 void			XX_httplib_open_auth_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, struct file *filep );
+bool			XX_httplib_open_temp_file( struct lh_ctx_t *ctx, const struct lh_con_t *conn, const char *path, char *tmp_path, size_t tmp_len, struct file *filep );
 bool			XX_httplib_option_value_to_bool( const char *value, bool *config );
 bool			XX_httplib_option_value_to_int( const char *value, int *config );
 int			XX_httplib_parse_auth_header( const struct lh_ctx_t *ctx, struct lh_con_t *conn, char *buf, size_t buf_size, struct ah *ah );
@@ -885,39 +1734,53 @@ void			XX_httplib_print_dir_entry( struct lh_ctx_t *ctx, struct de *de );
 void			XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn );
 bool			XX_httplib_process_options( struct lh_ctx_t *ctx, const struct lh_opt_t *options );
 void			XX_httplib_produce_socket( struct lh_ctx_t *ctx, const struct socket *sp );
-int			XX_httplib_pull( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn, char *buf, int len, double timeout );
+int			XX_httplib_pull( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn, char *buf, int len );
 int			XX_httplib_pull_all( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn, char *buf, int len );
 int64_t			XX_httplib_push_all( const struct lh_ctx_t *ctx, FILE *fp, SOCKET sock, SSL *ssl, const char *buf, int64_t len );
 int			XX_httplib_put_dir( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path );
 void			XX_httplib_put_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path );
 bool			XX_httplib_read_auth_file( struct lh_ctx_t *ctx, struct file *filep, struct read_auth_file_struct *workdata );
+int			XX_httplib_read_chunked( const struct lh_ctx_t *ctx, struct lh_con_t *conn, char *buf, size_t len );
 int			XX_httplib_read_request( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn, char *buf, int bufsiz, int *nread );
 void			XX_httplib_read_websocket( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_websocket_data_handler ws_data_handler, void *callback_data );
+int64_t			XX_httplib_receive_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, FILE *fp );
 void			XX_httplib_redirect_to_https_port( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int ssl_index );
 int			XX_httplib_refresh_trust( struct lh_ctx_t *ctx, struct lh_con_t *conn );
 void			XX_httplib_remove_bad_file( struct lh_ctx_t *ctx, const struct lh_con_t *conn, const char *path );
 int			XX_httplib_remove_directory( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *dir );
 void			XX_httplib_remove_double_dots_and_double_slashes( char *s );
+int			XX_httplib_rename( const char *from, const char *to );
 void			XX_httplib_reset_per_request_attributes( struct lh_con_t *conn );
+int			XX_httplib_resolve( struct lh_ctx_t *ctx, const char *host, union usa *addrs, int max_addrs );
+void			XX_httplib_resolver_free( struct lh_ctx_t *ctx );
+bool			XX_httplib_resolver_init( struct lh_ctx_t *ctx );
+int			XX_httplib_resolver_lookup( const struct lh_ctx_t *ctx, const char *host, union usa *addrs, int max_addrs );
+LIBHTTP_THREAD		XX_httplib_resolver_thread( void *data );
 int			XX_httplib_scan_directory( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *dir, void *data, void (*cb)(struct lh_ctx_t *ctx, struct de *, void *) );
 void			XX_httplib_send_authorization_request( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+bool			XX_httplib_send_chunk( const struct lh_ctx_t *ctx, struct lh_con_t *conn, char *data, size_t len, bool last );
 void			XX_httplib_send_file_data( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct file *filep, int64_t offset, int64_t len );
 void			XX_httplib_send_http_error( struct lh_ctx_t *ctx, struct lh_con_t *, int, PRINTF_FORMAT_STRING(const char *fmt), ... ) PRINTF_ARGS(4, 5);
 int			XX_httplib_send_no_cache_header( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
+int64_t			XX_httplib_send_nonblocking( SOCKET sock, const char *buf, int64_t len );
 void			XX_httplib_send_options( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
+bool			XX_httplib_send_requests( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_out_t *out, int num_out );
 int			XX_httplib_send_static_cache_header( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
 int			XX_httplib_send_websocket_handshake( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *websock_key );
+int64_t			XX_httplib_sendv( const struct lh_ctx_t *ctx, SOCKET sock, const struct lh_out_t *out, int num_out, bool blocking );
 int			XX_httplib_set_acl_option( struct lh_ctx_t *ctx );
 void			XX_httplib_set_close_on_exec( SOCKET sock );
 bool			XX_httplib_set_gpass_option( struct lh_ctx_t *ctx );
 void			XX_httplib_set_handler_type( struct lh_ctx_t *ctx, const char *uri, int handler_type, int is_delete_request, httplib_request_handler handler, httplib_websocket_connect_handler connect_handler, httplib_websocket_ready_handler ready_handler, httplib_websocket_data_handler data_handler, httplib_websocket_close_handler close_handler, httplib_authorization_handler auth_handler, void *cbdata );
+int			XX_httplib_set_blocking_mode( SOCKET sock );
 int			XX_httplib_set_non_blocking_mode( SOCKET sock );
 int			XX_httplib_set_ports_option( struct lh_ctx_t *ctx );
-int			XX_httplib_set_sock_timeout( SOCKET sock, int milliseconds );
+int			XX_httplib_set_sock_timeout( SOCKET sock, int milliseconds, bool receive );
 int			XX_httplib_set_tcp_nodelay( SOCKET sock, bool nodelay_on );
 void			XX_httplib_set_thread_name( struct lh_ctx_t *ctx, const char *name );
 int			XX_httplib_set_throttle( const char *spec, uint32_t remote_ip, const char *uri );
 bool			XX_httplib_set_uid_option( struct lh_ctx_t *ctx );
+void			XX_httplib_shift_message( struct lh_con_t *conn );
 bool			XX_httplib_should_decode_url( const struct lh_ctx_t *ctx );
 bool			XX_httplib_should_keep_alive( const struct lh_ctx_t *ctx, const struct lh_con_t *conn );
 char *			XX_httplib_skip( char **buf, const char *delimiters );
@@ -925,15 +1788,59 @@ char *			XX_httplib_skip_quoted( char **buf, const char *delimiters, const char
 void			XX_httplib_snprintf( struct lh_ctx_t *ctx, const struct lh_con_t *conn, bool *truncated, char *buf, size_t buflen, PRINTF_FORMAT_STRING(const char *fmt), ... ) PRINTF_ARGS(6, 7);
 void			XX_httplib_sockaddr_to_string(char *buf, size_t len, const union usa *usa );
 pid_t			XX_httplib_spawn_process( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *prog, char *envblk, char *envp[], int fdin[2], int fdout[2], int fderr[2], const char *dir );
+bool			XX_httplib_start_chunked( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers, bool static_cache );
 int			XX_httplib_start_thread_with_id( httplib_thread_func_t func, void *param, pthread_t *threadidptr );
 int			XX_httplib_stat( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, struct file *filep );
 int			XX_httplib_substitute_index_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, char *path, size_t path_len, struct file *filep );
 const char *		XX_httplib_suggest_connection_header( const struct lh_ctx_t *ctx, const struct lh_con_t *conn );
+bool			XX_httplib_timer_init( struct lh_ctx_t *ctx );
+void			XX_httplib_timer_schedule( struct lh_tms_t *tms, uint32_t slot );
+void			XX_httplib_timer_sift( struct lh_tms_t *tms, uint32_t pos );
+void			XX_httplib_timer_stop( struct lh_ctx_t *ctx );
+LIBHTTP_THREAD		XX_httplib_timer_thread( void *data );
+void			XX_httplib_timer_unschedule( struct lh_tms_t *tms, uint32_t slot );
 int			XX_httplib_vprintf( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *fmt, va_list ap );
 void			XX_httplib_vsnprintf( struct lh_ctx_t *ctx, const struct lh_con_t *conn, bool *truncated, char *buf, size_t buflen, const char *fmt, va_list ap );
 LIBHTTP_THREAD		XX_httplib_websocket_client_thread( void *data );
+int			XX_httplib_websocket_check_frame( struct lh_ctx_t *ctx, struct lh_con_t *conn, unsigned char mop, uint64_t data_len, bool fragmented, size_t base );
+bool			XX_httplib_websocket_deflate( struct lh_con_t *conn, const char *data, size_t len, const char **out, size_t *out_len );
+bool			XX_httplib_websocket_deflate_accept( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *response );
+void			XX_httplib_websocket_deflate_free( struct lh_con_t *conn );
+bool			XX_httplib_websocket_deflate_init( struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_pmp_t *pmp );
+bool			XX_httplib_websocket_deflate_negotiate( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *offers, char *response, size_t response_len );
+bool			XX_httplib_websocket_deflate_params( const char *ext, size_t len, struct lh_pmp_t *pmp );
+size_t			XX_httplib_websocket_frame_header( unsigned char *header, int opcode, size_t data_len, uint32_t masking_key );
+void			XX_httplib_websocket_frame_release( struct lh_wsf_t *frame );
+bool			XX_httplib_websocket_group_begin( struct lh_wsg_t *group, struct lh_wsi_t *iter );
+void			XX_httplib_websocket_group_end( struct lh_wsg_t *group, struct lh_wsi_t *iter );
+bool			XX_httplib_websocket_group_lock( struct lh_wsg_t *group, struct lh_wsi_t *iter, struct lh_con_t *conn );
+struct lh_con_t *	XX_httplib_websocket_group_next( struct lh_wsg_t *group, struct lh_wsi_t *iter );
+int			XX_httplib_websocket_inflate( struct lh_con_t *conn, const char *data, size_t len, size_t max_len, char **out, size_t *out_len );
+bool			XX_httplib_websocket_keepalive( struct lh_ctx_t *ctx, void *cbdata );
+void			XX_httplib_websocket_keepalive_add( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+void			XX_httplib_websocket_keepalive_remove( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+void			XX_httplib_websocket_mask( char *out, const char *in, size_t len, const unsigned char key[4], size_t phase );
+size_t			XX_httplib_websocket_parse_header( const unsigned char *hdr, size_t len, uint64_t *data_len );
+int			XX_httplib_websocket_queue_frame( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsf_t *frame );
+void			XX_httplib_websocket_queue_free( struct lh_con_t *conn );
+int			XX_httplib_websocket_queue_limit( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
+bool			XX_httplib_websocket_reactor_add( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_websocket_ready_handler ready_handler, httplib_websocket_data_handler data_handler, httplib_websocket_close_handler close_handler, void *cbdata );
+void			XX_httplib_websocket_reactor_close( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+void			XX_httplib_websocket_reactor_dispatch( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+void			XX_httplib_websocket_reactor_free( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+bool			XX_httplib_websocket_reactor_parse( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx, char *buf, size_t len );
+bool			XX_httplib_websocket_reactor_queue( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx, int opcode, const char *data, size_t len );
+void			XX_httplib_websocket_reactor_schedule( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+void			XX_httplib_websocket_reactor_stop( struct lh_ctx_t *ctx );
+LIBHTTP_THREAD		XX_httplib_websocket_reactor_thread( void *data );
+bool			XX_httplib_websocket_reactor_watch( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+void			XX_httplib_websocket_send_close( const struct lh_ctx_t *ctx, struct lh_con_t *conn, uint16_t code );
+int			XX_httplib_websocket_send_pending( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool blocking );
 int			XX_httplib_websocket_write_exec( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int opcode, const char *data, size_t dataLen, uint32_t masking_key );
+struct lh_wsz_t *	XX_httplib_websocket_zstream_get( struct lh_wzp_t *pool, bool deflate, int window_bits, int level );
+void			XX_httplib_websocket_zstream_put( struct lh_wzp_t *pool, struct lh_wsz_t *zs );
 LIBHTTP_THREAD		XX_httplib_worker_thread( void *thread_func_param );
+int			XX_httplib_write_raw( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *buf, size_t len );
 
 
 
@@ -959,5 +1866,8 @@ extern pthread_mutexattr_t			XX_httplib_pthread_mutex_attr;
 #endif /* _WIN32 */
 
 extern const struct uriprot_tp		XX_httplib_abs_uri_protocols[];
+extern const char * const		XX_httplib_encoding_ext[];
+extern const char * const		XX_httplib_compress_name[];
+extern const char * const		XX_httplib_encoding_name[];
 extern int				XX_httplib_sTlsInit;
 extern pthread_key_t			XX_httplib_sTlsKey;
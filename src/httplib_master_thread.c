@@ -152,6 +152,13 @@ static void master_thread_run(void *thread_func_param) {
 
 	XX_httplib_close_all_listening_sockets( ctx );
 
+	/*
+	 * Stop the timer thread first, so that no timer handlers run while
+	 * the other threads and their connections are shut down.
+	 */
+
+	XX_httplib_timer_stop( ctx );
+
 	/*
 	 * Wakeup workers that are waiting for connections to handle.
 	 */
@@ -184,6 +191,17 @@ static void master_thread_run(void *thread_func_param) {
 		if ( ctx->workerthreadids[i] != 0 ) httplib_pthread_join( ctx->workerthreadids[i], NULL );
 	}
 
+	/*
+	 * Join the websocket reactor thread and close the websocket
+	 * connections which it served.
+	 */
+
+	if ( ctx->enable_websocket_reactor ) {
+
+		httplib_pthread_join( ctx->ws_reactor_threadid, NULL );
+		XX_httplib_websocket_reactor_stop( ctx );
+	}
+
 #if !defined(NO_SSL)
 	if ( ctx->ssl_ctx != NULL ) XX_httplib_uninitialize_ssl( ctx );
 #endif
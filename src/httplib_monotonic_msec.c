@@ -0,0 +1,45 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int64_t XX_httplib_monotonic_msec( void );
+ *
+ * The function XX_httplib_monotonic_msec() returns the time in milliseconds
+ * of the monotonic clock of the system. The value is only meaningful when
+ * compared with other values returned by the function, but is not affected
+ * when the wall clock time of the system is changed.
+ */
+
+int64_t XX_httplib_monotonic_msec( void ) {
+
+	struct timespec now;
+
+	clock_gettime( CLOCK_MONOTONIC, & now );
+
+	return ((int64_t)now.tv_sec) * 1000 + (int64_t)(now.tv_nsec / 1000000);
+
+}  /* XX_httplib_monotonic_msec */
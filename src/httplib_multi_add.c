@@ -0,0 +1,91 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_multi_add( struct lh_mlt_t *multi, const char *host, int port, int use_ssl, const struct lh_req_t *request, void *user_data );
+ *
+ * The function httplib_multi_add() queues a request to a host in a multi
+ * handle. The request is sent during the next call to
+ * httplib_multi_perform(). The user data is returned with the result of the
+ * transfer. The function returns 0 if the request was queued and -1 if an
+ * error occured.
+ *
+ * Requests with a method which is idempotent according to RFC 7231 are
+ * pipelined with other queued requests to the same host and may be sent
+ * again when the connection is closed before the response arrived.
+ */
+
+int httplib_multi_add( struct lh_mlt_t *multi, const char *host, int port, int use_ssl, const struct lh_req_t *request, void *user_data ) {
+
+	struct lh_mxf_t *xfer;
+	const char *method;
+
+	if ( multi == NULL  ||  host == NULL  ||  request == NULL  ||  port <= 0  ||  port > 65535 ) return -1;
+
+	xfer = httplib_calloc( 1, sizeof(struct lh_mxf_t) );
+	if ( xfer == NULL ) return -1;
+
+	xfer->host = httplib_strdup( host );
+	xfer->data = XX_httplib_build_request( request, & xfer->data_len );
+
+	if ( xfer->host == NULL  ||  xfer->data == NULL ) {
+
+		xfer->host = httplib_free( xfer->host );
+		xfer->data = httplib_free( xfer->data );
+		xfer       = httplib_free( xfer       );
+
+		return -1;
+	}
+
+	method = ( request->method != NULL ) ? request->method : "GET";
+
+	xfer->next       = NULL;
+	xfer->port       = port;
+	xfer->use_ssl    = ( use_ssl != 0 );
+	xfer->no_body    = ( ! strcmp( method, "HEAD" ) );
+	xfer->idempotent = ( ! strcmp( method, "GET"     )  ||
+			     ! strcmp( method, "HEAD"    )  ||
+			     ! strcmp( method, "PUT"     )  ||
+			     ! strcmp( method, "DELETE"  )  ||
+			     ! strcmp( method, "OPTIONS" )  ||
+			     ! strcmp( method, "TRACE"   )     );
+	xfer->attempts   = 0;
+	xfer->user_data  = user_data;
+	xfer->status     = -1;
+	xfer->body       = NULL;
+	xfer->body_len   = 0;
+	xfer->body_size  = 0;
+
+	if ( multi->queue_last == NULL ) multi->queue_first      = xfer;
+	else                             multi->queue_last->next = xfer;
+
+	multi->queue_last = xfer;
+	multi->num_running++;
+
+	return 0;
+
+}  /* httplib_multi_add */
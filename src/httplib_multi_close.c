@@ -0,0 +1,119 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_multi_close( struct lh_mlt_t *multi, struct lh_mcn_t *mcn, bool failed );
+ *
+ * The function XX_httplib_multi_close() removes a connection from a multi
+ * handle. If all responses were received and the connection didn't fail, it
+ * is handed back to the connection pool of the context. Otherwise it is
+ * closed and the transfers which are still waiting for a response are either
+ * queued again or finished as failed.
+ *
+ * A request is only sent again if it was sent at most once before and
+ * nothing of its response was received. Requests with methods that are not
+ * idempotent are only sent again if they were the first request on a pooled
+ * connection which the server closed before any data came back, because a
+ * server which closes an idle connection can't have processed them.
+ */
+
+void XX_httplib_multi_close( struct lh_mlt_t *multi, struct lh_mcn_t *mcn, bool failed ) {
+
+	struct lh_mcn_t *walk;
+	struct lh_mcn_t *prev;
+	struct lh_mxf_t *xfer;
+	struct lh_mxf_t *next;
+	struct lh_mxf_t *retry_first;
+	struct lh_mxf_t *retry_last;
+	struct lh_con_t *conn;
+	bool untouched;
+	bool retry;
+
+	if ( multi == NULL  ||  mcn == NULL ) return;
+
+	prev = NULL;
+	for (walk=multi->conns; walk != NULL  &&  walk != mcn; walk=walk->next) prev = walk;
+
+	if ( walk != NULL ) {
+
+		if ( prev == NULL ) multi->conns = mcn->next;
+		else                prev->next   = mcn->next;
+	}
+
+	conn        = mcn->conn;
+	untouched   = ( ! mcn->in_body  &&  conn->request_len == 0  &&  conn->data_len == 0 );
+	retry_first = NULL;
+	retry_last  = NULL;
+
+	for (xfer=mcn->first; xfer != NULL; xfer=next) {
+
+		next       = xfer->next;
+		xfer->next = NULL;
+
+		if ( xfer == mcn->first ) retry = ( ! mcn->in_body  &&  ( xfer->idempotent  ||  ( untouched  &&  conn->pool_reused ) ) );
+		else                      retry = xfer->idempotent;
+
+		if ( xfer->attempts >= 2 ) retry = false;
+
+		if ( retry ) {
+
+			xfer->body      = httplib_free( xfer->body );
+			xfer->body_len  = 0;
+			xfer->body_size = 0;
+
+			if ( retry_last == NULL ) retry_first      = xfer;
+			else                      retry_last->next = xfer;
+
+			retry_last = xfer;
+		}
+
+		else XX_httplib_multi_done( multi, xfer, -1 );
+	}
+
+	/*
+	 * Requests which are sent again go to the front of the queue to keep
+	 * them ahead of requests which were added later.
+	 */
+
+	if ( retry_last != NULL ) {
+
+		retry_last->next   = multi->queue_first;
+		multi->queue_first = retry_first;
+
+		if ( multi->queue_last == NULL ) multi->queue_last = retry_last;
+	}
+
+	if ( failed ) XX_httplib_free_client_connection( multi->ctx, conn );
+
+	else {
+		XX_httplib_set_blocking_mode( conn->client.sock );
+		httplib_close_connection( multi->ctx, conn );
+	}
+
+	mcn = httplib_free( mcn );
+
+}  /* XX_httplib_multi_close */
@@ -0,0 +1,59 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * struct lh_mlt_t *httplib_multi_create( struct lh_ctx_t *ctx );
+ *
+ * The function httplib_multi_create() creates a multi handle which runs a
+ * number of client transfers concurrently from the thread of the caller.
+ * Transfers are added with httplib_multi_add(), driven with
+ * httplib_multi_perform() and their results are collected with
+ * httplib_multi_read(). The context must be a client context, because the
+ * connections are taken from and returned to its connection pool. NULL is
+ * returned if an error occured.
+ */
+
+struct lh_mlt_t *httplib_multi_create( struct lh_ctx_t *ctx ) {
+
+	struct lh_mlt_t *multi;
+
+	if ( ctx == NULL  ||  ctx->ctx_type != CTX_TYPE_CLIENT ) return NULL;
+
+	multi = httplib_calloc( 1, sizeof(struct lh_mlt_t) );
+	if ( multi == NULL ) return NULL;
+
+	multi->ctx         = ctx;
+	multi->queue_first = NULL;
+	multi->queue_last  = NULL;
+	multi->conns       = NULL;
+	multi->done_first  = NULL;
+	multi->done_last   = NULL;
+	multi->num_running = 0;
+
+	return multi;
+
+}  /* httplib_multi_create */
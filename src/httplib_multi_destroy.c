@@ -0,0 +1,87 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static void			free_transfers( struct lh_mxf_t *xfer );
+
+/*
+ * void httplib_multi_destroy( struct lh_mlt_t *multi );
+ *
+ * The function httplib_multi_destroy() releases a multi handle. Transfers
+ * which have not finished are aborted and their connections are closed.
+ * Results which were not read by the application are discarded.
+ */
+
+void httplib_multi_destroy( struct lh_mlt_t *multi ) {
+
+	struct lh_mcn_t *mcn;
+
+	if ( multi == NULL ) return;
+
+	while ( multi->conns != NULL ) {
+
+		mcn          = multi->conns;
+		multi->conns = mcn->next;
+
+		XX_httplib_free_client_connection( multi->ctx, mcn->conn );
+
+		free_transfers( mcn->first );
+		mcn = httplib_free( mcn );
+	}
+
+	free_transfers( multi->queue_first );
+	free_transfers( multi->done_first  );
+
+	multi = httplib_free( multi );
+
+}  /* httplib_multi_destroy */
+
+
+
+/*
+ * static void free_transfers( struct lh_mxf_t *xfer );
+ *
+ * The function free_transfers() releases a list of transfers together with
+ * their requests and the received bodies.
+ */
+
+static void free_transfers( struct lh_mxf_t *xfer ) {
+
+	struct lh_mxf_t *next;
+
+	while ( xfer != NULL ) {
+
+		next = xfer->next;
+
+		xfer->host = httplib_free( xfer->host );
+		xfer->data = httplib_free( xfer->data );
+		xfer->body = httplib_free( xfer->body );
+		xfer       = httplib_free( xfer       );
+
+		xfer = next;
+	}
+
+}  /* free_transfers */
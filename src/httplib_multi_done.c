@@ -0,0 +1,67 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_multi_done( struct lh_mlt_t *multi, struct lh_mxf_t *xfer, int status );
+ *
+ * The function XX_httplib_multi_done() finishes a transfer of a multi handle
+ * with a status code, or with -1 if the transfer failed. The transfer is
+ * moved to the list of finished transfers where the application picks it up
+ * with httplib_multi_read(). The request itself is not needed anymore and
+ * its memory is released. A successful transfer always has a NUL terminated
+ * body, which is empty if the response had no body.
+ */
+
+void XX_httplib_multi_done( struct lh_mlt_t *multi, struct lh_mxf_t *xfer, int status ) {
+
+	if ( multi == NULL  ||  xfer == NULL ) return;
+
+	xfer->next     = NULL;
+	xfer->status   = status;
+	xfer->data     = httplib_free( xfer->data );
+	xfer->data_len = 0;
+
+	if ( status < 0 ) {
+
+		xfer->body      = httplib_free( xfer->body );
+		xfer->body_len  = 0;
+		xfer->body_size = 0;
+	}
+
+	else if ( xfer->body == NULL ) {
+
+		xfer->body = httplib_calloc( 1, 1 );
+		if ( xfer->body == NULL ) xfer->status = -1;
+	}
+
+	if ( multi->done_last == NULL ) multi->done_first      = xfer;
+	else                            multi->done_last->next = xfer;
+
+	multi->done_last = xfer;
+	multi->num_running--;
+
+}  /* XX_httplib_multi_done */
@@ -0,0 +1,159 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+#include "httplib_ssl.h"
+
+static bool			data_pending( const struct lh_con_t *conn );
+
+/*
+ * int httplib_multi_perform( struct lh_mlt_t *multi, int timeout );
+ *
+ * The function httplib_multi_perform() drives the transfers of a multi
+ * handle. Queued requests are sent, and the responses are received from all
+ * connections at once with one call to poll(). The function returns when all
+ * transfers finished or after timeout milliseconds, where a negative timeout
+ * waits until all transfers finished. The number of transfers which are
+ * still running is returned, or -1 if an error occured. A connection which
+ * didn't receive data for longer than the request_timeout of the context is
+ * closed.
+ */
+
+int httplib_multi_perform( struct lh_mlt_t *multi, int timeout ) {
+
+	struct pollfd *pfd;
+	struct lh_mcn_t **mcns;
+	struct lh_mcn_t *mcn;
+	int64_t start;
+	int64_t now;
+	int64_t idle;
+	int num;
+	int wait;
+	int a;
+	int n;
+
+	if ( multi == NULL ) return -1;
+
+	start = XX_httplib_monotonic_msec();
+
+	for (;;) {
+
+		XX_httplib_multi_start( multi );
+
+		num = 0;
+		for (mcn=multi->conns; mcn != NULL; mcn=mcn->next) num++;
+
+		if ( num == 0 ) break;
+
+		pfd  = httplib_malloc( (size_t)num * sizeof(struct pollfd)     );
+		mcns = httplib_malloc( (size_t)num * sizeof(struct lh_mcn_t *) );
+
+		if ( pfd == NULL  ||  mcns == NULL ) {
+
+			pfd  = httplib_free( pfd  );
+			mcns = httplib_free( mcns );
+
+			return -1;
+		}
+
+		now  = XX_httplib_monotonic_msec();
+		wait = -1;
+		if ( timeout >= 0 ) wait = ( now - start < timeout ) ? (int)( timeout - ( now - start ) ) : 0;
+
+		a = 0;
+
+		for (mcn=multi->conns; mcn != NULL; mcn=mcn->next) {
+
+			pfd[a].fd      = mcn->conn->client.sock;
+			pfd[a].events  = POLLIN;
+			pfd[a].revents = 0;
+			mcns[a]        = mcn;
+			a++;
+
+			if ( data_pending( mcn->conn ) ) wait = 0;
+
+			if ( mcn->conn->request_timeout > 0 ) {
+
+				idle = mcn->last_rx + mcn->conn->request_timeout - now;
+				if ( idle < 0                         ) idle = 0;
+				if ( wait < 0  ||  idle < (int64_t)wait ) wait = (int)idle;
+			}
+		}
+
+		n = httplib_poll( pfd, (unsigned int)num, wait );
+
+		if ( n < 0  &&  ERRNO != EINTR ) {
+
+			pfd  = httplib_free( pfd  );
+			mcns = httplib_free( mcns );
+
+			return -1;
+		}
+
+		now = XX_httplib_monotonic_msec();
+
+		for (a=0; a<num; a++) {
+
+			mcn = mcns[a];
+
+			if ( ( n > 0  &&  pfd[a].revents != 0 )  ||  data_pending( mcn->conn ) ) XX_httplib_multi_receive( multi, mcn );
+
+			else if ( mcn->conn->request_timeout > 0  &&  now - mcn->last_rx >= mcn->conn->request_timeout ) {
+
+				httplib_cry( LH_DEBUG_WARNING, multi->ctx, mcn->conn, "%s: timeout waiting for a response", __func__ );
+				XX_httplib_multi_close( multi, mcn, true );
+			}
+		}
+
+		pfd  = httplib_free( pfd  );
+		mcns = httplib_free( mcns );
+
+		if ( timeout >= 0  &&  XX_httplib_monotonic_msec() - start >= timeout ) break;
+	}
+
+	return multi->num_running;
+
+}  /* httplib_multi_perform */
+
+
+
+/*
+ * static bool data_pending( const struct lh_con_t *conn );
+ *
+ * The function data_pending() returns true if the SSL layer of a connection
+ * already holds decrypted data which poll() doesn't see on the socket.
+ */
+
+static bool data_pending( const struct lh_con_t *conn ) {
+
+#if !defined(NO_SSL)
+	if ( conn->ssl != NULL  &&  SSL_pending( conn->ssl ) > 0 ) return true;
+#else  /* NO_SSL */
+	UNUSED_PARAMETER(conn);
+#endif  /* NO_SSL */
+
+	return false;
+
+}  /* data_pending */
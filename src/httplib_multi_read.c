@@ -0,0 +1,60 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * bool httplib_multi_read( struct lh_mlt_t *multi, struct lh_mrs_t *result );
+ *
+ * The function httplib_multi_read() returns the result of the transfer of a
+ * multi handle which finished first and wasn't read yet. The body of the
+ * response becomes property of the caller who must release it with
+ * httplib_free(). The function returns false if no finished transfer is
+ * available.
+ */
+
+bool httplib_multi_read( struct lh_mlt_t *multi, struct lh_mrs_t *result ) {
+
+	struct lh_mxf_t *xfer;
+
+	if ( multi == NULL  ||  result == NULL ) return false;
+
+	xfer = multi->done_first;
+	if ( xfer == NULL ) return false;
+
+	multi->done_first = xfer->next;
+	if ( multi->done_first == NULL ) multi->done_last = NULL;
+
+	result->user_data = xfer->user_data;
+	result->status    = xfer->status;
+	result->body      = xfer->body;
+	result->body_len  = xfer->body_len;
+
+	xfer->host = httplib_free( xfer->host );
+	xfer       = httplib_free( xfer       );
+
+	return true;
+
+}  /* httplib_multi_read */
@@ -0,0 +1,437 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+#include "httplib_ssl.h"
+
+#ifdef _WIN32
+	typedef int len_t;
+#else
+	typedef size_t len_t;
+#endif
+
+static bool			append_body( struct lh_mxf_t *xfer, const char *data, size_t len );
+static void			finish_transfer( struct lh_mlt_t *multi, struct lh_mcn_t *mcn );
+static bool			keep_alive( const struct lh_con_t *conn );
+static int			parse_header( struct lh_ctx_t *ctx, struct lh_mcn_t *mcn, struct lh_mxf_t *xfer );
+static bool			process_buffer( struct lh_mlt_t *multi, struct lh_mcn_t *mcn );
+static int			recv_nonblocking( struct lh_con_t *conn, char *buf, int len );
+
+/*
+ * bool XX_httplib_multi_receive( struct lh_mlt_t *multi, struct lh_mcn_t *mcn );
+ *
+ * The function XX_httplib_multi_receive() reads all data which is available
+ * on a connection of a multi handle without blocking and processes the
+ * responses in it. Every complete response finishes the transfer it belongs
+ * to. The function returns true if the connection is still waiting for more
+ * responses, and false if it was removed from the multi handle, either
+ * because all responses were received or because the connection was closed.
+ */
+
+bool XX_httplib_multi_receive( struct lh_mlt_t *multi, struct lh_mcn_t *mcn ) {
+
+	struct lh_con_t *conn;
+	struct lh_mxf_t *xfer;
+	int n;
+
+	if ( multi == NULL  ||  mcn == NULL ) return false;
+
+	conn = mcn->conn;
+
+	if ( conn->buf == NULL  &&  ! XX_httplib_buffer_grow( multi->ctx, conn ) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, multi->ctx, conn, "%s: cannot allocate receive buffer, OOM", __func__ );
+		XX_httplib_multi_close( multi, mcn, true );
+		return false;
+	}
+
+	for (;;) {
+
+		if ( ! process_buffer( multi, mcn ) ) return false;
+
+		/*
+		 * The body data in the buffer was already copied to the transfer,
+		 * so it can be dropped when the buffer is full. The headers must
+		 * stay, because the request info points into them. A header which
+		 * doesn't fit in the rest of the buffer is moved to its start, and
+		 * the buffer grows if the header doesn't fit in it at all.
+		 */
+
+		if ( conn->data_len >= conn->buf_size  &&  mcn->in_body ) {
+
+			if ( conn->content_len >= 0 ) conn->content_len -= conn->consumed_content;
+
+			conn->consumed_content = 0;
+			conn->data_len         = conn->request_len;
+		}
+
+		if ( conn->data_len >= conn->buf_size ) XX_httplib_buffer_compact( conn );
+
+		if ( conn->data_len >= conn->buf_size  &&  ( mcn->in_body  ||  ! XX_httplib_buffer_grow( multi->ctx, conn ) ) ) {
+
+			httplib_cry( LH_DEBUG_ERROR, multi->ctx, conn, "%s: response header too large", __func__ );
+			XX_httplib_multi_close( multi, mcn, true );
+			return false;
+		}
+
+		n = recv_nonblocking( conn, conn->buf + conn->data_len, conn->buf_size - conn->data_len );
+
+		if ( n > 0 ) {
+
+			conn->data_len += n;
+			mcn->last_rx    = XX_httplib_monotonic_msec();
+			continue;
+		}
+
+		if ( n == -1 ) return true;
+
+		/*
+		 * A response without length and without chunked encoding ends
+		 * when the server closes the connection. Like with an announced
+		 * close, the following requests were not answered and sending
+		 * them again isn't a retry.
+		 */
+
+		if ( n == 0  &&  mcn->in_body  &&  ! conn->is_chunked  &&  conn->content_len < 0 ) {
+
+			finish_transfer( multi, mcn );
+			for (xfer=mcn->first; xfer != NULL; xfer=xfer->next) xfer->attempts--;
+		}
+
+		XX_httplib_multi_close( multi, mcn, true );
+		return false;
+	}
+
+}  /* XX_httplib_multi_receive */
+
+
+
+/*
+ * static bool process_buffer( struct lh_mlt_t *multi, struct lh_mcn_t *mcn );
+ *
+ * The function process_buffer() processes the responses which are in the
+ * receive buffer of a connection of a multi handle. It returns true if more
+ * data is needed, and false if the connection was removed from the multi
+ * handle.
+ */
+
+static bool process_buffer( struct lh_mlt_t *multi, struct lh_mcn_t *mcn ) {
+
+	struct lh_con_t *conn;
+	struct lh_mxf_t *xfer;
+	const char *data;
+	size_t len;
+	int64_t avail;
+	int ret;
+
+	conn = mcn->conn;
+
+	while ( (xfer = mcn->first) != NULL ) {
+
+		if ( ! mcn->in_body ) {
+
+			ret = parse_header( multi->ctx, mcn, xfer );
+
+			if ( ret <  0     ) { XX_httplib_multi_close( multi, mcn, true ); return false; }
+			if ( ret == 0     ) return true;
+			if ( ! mcn->in_body ) continue;
+		}
+
+		if ( conn->is_chunked ) {
+
+			for (;;) {
+
+				ret = XX_httplib_chunked_view( multi->ctx, conn, false, & data, & len );
+
+				if ( ret < 0  ) { XX_httplib_multi_close( multi, mcn, true ); return false; }
+				if ( ret == 0 ) break;
+				if ( len == 0 ) return true;
+
+				if ( ! append_body( xfer, data, len ) ) { XX_httplib_multi_close( multi, mcn, true ); return false; }
+
+				httplib_consume_body( multi->ctx, conn, len );
+			}
+		}
+
+		else {
+			avail = (int64_t)conn->data_len - (int64_t)conn->request_len - conn->consumed_content;
+			if ( conn->content_len >= 0  &&  avail > conn->content_len - conn->consumed_content ) avail = conn->content_len - conn->consumed_content;
+
+			if ( avail > 0 ) {
+
+				if ( ! append_body( xfer, conn->buf + conn->request_len + conn->consumed_content, (size_t)avail ) ) { XX_httplib_multi_close( multi, mcn, true ); return false; }
+
+				conn->consumed_content += avail;
+			}
+
+			if ( conn->content_len < 0  ||  conn->consumed_content < conn->content_len ) return true;
+		}
+
+		finish_transfer( multi, mcn );
+
+		/*
+		 * After the last response the connection goes back to the pool,
+		 * which decides itself whether it can be used again.
+		 */
+
+		if ( mcn->first == NULL ) {
+
+			XX_httplib_multi_close( multi, mcn, false );
+			return false;
+		}
+
+		/*
+		 * The server announced that it closes the connection after this
+		 * response, so it didn't process any of the following requests
+		 * and sending them again isn't a retry.
+		 */
+
+		if ( ! keep_alive( conn ) ) {
+
+			for (xfer=mcn->first; xfer != NULL; xfer=xfer->next) xfer->attempts--;
+
+			XX_httplib_multi_close( multi, mcn, true );
+			return false;
+		}
+	}
+
+	return true;
+
+}  /* process_buffer */
+
+
+
+/*
+ * static int parse_header( struct lh_ctx_t *ctx, struct lh_mcn_t *mcn, struct lh_mxf_t *xfer );
+ *
+ * The function parse_header() parses the header of the next response on a
+ * connection of a multi handle, after the previous response was removed from
+ * the buffer. The function returns 1 if a header was parsed, 0 if it isn't
+ * complete yet and -1 if the response is malformed. Interim responses are
+ * parsed but don't start the body of the transfer.
+ */
+
+static int parse_header( struct lh_ctx_t *ctx, struct lh_mcn_t *mcn, struct lh_mxf_t *xfer ) {
+
+	struct lh_con_t *conn;
+	const char *cl;
+	char *endptr;
+	int len;
+	int status;
+
+	conn = mcn->conn;
+
+	XX_httplib_shift_message( conn );
+
+	len = XX_httplib_get_request_len( conn->buf, conn->data_len );
+	if ( len == 0 ) return 0;
+
+	XX_httplib_reset_per_request_attributes( conn );
+
+	if ( len < 0  ||  XX_httplib_parse_http_message( conn->buf, len, & conn->request_info ) <= 0  ||  httplib_strncasecmp( conn->request_info.request_method, "HTTP/", 5 ) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: malformed response from %s", __func__, xfer->host );
+		return -1;
+	}
+
+	conn->request_len      = len;
+	conn->request_info.uri = conn->request_info.request_uri;
+	status                 = atoi( conn->request_info.request_uri );
+
+	if ( status < 100 ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: invalid status from %s", __func__, xfer->host );
+		return -1;
+	}
+
+	if ( status < 200  &&  status != 101 ) {
+
+		conn->content_len = 0;
+		return 1;
+	}
+
+	if ( xfer->no_body  ||  status == 101  ||  status == 204  ||  status == 304 ) conn->content_len = 0;
+
+	else if ( (cl = XX_httplib_get_header( & conn->request_info, "Content-Length" )) != NULL ) {
+
+		endptr            = NULL;
+		conn->content_len = strtoll( cl, & endptr, 10 );
+
+		if ( endptr == cl  ||  conn->content_len < 0 ) {
+
+			httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: invalid content length from %s", __func__, xfer->host );
+			return -1;
+		}
+
+		conn->request_info.content_length = conn->content_len;
+	}
+
+	else if ( (cl = XX_httplib_get_header( & conn->request_info, "Transfer-Encoding" )) != NULL  &&  ! httplib_strcasecmp( cl, "chunked" ) ) {
+
+		conn->is_chunked  = 1;
+		conn->content_len = 0;
+	}
+
+	else {
+		conn->content_len = -1;
+		conn->must_close  = true;
+	}
+
+	xfer->status = status;
+	mcn->in_body = true;
+
+	return 1;
+
+}  /* parse_header */
+
+
+
+/*
+ * static void finish_transfer( struct lh_mlt_t *multi, struct lh_mcn_t *mcn );
+ *
+ * The function finish_transfer() finishes the transfer of which the
+ * response was received completely and removes it from its connection.
+ */
+
+static void finish_transfer( struct lh_mlt_t *multi, struct lh_mcn_t *mcn ) {
+
+	struct lh_mxf_t *xfer;
+
+	xfer         = mcn->first;
+	mcn->first   = xfer->next;
+	mcn->in_body = false;
+
+	if ( mcn->first == NULL ) mcn->last = NULL;
+
+	XX_httplib_multi_done( multi, xfer, xfer->status );
+
+}  /* finish_transfer */
+
+
+
+/*
+ * static bool keep_alive( const struct lh_con_t *conn );
+ *
+ * The function keep_alive() returns true if the server keeps a connection
+ * open after the response which was received last.
+ */
+
+static bool keep_alive( const struct lh_con_t *conn ) {
+
+	const char *http_version;
+	const char *header;
+
+	if ( conn->must_close ) return false;
+
+	http_version = conn->request_info.request_method;
+	header       = httplib_get_header( conn, "Connection" );
+
+	if ( header != NULL  &&  XX_httplib_header_has_option( header, "close" ) ) return false;
+	if ( ! strcmp( http_version+5, "1.1" )                                  ) return true;
+
+	return ( header != NULL  &&  XX_httplib_header_has_option( header, "keep-alive" ) );
+
+}  /* keep_alive */
+
+
+
+/*
+ * static bool append_body( struct lh_mxf_t *xfer, const char *data, size_t len );
+ *
+ * The function append_body() appends data to the response body of a
+ * transfer. The buffer grows by doubling its size and always has room for
+ * a terminating NUL character. False is returned if no memory is available.
+ */
+
+static bool append_body( struct lh_mxf_t *xfer, const char *data, size_t len ) {
+
+	size_t size;
+	char *body;
+
+	if ( xfer->body_len + len + 1 > xfer->body_size ) {
+
+		size = ( xfer->body_size > 0 ) ? xfer->body_size : 1024;
+		while ( size < xfer->body_len + len + 1 ) size *= 2;
+
+		body = httplib_realloc( xfer->body, size );
+		if ( body == NULL ) return false;
+
+		xfer->body      = body;
+		xfer->body_size = size;
+	}
+
+	memcpy( xfer->body + xfer->body_len, data, len );
+	xfer->body_len             += len;
+	xfer->body[xfer->body_len]  = '\0';
+
+	return true;
+
+}  /* append_body */
+
+
+
+/*
+ * static int recv_nonblocking( struct lh_con_t *conn, char *buf, int len );
+ *
+ * The function recv_nonblocking() reads data from a connection which is in
+ * non-blocking mode. It returns the number of bytes read, 0 if the peer
+ * closed the connection, -1 if no data is available right now and -2 if an
+ * error occured.
+ */
+
+static int recv_nonblocking( struct lh_con_t *conn, char *buf, int len ) {
+
+	int n;
+	int err;
+
+#if !defined(NO_SSL)
+	if ( conn->ssl != NULL ) {
+
+		n = SSL_read( conn->ssl, buf, len );
+		if ( n > 0 ) return n;
+
+		err = SSL_get_error( conn->ssl, n );
+
+		if ( err == SSL_ERROR_WANT_READ  ||  err == SSL_ERROR_WANT_WRITE ) return -1;
+		if ( err == SSL_ERROR_ZERO_RETURN                               ) return 0;
+
+		return -2;
+	}
+#endif  /* !NO_SSL */
+
+	n = (int)recv( conn->client.sock, buf, (len_t)len, 0 );
+	if ( n >= 0 ) return n;
+
+#if defined(_WIN32)
+	err = WSAGetLastError();
+	if ( err == WSAEWOULDBLOCK  ||  err == WSAEINTR ) return -1;
+#else  /* _WIN32 */
+	err = ERRNO;
+	if ( err == EAGAIN  ||  err == EWOULDBLOCK  ||  err == EINTR ) return -1;
+#endif  /* _WIN32 */
+
+	return -2;
+
+}  /* recv_nonblocking */
@@ -0,0 +1,206 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static struct lh_mxf_t *	take_batch( struct lh_mlt_t *multi, int *num );
+static struct lh_con_t *	send_batch( struct lh_mlt_t *multi, struct lh_mxf_t *first, int num );
+
+/*
+ * void XX_httplib_multi_start( struct lh_mlt_t *multi );
+ *
+ * The function XX_httplib_multi_start() sends all queued requests of a multi
+ * handle. Requests to the same host are grouped and pipelined on one
+ * connection, up to the number of requests configured with the option
+ * client_pipeline_depth. Every group is sent with one write over a
+ * connection from the pool of the context, or over a new connection if no
+ * idle one is available. The connection is then switched to non-blocking
+ * mode so that the responses of all connections can be received from one
+ * thread.
+ *
+ * Connections are still set up blocking, so a slow connect delays the other
+ * transfers of the handle.
+ */
+
+void XX_httplib_multi_start( struct lh_mlt_t *multi ) {
+
+	struct lh_mxf_t *first;
+	struct lh_mxf_t *xfer;
+	struct lh_mxf_t *next;
+	struct lh_mcn_t *mcn;
+	struct lh_con_t *conn;
+	int num;
+
+	if ( multi == NULL ) return;
+
+	while ( multi->queue_first != NULL ) {
+
+		first = take_batch( multi, & num );
+		conn  = send_batch( multi, first, num );
+		mcn   = NULL;
+
+		if ( conn != NULL ) {
+
+			mcn = httplib_calloc( 1, sizeof(struct lh_mcn_t) );
+			if ( mcn == NULL ) XX_httplib_free_client_connection( multi->ctx, conn );
+		}
+
+		if ( mcn == NULL ) {
+
+			for (xfer=first; xfer != NULL; xfer=next) {
+
+				next = xfer->next;
+				XX_httplib_multi_done( multi, xfer, -1 );
+			}
+
+			continue;
+		}
+
+		XX_httplib_set_non_blocking_mode( conn->client.sock );
+
+		mcn->conn    = conn;
+		mcn->first   = first;
+		mcn->in_body = false;
+		mcn->last_rx = XX_httplib_monotonic_msec();
+
+		for (mcn->last=first; mcn->last->next != NULL; mcn->last=mcn->last->next) continue;
+
+		mcn->next    = multi->conns;
+		multi->conns = mcn;
+	}
+
+}  /* XX_httplib_multi_start */
+
+
+
+/*
+ * static struct lh_mxf_t *take_batch( struct lh_mlt_t *multi, int *num );
+ *
+ * The function take_batch() removes the first queued transfer of a multi
+ * handle from the queue together with the following transfers to the same
+ * host which may be pipelined with it. The transfers are returned as a list
+ * in the order they were queued and the number of transfers is stored in
+ * num.
+ */
+
+static struct lh_mxf_t *take_batch( struct lh_mlt_t *multi, int *num ) {
+
+	struct lh_mxf_t *first;
+	struct lh_mxf_t *last;
+	struct lh_mxf_t *xfer;
+	struct lh_mxf_t *prev;
+	struct lh_mxf_t *next;
+	int depth;
+
+	depth = multi->ctx->client_pipeline_depth;
+	if ( depth < 1                     ) depth = 1;
+	if ( depth > PIPELINE_MAX_REQUESTS ) depth = PIPELINE_MAX_REQUESTS;
+
+	first              = multi->queue_first;
+	multi->queue_first = first->next;
+	first->next        = NULL;
+	last               = first;
+	*num               = 1;
+
+	if ( multi->queue_first == NULL ) multi->queue_last = NULL;
+	if ( ! first->idempotent        ) return first;
+
+	prev = NULL;
+
+	for (xfer=multi->queue_first; xfer != NULL  &&  *num < depth; xfer=next) {
+
+		next = xfer->next;
+
+		if ( ! xfer->idempotent  ||  xfer->port != first->port  ||  xfer->use_ssl != first->use_ssl  ||  httplib_strcasecmp( xfer->host, first->host ) ) {
+
+			prev = xfer;
+			continue;
+		}
+
+		if ( prev == NULL ) multi->queue_first = next;
+		else                prev->next         = next;
+
+		if ( multi->queue_last == xfer ) multi->queue_last = prev;
+
+		xfer->next = NULL;
+		last->next = xfer;
+		last       = xfer;
+		(*num)++;
+	}
+
+	return first;
+
+}  /* take_batch */
+
+
+
+/*
+ * static struct lh_con_t *send_batch( struct lh_mlt_t *multi, struct lh_mxf_t *first, int num );
+ *
+ * The function send_batch() connects to the host of a list of transfers and
+ * sends all their requests with one write. A connection from the pool may
+ * have been closed by the server in the meantime, in which case sending
+ * fails and the requests are sent once more over another connection. The
+ * function returns the connection, or NULL if the requests couldn't be sent.
+ */
+
+static struct lh_con_t *send_batch( struct lh_mlt_t *multi, struct lh_mxf_t *first, int num ) {
+
+	struct lh_out_t out[PIPELINE_MAX_REQUESTS];
+	struct lh_mxf_t *xfer;
+	struct lh_con_t *conn;
+	bool reused;
+	int tries;
+	int i;
+
+	i = 0;
+
+	for (xfer=first; xfer != NULL  &&  i < num; xfer=xfer->next) {
+
+		out[i].base = xfer->data;
+		out[i].len  = xfer->data_len;
+		i++;
+	}
+
+	for (tries=0; tries<2; tries++) {
+
+		conn = httplib_connect_client( multi->ctx, first->host, first->port, first->use_ssl );
+		if ( conn == NULL ) return NULL;
+
+		if ( XX_httplib_send_requests( multi->ctx, conn, out, num ) ) {
+
+			for (xfer=first; xfer != NULL; xfer=xfer->next) xfer->attempts++;
+			return conn;
+		}
+
+		reused = conn->pool_reused;
+		XX_httplib_free_client_connection( multi->ctx, conn );
+
+		if ( ! reused ) break;
+	}
+
+	return NULL;
+
+}  /* send_batch */
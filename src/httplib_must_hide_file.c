@@ -32,21 +32,25 @@
  *
  * The function XX_httplib_must_hide_file() returns true, if a file must be
  * hidden from browsing by the remote client. A used provided list of file
- * patterns to hide is used. Password files are always hidden, independent of
- * the patterns defined by the user.
+ * patterns to hide is used. Password files and the temporary files of uploads
+ * which are still being received are always hidden, independent of the
+ * patterns defined by the user.
  */
 
 bool XX_httplib_must_hide_file( const struct lh_ctx_t *ctx, const char *path ) {
 
 	const char *pw_pattern;
+	const char *upload_pattern;
 	const char *pattern;
 
 	if ( ctx == NULL ) return false;
 
-	pw_pattern = "**" PASSWORDS_FILE_NAME "$";
-	pattern    = ctx->hide_file_pattern;
+	pw_pattern     = "**" PASSWORDS_FILE_NAME "$";
+	upload_pattern = "**" UPLOAD_FILE_PREFIX "*$";
+	pattern        = ctx->hide_file_pattern;
 
-	return ( pw_pattern != NULL  &&  XX_httplib_match_prefix( pw_pattern, strlen( pw_pattern ), path ) > 0 )  ||
-	       ( pattern    != NULL  &&  XX_httplib_match_prefix( pattern,    strlen( pattern ),    path ) > 0 );
+	return ( pw_pattern     != NULL  &&  XX_httplib_match_prefix( pw_pattern,     strlen( pw_pattern ),     path ) > 0 )  ||
+	       ( upload_pattern != NULL  &&  XX_httplib_match_prefix( upload_pattern, strlen( upload_pattern ), path ) > 0 )  ||
+	       ( pattern        != NULL  &&  XX_httplib_match_prefix( pattern,        strlen( pattern ),        path ) > 0 );
 
 }  /* XX_httplib_must_hide_file */
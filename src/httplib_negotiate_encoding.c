@@ -0,0 +1,222 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static void		get_variants( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, const struct file *filep, bool is_found, struct encoding_variant_t *variant );
+static uint32_t		hash_path( const char *path );
+
+/*
+ * bool XX_httplib_negotiate_encoding( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, struct file *filep, bool is_found );
+ *
+ * The function XX_httplib_negotiate_encoding() selects which of a static file
+ * and its precompressed .br and .gz siblings is sent to the client. The
+ * choice is based on the quality values in the Accept-Encoding header of the
+ * request. If several variants are equally acceptable, the smallest one is
+ * sent.
+ *
+ * The parameter is_found tells if the original file exists, in which case
+ * filep already contains its status. On return filep describes the selected
+ * variant and its encoding field tells which sibling must be opened. The
+ * function returns true if a variant can be served and false if neither the
+ * original file nor an acceptable sibling exists.
+ *
+ * Range requests are always served from the original file if it exists,
+ * because the ranges are expressed in the space of the uncompressed data.
+ */
+
+bool XX_httplib_negotiate_encoding( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, struct file *filep, bool is_found ) {
+
+	struct encoding_variant_t variant[FILE_ENCODING_NUM];
+	const char *accept_encoding;
+	int best;
+	int best_quality;
+	int quality;
+	int enc;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  path == NULL  ||  filep == NULL ) return is_found;
+
+	if ( is_found  &&  ( filep->is_directory  ||  filep->membuf != NULL  ||  filep->encoding != FILE_ENCODING_IDENTITY ) ) return true;
+
+	get_variants( ctx, conn, path, filep, is_found, variant );
+
+	if ( ! variant[FILE_ENCODING_GZIP].exists  &&  ! variant[FILE_ENCODING_BR].exists ) return is_found;
+
+	/*
+	 * Precompressed siblings exist, so the response depends on the
+	 * Accept-Encoding header, even when the original file is sent.
+	 */
+
+	if ( is_found ) filep->has_variants = 1;
+
+	if ( is_found  &&  httplib_get_header( conn, "Range" ) != NULL ) return true;
+
+	accept_encoding = httplib_get_header( conn, "Accept-Encoding" );
+	best            = -1;
+	best_quality    = 0;
+
+	for (enc=FILE_ENCODING_NUM-1; enc>=0; enc--) {
+
+		if ( ! variant[enc].exists ) continue;
+
+		quality = XX_httplib_get_encoding_quality( accept_encoding, XX_httplib_encoding_name[enc] );
+
+		if ( quality <= 0 ) continue;
+
+		if ( best < 0  ||  quality > best_quality  ||  ( quality == best_quality  &&  variant[enc].size < variant[best].size ) ) {
+
+			best         = enc;
+			best_quality = quality;
+		}
+	}
+
+	if ( best < 0  ||  best == FILE_ENCODING_IDENTITY ) return is_found;
+
+	memset( filep, 0, sizeof(*filep) );
+
+	filep->size          = variant[best].size;
+	filep->last_modified = variant[best].last_modified;
+	filep->encoding      = best;
+	filep->has_variants  = 1;
+
+	return true;
+
+}  /* XX_httplib_negotiate_encoding */
+
+
+
+/*
+ * static void get_variants( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, const struct file *filep, bool is_found, struct encoding_variant_t *variant );
+ *
+ * The function get_variants() fills an array with the status of a static file
+ * and its precompressed siblings. The status of the siblings is taken from
+ * the encoding cache of the context if possible. A cached entry is only used
+ * if it has not expired and the original file did not change since the entry
+ * was created. Otherwise the siblings are checked on disk and the result is
+ * stored in the cache for subsequent requests.
+ */
+
+static void get_variants( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path, const struct file *filep, bool is_found, struct encoding_variant_t *variant ) {
+
+	struct encoding_cache_t *entry;
+	struct encoding_variant_t *cached;
+	struct file sibling;
+	char sibling_path[PATH_MAX];
+	uint32_t hash;
+	time_t now;
+	bool truncated;
+	int enc;
+
+	memset( variant, 0, FILE_ENCODING_NUM * sizeof(*variant) );
+
+	if ( is_found ) {
+
+		variant[FILE_ENCODING_IDENTITY].exists        = true;
+		variant[FILE_ENCODING_IDENTITY].size          = filep->size;
+		variant[FILE_ENCODING_IDENTITY].last_modified = filep->last_modified;
+	}
+
+	now   = time( NULL );
+	hash  = hash_path( path );
+	entry = NULL;
+
+	if ( ctx->encoding_cache != NULL ) {
+
+		entry  = & ctx->encoding_cache[hash % ENCODING_CACHE_SIZE];
+		cached = & entry->variant[FILE_ENCODING_IDENTITY];
+
+		httplib_pthread_mutex_lock( & ctx->encoding_cache_mutex );
+
+		if ( entry->path != NULL  &&  entry->hash == hash  &&  now < entry->expires  &&  ! strcmp( entry->path, path )  &&
+		     cached->exists == is_found  &&  cached->size == variant[FILE_ENCODING_IDENTITY].size  &&  cached->last_modified == variant[FILE_ENCODING_IDENTITY].last_modified ) {
+
+			for (enc=0; enc<FILE_ENCODING_NUM; enc++) if ( enc != FILE_ENCODING_IDENTITY ) variant[enc] = entry->variant[enc];
+
+			httplib_pthread_mutex_unlock( & ctx->encoding_cache_mutex );
+			return;
+		}
+
+		httplib_pthread_mutex_unlock( & ctx->encoding_cache_mutex );
+	}
+
+	for (enc=0; enc<FILE_ENCODING_NUM; enc++) {
+
+		if ( enc == FILE_ENCODING_IDENTITY ) continue;
+
+		XX_httplib_snprintf( ctx, conn, &truncated, sibling_path, sizeof(sibling_path), "%s%s", path, XX_httplib_encoding_ext[enc] );
+
+		if ( truncated  ||  ! XX_httplib_stat( ctx, conn, sibling_path, &sibling )  ||  sibling.is_directory ) continue;
+
+		variant[enc].exists        = true;
+		variant[enc].size          = sibling.size;
+		variant[enc].last_modified = sibling.last_modified;
+	}
+
+	if ( entry == NULL ) return;
+
+	httplib_pthread_mutex_lock( & ctx->encoding_cache_mutex );
+
+	if ( entry->path == NULL  ||  strcmp( entry->path, path ) ) {
+
+		entry->path = httplib_free( entry->path );
+		entry->path = httplib_strdup( path );
+	}
+
+	if ( entry->path != NULL ) {
+
+		entry->hash    = hash;
+		entry->expires = now + ctx->encoding_cache_ttl;
+
+		memcpy( entry->variant, variant, FILE_ENCODING_NUM * sizeof(*variant) );
+	}
+
+	httplib_pthread_mutex_unlock( & ctx->encoding_cache_mutex );
+
+}  /* get_variants */
+
+
+
+/*
+ * static uint32_t hash_path( const char *path );
+ *
+ * The function hash_path() returns the 32 bit FNV-1a hash of a path which is
+ * used to find the slot of the path in the encoding cache.
+ */
+
+static uint32_t hash_path( const char *path ) {
+
+	uint32_t hash;
+
+	hash = 2166136261u;
+
+	while ( *path != '\0' ) {
+
+		hash ^= (unsigned char)*path++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+
+}  /* hash_path */
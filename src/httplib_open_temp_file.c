@@ -0,0 +1,110 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_open_temp_file( struct lh_ctx_t *ctx, const struct lh_con_t *conn, const char *path, char *tmp_path, size_t tmp_len, struct file *filep );
+ *
+ * The function XX_httplib_open_temp_file() creates a new file in the same
+ * directory as the file with the given path. The name of the new file is
+ * UPLOAD_FILE_PREFIX followed by a random number. It starts with a dot and is
+ * hidden from directory listings and PROPFIND. Data can be written to the
+ * temporary file and the file can then be renamed to the final name with
+ * XX_httplib_rename(), so that the final file never appears partially
+ * written. If the file with the given path exists, the temporary file gets
+ * its permissions, so that replacing the file doesn't change them.
+ *
+ * The name of the temporary file is returned in tmp_path. The function
+ * returns true if the file could be created, and false otherwise.
+ */
+
+bool XX_httplib_open_temp_file( struct lh_ctx_t *ctx, const struct lh_con_t *conn, const char *path, char *tmp_path, size_t tmp_len, struct file *filep ) {
+
+	int tries;
+	int len;
+	int dir_len;
+	const char *name;
+#if defined(_WIN32)
+	struct file fi;
+#else  /* _WIN32 */
+	int fd;
+	struct stat st;
+#endif  /* _WIN32 */
+
+	if ( ctx == NULL  ||  path == NULL  ||  tmp_path == NULL  ||  filep == NULL ) return false;
+
+	name = strrchr( path, '/' );
+#if defined(_WIN32)
+	if ( strrchr( path, '\\' ) > name ) name = strrchr( path, '\\' );
+#endif  /* _WIN32 */
+	dir_len = ( name != NULL ) ? (int)(name - path + 1) : 0;
+
+	for (tries=0; tries<8; tries++) {
+
+		len = snprintf( tmp_path, tmp_len, "%.*s" UPLOAD_FILE_PREFIX "%016llx", dir_len, path, (unsigned long long)httplib_get_random() );
+		if ( len < 0  ||  (size_t)len >= tmp_len ) return false;
+
+#if defined(_WIN32)
+
+		if ( XX_httplib_stat( ctx, conn, tmp_path, & fi ) ) continue;
+		if ( XX_httplib_fopen( ctx, conn, tmp_path, "wb", filep ) ) return true;
+
+#else  /* _WIN32 */
+
+		/*
+		 * The file is created exclusively, so that an existing file is
+		 * never overwritten, and it is not inherited by CGI processes.
+		 */
+
+		UNUSED_PARAMETER(conn);
+
+		fd = open( tmp_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666 );
+
+		if ( fd < 0 ) {
+
+			if ( ERRNO == EEXIST ) continue;
+			return false;
+		}
+
+		if ( stat( path, & st ) == 0  &&  S_ISREG( st.st_mode ) ) fchmod( fd, st.st_mode & 07777 );
+
+		memset( filep, 0, sizeof(*filep) );
+		filep->fp = fdopen( fd, "wb" );
+
+		if ( filep->fp != NULL ) return true;
+
+		close( fd );
+		httplib_remove( tmp_path );
+
+#endif  /* _WIN32 */
+
+		return false;
+	}
+
+	return false;
+
+}  /* XX_httplib_open_temp_file */
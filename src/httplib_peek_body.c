@@ -0,0 +1,88 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_peek_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char **data, size_t *len );
+ *
+ * The function httplib_peek_body() gives access to the next part of the body
+ * of a request without copying it. On return data points to body bytes in the
+ * connection buffer and len contains the number of bytes available there. If
+ * no body data is buffered, the function waits for data from the remote side
+ * first. Bodies received with chunked transfer encoding are decoded in place
+ * and only chunk data is returned.
+ *
+ * The data remains valid until the next call to a function which reads from
+ * the connection. The bytes are not removed from the body until they are
+ * released with httplib_consume_body(), so calling the function twice returns
+ * the same data.
+ *
+ * The function returns 1 if data is available, 0 at the end of the body and
+ * -1 if an error occured.
+ */
+
+int httplib_peek_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const char **data, size_t *len ) {
+
+	int64_t avail;
+
+	if ( data != NULL ) *data = NULL;
+	if ( len  != NULL ) *len  = 0;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  data == NULL  ||  len == NULL ) return -1;
+
+	if ( conn->is_chunked ) return XX_httplib_chunked_view( ctx, conn, true, data, len );
+
+	/*
+	 * If Content-Length is not set for a PUT or POST request, read until
+	 * socket is closed
+	 */
+
+	if ( conn->consumed_content == 0  &&  conn->content_len == -1 ) {
+
+		conn->content_len = INT64_MAX;
+		conn->must_close  = true;
+	}
+
+	if ( conn->consumed_content >= conn->content_len ) return 0;
+
+	avail = (int64_t)conn->data_len - (int64_t)conn->request_len - conn->consumed_content;
+
+	if ( avail <= 0 ) {
+
+		if ( ! XX_httplib_fill_body_buffer( ctx, conn ) ) return ( conn->content_len == INT64_MAX ) ? 0 : -1;
+
+		avail = (int64_t)conn->data_len - (int64_t)conn->request_len;
+	}
+
+	if ( avail > conn->content_len - conn->consumed_content ) avail = conn->content_len - conn->consumed_content;
+
+	*data = conn->buf + conn->request_len + conn->consumed_content;
+	*len  = (size_t)avail;
+
+	return 1;
+
+}  /* httplib_peek_body */
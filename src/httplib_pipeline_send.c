@@ -0,0 +1,87 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_pipeline_send( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_req_t *requests, int num_requests );
+ *
+ * The function httplib_pipeline_send() sends a number of requests over a
+ * client connection without waiting for the responses in between. All
+ * requests are written with one call. The responses are read afterwards in
+ * the same order with httplib_get_response() and httplib_read(). The function
+ * returns the number of requests sent, or -1 if an error occured. At most
+ * PIPELINE_MAX_REQUESTS responses may be outstanding on one connection.
+ */
+
+int httplib_pipeline_send( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_req_t *requests, int num_requests ) {
+
+	struct lh_out_t *out;
+	bool ok;
+	int i;
+	union {
+		const void *	con;
+		void *		var;
+	} ptr;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  requests == NULL  ||  num_requests <= 0 ) return -1;
+	if ( num_requests > PIPELINE_MAX_REQUESTS - conn->pipeline_pending              ) return -1;
+
+	out = httplib_calloc( (size_t)num_requests, sizeof(struct lh_out_t) );
+	if ( out == NULL ) return -1;
+
+	ok = true;
+
+	for (i=0; i<num_requests && ok; i++) {
+
+		out[i].base = XX_httplib_build_request( & requests[i], & out[i].len );
+		if ( out[i].base == NULL ) ok = false;
+	}
+
+	if ( ok ) ok = XX_httplib_send_requests( ctx, conn, out, num_requests );
+
+	if ( ok ) {
+
+		for (i=0; i<num_requests; i++) {
+
+			if ( requests[i].method != NULL  &&  ! strcmp( requests[i].method, "HEAD" ) ) conn->pipeline_no_body |= UINT64_C(1) << ( conn->pipeline_pending + i );
+		}
+
+		conn->pipeline_pending += num_requests;
+	}
+
+	else conn->must_close = true;
+
+	for (i=0; i<num_requests; i++) {
+
+		ptr.con = out[i].base;
+		httplib_free( ptr.var );
+	}
+
+	out = httplib_free( out );
+
+	return ( ok ) ? num_requests : -1;
+
+}  /* httplib_pipeline_send */
@@ -32,6 +32,17 @@
  *
  * The function XX_httplib_process_new_connection() is used to process a new
  * incoming connection on a socket.
+ *
+ * The first request on a connection, and a request of which some bytes have
+ * already been received, must arrive before the header deadline. Otherwise
+ * the connection waits for the next request until the keep-alive deadline.
+ * The body of a request is read with an idle deadline. A receive buffer which
+ * grew for a large header shrinks again while the connection waits for its
+ * next request.
+ *
+ * Pipelined requests are parsed where they are in the buffer. Their
+ * responses are held back while the next request is already buffered, and
+ * are then sent together with one call.
  */
 
 void XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
@@ -40,6 +51,7 @@ void XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *c
 	int keep_alive;
 	int discard_len;
 	bool was_error;
+	bool first;
 	const char *hostend;
 	int reqerr;
 	enum uri_type_t uri_type;
@@ -59,8 +71,18 @@ void XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *c
 
 	conn->data_len = 0;
 	was_error      = false;
+	first          = true;
+
+	XX_httplib_buffer_compact( conn );
 
 	do {
+		if ( first  ||  conn->data_len > 0 ) XX_httplib_deadline_set( conn, DEADLINE_HEADER,     conn->request_timeout   );
+		else                                 XX_httplib_deadline_set( conn, DEADLINE_KEEP_ALIVE, ctx->keep_alive_timeout );
+
+		if ( ! first  &&  conn->data_len == 0 ) XX_httplib_buffer_shrink( ctx, conn );
+
+		first = false;
+
 		if ( ! XX_httplib_getreq( ctx, conn, &reqerr ) ) {
 
 			/*
@@ -84,6 +106,8 @@ void XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *c
 
 		if ( ! was_error ) {
 
+			XX_httplib_deadline_set( conn, DEADLINE_BODY, conn->request_timeout );
+
 			uri_type = XX_httplib_get_uri_type( conn->request_info.request_uri );
 
 			switch ( uri_type ) {
@@ -122,6 +146,16 @@ void XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *c
 			conn->request_info.uri = conn->request_info.local_uri;
 		}
 
+		/*
+		 * When the next pipelined request is already in the buffer, the
+		 * response is held back and sent together with the response to
+		 * that request. This is only possible if the request has no body
+		 * and doesn't switch to another protocol.
+		 */
+
+		conn->out_hold = ( ! was_error  &&  conn->content_len == 0  &&  ! conn->is_chunked  &&  httplib_get_header( conn, "Upgrade" ) == NULL  &&
+				   XX_httplib_get_request_len( conn->buf + conn->request_len, conn->data_len - conn->request_len ) > 0 );
+
 		if ( ! was_error ) {
 
 			if ( conn->request_info.local_uri != NULL ) {
@@ -131,6 +165,17 @@ void XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *c
 				 */
 
 				XX_httplib_handle_request( ctx, conn );
+
+				/*
+				 * A compressed or chunked response which has not
+				 * been finished by the request handler is finished
+				 * here, because the next response on the connection
+				 * can't be sent otherwise.
+				 */
+
+				if ( conn->compress  != NULL ) httplib_end_compressed_response( ctx, conn );
+				if ( conn->chunk_out != NULL ) httplib_end_chunked( ctx, conn, NULL );
+
 				if ( ctx->callbacks.end_request != NULL ) ctx->callbacks.end_request( ctx, conn, conn->status_code );
 				XX_httplib_log_access( ctx, conn );
 			}
@@ -160,7 +205,7 @@ void XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *c
 
 		/*
 		 * NOTE(lsm): order is important here. XX_httplib_should_keep_alive() call is
-		 * using parsed request, which will be invalid after memmove's below.
+		 * using parsed request, which will be invalid after the discard below.
 		 * Therefore, memorize XX_httplib_should_keep_alive() result now for later use
 		 * in loop exit condition.
 		 */
@@ -178,11 +223,13 @@ void XX_httplib_process_new_connection( struct lh_ctx_t *ctx, struct lh_con_t *c
 		                  : conn->data_len;
 
 		if ( discard_len < 0 ) break;
-		conn->data_len -= discard_len;
-		if ( conn->data_len > 0 ) memmove( conn->buf, conn->buf + discard_len, (size_t)conn->data_len );
+		XX_httplib_buffer_discard( conn, discard_len );
 
 		if ( conn->data_len < 0  ||  conn->data_len > conn->buf_size ) break;
 
 	} while ( keep_alive );
 
+	conn->out_hold = false;
+	if ( conn->out_len > 0 ) XX_httplib_flush_output( ctx, conn, NULL, 0 );
+
 }  /* XX_httplib_process_new_connection */
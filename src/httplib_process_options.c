@@ -54,22 +54,40 @@ bool XX_httplib_process_options( struct lh_ctx_t *ctx, const struct lh_opt_t *op
 		if ( check_str(  ctx, options, "cgi_environment",             & ctx->cgi_environment                         ) ) return true;
 		if ( check_file( ctx, options, "cgi_interpreter",             & ctx->cgi_interpreter                         ) ) return true;
 		if ( check_patt( ctx, options, "cgi_pattern",                 & ctx->cgi_pattern                             ) ) return true;
+		if ( check_int(  ctx, options, "client_pipeline_depth",       & ctx->client_pipeline_depth,       1, PIPELINE_MAX_REQUESTS ) ) return true;
+		if ( check_int(  ctx, options, "client_pool_idle_timeout",    & ctx->client_pool_idle_timeout,    0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "client_pool_max_idle",        & ctx->client_pool_max_idle,        0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "client_pool_max_per_host",    & ctx->client_pool_max_per_host,    0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "compression_level",           & ctx->compression_level,           0, 9       ) ) return true;
+		if ( check_int(  ctx, options, "compression_min_size",        & ctx->compression_min_size,        0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "connect_timeout",             & ctx->connect_timeout,             0, INT_MAX ) ) return true;
 		if ( check_dbg(  ctx, options, "debug_level",                 & ctx->debug_level                             ) ) return true;
 		if ( check_bool( ctx, options, "decode_url",                  & ctx->decode_url                              ) ) return true;
 		if ( check_dir(  ctx, options, "document_root",               & ctx->document_root                           ) ) return true;
 		if ( check_bool( ctx, options, "enable_directory_listing",    & ctx->enable_directory_listing                ) ) return true;
 		if ( check_bool( ctx, options, "enable_keep_alive",           & ctx->enable_keep_alive                       ) ) return true;
+		if ( check_bool( ctx, options, "enable_websocket_compression", & ctx->enable_websocket_compression           ) ) return true;
+		if ( check_bool( ctx, options, "enable_websocket_reactor",    & ctx->enable_websocket_reactor               ) ) return true;
+		if ( check_int(  ctx, options, "encoding_cache_ttl",          & ctx->encoding_cache_ttl,          0, INT_MAX ) ) return true;
 		if ( check_file( ctx, options, "error_log_file",              & ctx->error_log_file                          ) ) return true;
 		if ( check_dir(  ctx, options, "error_pages",                 & ctx->error_pages                             ) ) return true;
 		if ( check_str(  ctx, options, "extra_mime_types",            & ctx->extra_mime_types                        ) ) return true;
 		if ( check_file( ctx, options, "global_auth_file",            & ctx->global_auth_file                        ) ) return true;
 		if ( check_patt( ctx, options, "hide_file_pattern",           & ctx->hide_file_pattern                       ) ) return true;
+		if ( check_file( ctx, options, "hosts_file",                  & ctx->hosts_file                              ) ) return true;
 		if ( check_str(  ctx, options, "index_files",                 & ctx->index_files                             ) ) return true;
+		if ( check_int(  ctx, options, "keep_alive_timeout",          & ctx->keep_alive_timeout,          0, INT_MAX ) ) return true;
 		if ( check_str(  ctx, options, "listening_ports",             & ctx->listening_ports                         ) ) return true;
+		if ( check_int(  ctx, options, "max_request_size",            & ctx->max_request_size,            BUFFER_MIN_SIZE, BUFFER_MAX_SIZE ) ) return true;
 		if ( check_int(  ctx, options, "num_threads",                 & ctx->num_threads,                 1, INT_MAX ) ) return true;
 		if ( check_str(  ctx, options, "protect_uri",                 & ctx->protect_uri                             ) ) return true;
 		if ( check_file( ctx, options, "put_delete_auth_file",        & ctx->put_delete_auth_file                    ) ) return true;
+		if ( check_int(  ctx, options, "request_buffer_size",         & ctx->request_buffer_size,         BUFFER_MIN_SIZE, BUFFER_MAX_SIZE ) ) return true;
 		if ( check_int(  ctx, options, "request_timeout",             & ctx->request_timeout,             0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "resolver_cache_ttl",          & ctx->resolver_cache_ttl,          0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "resolver_negative_ttl",       & ctx->resolver_negative_ttl,       0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "resolver_threads",            & ctx->resolver_threads,            1, RESOLVER_MAX_THREADS ) ) return true;
+		if ( check_int(  ctx, options, "resolver_timeout",            & ctx->resolver_timeout,            0, INT_MAX ) ) return true;
 		if ( check_str(  ctx, options, "run_as_user",                 & ctx->run_as_user                             ) ) return true;
 		if ( check_int(  ctx, options, "ssi_include_depth",           & ctx->ssi_include_depth,           0, 20      ) ) return true;
 		if ( check_patt( ctx, options, "ssi_pattern",                 & ctx->ssi_pattern                             ) ) return true;
@@ -87,6 +105,12 @@ bool XX_httplib_process_options( struct lh_ctx_t *ctx, const struct lh_opt_t *op
 		if ( check_bool( ctx, options, "tcp_nodelay",                 & ctx->tcp_nodelay                             ) ) return true;
 		if ( check_str(  ctx, options, "url_rewrite_patterns",        & ctx->url_rewrite_patterns                    ) ) return true;
 		if ( check_dir(  ctx, options, "websocket_root",              & ctx->websocket_root                          ) ) return true;
+		if ( check_int(  ctx, options, "websocket_max_message_size",  & ctx->websocket_max_message_size,  0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "websocket_ping_interval",     & ctx->websocket_ping_interval,     0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "websocket_pong_timeout",      & ctx->websocket_pong_timeout,      0, INT_MAX ) ) return true;
+		if ( check_bool( ctx, options, "websocket_send_queue_drop",   & ctx->websocket_send_queue_drop               ) ) return true;
+		if ( check_int(  ctx, options, "websocket_send_queue_high",   & ctx->websocket_send_queue_high,   0, INT_MAX ) ) return true;
+		if ( check_int(  ctx, options, "websocket_send_queue_low",    & ctx->websocket_send_queue_low,    0, INT_MAX ) ) return true;
 		if ( check_int(  ctx, options, "websocket_timeout",           & ctx->websocket_timeout,           0, INT_MAX ) ) return true;
 
 		/*
@@ -96,6 +120,23 @@ bool XX_httplib_process_options( struct lh_ctx_t *ctx, const struct lh_opt_t *op
 		options++;
 	}
 
+	/*
+	 * Options which depend on each other are checked after all options
+	 * have been read, because they can be passed in any order.
+	 */
+
+	if ( ctx->websocket_send_queue_high > 0  &&  ctx->websocket_send_queue_low > ctx->websocket_send_queue_high ) {
+
+		XX_httplib_abort_start( ctx, "Option \"websocket_send_queue_low\" (%d) is larger than option \"websocket_send_queue_high\" (%d)", ctx->websocket_send_queue_low, ctx->websocket_send_queue_high );
+		return true;
+	}
+
+	if ( ctx->request_buffer_size > ctx->max_request_size ) {
+
+		XX_httplib_abort_start( ctx, "Option \"request_buffer_size\" (%d) is larger than option \"max_request_size\" (%d)", ctx->request_buffer_size, ctx->max_request_size );
+		return true;
+	}
+
 	return false;
 
 }  /* XX_httplib_process_options */
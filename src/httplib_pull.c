@@ -30,16 +30,19 @@
 #include "httplib_utils.h"
 
 /*
- * Read from IO channel - opened file descriptor, socket, or SSL descriptor.
- * Return negative value on error, or number of bytes read on success.
+ * int XX_httplib_pull( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn, char *buf, int len );
+ *
+ * The function XX_httplib_pull() reads from an IO channel, which is either an
+ * opened file descriptor, a socket or an SSL descriptor. Reads from a socket
+ * wait with XX_httplib_deadline_wait() until data has arrived or the deadline
+ * of the connection has expired. The function returns a negative value on
+ * error, or the number of bytes read on success.
  */
 
-int XX_httplib_pull( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn, char *buf, int len, double timeout ) {
+int XX_httplib_pull( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn, char *buf, int len ) {
 
 	int nread;
 	int err;
-	struct timespec start;
-	struct timespec now;
 
 #ifdef _WIN32
 	typedef int len_t;
@@ -47,15 +50,15 @@ int XX_httplib_pull( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn
 	typedef size_t len_t;
 #endif
 
-	if ( timeout > 0 ) {
+	/*
+	 * Responses which are held back are sent before waiting for data, so
+	 * that they are never delayed by a slow peer or CGI process.
+	 */
 
-		memset( &start, 0, sizeof(start) );
-		memset( &now,   0, sizeof(now)   );
+	if ( conn != NULL  &&  conn->out_len > 0 ) XX_httplib_flush_output( ctx, conn, NULL, 0 );
 
-		clock_gettime( CLOCK_MONOTONIC, &start );
-	}
+	for (;;) {
 
-	do {
 		if ( fp != NULL ) {
 #if !defined(_WIN32_WCE)
 			/*
@@ -74,32 +77,44 @@ int XX_httplib_pull( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn
 			nread = (int)fread(buf, 1, (size_t)len, fp);
 #endif
 			err = (nread < 0) ? ERRNO : 0;
+		}
+
+		else {
+			/*
+			 * Data which SSL has already decrypted can be read without
+			 * waiting for the socket.
+			 */
 
 #ifndef NO_SSL
-		}
-		
-		else if ( conn->ssl != NULL ) {
+			if ( conn->ssl == NULL  ||  SSL_pending( conn->ssl ) == 0 ) {
+#endif
+				if ( XX_httplib_deadline_wait( ctx, conn ) <= 0 ) return -1;
+#ifndef NO_SSL
+			}
+
+			if ( conn->ssl != NULL ) {
 
-			nread = SSL_read( conn->ssl, buf, len );
+				nread = SSL_read( conn->ssl, buf, len );
 
-			if (nread <= 0) {
+				if (nread <= 0) {
 
-				err = SSL_get_error( conn->ssl, nread );
+					err = SSL_get_error( conn->ssl, nread );
 
-				if      ( err == SSL_ERROR_SYSCALL    &&  nread == -1                 ) err   = ERRNO;
-				else if ( err == SSL_ERROR_WANT_READ  ||  err == SSL_ERROR_WANT_WRITE ) nread = 0;
-				
-				else return -1;
+					if      ( err == SSL_ERROR_SYSCALL    &&  nread == -1                 ) err   = ERRNO;
+					else if ( err == SSL_ERROR_WANT_READ  ||  err == SSL_ERROR_WANT_WRITE ) nread = 0;
+
+					else return -1;
+				}
+				else err = 0;
 			}
-			else err = 0;
-#endif
 
-		}
-		
-		else {
-			nread = (int)recv( conn->client.sock, buf, (len_t)len, 0 );
-			err   = (nread < 0) ? ERRNO : 0;
-			if (nread == 0) return -1; /* shutdown of the socket at client side */
+			else
+#endif
+			{
+				nread = (int)recv( conn->client.sock, buf, (len_t)len, 0 );
+				err   = (nread < 0) ? ERRNO : 0;
+				if (nread == 0) return -1; /* shutdown of the socket at client side */
+			}
 		}
 
 		if ( ctx->status != CTX_STATUS_RUNNING ) return -1;
@@ -113,66 +128,24 @@ int XX_httplib_pull( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn
 			return nread;
 		}
 
-		if (nread < 0) {
+		if ( nread < 0 ) {
 
 			/*
 			 * socket error - check errno
 			 */
 #ifdef _WIN32
-			if ( err == WSAEWOULDBLOCK ) {
-
-				/*
-				 * standard case if called from close_socket_gracefully
-				 */
-
-				return -1;
-			}
-			
-			else if ( err == WSAETIMEDOUT ) {
-
-				/*
-				 * timeout is handled by the while loop
-				 */
-			}
-			
-			else return -1;
+			if ( err != WSAETIMEDOUT  &&  err != WSAEINTR ) return -1;
 #else
-			/*
-			 * TODO: POSIX returns either EAGAIN or EWOULDBLOCK in both cases,
-			 * if the timeout is reached and if the socket was set to non-
-			 * blocking in close_socket_gracefully, so we can not distinguish
-			 * here. We have to wait for the timeout in both cases for now.
-			 */
-
-			if ( err == EAGAIN  ||  err == EWOULDBLOCK  ||  err == EINTR ) {
-
-				/*
-				 * EAGAIN/EWOULDBLOCK:
-				 * standard case if called from close_socket_gracefully
-				 * => should return -1
-				 * or timeout occured
-				 * => the code must stay in the while loop
-				 *
-				 * EINTR can be generated on a socket with a timeout set even
-				 * when SA_RESTART is effective for all relevant signals
-				 * (see signal(7)).
-				 * => stay in the while loop
-				 */
-
-			}
-			
-			else return -1;
+			if ( err != EAGAIN  &&  err != EWOULDBLOCK  &&  err != EINTR ) return -1;
 #endif
 		}
 
-		if ( timeout > 0 ) clock_gettime( CLOCK_MONOTONIC, &now );
-
-	} while ( timeout <= 0  ||  XX_httplib_difftimespec( & now,  & start ) <= timeout );
+		if ( fp != NULL  &&  nread == 0 ) return -1; /* end of file */
 
-	/*
-	 * Timeout occured, but no data available.
-	 */
-
-	return -1;
+		/*
+		 * An interrupted call, or an SSL record which is not complete yet.
+		 * The next wait for the socket checks the deadline again.
+		 */
+	}
 
 }  /* XX_httplib_pull */
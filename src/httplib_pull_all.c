@@ -31,16 +31,14 @@ int XX_httplib_pull_all( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *
 
 	int n;
 	int nread;
-	double timeout;
 
 	if ( ctx == NULL  ||   conn == NULL ) return 0;
 
-	nread   = 0;
-	timeout = ((double)ctx->request_timeout) / 1000.0;
+	nread = 0;
 
 	while ( len > 0  &&  ctx->status == CTX_STATUS_RUNNING ) {
 
-		n = XX_httplib_pull( ctx, fp, conn, buf + nread, len, timeout );
+		n = XX_httplib_pull( ctx, fp, conn, buf + nread, len );
 
 		if ( n < 0 ) {
 
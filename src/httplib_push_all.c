@@ -36,12 +36,13 @@
 #endif
 
 /*
- * static int64_t push( const struct lh_ctx_t *ctx, FILE *fp, SOCKET sock, SSL *ssl, const char *buf, int64_t len, double timeout );
+ * static int64_t push( const struct lh_ctx_t *ctx, FILE *fp, SOCKET sock, SSL *ssl, const char *buf, int64_t len );
  *
  * The function push() writes data to the I/O channel, opened file descriptor,
  * socket or SSL descriptor. The function returns the number of bytes which
  * were actually written. A negative value is returned if an error is
- * encountered.
+ * encountered. A write to a socket which doesn't make progress ends with the
+ * send timeout which was set on the socket when it was accepted.
  *
  * Although we specify the number of bytes in a 64 bit integer, the OS functins
  * may not be able to handle that. We therefore cap the amount of bytes to
@@ -50,12 +51,9 @@
  * been written.
  */
 
-static int64_t push( const struct lh_ctx_t *ctx, FILE *fp, SOCKET sock, SSL *ssl, const char *buf, int64_t len, double timeout ) {
+static int64_t push( const struct lh_ctx_t *ctx, FILE *fp, SOCKET sock, SSL *ssl, const char *buf, int64_t len ) {
 
-	struct timespec start;
-	struct timespec now;
 	int n;
-	int err;
 
 	if ( ctx == NULL ) return -1;
 #ifdef NO_SSL
@@ -64,84 +62,35 @@ static int64_t push( const struct lh_ctx_t *ctx, FILE *fp, SOCKET sock, SSL *ssl
 
 	if ( len > INT_MAX ) len = INT_MAX;
 
-	if ( timeout > 0.0 ) clock_gettime( CLOCK_MONOTONIC, &start );
-
-	do {
-
 #ifndef NO_SSL
-		if ( ssl != NULL ) {
-
-			n = SSL_write( ssl, buf, (int)len );
-
-			if ( n <= 0 ) {
+	if ( ssl != NULL ) {
 
-				err = SSL_get_error( ssl, n );
-
-				if      ( err == SSL_ERROR_SYSCALL   &&  n   == -1                   ) err = ERRNO;
-				else if ( err == SSL_ERROR_WANT_READ ||  err == SSL_ERROR_WANT_WRITE ) n   = 0;
-				else return -1;
-
-			}
-			
-			else err = 0;
-		}
-		
-		else
+		n = SSL_write( ssl, buf, (int)len );
+		if ( n <= 0 ) return -1;
+	}
+	
+	else
 #endif  /* NO_SSL */
-		if ( fp != NULL ) {
-
-			n = (int)fwrite( buf, 1, (size_t)len, fp );
-			if ( ferror(fp) ) {
-
-				n   = -1;
-				err = ERRNO;
-			}
-			
-			else err = 0;
-		}
-		
-		else {
-			n = (int)send( sock, buf, (len_t)len, MSG_NOSIGNAL );
-			err = ( n < 0 ) ? ERRNO : 0;
+	if ( fp != NULL ) {
 
-			if ( n == 0 ) {
-
-				/*
-				 * shutdown of the socket at client side
-				 */
-
-				return -1;
-			}
-		}
-
-		if ( ctx->status != CTX_STATUS_RUNNING ) return -1;
-
-		if ( n > 0  ||  (n == 0 && len == 0) ) return n;
-
-		if ( n < 0 ) {
-
-			/*
-			 * socket error - check errno
-			 *
-			 * TODO: error handling depending on the error code.
-			 * These codes are different between Windows and Linux.
-			 */
-
-			return -1;
-		}
+		n = (int)fwrite( buf, 1, (size_t)len, fp );
+		if ( ferror(fp) ) return -1;
+	}
+	
+	else {
+		n = (int)send( sock, buf, (len_t)len, MSG_NOSIGNAL );
 
 		/*
-		 * This code is not reached in the moment.
-		 * ==> Fix the TODOs above first.
+		 * An error, the send timeout of the socket, or a shutdown of
+		 * the socket at client side
 		 */
 
-		if ( err ) return -1;
-
-		if ( timeout > 0.0 ) clock_gettime( CLOCK_MONOTONIC, &now );
+		if ( n <= 0 ) return -1;
+	}
 
-	} while ( timeout <= 0.0  ||  XX_httplib_difftimespec( &now, &start ) <= timeout );
+	if ( ctx->status != CTX_STATUS_RUNNING ) return -1;
 
-	return -1;
+	return n;
 
 }  /* push */
 
@@ -156,18 +105,16 @@ static int64_t push( const struct lh_ctx_t *ctx, FILE *fp, SOCKET sock, SSL *ssl
 
 int64_t XX_httplib_push_all( const struct lh_ctx_t *ctx, FILE *fp, SOCKET sock, SSL *ssl, const char *buf, int64_t len ) {
 
-	double timeout;
 	int64_t n;
 	int64_t nwritten;
 
 	if ( ctx == NULL ) return -1;
 
 	nwritten = 0;
-	timeout  = ((double)ctx->request_timeout) / 1000.0;
 
 	while ( len > 0  &&  ctx->status == CTX_STATUS_RUNNING ) {
 
-		n = push( ctx, fp, sock, ssl, buf + nwritten, len, timeout );
+		n = push( ctx, fp, sock, ssl, buf + nwritten, len );
 
 		if ( n < 0 ) {
 
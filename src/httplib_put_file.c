@@ -33,12 +33,21 @@
  *
  * The function XX_httplib_put_file() processes a file PUT request coming from
  * a remote client.
+ *
+ * A complete file is received in a temporary file which replaces the old
+ * file when the upload has finished, so that readers never see a partially
+ * uploaded file. A request with a Content-Range header updates the existing
+ * file in place.
  */
 
 void XX_httplib_put_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path ) {
 
 	struct file file = STRUCT_FILE_INITIALIZER;
+	char tmp_path[PATH_MAX];
 	const char *range;
+	bool exists;
+	bool partial;
+	int status;
 	int64_t r1;
 	int64_t r2;
 	int rc;
@@ -50,6 +59,7 @@ void XX_httplib_put_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const cha
 	if ( ctx->document_root    == NULL ) return;
 
 	curtime = time( NULL );
+	exists  = false;
 
 	if ( XX_httplib_stat( ctx, conn, path, &file ) ) {
 
@@ -98,6 +108,7 @@ void XX_httplib_put_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const cha
 
 				conn->status_code = 200;
 				rc                = 1;
+				exists            = true;
 			}
 			
 			else {
@@ -159,24 +170,38 @@ void XX_httplib_put_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const cha
 	 * A file should be created or overwritten.
 	 */
 
-	if ( ! XX_httplib_fopen( ctx, conn, path, "wb+", &file)  ||  file.fp == NULL ) {
+	range   = httplib_get_header( conn, "Content-Range" );
+	r1      = 0;
+	r2      = 0;
+	partial = ( range != NULL  &&  XX_httplib_parse_range_header( range, &r1, &r2 ) > 0 );
+
+	if ( partial ) {
+
+		if ( ! XX_httplib_fopen( ctx, conn, path, ( exists ) ? "rb+" : "wb+", &file )  ||  file.fp == NULL ) {
+
+			XX_httplib_fclose( & file );
+			XX_httplib_send_http_error( ctx, conn, 500, "Error: Can not create file\nfopen(%s): %s", path, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
+			return;
+		}
+
+		conn->status_code = 206; /* Partial content */
+		fseeko( file.fp, r1, SEEK_SET );
+	}
+
+	else if ( ! XX_httplib_open_temp_file( ctx, conn, path, tmp_path, sizeof(tmp_path), &file ) ) {
 
-		XX_httplib_fclose( & file );
 		XX_httplib_send_http_error( ctx, conn, 500, "Error: Can not create file\nfopen(%s): %s", path, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
 		return;
 	}
 
 	XX_httplib_fclose_on_exec( ctx, &file, conn );
 
-	range = httplib_get_header( conn, "Content-Range" );
-	r1    = 0;
-	r2    = 0;
-
-	if ( range != NULL  &&  XX_httplib_parse_range_header( range, &r1, &r2 ) > 0 ) {
+	/*
+	 * XX_httplib_forward_body_data() changes the status code when it
+	 * answers an Expect: 100-continue header.
+	 */
 
-		conn->status_code = 206; /* Partial content */
-		fseeko( file.fp, r1, SEEK_SET );
-	}
+	status = conn->status_code;
 
 	if ( ! XX_httplib_forward_body_data( ctx, conn, file.fp, INVALID_SOCKET, NULL ) ) {
 
@@ -187,14 +212,22 @@ void XX_httplib_put_file( struct lh_ctx_t *ctx, struct lh_con_t *conn, const cha
 		 */
 
 		XX_httplib_fclose( & file );
+		if ( ! partial ) XX_httplib_remove_bad_file( ctx, conn, tmp_path );
 		return;
 	}
 
+	if ( XX_httplib_fclose( & file ) != 0  ||  ( ! partial  &&  XX_httplib_rename( tmp_path, path ) != 0 ) ) {
+
+		if ( ! partial ) XX_httplib_remove_bad_file( ctx, conn, tmp_path );
+		XX_httplib_send_http_error( ctx, conn, 500, "Error: Can not save file\n%s: %s", path, httplib_error_string( ERRNO, error_string, ERROR_STRING_LEN ) );
+		return;
+	}
+
+	conn->status_code = status;
+
 	XX_httplib_gmt_time_string( date, sizeof(date), &curtime );
 	httplib_printf( ctx, conn, "HTTP/1.1 %d %s\r\n", conn->status_code, httplib_get_response_code_text( ctx, NULL, conn->status_code ) );
 	XX_httplib_send_no_cache_header( ctx, conn );
 	httplib_printf( ctx, conn, "Date: %s\r\n" "Content-Length: 0\r\n" "Connection: %s\r\n\r\n", date, XX_httplib_suggest_connection_header( ctx, conn ) );
 
-	XX_httplib_fclose( & file );
-
 }  /* XX_httplib_put_file */
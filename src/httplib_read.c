@@ -92,6 +92,17 @@ static int httplib_read_inner( const struct lh_ctx_t *ctx, struct lh_con_t *conn
 
 		n = XX_httplib_pull_all( ctx, NULL, conn, buf, (int)len64 );
 
+		/*
+		 * A body without a length ends when the peer closes the
+		 * connection. Only a timeout is an error then.
+		 */
+
+		if ( n < 0  &&  conn->content_len == INT64_MAX  &&  ! conn->deadline.expired  &&  ctx->status == CTX_STATUS_RUNNING ) {
+
+			conn->content_len = conn->consumed_content;
+			n                 = 0;
+		}
+
 		if ( n >= 0 ) nread += n;
 		else          nread  = (nread > 0) ? nread : n;
 	}
@@ -101,124 +112,13 @@ static int httplib_read_inner( const struct lh_ctx_t *ctx, struct lh_con_t *conn
 }  /* httplib_read_inner */
 
 
-static char httplib_getc( const struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
-
-	char c;
-
-	if ( conn == NULL ) return 0;
-
-	conn->content_len++;
-	if ( httplib_read_inner( ctx, conn, &c, 1 ) <= 0 ) return '\0';
-
-	return c;
-
-}  /* httplib_getc */
-
-
 int httplib_read( const struct lh_ctx_t *ctx, struct lh_con_t *conn, void *buf, size_t len ) {
 
 	if ( len > INT_MAX ) len = INT_MAX;
 
 	if ( conn == NULL ) return 0;
 
-	if ( conn->is_chunked ) {
-
-		size_t all_read;
-
-		all_read = 0;
-
-		while (len > 0) {
-
-			/*
-			 * No more data left to read
-			 */
-
-			if ( conn->is_chunked == 2 ) return 0;
-
-			if (conn->chunk_remainder) {
-
-				/* copy from the remainder of the last received chunk */
-				long read_ret;
-				size_t read_now = ((conn->chunk_remainder > len) ? (len) : (conn->chunk_remainder));
-
-				conn->content_len += (int)read_now;
-				read_ret           = httplib_read_inner( ctx, conn, (char *)buf + all_read, read_now );
-				all_read          += (size_t)read_ret;
-
-				conn->chunk_remainder -= read_now;
-				len                   -= read_now;
-
-				if ( conn->chunk_remainder == 0 ) {
-
-					/*
-					 * the rest of the data in the current chunk has been read
-					 */
-
-					if ( httplib_getc( ctx, conn ) != '\r'  ||  httplib_getc( ctx, conn ) != '\n' ) {
-
-						/*
-						 * Protocol violation
-						 */
-
-						return -1;
-					}
-				}
-			}
-			
-			else {
-				/*
-				 * fetch a new chunk
-				 */
-
-				int i;
-				char lenbuf[64];
-				char *end;
-				unsigned long chunkSize;
-
-				i         = 0;
-				end       = NULL;
-				chunkSize = 0;
-
-				for (i=0; i < ((int)sizeof(lenbuf)-1); i++) {
-
-					lenbuf[i] = httplib_getc( ctx, conn );
-
-					if ( i > 0  &&  lenbuf[i] == '\r' && lenbuf[i-1] != '\r' ) continue;
-
-					if ( i > 1  &&  lenbuf[i] == '\n' && lenbuf[i-1] == '\r' ) {
-
-						lenbuf[i+1] = 0;
-						chunkSize   = strtoul( lenbuf, &end, 16 );
-
-						/*
-						 * regular end of content
-						 */
-
-						if ( chunkSize == 0 ) conn->is_chunked = 2;
-						break;
-					}
-
-					/*
-					 * illegal character for chunk length
-					 */
-
-					if ( ! isalnum( lenbuf[i] ) ) return -1;
-				}
-
-				/*
-				 * chunksize not set correctly
-				 */
-
-				if ( end == NULL  ||  *end != '\r' ) return -1;
-
-				if ( chunkSize == 0 ) break;
-
-				conn->chunk_remainder = chunkSize;
-			}
-		}
-
-		return (int)all_read;
-	}
+	if ( conn->is_chunked ) return XX_httplib_read_chunked( ctx, conn, buf, len );
 
 	return httplib_read_inner( ctx, conn, buf, len );
 
@@ -0,0 +1,73 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int64_t httplib_read_body( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_body_handler handler, void *cbdata );
+ *
+ * The function httplib_read_body() streams the body of a request or of a
+ * response which was received with httplib_get_response() to a handler
+ * function. Chunked bodies are decoded, bodies with a Content-Length end
+ * after that number of bytes and other response bodies end when the peer
+ * closes the connection. The handler is called with every block of body
+ * data as it arrives, directly from the receive buffer of the connection
+ * without copying it first. It returns a non zero value to continue, or 0 to
+ * stop reading, in which case the connection can't be used for another
+ * request anymore.
+ *
+ * The function returns the number of bytes passed to the handler, -1 if an
+ * error occured while receiving the body and -2 if the handler stopped the
+ * transfer.
+ */
+
+int64_t httplib_read_body( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_body_handler handler, void *cbdata ) {
+
+	const char *data;
+	size_t len;
+	int64_t total;
+	int retval;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  handler == NULL ) return -1;
+
+	total = 0;
+
+	while ( (retval = httplib_peek_body( ctx, conn, & data, & len )) > 0 ) {
+
+		if ( handler( ctx, conn, data, len, cbdata ) == 0 ) {
+
+			conn->must_close = true;
+			return -2;
+		}
+
+		httplib_consume_body( ctx, conn, len );
+		total += (int64_t)len;
+	}
+
+	if ( retval < 0 ) return -1;
+
+	return total;
+
+}  /* httplib_read_body */
@@ -0,0 +1,109 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int XX_httplib_read_chunked( const struct lh_ctx_t *ctx, struct lh_con_t *conn, char *buf, size_t len );
+ *
+ * The function XX_httplib_read_chunked() reads up to len bytes of a body which
+ * is received with chunked transfer encoding. The data is decoded in the
+ * connection buffer by XX_httplib_chunked_view() and copied to the buffer of
+ * the caller. Chunk data which hasn't been buffered yet is read directly into
+ * the buffer of the caller if at least CHUNK_DIRECT_READ_MIN bytes of it are
+ * requested.
+ *
+ * The function returns the number of bytes read, 0 if the whole body has
+ * already been read, or -1 if the body violates the protocol or the connection
+ * is closed before the end of the body.
+ *
+ * The bytes of the body are counted in consumed_content relative to the end
+ * of the request headers in the buffer, and the same value is kept in
+ * content_len. That way the next request on a keep-alive connection is found
+ * at request_len + content_len when the body has been read completely.
+ */
+
+int XX_httplib_read_chunked( const struct lh_ctx_t *ctx, struct lh_con_t *conn, char *buf, size_t len ) {
+
+	const char *data;
+	size_t avail;
+	size_t all_read;
+	size_t part;
+	int retval;
+	int n;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  buf == NULL ) return 0;
+
+	if ( len > INT_MAX ) len = INT_MAX;
+	all_read = 0;
+
+	while ( len > 0 ) {
+
+		retval = XX_httplib_chunked_view( ctx, conn, false, & data, & avail );
+
+		if ( retval < 0 ) return -1;
+		if ( retval == 0 ) break;
+
+		if ( avail == 0 ) {
+
+			if ( conn->chunk_state == CHUNK_STATE_DATA ) part = ( conn->chunk_remainder < len ) ? conn->chunk_remainder : len;
+			else                                         part = 0;
+
+			if ( part < CHUNK_DIRECT_READ_MIN ) {
+
+				if ( ! XX_httplib_fill_body_buffer( ctx, conn ) ) conn->chunk_state = CHUNK_STATE_ERROR;
+				continue;
+			}
+
+			n = XX_httplib_pull_all( ctx, NULL, conn, buf + all_read, (int)part );
+
+			if ( n <= 0 ) {
+
+				conn->chunk_state = CHUNK_STATE_ERROR;
+				conn->must_close  = true;
+				return -1;
+			}
+
+			conn->content_len      = conn->consumed_content;
+			conn->chunk_remainder -= (size_t)n;
+			all_read              += (size_t)n;
+			len                   -= (size_t)n;
+
+			if ( conn->chunk_remainder == 0 ) conn->chunk_state = CHUNK_STATE_DATA_CR;
+			continue;
+		}
+
+		part = ( avail < len ) ? avail : len;
+		memcpy( buf + all_read, data, part );
+		httplib_consume_body( ctx, conn, part );
+
+		all_read += part;
+		len      -= part;
+	}
+
+	return (int)all_read;
+
+}  /* XX_httplib_read_chunked */
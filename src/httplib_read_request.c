@@ -37,41 +37,34 @@
  * of the HTTP request. The buffer buf may already have some data. The length
  * of the data is stored in nread. Upon every read operation the value of nread
  * is incremented by the number of bytes read.
+ *
+ * Reads from a socket end at the deadline of the connection. When the first
+ * bytes of a request arrive on a connection which waits with a keep-alive
+ * deadline, the header deadline starts, so that the time for sending the
+ * whole request header is limited and not only the time between two reads.
  */
 
 int XX_httplib_read_request( const struct lh_ctx_t *ctx, FILE *fp, struct lh_con_t *conn, char *buf, int bufsiz, int *nread ) {
 
 	int request_len;
 	int n;
-	struct timespec last_action_time;
-	double request_timeout;
 
 	if ( ctx == NULL  ||  conn == NULL ) return 0;
 
-	n = 0;
-
-	memset( & last_action_time, 0, sizeof(last_action_time) );
-
-	request_timeout = ((double)ctx->request_timeout) / 1000.0;
-	request_len     = XX_httplib_get_request_len( buf, *nread );
+	n           = 0;
+	request_len = XX_httplib_get_request_len( buf, *nread );
 
-	/*
-	 * first time reading from this connection
-	 */
+	while ( ctx->status == CTX_STATUS_RUNNING  &&  *nread < bufsiz  &&  request_len == 0 ) {
 
-	clock_gettime( CLOCK_MONOTONIC, & last_action_time );
+		n = XX_httplib_pull( ctx, fp, conn, buf + *nread, bufsiz - *nread );
+		if ( n <= 0 ) break;
 
-	while ( ctx->status == CTX_STATUS_RUNNING  &&
-		*nread      <  bufsiz              &&
-		request_len == 0                   &&
-		((XX_httplib_difftimespec(&last_action_time, &(conn->req_time)) <= request_timeout) || (request_timeout < 0)) &&
-		( (n = XX_httplib_pull( ctx, fp, conn, buf + *nread, bufsiz - *nread, request_timeout )) > 0 ) ) {
+		if ( fp == NULL  &&  conn->deadline.kind == DEADLINE_KEEP_ALIVE ) XX_httplib_deadline_set( conn, DEADLINE_HEADER, conn->request_timeout );
 
 		*nread += n;
 		if ( *nread > bufsiz ) return -2;
 
 		request_len = XX_httplib_get_request_len( buf, *nread );
-		if ( request_timeout > 0.0 ) clock_gettime( CLOCK_MONOTONIC, & last_action_time );
 	}
 
 	return ( request_len <= 0  &&   n <= 0 ) ? -1 : request_len;
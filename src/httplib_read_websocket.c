@@ -25,263 +25,413 @@
  * Release: 1.9
  */
 
+
 #include "httplib_main.h"
 
+static bool	arena_reserve( struct lh_wsr_t *ws, size_t size );
+static void	ring_copy( const struct lh_wsr_t *ws, uint64_t pos, char *out, size_t len );
+static int	ring_fill( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsr_t *ws );
+static int	ws_pull( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsr_t *ws, char *buf, int len );
+
 /*
  * void XX_httplib_read_websocket( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_websocket_data_handler ws_data_handler, void *calback_data );
  *
- * The function XX_httplib_read_websocket() reads from a websocket connection.
+ * The function XX_httplib_read_websocket() reads from a websocket connection
+ * and passes every received message to the data handler, until the handler
+ * or the remote peer closes the connection or an error occurs.
+ *
+ * Frames are read into a ring buffer. A frame which lies completely and in
+ * one piece in the ring is unmasked in place and passed to the handler
+ * without copying. Frames which wrap around the end of the ring or are larger
+ * than the ring are collected in a payload arena. Fragmented messages are
+ * reassembled in the arena and passed to the handler as one message with the
+ * opcode of the first frame. Control frames may arrive between the fragments
+ * and are passed to the handler immediately. Messages which are compressed
+ * with the permessage-deflate extension are decompressed before they are
+ * passed to the handler. A message which would become larger than the
+ * websocket_max_message_size option is refused with a close frame with
+ * status 1009.
  */
 
 void XX_httplib_read_websocket( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_websocket_data_handler ws_data_handler, void *callback_data ) {
 
-	/* Pointer to the beginning of the portion of the incoming websocket
-	 * message queue.
-	 * The original websocket upgrade request is never removed, so the queue
-	 * begins after it. */
-	unsigned char *buf = (unsigned char *)conn->buf + conn->request_len;
+	struct lh_wsr_t ws;
+	unsigned char hdr[WEBSOCKET_HEADER_MAX];
+	unsigned char mask[4];
+	unsigned char mop;
+	unsigned char opcode;
+	char *data;
+	uint64_t data_len64;
+	size_t data_len;
+	size_t frame_len;
+	size_t header_len;
+	size_t mask_len;
+	size_t used;
+	size_t offset;
+	size_t base;
+	size_t len;
+	bool in_place;
+	bool fin;
+	bool exit_by_callback;
 	int n;
-	int error;
-	int exit_by_callback;
-
-	/* 
-	 * body_len is the length of the entire queue in bytes
-	 * len is the length of the current message
-	 * data_len is the length of the current message's data payload
-	 * header_len is the length of the current message's header
-	 */
+	int timeout;
 
-	size_t i;
-	size_t len;
-	size_t mask_len = 0;
-	size_t data_len = 0;
-	size_t header_len;
-	size_t body_len;
+	if ( ctx == NULL  ||   conn == NULL ) return;
 
 	/*
-	 * "The masking key is a 32-bit value chosen at random by the client."
-	 * http://tools.ietf.org/html/draft-ietf-hybi-thewebsocketprotocol-17#section-5
+	 * Websocket connections are closed when no data has been received for
+	 * the websocket timeout, or the request timeout if no websocket
+	 * timeout has been set.
 	 */
 
-	unsigned char mask[4];
+	timeout                     = ctx->websocket_timeout;
+	if ( timeout <= 0 ) timeout = ctx->request_timeout;
 
-	/*
-	 * data points to the place where the message is stored when passed to
-	 * the websocket_data callback.  This is either mem on the stack, or a
-	 * dynamically allocated buffer if it is too large.
-	 */
+	XX_httplib_deadline_set( conn, DEADLINE_WEBSOCKET, timeout );
 
-	char mem[4096];
-	char *data;
-	unsigned char mop; /* mask flag and opcode */
-	double timeout;
-
-	if ( ctx == NULL  ||   conn == NULL ) return;
+	memset( & ws, 0, sizeof(ws) );
 
-	data = mem;
+	ws.ring = httplib_malloc( WEBSOCKET_RING_LEN );
 
-	timeout                       = ((double)ctx->websocket_timeout) / 1000.0;
-	if ( timeout <= 0.0 ) timeout = ((double)ctx->request_timeout  ) / 1000.0;
+	if ( ws.ring == NULL ) {
 
-	XX_httplib_set_thread_name( ctx, "wsock" );
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket out of memory; closing connection", __func__ );
+		return;
+	}
 
 	/*
-	 * Loop continuously, reading messages from the socket, invoking the
-	 * callback, and waiting repeatedly until an error occurs.
+	 * Frames which were received together with the upgrade request are
+	 * moved from the connection buffer to the ring. The connection buffer
+	 * may be larger than the ring and what does not fit is kept in a
+	 * separate buffer which is read before the socket.
 	 */
 
-	while ( ctx->status == CTX_STATUS_RUNNING ) {
+	if ( conn->data_len > conn->request_len ) {
 
-		header_len = 0;
+		len = (size_t)(conn->data_len - conn->request_len);
+		if ( len > WEBSOCKET_RING_LEN ) len = WEBSOCKET_RING_LEN;
 
-		if ( conn->data_len < conn->request_len ) {
+		memcpy( ws.ring, conn->buf + conn->request_len, len );
+		ws.tail = len;
 
-			httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket error: data len less than request len, closing connection", __func__ );
-			break;
+		if ( conn->data_len - conn->request_len > (int)len ) {
+
+			ws.extra_len = (size_t)(conn->data_len - conn->request_len) - len;
+			ws.extra     = httplib_malloc( ws.extra_len );
+
+			if ( ws.extra == NULL ) {
+
+				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket out of memory; closing connection", __func__ );
+				ws.ring = httplib_free( ws.ring );
+				return;
+			}
+
+			memcpy( ws.extra, conn->buf + conn->request_len + len, ws.extra_len );
 		}
+	}
 
-		body_len = (size_t)(conn->data_len - conn->request_len);
+	conn->data_len = conn->request_len;
 
-		if ( body_len >= 2 ) {
+	XX_httplib_set_thread_name( ctx, "wsock" );
 
-			len      =  buf[1] & 127;
-			mask_len = (buf[1] & 128) ? 4 : 0;
+	while ( ctx->status == CTX_STATUS_RUNNING ) {
 
-			if ( len < 126  &&  body_len >= mask_len ) {
+		used       = (size_t)(ws.tail - ws.head);
+		header_len = 0;
+		data_len64 = 0;
+		mask_len   = 0;
 
-				data_len   = len;
-				header_len = 2 + mask_len;
-			}
-			
-			else if ( len == 126  &&  body_len >= mask_len+4 ) {
+		/*
+		 * Frame format: http://tools.ietf.org/html/rfc6455#section-5.2
+		 */
 
-				header_len = mask_len+4;
-				data_len   = (((size_t)buf[2]) << 8) + buf[3];
-			}
-			
-			else if ( body_len >= 10+mask_len+10 ) {
+		if ( used >= 2 ) {
 
-				header_len = mask_len+10;
-				data_len   = (((uint64_t)ntohl(*(uint32_t *)(void *)&buf[2])) << 32) + ntohl(*(uint32_t *)(void *)&buf[6]);
-			}
+			ring_copy( & ws, ws.head, (char *)hdr, ( used < sizeof(hdr) ) ? used : sizeof(hdr) );
+			header_len = XX_httplib_websocket_parse_header( hdr, used, & data_len64 );
+			mask_len   = (hdr[1] & 128) ? 4 : 0;
 		}
 
-		if ( header_len > 0  &&  body_len >= header_len ) {
+		if ( header_len == 0 ) {
 
 			/*
-			 * Allocate space to hold websocket payload
+			 * The frame header is not complete yet
 			 */
 
-			data = mem;
+			if ( ring_fill( ctx, conn, & ws ) <= 0 ) break;
+			continue;
+		}
+
+		mop    = hdr[0];
+		opcode = mop & 0x0F;
+		fin    = ( (mop & 0x80) != 0 );
+
+		if ( mask_len > 0 ) memcpy( mask, hdr + header_len - mask_len, sizeof(mask) );
+
+		/*
+		 * The payload of a fragment is appended to the message which is
+		 * reassembled in the arena. Control frames between fragments are
+		 * put behind it without becoming part of the message.
+		 */
+
+		base = ( ws.fragmented ) ? ws.msg_len : 0;
+		n    = XX_httplib_websocket_check_frame( ctx, conn, mop, data_len64, ws.fragmented, base );
+
+		if ( n != 0 ) {
+
+			XX_httplib_websocket_send_close( ctx, conn, (uint16_t)n );
+			break;
+		}
+
+		data_len  = (size_t)data_len64;
+		frame_len = header_len + data_len;
+		in_place  = ( (opcode & 0x08)  ||  ( fin  &&  ! ws.fragmented ) );
 
-			if ( data_len > sizeof(mem) ) {
+		if ( frame_len <= used ) {
 
-				data = httplib_malloc( data_len );
+			offset = (size_t)((ws.head + header_len) & (WEBSOCKET_RING_LEN-1));
 
-				if ( data == NULL ) {
+			if ( in_place  &&  offset + data_len <= WEBSOCKET_RING_LEN ) data = ws.ring + offset;
 
-					/*
-					 * Allocation failed, exit the loop and then close the
-					 * connection
-					 */
+			else {
+				if ( ! arena_reserve( & ws, base + data_len ) ) {
 
 					httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket out of memory; closing connection", __func__ );
 					break;
 				}
+
+				data = ws.arena + base;
+				ring_copy( & ws, ws.head + header_len, data, data_len );
 			}
 
-			/* Copy the mask before we shift the queue and destroy it */
-			if ( mask_len > 0 ) memcpy( mask, buf + header_len - mask_len, sizeof(mask) );
-			else                memset( mask, 0,                           sizeof(mask) );
+			ws.head += frame_len;
+		}
+
+		else if ( frame_len <= WEBSOCKET_RING_LEN ) {
 
 			/*
-			 * Read frame payload from the first message in the queue into
-			 * data and advance the queue by moving the memory in place.
+			 * The frame fits in the ring but is not complete yet
 			 */
 
-			if ( body_len < header_len ) {
+			if ( ring_fill( ctx, conn, & ws ) <= 0 ) break;
+			continue;
+		}
+
+		else {
+			/*
+			 * The frame is larger than the ring. The part which has
+			 * been received is copied to the arena and the rest is
+			 * read directly behind it.
+			 */
 
-				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket error: body len less than header len, closing connection", __func__ );
+			if ( ! arena_reserve( & ws, base + data_len ) ) {
+
+				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket out of memory; closing connection", __func__ );
 				break;
 			}
 
-			if (data_len + header_len > body_len) {
+			data = ws.arena + base;
+			len  = used - header_len;
 
-				 /*
-				  * current mask and opcode
-				  */
+			ring_copy( & ws, ws.head + header_len, data, len );
+			ws.head = ws.tail;
 
-				mop = buf[0];
+			while ( len < data_len ) {
 
-				/*
-				 * Overflow case
-				 */
+				n = ws_pull( ctx, conn, & ws, data + len, ( data_len - len > INT_MAX ) ? INT_MAX : (int)(data_len - len) );
+				if ( n <= 0 ) break;
 
-				len = body_len - header_len;
-				memcpy( data, buf + header_len, len );
-				error = 0;
+				len              += (size_t)n;
+				conn->ws_last_rx  = XX_httplib_monotonic_msec();
+			}
 
-				while ( len < data_len ) {
+			if ( len < data_len ) {
 
-					n = XX_httplib_pull( ctx, NULL, conn, data + len, (int)(data_len - len), timeout );
-					if ( n <= 0 ) {
+				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket pull failed; closing connection", __func__ );
+				break;
+			}
+		}
 
-						error = 1;
-						break;
-					}
+		if ( mask_len > 0 ) XX_httplib_websocket_mask( data, data, data_len, mask, 0 );
 
-					len += (size_t)n;
-				}
-				
-				if (error) {
+		/*
+		 * Exit the loop if callback signals to exit (server side),
+		 * or "connection close" opcode received (client side).
+		 */
 
-					httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket pull failed; closing connection", __func__ );
-					break;
-				}
+		exit_by_callback = false;
 
-				conn->data_len = conn->request_len;
-			}
-			
-			else {
-				/*
-				 * current mask and opcode, overwritten by
-				 * memmove()
-				 */
+		if ( ! (opcode & 0x08)  &&  ! fin ) {
 
-				mop = buf[0];
+			if ( ! ws.fragmented ) {
 
-				/*
-				 * Length of the message being read at the front of the
-				 * queue
-				 */
+				ws.fragmented = true;
+				ws.msg_op     = mop & 0x7F;
+			}
 
-				len = data_len + header_len;
+			ws.msg_len += data_len;
+			continue;
+		}
 
-				/*
-				 * Copy the data payload into the data pointer for the
-				 * callback
-				 */
+		if ( ! (opcode & 0x08)  &&  ws.fragmented ) {
 
-				memcpy( data, buf + header_len, data_len );
+			mop           = 0x80 | ws.msg_op;
+			data          = ws.arena;
+			data_len      = ws.msg_len + data_len;
+			ws.msg_len    = 0;
+			ws.fragmented = false;
+		}
 
-				/*
-				 * Move the queue forward len bytes
-				 */
+		if ( mop & WEBSOCKET_RSV1 ) {
 
-				memmove( buf, buf + len, body_len - len );
+			n = XX_httplib_websocket_inflate( conn, data, data_len, (size_t)ctx->websocket_max_message_size, & data, & data_len );
 
-				/*
-				 * Mark the queue as advanced
-				 */
+			if ( n != 0 ) {
 
-				conn->data_len -= (int)len;
+				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket error: %s, closing connection", __func__, ( n == -2 ) ? "decompressed message too large" : ( n == -1 ) ? "invalid compressed data" : "out of memory" );
+				XX_httplib_websocket_send_close( ctx, conn, ( n == -2 ) ? 1009 : ( n == -1 ) ? 1007 : 1011 );
+				break;
 			}
 
-			/*
-			 * Apply mask if necessary
-			 */
+			mop &= (unsigned char)~WEBSOCKET_RSV1;
+		}
 
-			if ( mask_len > 0 ) for (i=0; i<data_len; i++) data[i] ^= mask[i % 4];
+		if ( ws_data_handler != NULL  &&  ! ws_data_handler( ctx, conn, mop, data, data_len, callback_data ) ) exit_by_callback = true;
 
-			/*
-			 * Exit the loop if callback signals to exit (server side),
-			 * or "connection close" opcode received (client side).
-			 */
+		if ( exit_by_callback  ||  opcode == WEBSOCKET_OPCODE_CONNECTION_CLOSE ) break;
+	}
 
-			exit_by_callback = 0;
-			if ((ws_data_handler != NULL) && !ws_data_handler( ctx, conn, mop, data, data_len, callback_data)) exit_by_callback = 1;
+	ws.ring  = httplib_free( ws.ring  );
+	ws.arena = httplib_free( ws.arena );
+	ws.extra = httplib_free( ws.extra );
 
-			if ( data != mem ) data = httplib_free( data );
+	XX_httplib_set_thread_name( ctx, "worker" );
 
-			/*
-			 * Opcode == 8, connection close
-			 */
+}  /* XX_httplib_read_websocket */
 
-			if ( exit_by_callback  ||  (mop & 0xf) == WEBSOCKET_OPCODE_CONNECTION_CLOSE ) break;
 
-			/*
-			 * Not breaking the loop, process next websocket frame.
-			 */
-		}
-		
-		else {
-			/*
-			 * Read from the socket into the next available location in the
-			 * message queue.
-			 */
 
-			n = XX_httplib_pull( ctx, NULL, conn, conn->buf + conn->data_len, conn->buf_size - conn->data_len, timeout );
+/*
+ * static bool arena_reserve( struct lh_wsr_t *ws, size_t size );
+ *
+ * The function arena_reserve() makes sure that the payload arena has room for
+ * at least size bytes. The arena grows at least by doubling its size and the
+ * contents is preserved. The function returns false if no memory could be
+ * allocated.
+ */
 
-			/*
-			 * Error, no bytes read
-			 */
+static bool arena_reserve( struct lh_wsr_t *ws, size_t size ) {
 
-			if ( n <= 0 ) break;
+	size_t new_size;
+	char *arena;
 
-			conn->data_len += n;
-		}
+	if ( ws->arena != NULL  &&  size <= ws->arena_size ) return true;
+
+	new_size = ( ws->arena_size > 0 ) ? 2 * ws->arena_size : 4096;
+	if ( new_size < size ) new_size = size;
+
+	arena = httplib_realloc( ws->arena, new_size );
+	if ( arena == NULL ) return false;
+
+	ws->arena      = arena;
+	ws->arena_size = new_size;
+
+	return true;
+
+}  /* arena_reserve */
+
+
+
+/*
+ * static void ring_copy( const struct lh_wsr_t *ws, uint64_t pos, char *out, size_t len );
+ *
+ * The function ring_copy() copies len bytes from the ring, starting at the
+ * running byte position pos, taking care of the wrap around at the end of the
+ * ring.
+ */
+
+static void ring_copy( const struct lh_wsr_t *ws, uint64_t pos, char *out, size_t len ) {
+
+	size_t offset;
+	size_t part;
+
+	offset = (size_t)(pos & (WEBSOCKET_RING_LEN-1));
+	part   = WEBSOCKET_RING_LEN - offset;
+
+	if ( part >= len ) memcpy( out, ws->ring + offset, len );
+
+	else {
+		memcpy( out,        ws->ring + offset, part       );
+		memcpy( out + part, ws->ring,          len - part );
 	}
 
-	XX_httplib_set_thread_name( ctx, "worker" );
+}  /* ring_copy */
 
-}  /* XX_httplib_read_websocket */
+
+
+/*
+ * static int ring_fill( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsr_t *ws );
+ *
+ * The function ring_fill() reads data from the connection into the free
+ * space of the ring up to the end of the ring. The number of bytes read is
+ * returned, or a value of zero or less if the connection was closed or an
+ * error occured.
+ */
+
+static int ring_fill( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsr_t *ws ) {
+
+	size_t offset;
+	size_t len;
+	int n;
+
+	offset = (size_t)(ws->tail & (WEBSOCKET_RING_LEN-1));
+	len    = WEBSOCKET_RING_LEN - offset;
+
+	if ( len > WEBSOCKET_RING_LEN - (size_t)(ws->tail - ws->head) ) len = WEBSOCKET_RING_LEN - (size_t)(ws->tail - ws->head);
+	if ( len == 0 ) return -1;
+
+	n = ws_pull( ctx, conn, ws, ws->ring + offset, (int)len );
+
+	if ( n > 0 ) {
+
+		ws->tail         += (uint64_t)n;
+		conn->ws_last_rx  = XX_httplib_monotonic_msec();
+	}
+
+	return n;
+
+}  /* ring_fill */
+
+
+
+/*
+ * static int ws_pull( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsr_t *ws, char *buf, int len );
+ *
+ * The function ws_pull() reads at most len bytes for the websocket. Data
+ * which was received with the upgrade request and did not fit in the ring is
+ * returned first. The buffer with that data is freed as soon as it has been
+ * read completely. After that the data is read from the connection.
+ */
+
+static int ws_pull( struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsr_t *ws, char *buf, int len ) {
+
+	size_t part;
+
+	if ( ws->extra == NULL ) return XX_httplib_pull( ctx, NULL, conn, buf, len );
+
+	part = ws->extra_len - ws->extra_off;
+	if ( part > (size_t)len ) part = (size_t)len;
+
+	memcpy( buf, ws->extra + ws->extra_off, part );
+	ws->extra_off += part;
+
+	if ( ws->extra_off == ws->extra_len ) {
+
+		ws->extra     = httplib_free( ws->extra );
+		ws->extra_len = 0;
+		ws->extra_off = 0;
+	}
+
+	return (int)part;
+
+}  /* ws_pull */
@@ -0,0 +1,207 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_readv( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_iov_t *iov, int iovcnt );
+ *
+ * The function httplib_readv() reads body data of a request into a list of
+ * buffers supplied by the caller. The buffers are filled in order. Data which
+ * is already present in the connection buffer is copied first. The remaining
+ * data of a body with a known length is read from a plain socket with one
+ * readv() call for all buffers. Encrypted connections and bodies which are
+ * received with chunked transfer encoding are read buffer by buffer.
+ *
+ * The function returns the number of bytes read, 0 at the end of the body or
+ * a negative value if an error occured and no data could be read.
+ */
+
+int httplib_readv( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_iov_t *iov, int iovcnt ) {
+
+	int64_t avail;
+	int64_t total;
+	size_t part;
+	size_t offset;
+	const char *body;
+	char *base;
+	int n;
+	int i;
+#if !defined(_WIN32)
+	struct iovec vec[READV_MAX_IOV];
+	int64_t left;
+	int cnt;
+	int j;
+#endif  /* _WIN32 */
+
+	if ( ctx == NULL  ||  conn == NULL  ||  iov == NULL  ||  iovcnt < 0 ) return -1;
+
+	total = 0;
+
+	if ( conn->is_chunked ) {
+
+		for (i=0; i<iovcnt; i++) {
+
+			n = httplib_read( ctx, conn, iov[i].base, iov[i].len );
+
+			if ( n < 0 ) return ( total > 0 ) ? (int)total : n;
+
+			total += n;
+			if ( (size_t)n < iov[i].len  ||  total >= INT_MAX ) break;
+		}
+
+		return (int)total;
+	}
+
+	/*
+	 * If Content-Length is not set for a PUT or POST request, read until
+	 * socket is closed
+	 */
+
+	if ( conn->consumed_content == 0  &&  conn->content_len == -1 ) {
+
+		conn->content_len = INT64_MAX;
+		conn->must_close  = true;
+	}
+
+	/*
+	 * Copy the data which is already buffered
+	 */
+
+	avail = (int64_t)conn->data_len - (int64_t)conn->request_len - conn->consumed_content;
+	if ( avail > conn->content_len - conn->consumed_content ) avail = conn->content_len - conn->consumed_content;
+	if ( avail > INT_MAX ) avail = INT_MAX;
+
+	i      = 0;
+	offset = 0;
+
+	while ( avail > 0  &&  i < iovcnt ) {
+
+		part = iov[i].len - offset;
+		if ( (int64_t)part > avail ) part = (size_t)avail;
+
+		body = conn->buf + conn->request_len + conn->consumed_content;
+		base = iov[i].base;
+		memcpy( base + offset, body, part );
+
+		conn->consumed_content += (int64_t)part;
+		total                  += (int64_t)part;
+		avail                  -= (int64_t)part;
+		offset                 += part;
+
+		if ( offset == iov[i].len ) { i++; offset = 0; }
+	}
+
+	/*
+	 * Read the rest directly from the connection into the buffers of the
+	 * caller.
+	 */
+
+	while ( i < iovcnt  &&  conn->consumed_content < conn->content_len  &&  total < INT_MAX ) {
+
+		if ( iov[i].len == offset ) { i++; offset = 0; continue; }
+
+		n = -1;
+
+#if !defined(_WIN32)
+		if ( conn->ssl == NULL ) {
+
+			left = conn->content_len - conn->consumed_content;
+			if ( left > INT_MAX - total ) left = INT_MAX - total;
+
+			for (cnt=0, j=i; j<iovcnt  &&  cnt<READV_MAX_IOV  &&  left > 0; j++) {
+
+				base = iov[j].base;
+				vec[cnt].iov_base = base + ((j == i) ? offset : 0);
+				vec[cnt].iov_len  = iov[j].len - ((j == i) ? offset : 0);
+
+				if ( (int64_t)vec[cnt].iov_len > left ) vec[cnt].iov_len = (size_t)left;
+				left -= (int64_t)vec[cnt].iov_len;
+
+				if ( vec[cnt].iov_len > 0 ) cnt++;
+			}
+
+			/*
+			 * Let XX_httplib_pull() handle interrupted calls.
+			 */
+
+			if ( XX_httplib_deadline_wait( ctx, conn ) > 0 ) {
+
+				n = (int)readv( conn->client.sock, vec, cnt );
+				if ( n < 0  &&  ( ERRNO == EINTR  ||  ERRNO == EAGAIN  ||  ERRNO == EWOULDBLOCK ) ) n = -2;
+			}
+		}
+
+		else n = -2;
+#else  /* _WIN32 */
+		n = -2;
+#endif  /* _WIN32 */
+
+		if ( n == -2 ) {
+
+			part = iov[i].len - offset;
+			if ( (int64_t)part > conn->content_len - conn->consumed_content ) part = (size_t)(conn->content_len - conn->consumed_content);
+			if ( (int64_t)part > INT_MAX - total                            ) part = (size_t)(INT_MAX - total);
+
+			base = iov[i].base;
+			n    = XX_httplib_pull( ctx, NULL, conn, base + offset, (int)part );
+		}
+
+		if ( n <= 0 ) {
+
+			/*
+			 * A body without a length ends when the peer closes
+			 * the connection. Only a timeout is an error then.
+			 */
+
+			if ( conn->content_len == INT64_MAX  &&  ! conn->deadline.expired  &&  ctx->status == CTX_STATUS_RUNNING ) {
+
+				conn->content_len = conn->consumed_content;
+				break;
+			}
+
+			if ( total == 0 ) return -1;
+			break;
+		}
+
+		conn->consumed_content += n;
+		total                  += n;
+
+		while ( n > 0 ) {
+
+			part = iov[i].len - offset;
+			if ( part > (size_t)n ) part = (size_t)n;
+
+			offset += part;
+			n      -= (int)part;
+
+			if ( offset == iov[i].len ) { i++; offset = 0; }
+		}
+	}
+
+	return (int)total;
+
+}  /* httplib_readv */
@@ -0,0 +1,197 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+#include "httplib_utils.h"
+
+#if defined(__linux__)
+static int64_t	splice_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int fd );
+#endif  /* __linux__ */
+
+/*
+ * int64_t XX_httplib_receive_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, FILE *fp );
+ *
+ * The function XX_httplib_receive_body() writes the rest of the body of a
+ * request to an open file. Data which is already in the connection buffer is
+ * written first.
+ *
+ * On Linux the remaining data of a body with a known length, received over a
+ * plain TCP connection, is moved from the socket to a regular file with
+ * splice() through a pipe, so that the data is never copied to user space.
+ * The space for the body is reserved in advance with fallocate(). Encrypted
+ * connections, bodies with chunked transfer encoding and other systems use
+ * the buffered path with httplib_peek_body().
+ *
+ * The function returns the number of bytes written, or -1 if an error
+ * occured.
+ */
+
+int64_t XX_httplib_receive_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, FILE *fp ) {
+
+	const char *data;
+	size_t data_len;
+	int64_t total;
+	int retval;
+#if defined(__linux__)
+	int64_t n;
+	int64_t avail;
+	off_t offset;
+	struct stat st;
+	int fd;
+#endif  /* __linux__ */
+
+	if ( ctx == NULL  ||  conn == NULL  ||  fp == NULL ) return -1;
+
+	total = 0;
+
+#if defined(__linux__)
+	if ( ! conn->is_chunked  &&  conn->ssl == NULL  &&  conn->content_len >= 0  &&  conn->content_len != INT64_MAX ) {
+
+		avail = (int64_t)conn->data_len - (int64_t)conn->request_len - conn->consumed_content;
+		if ( avail > conn->content_len - conn->consumed_content ) avail = conn->content_len - conn->consumed_content;
+
+		if ( avail > 0 ) {
+
+			data = conn->buf + conn->request_len + conn->consumed_content;
+			if ( fwrite( data, 1, (size_t)avail, fp ) != (size_t)avail ) return -1;
+
+			httplib_consume_body( ctx, conn, (size_t)avail );
+			total += avail;
+		}
+
+		if ( fflush( fp ) != 0 ) return -1;
+
+		fd = fileno( fp );
+
+		if ( fstat( fd, & st ) == 0  &&  S_ISREG( st.st_mode ) ) {
+
+			offset = lseek( fd, 0, SEEK_CUR );
+
+			if ( offset >= 0  &&  conn->content_len > conn->consumed_content ) fallocate( fd, FALLOC_FL_KEEP_SIZE, offset, (off_t)(conn->content_len - conn->consumed_content) );
+
+			n = splice_body( ctx, conn, fd );
+
+			if ( n == -1 ) return -1;
+			if ( n >=  0 ) return total + n;
+
+			/*
+			 * The socket doesn't support splice(). Continue with the
+			 * buffered path.
+			 */
+		}
+	}
+#endif  /* __linux__ */
+
+	while ( (retval = httplib_peek_body( ctx, conn, & data, & data_len )) > 0 ) {
+
+		if ( fwrite( data, 1, data_len, fp ) != data_len ) return -1;
+
+		httplib_consume_body( ctx, conn, data_len );
+		total += (int64_t)data_len;
+	}
+
+	if ( retval < 0 ) return -1;
+
+	return total;
+
+}  /* XX_httplib_receive_body */
+
+
+
+#if defined(__linux__)
+
+/*
+ * static int64_t splice_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int fd );
+ *
+ * The function splice_body() moves the remaining body data from the socket
+ * of a connection to a file through a pipe. Like XX_httplib_pull() the
+ * function waits for new data until the deadline of the connection. The
+ * function returns the number of bytes written, -1 if an error occured or -2
+ * if splice() isn't supported for the socket and no data has been moved.
+ */
+
+static int64_t splice_body( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int fd ) {
+
+	int64_t total;
+	int64_t left;
+	ssize_t in;
+	ssize_t out;
+	int pfd[2];
+
+	if ( pipe2( pfd, O_CLOEXEC ) != 0 ) return -2;
+
+	total = 0;
+
+	while ( conn->consumed_content < conn->content_len ) {
+
+		if ( ctx->status != CTX_STATUS_RUNNING ) { total = -1; break; }
+
+		left = conn->content_len - conn->consumed_content;
+		if ( left > SPLICE_BLOCK_LEN ) left = SPLICE_BLOCK_LEN;
+
+		if ( XX_httplib_deadline_wait( ctx, conn ) <= 0 ) { total = -1; break; }
+
+		in = splice( conn->client.sock, NULL, pfd[1], NULL, (size_t)left, SPLICE_F_MOVE | SPLICE_F_MORE );
+
+		if ( in == 0 ) { total = -1; break; } /* shutdown of the socket at client side */
+
+		if ( in < 0 ) {
+
+			if ( ( ERRNO == EINVAL  ||  ERRNO == ENOSYS )  &&  total == 0 ) { total = -2; break; }
+
+			if ( ERRNO != EAGAIN  &&  ERRNO != EWOULDBLOCK  &&  ERRNO != EINTR ) { total = -1; break; }
+
+			/*
+			 * Interrupted call, the next wait checks the deadline again
+			 */
+
+			continue;
+		}
+
+		conn->consumed_content += in;
+
+		while ( in > 0 ) {
+
+			out = splice( pfd[0], NULL, fd, NULL, (size_t)in, SPLICE_F_MOVE | SPLICE_F_MORE );
+
+			if ( out < 0  &&  ERRNO == EINTR ) continue;
+			if ( out <= 0 ) { total = -1; break; }
+
+			in    -= out;
+			total += out;
+		}
+
+		if ( total < 0 ) break;
+	}
+
+	close( pfd[0] );
+	close( pfd[1] );
+
+	return total;
+
+}  /* splice_body */
+
+#endif  /* __linux__ */
@@ -74,7 +74,7 @@ int XX_httplib_refresh_trust( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
 
 		if ( httplib_atomic_inc( p_reload_lock ) == 1 ) {
 
-			if ( XX_httplib_ssl_use_pem_file( ctx, pem ) == 0 ) return 0;
+			if ( XX_httplib_ssl_use_pem_file( ctx, ctx->ssl_ctx, pem ) == 0 ) return 0;
 			*p_reload_lock = 0;
 		}
 	}
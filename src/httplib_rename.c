@@ -0,0 +1,58 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int XX_httplib_rename( const char *from, const char *to );
+ *
+ * The function XX_httplib_rename() provides a platform independent way to
+ * give a file a new name. An existing file with the new name is replaced. On
+ * Posix compliant systems the replacement is atomic, so that other processes
+ * either see the old or the new file, but never a partial one.
+ *
+ * The function returns 0 when successful and -1 if an error occurs.
+ */
+
+int XX_httplib_rename( const char *from, const char *to ) {
+
+#if defined(_WIN32)
+
+	wchar_t wfrom[PATH_MAX];
+	wchar_t wto[PATH_MAX];
+
+	XX_httplib_path_to_unicode( from, wfrom, ARRAY_SIZE(wfrom) );
+	XX_httplib_path_to_unicode( to,   wto,   ARRAY_SIZE(wto)   );
+
+	return ( MoveFileExW( wfrom, wto, MOVEFILE_REPLACE_EXISTING ) ) ? 0 : -1;
+
+#else  /* _WIN32 */
+
+	return rename( from, to );
+
+#endif  /* _WIN32 */
+
+}  /* XX_httplib_rename */
@@ -31,7 +31,8 @@
  * void XX_httplib_reset_per_request_attributes( struct lh_con_t *conn );
  *
  * The function XX_httplib_reset_per_request_attributes() resets the request
- * attributes of a connection.
+ * attributes of a connection. The data in the buffer is kept, because it may
+ * already contain the next pipelined request or response.
  */
 
 void XX_httplib_reset_per_request_attributes( struct lh_con_t *conn ) {
@@ -54,7 +55,8 @@ void XX_httplib_reset_per_request_attributes( struct lh_con_t *conn ) {
 	conn->request_info.uri            = NULL; /* TODO: cleanup uri, local_uri and request_uri */
 	conn->request_info.http_version   = NULL;
 	conn->request_info.num_headers    = 0;
-	conn->data_len                    = 0;
 	conn->chunk_remainder             = 0;
+	conn->chunk_state                 = CHUNK_STATE_SIZE;
+	conn->chunk_line_len              = 0;
 
 }  /* XX_httplib_reset_per_request_attributes */
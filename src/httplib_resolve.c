@@ -0,0 +1,316 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static struct lh_dns_t *	cache_find( struct lh_rsv_t *rsv, const char *host );
+static struct lh_dns_t *	cache_add( struct lh_ctx_t *ctx, const char *host );
+static void			cache_remove( struct lh_rsv_t *rsv, struct lh_dns_t *entry );
+static bool			queue_lookup( struct lh_ctx_t *ctx, struct lh_dns_t *entry );
+static void			abstime_after( struct timespec *abstime, int64_t msec );
+
+/*
+ * int XX_httplib_resolve( struct lh_ctx_t *ctx, const char *host, union usa *addrs, int max_addrs );
+ *
+ * The function XX_httplib_resolve() returns the addresses of a host name.
+ * Names which were looked up before are answered from the resolver cache of
+ * the context until their entry expires, also when they were not found.
+ * Other names are passed to a resolver thread, and the caller waits for the
+ * result for at most resolver_timeout milliseconds. The lookup goes on when
+ * the caller gives up, so that a later call may find the name in the cache.
+ *
+ * The function returns the number of addresses, 0 if the host name was not
+ * found and -1 if the lookup didn't finish in time or failed.
+ */
+
+int XX_httplib_resolve( struct lh_ctx_t *ctx, const char *host, union usa *addrs, int max_addrs ) {
+
+	struct lh_rsv_t *rsv;
+	struct lh_dns_t *entry;
+	struct timespec abstime;
+	int64_t now;
+	int num_addrs;
+	bool timed_out;
+
+	if ( ctx == NULL  ||  host == NULL  ||  addrs == NULL  ||  max_addrs <= 0 ) return -1;
+
+	/*
+	 * Without resolver the name is looked up directly and not cached
+	 */
+
+	if ( ! ctx->resolver.initialized ) return XX_httplib_resolver_lookup( ctx, host, addrs, max_addrs );
+
+	rsv = & ctx->resolver;
+	now = XX_httplib_monotonic_msec();
+
+	httplib_pthread_mutex_lock( & rsv->mutex );
+
+	entry = cache_find( rsv, host );
+
+	if ( entry != NULL  &&  ! entry->pending  &&  entry->refs == 0  &&  entry->expires <= now ) {
+
+		cache_remove( rsv, entry );
+		entry = NULL;
+	}
+
+	if ( entry == NULL ) {
+
+		if ( rsv->stop  ||  (entry = cache_add( ctx, host )) == NULL ) {
+
+			httplib_pthread_mutex_unlock( & rsv->mutex );
+			return -1;
+		}
+
+		if ( ! queue_lookup( ctx, entry ) ) {
+
+			/*
+			 * No resolver thread is running, so the name is looked
+			 * up directly and not cached.
+			 */
+
+			cache_remove( rsv, entry );
+			httplib_pthread_mutex_unlock( & rsv->mutex );
+
+			return XX_httplib_resolver_lookup( ctx, host, addrs, max_addrs );
+		}
+
+		rsv->num_misses++;
+	}
+
+	else if ( ! entry->pending ) rsv->num_hits++;
+
+	/*
+	 * The reference keeps the entry in the cache until its result has
+	 * been copied, even if it expires or the cache is full meanwhile.
+	 */
+
+	entry->refs++;
+
+	abstime_after( &abstime, ctx->resolver_timeout );
+	timed_out = false;
+
+	while ( entry->pending  &&  ! rsv->stop  &&  ! timed_out ) {
+
+		if ( ctx->resolver_timeout > 0 ) timed_out = ( httplib_pthread_cond_timedwait( & rsv->done, & rsv->mutex, &abstime ) != 0  &&  entry->pending );
+		else                             httplib_pthread_cond_wait( & rsv->done, & rsv->mutex );
+	}
+
+	if ( entry->pending ) num_addrs = -1;
+
+	else {
+		num_addrs = ( entry->num_addrs < max_addrs ) ? entry->num_addrs : max_addrs;
+		if ( num_addrs > 0 ) memcpy( addrs, entry->addrs, (size_t)num_addrs * sizeof(addrs[0]) );
+	}
+
+	entry->refs--;
+
+	httplib_pthread_mutex_unlock( & rsv->mutex );
+
+	return num_addrs;
+
+}  /* XX_httplib_resolve */
+
+
+
+/*
+ * static struct lh_dns_t *cache_find( struct lh_rsv_t *rsv, const char *host );
+ *
+ * The function cache_find() searches the resolver cache for a host name and
+ * moves the entry to the front of the cache, so that the entries which have
+ * not been used for the longest time are at the end.
+ */
+
+static struct lh_dns_t *cache_find( struct lh_rsv_t *rsv, const char *host ) {
+
+	struct lh_dns_t *entry;
+	struct lh_dns_t *prev;
+
+	prev = NULL;
+
+	for (entry=rsv->first; entry != NULL; entry=entry->next) {
+
+		if ( ! httplib_strcasecmp( entry->host, host ) ) break;
+		prev = entry;
+	}
+
+	if ( entry != NULL  &&  prev != NULL ) {
+
+		prev->next  = entry->next;
+		entry->next = rsv->first;
+		rsv->first  = entry;
+	}
+
+	return entry;
+
+}  /* cache_find */
+
+
+
+/*
+ * static struct lh_dns_t *cache_add( struct lh_ctx_t *ctx, const char *host );
+ *
+ * The function cache_add() adds a pending entry for a host name in front of
+ * the resolver cache. When the cache is full, expired entries are removed
+ * first, and otherwise the least recently used entry which nobody waits for.
+ * NULL is returned if no memory could be allocated.
+ */
+
+static struct lh_dns_t *cache_add( struct lh_ctx_t *ctx, const char *host ) {
+
+	struct lh_rsv_t *rsv;
+	struct lh_dns_t *entry;
+	struct lh_dns_t *next;
+	struct lh_dns_t *victim;
+	int64_t now;
+
+	rsv = & ctx->resolver;
+
+	if ( rsv->num_entries >= RESOLVER_MAX_ENTRIES ) {
+
+		now    = XX_httplib_monotonic_msec();
+		victim = NULL;
+
+		for (entry=rsv->first; entry != NULL; entry=next) {
+
+			next = entry->next;
+
+			if ( entry->pending  ||  entry->refs > 0 ) continue;
+
+			if ( entry->expires <= now ) cache_remove( rsv, entry );
+			else                         victim = entry;
+		}
+
+		if ( rsv->num_entries >= RESOLVER_MAX_ENTRIES  &&  victim != NULL ) cache_remove( rsv, victim );
+	}
+
+	entry = httplib_calloc( 1, sizeof(struct lh_dns_t) );
+	if ( entry == NULL ) return NULL;
+
+	entry->host = httplib_strdup( host );
+
+	if ( entry->host == NULL ) {
+
+		entry = httplib_free( entry );
+		return NULL;
+	}
+
+	entry->pending = true;
+	entry->next    = rsv->first;
+	rsv->first     = entry;
+	rsv->num_entries++;
+
+	return entry;
+
+}  /* cache_add */
+
+
+
+/*
+ * static void cache_remove( struct lh_rsv_t *rsv, struct lh_dns_t *entry );
+ *
+ * The function cache_remove() unlinks an entry from the resolver cache and
+ * frees it. The entry may not be pending or waited for.
+ */
+
+static void cache_remove( struct lh_rsv_t *rsv, struct lh_dns_t *entry ) {
+
+	struct lh_dns_t **link;
+
+	for (link=&rsv->first; *link != NULL; link=&(*link)->next) {
+
+		if ( *link != entry ) continue;
+
+		*link       = entry->next;
+		entry->host = httplib_free( entry->host );
+		entry       = httplib_free( entry       );
+		rsv->num_entries--;
+
+		return;
+	}
+
+}  /* cache_remove */
+
+
+
+/*
+ * static bool queue_lookup( struct lh_ctx_t *ctx, struct lh_dns_t *entry );
+ *
+ * The function queue_lookup() appends a pending entry to the queue of the
+ * resolver and wakes up a resolver thread. A new thread is started when all
+ * threads are busy and the number of threads set with the resolver_threads
+ * option has not been reached yet. If no resolver thread is running at all,
+ * the entry is not queued and false is returned.
+ */
+
+static bool queue_lookup( struct lh_ctx_t *ctx, struct lh_dns_t *entry ) {
+
+	struct lh_rsv_t *rsv;
+	int max_threads;
+
+	rsv         = & ctx->resolver;
+	max_threads = ( ctx->resolver_threads < RESOLVER_MAX_THREADS ) ? ctx->resolver_threads : RESOLVER_MAX_THREADS;
+
+	if ( rsv->num_idle == 0  &&  rsv->num_threads < max_threads ) {
+
+		if ( XX_httplib_start_thread_with_id( XX_httplib_resolver_thread, ctx, & rsv->threadids[rsv->num_threads] ) == 0 ) rsv->num_threads++;
+		else httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: cannot start resolver thread", __func__ );
+	}
+
+	if ( rsv->num_threads == 0 ) return false;
+
+	if ( rsv->queue_last == NULL ) rsv->queue_first            = entry;
+	else                           rsv->queue_last->queue_next = entry;
+
+	rsv->queue_last = entry;
+
+	httplib_pthread_cond_signal( & rsv->work );
+
+	return true;
+
+}  /* queue_lookup */
+
+
+
+/*
+ * static void abstime_after( struct timespec *abstime, int64_t msec );
+ *
+ * The function abstime_after() returns the wall clock time a number of
+ * milliseconds from now, as needed by a timed wait on a condition variable.
+ */
+
+static void abstime_after( struct timespec *abstime, int64_t msec ) {
+
+	clock_gettime( CLOCK_REALTIME, abstime );
+
+	abstime->tv_sec  += (time_t)(msec / 1000);
+	abstime->tv_nsec += (long)((msec % 1000) * 1000000);
+
+	if ( abstime->tv_nsec >= 1000000000 ) {
+
+		abstime->tv_sec++;
+		abstime->tv_nsec -= 1000000000;
+	}
+
+}  /* abstime_after */
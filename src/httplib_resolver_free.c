@@ -0,0 +1,74 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_resolver_free( struct lh_ctx_t *ctx );
+ *
+ * The function XX_httplib_resolver_free() stops the resolver threads of a
+ * context and frees the resolver cache. A thread which is busy with a lookup
+ * is waited for, because the system resolver can't be interrupted.
+ */
+
+void XX_httplib_resolver_free( struct lh_ctx_t *ctx ) {
+
+	struct lh_rsv_t *rsv;
+	struct lh_dns_t *entry;
+	int i;
+
+	if ( ctx == NULL  ||  ! ctx->resolver.initialized ) return;
+
+	rsv = & ctx->resolver;
+
+	httplib_pthread_mutex_lock( & rsv->mutex );
+
+	rsv->stop = true;
+	httplib_pthread_cond_broadcast( & rsv->work );
+	httplib_pthread_cond_broadcast( & rsv->done );
+
+	httplib_pthread_mutex_unlock( & rsv->mutex );
+
+	for (i=0; i<rsv->num_threads; i++) httplib_pthread_join( rsv->threadids[i], NULL );
+
+	rsv->num_threads = 0;
+
+	while ( (entry = rsv->first) != NULL ) {
+
+		rsv->first  = entry->next;
+		entry->host = httplib_free( entry->host );
+		entry       = httplib_free( entry       );
+	}
+
+	rsv->num_entries = 0;
+	rsv->queue_first = NULL;
+	rsv->queue_last  = NULL;
+	rsv->initialized = false;
+
+	httplib_pthread_cond_destroy(  & rsv->done  );
+	httplib_pthread_cond_destroy(  & rsv->work  );
+	httplib_pthread_mutex_destroy( & rsv->mutex );
+
+}  /* XX_httplib_resolver_free */
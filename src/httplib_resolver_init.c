@@ -0,0 +1,63 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_resolver_init( struct lh_ctx_t *ctx );
+ *
+ * The function XX_httplib_resolver_init() initializes the resolver of a
+ * context. The resolver threads are started when the first host name must be
+ * looked up. The function returns false if an error occured.
+ */
+
+bool XX_httplib_resolver_init( struct lh_ctx_t *ctx ) {
+
+	struct lh_rsv_t *rsv;
+
+	if ( ctx == NULL ) return false;
+
+	rsv = & ctx->resolver;
+
+	if ( httplib_pthread_mutex_init( & rsv->mutex, NULL ) ) return false;
+
+	if ( httplib_pthread_cond_init( & rsv->work, NULL ) ) {
+
+		httplib_pthread_mutex_destroy( & rsv->mutex );
+		return false;
+	}
+
+	if ( httplib_pthread_cond_init( & rsv->done, NULL ) ) {
+
+		httplib_pthread_cond_destroy(  & rsv->work  );
+		httplib_pthread_mutex_destroy( & rsv->mutex );
+		return false;
+	}
+
+	rsv->initialized = true;
+
+	return true;
+
+}  /* XX_httplib_resolver_init */
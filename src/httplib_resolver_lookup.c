@@ -0,0 +1,189 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+#include "httplib_utils.h"
+
+static int	hosts_lookup( const char *path, const char *host, union usa *addrs, int max_addrs );
+static int	add_address( union usa *addrs, int num_addrs, int max_addrs, const struct sockaddr *sa, size_t len );
+static char *	next_token( char **ptr );
+
+/*
+ * int XX_httplib_resolver_lookup( const struct lh_ctx_t *ctx, const char *host, union usa *addrs, int max_addrs );
+ *
+ * The function XX_httplib_resolver_lookup() looks up the addresses of a host
+ * name. The hosts file set with the hosts_file option is read first. If the
+ * name is not found there, the system resolver is asked, which also reads
+ * /etc/hosts. The addresses are returned in the order of the system resolver
+ * without duplicates and without port numbers. The function returns the
+ * number of addresses, 0 if the name was not found. The function blocks and
+ * is called by the resolver threads.
+ */
+
+int XX_httplib_resolver_lookup( const struct lh_ctx_t *ctx, const char *host, union usa *addrs, int max_addrs ) {
+
+	struct addrinfo hints;
+	struct addrinfo *res;
+	struct addrinfo *walk;
+	int num_addrs;
+
+	if ( ctx == NULL  ||  host == NULL  ||  addrs == NULL  ||  max_addrs <= 0 ) return 0;
+
+	if ( ctx->hosts_file != NULL ) {
+
+		num_addrs = hosts_lookup( ctx->hosts_file, host, addrs, max_addrs );
+		if ( num_addrs > 0 ) return num_addrs;
+	}
+
+	memset( & hints, 0, sizeof(hints) );
+	hints.ai_family   = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if ( getaddrinfo( host, NULL, &hints, &res ) != 0 ) return 0;
+
+	num_addrs = 0;
+
+	for (walk=res; walk != NULL; walk=walk->ai_next) num_addrs = add_address( addrs, num_addrs, max_addrs, walk->ai_addr, (size_t)walk->ai_addrlen );
+
+	freeaddrinfo( res );
+
+	return num_addrs;
+
+}  /* XX_httplib_resolver_lookup */
+
+
+
+/*
+ * static int hosts_lookup( const char *path, const char *host, union usa *addrs, int max_addrs );
+ *
+ * The function hosts_lookup() searches a file in the format of /etc/hosts for
+ * a host name. Each line holds an address followed by one or more names, and
+ * everything after a '#' is a comment. The addresses of all lines with the
+ * name are returned, in the order they appear in the file.
+ */
+
+static int hosts_lookup( const char *path, const char *host, union usa *addrs, int max_addrs ) {
+
+	FILE *fp;
+	char line[512];
+	char *addr;
+	char *name;
+	char *ptr;
+	union usa sa;
+	int num_addrs;
+	bool found;
+
+	fp = fopen( path, "r" );
+	if ( fp == NULL ) return 0;
+
+	num_addrs = 0;
+
+	while ( num_addrs < max_addrs  &&  fgets( line, sizeof(line), fp ) != NULL ) {
+
+		if ( (ptr = strchr( line, '#' )) != NULL ) *ptr = '\0';
+
+		ptr  = line;
+		addr = next_token( &ptr );
+		if ( addr == NULL ) continue;
+
+		found = false;
+
+		while ( ! found  &&  (name = next_token( &ptr )) != NULL ) found = ( httplib_strcasecmp( name, host ) == 0 );
+
+		if ( ! found ) continue;
+
+		memset( & sa, 0, sizeof(sa) );
+
+		if      ( XX_httplib_inet_pton( AF_INET,  addr, & sa.sin,  sizeof(sa.sin)  ) ) num_addrs = add_address( addrs, num_addrs, max_addrs, & sa.sa, sizeof(sa.sin)  );
+		else if ( XX_httplib_inet_pton( AF_INET6, addr, & sa.sin6, sizeof(sa.sin6) ) ) num_addrs = add_address( addrs, num_addrs, max_addrs, & sa.sa, sizeof(sa.sin6) );
+	}
+
+	fclose( fp );
+
+	return num_addrs;
+
+}  /* hosts_lookup */
+
+
+
+/*
+ * static int add_address( union usa *addrs, int num_addrs, int max_addrs, const struct sockaddr *sa, size_t len );
+ *
+ * The function add_address() adds an IPv4 or IPv6 address to a list of
+ * addresses, unless the list is full or already contains the address. The
+ * new number of addresses in the list is returned.
+ */
+
+static int add_address( union usa *addrs, int num_addrs, int max_addrs, const struct sockaddr *sa, size_t len ) {
+
+	union usa addr;
+	int a;
+
+	if ( num_addrs >= max_addrs ) return num_addrs;
+
+	memset( & addr, 0, sizeof(addr) );
+
+	if      ( sa->sa_family == AF_INET   &&  len >= sizeof(addr.sin)  ) memcpy( & addr.sin,  sa, sizeof(addr.sin)  );
+	else if ( sa->sa_family == AF_INET6  &&  len >= sizeof(addr.sin6) ) memcpy( & addr.sin6, sa, sizeof(addr.sin6) );
+	else return num_addrs;
+
+	for (a=0; a<num_addrs; a++) {
+
+		if ( addrs[a].sa.sa_family != addr.sa.sa_family ) continue;
+
+		if ( addr.sa.sa_family == AF_INET   &&  ! memcmp( & addrs[a].sin.sin_addr,   & addr.sin.sin_addr,   sizeof(addr.sin.sin_addr)   ) ) return num_addrs;
+		if ( addr.sa.sa_family == AF_INET6  &&  ! memcmp( & addrs[a].sin6.sin6_addr, & addr.sin6.sin6_addr, sizeof(addr.sin6.sin6_addr) ) ) return num_addrs;
+	}
+
+	addrs[num_addrs] = addr;
+
+	return num_addrs+1;
+
+}  /* add_address */
+
+
+
+/*
+ * static char *next_token( char **ptr );
+ *
+ * The function next_token() returns the next word of a line which is
+ * separated by white space and terminates it in place. The pointer is moved
+ * past the word. NULL is returned at the end of the line. Unlike strtok() the
+ * function keeps no state, so that several resolver threads can use it.
+ */
+
+static char *next_token( char **ptr ) {
+
+	char *token;
+
+	token = *ptr + strspn( *ptr, " \t\r\n" );
+	if ( *token == '\0' ) return NULL;
+
+	*ptr = token + strcspn( token, " \t\r\n" );
+	if ( **ptr != '\0' ) *(*ptr)++ = '\0';
+
+	return token;
+
+}  /* next_token */
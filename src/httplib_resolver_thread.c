@@ -0,0 +1,128 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+#include "httplib_pthread.h"
+
+static void	resolver_run( struct lh_ctx_t *ctx );
+
+/*
+ * LIBHTTP_THREAD XX_httplib_resolver_thread( void *data );
+ *
+ * The function XX_httplib_resolver_thread() is the wrapper function around a
+ * resolver thread of a context. Calling convention of the function differs
+ * depending on the operating system.
+ */
+
+LIBHTTP_THREAD XX_httplib_resolver_thread( void *data ) {
+
+	if ( data != NULL ) resolver_run( data );
+
+	return LIBHTTP_THREAD_RETNULL;
+
+}  /* XX_httplib_resolver_thread */
+
+
+
+/*
+ * static void resolver_run( struct lh_ctx_t *ctx );
+ *
+ * The function resolver_run() takes host names from the queue of the
+ * resolver and looks them up without holding the mutex of the resolver. The
+ * result is stored in the cache entry of the name with the time it expires,
+ * and the callers waiting for it are woken up. The thread runs until the
+ * resolver is freed.
+ */
+
+static void resolver_run( struct lh_ctx_t *ctx ) {
+
+	struct httplib_workerTLS tls;
+	struct lh_rsv_t *rsv;
+	struct lh_dns_t *entry;
+	union usa addrs[RESOLVER_MAX_ADDRS];
+	int num_addrs;
+	int ttl;
+
+	XX_httplib_set_thread_name( ctx, "resolver" );
+
+	/*
+	 * The thread local storage key only exists while a server context is
+	 * running.
+	 */
+
+	tls.thread_idx = (unsigned)httplib_atomic_inc( & XX_httplib_thread_idx_max );
+#if defined(_WIN32)
+	tls.pthread_cond_helper_mutex = CreateEvent( NULL, FALSE, FALSE, NULL );
+#endif
+	if ( ctx->ctx_type == CTX_TYPE_SERVER ) httplib_pthread_setspecific( XX_httplib_sTlsKey, &tls );
+
+	rsv = & ctx->resolver;
+
+	httplib_pthread_mutex_lock( & rsv->mutex );
+
+	while ( ! rsv->stop ) {
+
+		if ( rsv->queue_first == NULL ) {
+
+			rsv->num_idle++;
+			httplib_pthread_cond_wait( & rsv->work, & rsv->mutex );
+			rsv->num_idle--;
+			continue;
+		}
+
+		entry            = rsv->queue_first;
+		rsv->queue_first = entry->queue_next;
+		if ( rsv->queue_first == NULL ) rsv->queue_last = NULL;
+
+		entry->queue_next = NULL;
+
+		/*
+		 * The entry stays in place while it is pending, so its host
+		 * name can be used without holding the mutex.
+		 */
+
+		httplib_pthread_mutex_unlock( & rsv->mutex );
+
+		num_addrs = XX_httplib_resolver_lookup( ctx, entry->host, addrs, RESOLVER_MAX_ADDRS );
+		ttl       = ( num_addrs > 0 ) ? ctx->resolver_cache_ttl : ctx->resolver_negative_ttl;
+
+		httplib_pthread_mutex_lock( & rsv->mutex );
+
+		if ( num_addrs > 0 ) memcpy( entry->addrs, addrs, (size_t)num_addrs * sizeof(addrs[0]) );
+
+		entry->num_addrs = num_addrs;
+		entry->expires   = XX_httplib_monotonic_msec() + (int64_t)ttl * 1000;
+		entry->pending   = false;
+
+		httplib_pthread_cond_broadcast( & rsv->done );
+	}
+
+	httplib_pthread_mutex_unlock( & rsv->mutex );
+
+#if defined(_WIN32)
+	CloseHandle( tls.pthread_cond_helper_mutex );
+#endif
+
+}  /* resolver_run */
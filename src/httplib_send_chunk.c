@@ -0,0 +1,80 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_send_chunk( const struct lh_ctx_t *ctx, struct lh_con_t *conn, char *data, size_t len, bool last );
+ *
+ * The function XX_httplib_send_chunk() sends a block of data as one chunk of
+ * a response with chunked transfer encoding. The chunk size line is written
+ * in the CHUNK_HDR_LEN bytes in front of the data, and the CRLF which ends
+ * the chunk after the data. If the last flag is set, the last chunk which
+ * ends the body is added as well. The caller must therefore make sure that
+ * CHUNK_HDR_LEN bytes before and CHUNK_TAIL_LEN bytes after the data can be
+ * overwritten. The whole block is sent with one write. The function returns
+ * false if an error occured.
+ */
+
+bool XX_httplib_send_chunk( const struct lh_ctx_t *ctx, struct lh_con_t *conn, char *data, size_t len, bool last ) {
+
+	char size_line[CHUNK_HDR_LEN];
+	char *start;
+	size_t total;
+	int hlen;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  data == NULL ) return false;
+
+	start = data;
+	total = 0;
+
+	/*
+	 * A chunk with size zero would be interpreted as the last chunk by the
+	 * client, so empty data is only sent when the body is finished.
+	 */
+
+	if ( len > 0 ) {
+
+		hlen = snprintf( size_line, sizeof(size_line), "%lx\r\n", (unsigned long)len );
+		if ( hlen < 0  ||  hlen >= CHUNK_HDR_LEN ) return false;
+
+		start -= hlen;
+		memcpy( start, size_line, (size_t)hlen );
+		memcpy( data + len, "\r\n", 2 );
+		total = (size_t)hlen + len + 2;
+	}
+
+	if ( last ) {
+
+		memcpy( start + total, "0\r\n\r\n", 5 );
+		total += 5;
+	}
+
+	if ( total == 0 ) return true;
+
+	return ( XX_httplib_write_raw( ctx, conn, start, total ) == (int)total );
+
+}  /* XX_httplib_send_chunk */
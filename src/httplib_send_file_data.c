@@ -83,6 +83,13 @@ void XX_httplib_send_file_data( struct lh_ctx_t *ctx, struct lh_con_t *conn, str
 
 		if ( ctx->allow_sendfile_call  &&  conn->ssl == 0  &&  conn->throttle == 0 ) {
 
+			/*
+			 * Held back responses and the headers of this response
+			 * must go out before the file.
+			 */
+
+			if ( conn->out_len > 0  &&  XX_httplib_flush_output( ctx, conn, NULL, 0 ) < 0 ) return;
+
 			sf_offs  = (off_t)offset;
 			sf_file  = fileno( filep->fp );
 			loop_cnt = 0;
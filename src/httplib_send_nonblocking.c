@@ -0,0 +1,80 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+#ifdef _WIN32
+	typedef int len_t;
+#else
+	typedef size_t len_t;
+#endif
+
+/*
+ * int64_t XX_httplib_send_nonblocking( SOCKET sock, const char *buf, int64_t len );
+ *
+ * The function XX_httplib_send_nonblocking() sends as much data from a buffer
+ * to a socket as is possible without waiting for the peer. The socket itself
+ * stays in blocking mode for all other I/O. The number of bytes sent is
+ * returned, which is zero if the send buffer of the socket is full. A
+ * negative value is returned if an error occured.
+ */
+
+int64_t XX_httplib_send_nonblocking( SOCKET sock, const char *buf, int64_t len ) {
+
+	int n;
+	int err;
+#if defined(_WIN32)
+	unsigned long on;
+#endif  /* _WIN32 */
+
+	if ( buf == NULL  ||  len < 0 ) return -1;
+	if ( len > INT_MAX            ) len = INT_MAX;
+
+#if defined(_WIN32)
+
+	on = 1;
+	if ( ioctlsocket( sock, (long)FIONBIO, & on ) != 0 ) return -1;
+
+	n   = send( sock, buf, (len_t)len, 0 );
+	err = ( n < 0 ) ? WSAGetLastError() : 0;
+
+	on = 0;
+	ioctlsocket( sock, (long)FIONBIO, & on );
+
+	if ( n < 0  &&  err == WSAEWOULDBLOCK ) n = 0;
+
+#else  /* _WIN32 */
+
+	n   = (int)send( sock, buf, (len_t)len, MSG_DONTWAIT | MSG_NOSIGNAL );
+	err = ( n < 0 ) ? ERRNO : 0;
+
+	if ( n < 0  &&  ( err == EAGAIN  ||  err == EWOULDBLOCK  ||  err == EINTR ) ) n = 0;
+
+#endif  /* _WIN32 */
+
+	return n;
+
+}  /* XX_httplib_send_nonblocking */
@@ -0,0 +1,83 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_send_requests( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_out_t *out, int num_out );
+ *
+ * The function XX_httplib_send_requests() sends a number of formatted
+ * requests over a client connection as one stream. Over a plain connection
+ * the buffers are passed to the kernel with one call, so that small pipelined
+ * requests leave in one packet. Over a secure connection the requests are
+ * copied into one buffer first, which is then encrypted and sent with one
+ * SSL_write(). The function returns true if all data was sent.
+ */
+
+bool XX_httplib_send_requests( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_out_t *out, int num_out ) {
+
+	int64_t total;
+	int64_t sent;
+	size_t pos;
+	char *buf;
+	int i;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  out == NULL  ||  num_out <= 0 ) return false;
+
+	total = 0;
+	for (i=0; i<num_out; i++) total += (int64_t)out[i].len;
+
+	if ( conn->ssl == NULL ) {
+
+		sent = XX_httplib_sendv( ctx, conn->client.sock, out, num_out, true );
+		conn->num_bytes_sent += ( sent > 0 ) ? sent : 0;
+
+		return ( sent == total );
+	}
+
+	if ( num_out == 1 ) sent = XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, out[0].base, total );
+
+	else {
+
+		buf = httplib_malloc( (size_t)total );
+		if ( buf == NULL ) return false;
+
+		pos = 0;
+
+		for (i=0; i<num_out; i++) {
+
+			memcpy( buf+pos, out[i].base, out[i].len );
+			pos += out[i].len;
+		}
+
+		sent = XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, buf, total );
+		buf  = httplib_free( buf );
+	}
+
+	conn->num_bytes_sent += ( sent > 0 ) ? sent : 0;
+
+	return ( sent == total );
+
+}  /* XX_httplib_send_requests */
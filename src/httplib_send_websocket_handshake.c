@@ -34,7 +34,8 @@
  * int XX_httplib_send_websocket_handshake( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *websock_key );
  *
  * The function XX_httplib_send_websocket_handshake() sends a handshake over
- * a websocket connection.
+ * a websocket connection. If the client offers the permessage-deflate
+ * extension and it can be supported, it is accepted in the response.
  */
 
 int XX_httplib_send_websocket_handshake( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *websock_key ) {
@@ -42,6 +43,7 @@ int XX_httplib_send_websocket_handshake( struct lh_ctx_t *ctx, struct lh_con_t *
 	static const char *magic = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 	const char *protocol;
 	char buf[100];
+	char extensions[128];
 	char sha[20];
 	char b64_sha[B64_SHA_LEN];
 	SHA1_CTX sha_ctx;
@@ -74,6 +76,11 @@ int XX_httplib_send_websocket_handshake( struct lh_ctx_t *ctx, struct lh_con_t *
 	          "Sec-WebSocket-Accept: %s\r\n",
 	          b64_sha );
 
+	if ( XX_httplib_websocket_deflate_negotiate( ctx, conn, httplib_get_header( conn, "Sec-WebSocket-Extensions" ), extensions, sizeof(extensions) ) ) {
+
+		httplib_printf( ctx, conn, "Sec-WebSocket-Extensions: %s\r\n", extensions );
+	}
+
 	protocol = httplib_get_header( conn, "Sec-WebSocket-Protocol" );
 	if ( protocol ) {
 		/*
@@ -0,0 +1,154 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int64_t XX_httplib_sendv( const struct lh_ctx_t *ctx, SOCKET sock, const struct lh_out_t *out, int num_out, bool blocking );
+ *
+ * The function XX_httplib_sendv() sends the data in a list of buffers over a
+ * plain socket as one stream, so that for example a websocket frame header
+ * and its payload, or several queued frames, leave with one system call and
+ * end up in one packet when they are small enough. On systems with sendmsg()
+ * up to SENDV_MAX_IOV buffers are passed in one call, on other systems the
+ * buffers are sent one by one.
+ *
+ * In blocking mode the function returns when all data has been sent, the
+ * server stops or an error occurs. Otherwise it sends as much as the socket
+ * accepts without waiting. The function returns the number of bytes sent,
+ * which is less than the total length of the buffers if not everything could
+ * be sent, or -1 if an error occured before any data was sent.
+ */
+
+int64_t XX_httplib_sendv( const struct lh_ctx_t *ctx, SOCKET sock, const struct lh_out_t *out, int num_out, bool blocking ) {
+
+	int64_t total;
+	int64_t n;
+	int i;
+#if defined(_WIN32)
+	int64_t len;
+#else  /* _WIN32 */
+	struct iovec vec[SENDV_MAX_IOV];
+	struct msghdr msg;
+	size_t skip;
+	size_t off;
+	size_t want;
+	ssize_t sent;
+	int cnt;
+	int err;
+	int j;
+	union {
+		const void *	con;
+		void *		var;
+	} ptr;
+#endif  /* _WIN32 */
+
+	if ( ctx == NULL  ||  out == NULL  ||  num_out < 0 ) return -1;
+
+	total = 0;
+
+#if defined(_WIN32)
+
+	for (i=0; i<num_out; i++) {
+
+		if ( out[i].len == 0 ) continue;
+
+		len = (int64_t)out[i].len;
+
+		if ( blocking ) n = XX_httplib_push_all(         ctx, NULL, sock, NULL, out[i].base, len );
+		else            n = XX_httplib_send_nonblocking(                sock,       out[i].base, len );
+
+		if ( n < 0 ) return ( total > 0 ) ? total : -1;
+
+		total += n;
+		if ( n < len ) break;
+	}
+
+#else  /* _WIN32 */
+
+	i    = 0;
+	skip = 0;
+
+	while ( i < num_out ) {
+
+		cnt  = 0;
+		want = 0;
+
+		for (j=i; j<num_out && cnt<SENDV_MAX_IOV; j++) {
+
+			off = ( j == i ) ? skip : 0;
+			if ( out[j].len <= off ) continue;
+
+			ptr.con           = (const char *)out[j].base + off;
+			vec[cnt].iov_base = ptr.var;
+			vec[cnt].iov_len  = out[j].len - off;
+			want             += out[j].len - off;
+			cnt++;
+		}
+
+		if ( cnt == 0 ) break;
+
+		memset( & msg, 0, sizeof(msg) );
+		msg.msg_iov    = vec;
+		msg.msg_iovlen = (size_t)cnt;
+
+		sent = sendmsg( sock, & msg, MSG_NOSIGNAL | ( ( blocking ) ? 0 : MSG_DONTWAIT ) );
+
+		if ( sent < 0 ) {
+
+			err = ERRNO;
+
+			if (   blocking  &&  err == EINTR  &&  ctx->status == CTX_STATUS_RUNNING                  ) continue;
+			if ( ! blocking  &&  ( err == EAGAIN  ||  err == EWOULDBLOCK  ||  err == EINTR ) ) break;
+
+			return ( total > 0 ) ? total : -1;
+		}
+
+		total += sent;
+		n      = sent;
+
+		/*
+		 * The buffers which have been sent completely are skipped, and
+		 * for the first remaining buffer the number of bytes which were
+		 * sent already is remembered.
+		 */
+
+		while ( i < num_out  &&  n >= (int64_t)(out[i].len - skip) ) {
+
+			n    -= (int64_t)(out[i].len - skip);
+			skip  = 0;
+			i++;
+		}
+
+		skip += (size_t)n;
+
+		if ( (size_t)sent < want  &&  ( ! blocking  ||  ctx->status != CTX_STATUS_RUNNING ) ) break;
+	}
+
+#endif  /* _WIN32 */
+
+	return total;
+
+}  /* XX_httplib_sendv */
@@ -39,13 +39,14 @@
 // #define TCP_USER_TIMEOUT (18)
 
 /*
- * int XX_httplib_set_sock_timeout( SOCKET sock, int milliseconds );
+ * int XX_httplib_set_sock_timeout( SOCKET sock, int milliseconds, bool receive );
  *
- * The function XX_httplib_set_sock_timeout() sets the timeout of a socket
- * to the specified nummer of milliseconds.
+ * The function XX_httplib_set_sock_timeout() sets the send timeout of a
+ * socket to the specified nummer of milliseconds. The receive timeout is
+ * only set when requested.
  */
 
-int XX_httplib_set_sock_timeout( SOCKET sock, int milliseconds ) {
+int XX_httplib_set_sock_timeout( SOCKET sock, int milliseconds, bool receive ) {
 
 	int r0;
 	int r1;
@@ -78,7 +79,7 @@ int XX_httplib_set_sock_timeout( SOCKET sock, int milliseconds ) {
 
 #endif /* _WIN32 */
 
-	r1 = setsockopt( sock, SOL_SOCKET, SO_RCVTIMEO, (SOCK_OPT_TYPE)&tv, sizeof(tv) );
+	r1 = ( receive ) ? setsockopt( sock, SOL_SOCKET, SO_RCVTIMEO, (SOCK_OPT_TYPE)&tv, sizeof(tv) ) : 0;
 	r2 = setsockopt( sock, SOL_SOCKET, SO_SNDTIMEO, (SOCK_OPT_TYPE)&tv, sizeof(tv) );
 
 	return (r0  ||  r1  ||  r2);
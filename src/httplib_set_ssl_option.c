@@ -30,8 +30,6 @@
 #include "httplib_main.h"
 #include "httplib_ssl.h"
 
-static void *ssllib_dll_handle;    /* Store the ssl library handle. */
-
 /*
  * bool XX_httplib_set_ssl_option( struct lh_ctx_t *ctx );
  *
@@ -62,19 +60,6 @@ bool XX_httplib_set_ssl_option( struct lh_ctx_t *ctx ) {
 
 	if ( ! XX_httplib_initialize_ssl( ctx ) ) return false;
 
-#if !defined(NO_SSL_DL)
-
-	if ( ssllib_dll_handle == NULL ) {
-
-		ssllib_dll_handle = XX_httplib_load_dll( ctx, SSL_LIB, XX_httplib_ssl_sw );
-		if ( ssllib_dll_handle == NULL ) return false;
-	}
-
-#endif /* NO_SSL_DL */
-
-	SSL_library_init();
-	SSL_load_error_strings();
-
 	ctx->ssl_ctx = SSL_CTX_new( SSLv23_server_method() );
 	if ( ctx->ssl_ctx == NULL ) {
 
@@ -125,7 +110,7 @@ bool XX_httplib_set_ssl_option( struct lh_ctx_t *ctx ) {
 
 	SSL_CTX_set_session_id_context( ctx->ssl_ctx, (const unsigned char *)&ssl_context_id, sizeof(ssl_context_id) );
 
-	if ( pem != NULL  &&  ! XX_httplib_ssl_use_pem_file( ctx, pem ) ) return false;
+	if ( pem != NULL  &&  ! XX_httplib_ssl_use_pem_file( ctx, ctx->ssl_ctx, pem ) ) return false;
 
 	if ( ctx->ssl_verify_peer ) {
 
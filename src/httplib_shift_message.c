@@ -0,0 +1,48 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_shift_message( struct lh_con_t *conn );
+ *
+ * The function XX_httplib_shift_message() removes the message which was read
+ * last from the buffer of a connection. Bytes which were received after the
+ * end of its body belong to the next pipelined message, which now starts the
+ * buffer without being copied. The body of the message must have been read
+ * completely. Nothing is removed if no message has been parsed yet, so that
+ * partly received headers are kept.
+ */
+
+void XX_httplib_shift_message( struct lh_con_t *conn ) {
+
+	if ( conn == NULL  ||  conn->request_len <= 0 ) return;
+
+	XX_httplib_buffer_discard( conn, (int)( conn->request_len + conn->consumed_content ) );
+
+	conn->request_len      = 0;
+	conn->consumed_content = 0;
+
+}  /* XX_httplib_shift_message */
@@ -96,6 +96,9 @@ struct ssl_func {
 #define SSL_CTX_set_session_id_context		(*(int (*)(SSL_CTX *, const unsigned char *, unsigned int))XX_httplib_ssl_sw[29].ptr)
 #define SSL_CTX_ctrl				(*(long (*)(SSL_CTX *, int, long, void *))XX_httplib_ssl_sw[30].ptr)
 #define SSL_CTX_set_cipher_list			(*(int (*)(SSL_CTX *, const char *))XX_httplib_ssl_sw[31].ptr)
+#define SSL_get1_session			(*(SSL_SESSION * (*)(SSL *))XX_httplib_ssl_sw[32].ptr)
+#define SSL_set_session				(*(int (*)(SSL *, SSL_SESSION *))XX_httplib_ssl_sw[33].ptr)
+#define SSL_SESSION_free			(*(void (*)(SSL_SESSION *))XX_httplib_ssl_sw[34].ptr)
 #define SSL_CTX_set_options(ctx, op)		SSL_CTX_ctrl((ctx), SSL_CTRL_OPTIONS, (op), NULL)
 #define SSL_CTX_clear_options(ctx, op)		SSL_CTX_ctrl((ctx), SSL_CTRL_CLEAR_OPTIONS, (op), NULL)
 #define SSL_CTX_set_ecdh_auto(ctx, onoff)	SSL_CTX_ctrl(ctx, SSL_CTRL_SET_ECDH_AUTO, onoff, NULL)
@@ -129,6 +132,8 @@ struct ssl_func {
 
 
 
+SSL_CTX *			XX_httplib_client_ssl_ctx( struct lh_ctx_t *ctx );
+void				XX_httplib_client_ssl_free( struct lh_ctx_t *ctx );
 int				XX_httplib_get_first_ssl_listener_index( const struct lh_ctx_t *ctx );
 int				XX_httplib_initialize_ssl( struct lh_ctx_t *ctx );
 bool				XX_httplib_set_ssl_option( struct lh_ctx_t *ctx );
@@ -137,8 +142,10 @@ void				XX_httplib_ssl_get_client_cert_info( struct lh_con_t *conn );
 long				XX_httplib_ssl_get_protocol( int version_id );
 unsigned long			XX_httplib_ssl_id_callback( void );
 void				XX_httplib_ssl_locking_callback( int mode, int mutex_num, const char *file, int line );
-int				XX_httplib_ssl_use_pem_file( struct lh_ctx_t *ctx, const char *pem );
-int				XX_httplib_sslize( struct lh_ctx_t *ctx, struct lh_con_t *conn, SSL_CTX *s, int (*func)(SSL *) );
+SSL_SESSION *			XX_httplib_ssl_session_take( struct lh_ctx_t *ctx, const char *host, int port );
+void				XX_httplib_ssl_session_put( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+int				XX_httplib_ssl_use_pem_file( struct lh_ctx_t *ctx, SSL_CTX *ssl_ctx, const char *pem );
+int				XX_httplib_sslize( struct lh_ctx_t *ctx, struct lh_con_t *conn, SSL_CTX *s, SSL_SESSION *session, int (*func)(SSL *) );
 void				XX_httplib_tls_dtor( void *key );
 void				XX_httplib_uninitialize_ssl( struct lh_ctx_t *ctx );
 
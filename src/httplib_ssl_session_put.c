@@ -0,0 +1,137 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+#if !defined(NO_SSL)
+
+#include "httplib_main.h"
+#include "httplib_pthread.h"
+#include "httplib_ssl.h"
+
+/*
+ * void XX_httplib_ssl_session_put( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_ssl_session_put() stores the TLS session of a
+ * secure client connection in the session cache of the client context, where
+ * it replaces an older session for the same host and port. The function is
+ * called after the handshake and again when the connection is closed, because
+ * with TLS 1.3 the server sends the session ticket after the handshake. When
+ * the cache is full, the least recently stored session is dropped.
+ */
+
+void XX_httplib_ssl_session_put( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	struct lh_tss_t *walk;
+	struct lh_tss_t *prev;
+	struct lh_tss_t *entry;
+	struct lh_tss_t *evict;
+	SSL_SESSION *old;
+	SSL_SESSION *session;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->ssl == NULL  ||  conn->pool_host == NULL  ||  ! ctx->client_ssl.initialized ) return;
+
+	session = SSL_get1_session( conn->ssl );
+	if ( session == NULL ) return;
+
+	entry = httplib_calloc( 1, sizeof(struct lh_tss_t) );
+	if ( entry == NULL ) {
+
+		SSL_SESSION_free( session );
+		return;
+	}
+
+	entry->host = httplib_strdup( conn->pool_host );
+	if ( entry->host == NULL ) {
+
+		SSL_SESSION_free( session );
+		entry = httplib_free( entry );
+		return;
+	}
+
+	entry->port    = conn->pool_port;
+	entry->session = session;
+	old            = NULL;
+	evict          = NULL;
+	prev           = NULL;
+
+	httplib_pthread_mutex_lock( & ctx->client_ssl.mutex );
+
+	for (walk=ctx->client_ssl.first; walk != NULL; walk=walk->next) {
+
+		if ( walk->port == entry->port  &&  ! httplib_strcasecmp( walk->host, entry->host ) ) break;
+		prev = walk;
+	}
+
+	if ( walk != NULL ) {
+
+		/*
+		 * Move the existing entry to the front of the list with the new
+		 * session and drop the entry which was allocated for it.
+		 */
+
+		if ( prev != NULL ) {
+
+			prev->next            = walk->next;
+			walk->next            = ctx->client_ssl.first;
+			ctx->client_ssl.first = walk;
+		}
+
+		old            = walk->session;
+		walk->session  = session;
+		entry->session = NULL;
+		evict          = entry;
+	}
+
+	else {
+
+		if ( ctx->client_ssl.num_sessions >= SSL_SESSION_CACHE_MAX ) {
+
+			prev = NULL;
+			for (walk=ctx->client_ssl.first; walk->next != NULL; walk=walk->next) prev = walk;
+
+			if ( prev == NULL ) ctx->client_ssl.first = NULL;
+			else                prev->next            = NULL;
+
+			evict = walk;
+			ctx->client_ssl.num_sessions--;
+		}
+
+		entry->next           = ctx->client_ssl.first;
+		ctx->client_ssl.first = entry;
+		ctx->client_ssl.num_sessions++;
+	}
+
+	httplib_pthread_mutex_unlock( & ctx->client_ssl.mutex );
+
+	if ( old != NULL ) SSL_SESSION_free( old );
+
+	if ( evict != NULL ) {
+
+		if ( evict->session != NULL ) SSL_SESSION_free( evict->session );
+		evict->host = httplib_free( evict->host );
+		evict       = httplib_free( evict       );
+	}
+
+}  /* XX_httplib_ssl_session_put */
+
+#endif /* !NO_SSL */
@@ -0,0 +1,84 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+#if !defined(NO_SSL)
+
+#include "httplib_main.h"
+#include "httplib_pthread.h"
+#include "httplib_ssl.h"
+
+/*
+ * SSL_SESSION *XX_httplib_ssl_session_take( struct lh_ctx_t *ctx, const char *host, int port );
+ *
+ * The function XX_httplib_ssl_session_take() removes the TLS session which
+ * was negotiated with a host and port from the session cache of a client
+ * context and returns it. The caller owns the reference to the session and
+ * must free it with SSL_SESSION_free(). A session is taken out of the cache
+ * because servers may accept a session ticket only once. The connection which
+ * resumes it stores the renewed session again. NULL is returned if the cache
+ * has no session for the host and port.
+ */
+
+SSL_SESSION *XX_httplib_ssl_session_take( struct lh_ctx_t *ctx, const char *host, int port ) {
+
+	struct lh_tss_t *walk;
+	struct lh_tss_t *prev;
+	SSL_SESSION *session;
+
+	if ( ctx == NULL  ||  host == NULL  ||  ! ctx->client_ssl.initialized ) return NULL;
+
+	session = NULL;
+	prev    = NULL;
+
+	httplib_pthread_mutex_lock( & ctx->client_ssl.mutex );
+
+	for (walk=ctx->client_ssl.first; walk != NULL; walk=walk->next) {
+
+		if ( walk->port == port  &&  ! httplib_strcasecmp( walk->host, host ) ) break;
+		prev = walk;
+	}
+
+	if ( walk != NULL ) {
+
+		if ( prev == NULL ) ctx->client_ssl.first = walk->next;
+		else                prev->next            = walk->next;
+
+		ctx->client_ssl.num_sessions--;
+		ctx->client_ssl.num_offered++;
+		session = walk->session;
+	}
+
+	httplib_pthread_mutex_unlock( & ctx->client_ssl.mutex );
+
+	if ( walk != NULL ) {
+
+		walk->host = httplib_free( walk->host );
+		walk       = httplib_free( walk       );
+	}
+
+	return session;
+
+}  /* XX_httplib_ssl_session_take */
+
+#endif /* !NO_SSL */
@@ -31,17 +31,18 @@
 #include "httplib_ssl.h"
 
 /*
- * int XX_httplib_ssl_use_pem_file( struct lh_ctx_t *ctx, const char *pem );
+ * int XX_httplib_ssl_use_pem_file( struct lh_ctx_t *ctx, SSL_CTX *ssl_ctx, const char *pem );
  *
  * The function XX_httplib_ssl_use_pem_file() tries to use a certificate which
- * is passed as a parameter with the filename of the certificate.
+ * is passed as a parameter with the filename of the certificate in the SSL
+ * context ssl_ctx.
  */
 
-int XX_httplib_ssl_use_pem_file( struct lh_ctx_t *ctx, const char *pem ) {
+int XX_httplib_ssl_use_pem_file( struct lh_ctx_t *ctx, SSL_CTX *ssl_ctx, const char *pem ) {
 
-	if ( ctx == NULL  ||  pem == NULL ) return 0;
+	if ( ctx == NULL  ||  ssl_ctx == NULL  ||  pem == NULL ) return 0;
 
-	if ( SSL_CTX_use_certificate_file( ctx->ssl_ctx, pem, 1 ) == 0 ) {
+	if ( SSL_CTX_use_certificate_file( ssl_ctx, pem, 1 ) == 0 ) {
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: cannot open certificate file %s: %s", __func__, pem, XX_httplib_ssl_error() );
 		return 0;
@@ -51,19 +52,19 @@ int XX_httplib_ssl_use_pem_file( struct lh_ctx_t *ctx, const char *pem ) {
 	 * could use SSL_CTX_set_default_passwd_cb_userdata
 	 */
 
-	if ( SSL_CTX_use_PrivateKey_file( ctx->ssl_ctx, pem, 1 ) == 0 ) {
+	if ( SSL_CTX_use_PrivateKey_file( ssl_ctx, pem, 1 ) == 0 ) {
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: cannot open private key file %s: %s", __func__, pem, XX_httplib_ssl_error() );
 		return 0;
 	}
 
-	if ( SSL_CTX_check_private_key( ctx->ssl_ctx ) == 0 ) {
+	if ( SSL_CTX_check_private_key( ssl_ctx ) == 0 ) {
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: certificate and private key do not match: %s", __func__, pem );
 		return 0;
 	}
 
-	if ( SSL_CTX_use_certificate_chain_file( ctx->ssl_ctx, pem ) == 0 ) {
+	if ( SSL_CTX_use_certificate_chain_file( ssl_ctx, pem ) == 0 ) {
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: cannot use certificate chain file %s: %s", __func__, pem, XX_httplib_ssl_error() );
 		return 0;
@@ -31,12 +31,15 @@
 #include "httplib_ssl.h"
 
 /*
- * int XX_httplib_sslize( lh_con_t *conn, SSL_CTX *s, int (*func)(SSL *) );
+ * int XX_httplib_sslize( lh_con_t *conn, SSL_CTX *s, SSL_SESSION *session, int (*func)(SSL *) );
  *
- * The fucntion XX_httplib_sslize() initiates SSL on a connection.
+ * The fucntion XX_httplib_sslize() initiates SSL on a connection. A client
+ * can pass a session from an earlier connection to the same server, which is
+ * then offered for resumption in the handshake. The caller keeps its own
+ * reference to the session.
  */
 
-int XX_httplib_sslize( struct lh_ctx_t *ctx, struct lh_con_t *conn, SSL_CTX *s, int (*func)(SSL *) ) {
+int XX_httplib_sslize( struct lh_ctx_t *ctx, struct lh_con_t *conn, SSL_CTX *s, SSL_SESSION *session, int (*func)(SSL *) ) {
 
 	int ret;
 	int err;
@@ -44,7 +47,7 @@ int XX_httplib_sslize( struct lh_ctx_t *ctx, struct lh_con_t *conn, SSL_CTX *s,
 
 	if ( ctx == NULL  ||  conn == NULL ) return 0;
 
-	if ( ctx->ssl_short_trust ) {
+	if ( ctx->ssl_short_trust  &&  s == ctx->ssl_ctx ) {
 
 		int trust_ret = XX_httplib_refresh_trust( ctx, conn );
 		if ( ! trust_ret ) return trust_ret;
@@ -71,6 +74,8 @@ int XX_httplib_sslize( struct lh_ctx_t *ctx, struct lh_con_t *conn, SSL_CTX *s,
 		return 0;
 	}
 
+	if ( session != NULL ) SSL_set_session( conn->ssl, session );
+
 	/*
 	 * SSL functions may fail and require to be called again:
 	 * see https://www.openssl.org/docs/manmaster/ssl/SSL_get_error.html
@@ -128,6 +128,12 @@ struct lh_ctx_t *httplib_start( const struct lh_clb_t *callbacks, void *user_dat
 	if ( httplib_pthread_cond_init(  & ctx->sq_full,  NULL )                                ) return XX_httplib_abort_start( ctx, "Cannot initialize full queue condition"  );
 #endif
 	if ( httplib_pthread_mutex_init( & ctx->nonce_mutex,  & XX_httplib_pthread_mutex_attr ) ) return XX_httplib_abort_start( ctx, "Cannot initialize nonce mutex"           );
+	if ( httplib_pthread_mutex_init( & ctx->encoding_cache_mutex, & XX_httplib_pthread_mutex_attr ) ) return XX_httplib_abort_start( ctx, "Cannot initialize encoding cache mutex" );
+	if ( httplib_pthread_mutex_init( & ctx->ws_zstream_pool.mutex, & XX_httplib_pthread_mutex_attr ) ) return XX_httplib_abort_start( ctx, "Cannot initialize websocket zstream pool mutex" );
+	if ( httplib_pthread_mutex_init( & ctx->ws_keepalive.mutex,    & XX_httplib_pthread_mutex_attr ) ) return XX_httplib_abort_start( ctx, "Cannot initialize websocket keepalive mutex" );
+	if ( httplib_pthread_mutex_init( & ctx->buffer_pool.mutex,     & XX_httplib_pthread_mutex_attr ) ) return XX_httplib_abort_start( ctx, "Cannot initialize buffer pool mutex" );
+
+	ctx->buffer_pool.initialized = true;
 
 	ctx->user_data = user_data;
 	ctx->handlers  = NULL;
@@ -137,6 +143,17 @@ struct lh_ctx_t *httplib_start( const struct lh_clb_t *callbacks, void *user_dat
 
 	XX_httplib_get_system_name( & ctx->systemName );
 
+	/*
+	 * The results of looking up precompressed siblings of static files
+	 * are cached, unless caching has been switched off.
+	 */
+
+	if ( ctx->encoding_cache_ttl > 0 ) {
+
+		ctx->encoding_cache = httplib_calloc( ENCODING_CACHE_SIZE, sizeof(struct encoding_cache_t) );
+		if ( ctx->encoding_cache == NULL ) return XX_httplib_abort_start( ctx, "Not enough memory for encoding cache" );
+	}
+
 	/*
 	 * NOTE(lsm): order is important here. SSL certificates must
 	 * be initialized before listening ports. UID must be set last.
@@ -186,9 +203,34 @@ struct lh_ctx_t *httplib_start( const struct lh_clb_t *callbacks, void *user_dat
 #endif
 	}
 
-#if defined(USE_TIMERS)
-	if ( timers_init( ctx ) != 0 ) return XX_httplib_abort_start( ctx, "Error creating timers" );
-#endif
+	/*
+	 * Start the timer service and the resolver. Idle websocket connections
+	 * are checked by a repeating timer when keepalive pings are enabled.
+	 */
+
+	if ( ! XX_httplib_timer_init( ctx ) ) return XX_httplib_abort_start( ctx, "Cannot start timer service: error %ld", (long)ERRNO );
+
+	if ( ! XX_httplib_resolver_init( ctx ) ) return XX_httplib_abort_start( ctx, "Cannot initialize resolver: error %ld", (long)ERRNO );
+
+	if ( ctx->websocket_ping_interval > 0  &&  httplib_timer_add( ctx, WEBSOCKET_KEEPALIVE_TICK, WEBSOCKET_KEEPALIVE_TICK, XX_httplib_websocket_keepalive, NULL ) == 0 ) return XX_httplib_abort_start( ctx, "Cannot add websocket keepalive timer" );
+
+	/*
+	 * Create the event queue of the websocket reactor. Websockets are
+	 * served by the worker threads on systems without a reactor.
+	 */
+
+#if defined(USE_WEBSOCKET_REACTOR)
+	if ( ctx->enable_websocket_reactor ) {
+
+		ctx->ws_reactor_buf = httplib_malloc( WEBSOCKET_REACTOR_BUF_LEN );
+		if ( ctx->ws_reactor_buf == NULL ) return XX_httplib_abort_start( ctx, "Not enough memory for websocket reactor buffer" );
+
+		ctx->ws_epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+		if ( ctx->ws_epoll_fd < 0 ) return XX_httplib_abort_start( ctx, "Cannot create websocket reactor event queue: error %ld", (long)ERRNO );
+	}
+#else  /* USE_WEBSOCKET_REACTOR */
+	ctx->enable_websocket_reactor = false;
+#endif  /* USE_WEBSOCKET_REACTOR */
 
 	/*
 	 * Context has been created - init user libraries
@@ -202,6 +244,12 @@ struct lh_ctx_t *httplib_start( const struct lh_clb_t *callbacks, void *user_dat
 	ctx->callbacks.exit_context = exit_callback;
 	ctx->ctx_type               = CTX_TYPE_SERVER;
 
+	/*
+	 * Start the websocket reactor thread
+	 */
+
+	if ( ctx->enable_websocket_reactor  &&  XX_httplib_start_thread_with_id( XX_httplib_websocket_reactor_thread, ctx, & ctx->ws_reactor_threadid ) != 0 ) return XX_httplib_abort_start( ctx, "Cannot create websocket reactor thread: error %ld", (long)ERRNO );
+
 	/*
 	 * Start master (listening) thread
 	 */
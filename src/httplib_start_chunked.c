@@ -0,0 +1,88 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+#include "httplib_utils.h"
+
+/*
+ * bool XX_httplib_start_chunked( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers, bool static_cache );
+ *
+ * The function XX_httplib_start_chunked() sends the headers of a response of
+ * which the length is not known in advance, and switches the connection to
+ * chunked transfer encoding. All data written to the connection afterwards
+ * is collected in chunks until httplib_end_chunked() is called. The cache
+ * headers for static content are added when the static_cache flag is set.
+ *
+ * HTTP/1.0 clients don't understand chunked transfer encoding. The data is
+ * then sent without framing and the connection is closed after the response.
+ * For HEAD requests only the headers are sent and the data is discarded.
+ *
+ * The function returns false if the connection could not be switched.
+ */
+
+bool XX_httplib_start_chunked( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers, bool static_cache ) {
+
+	struct lh_chk_t *chk;
+	char date[64];
+	time_t curtime;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->chunk_out != NULL  ||  conn->compress != NULL  ||  status < 100  ||  status > 999 ) return false;
+
+	if ( mime_type          == NULL ) mime_type          = "text/plain";
+	if ( additional_headers == NULL ) additional_headers = "";
+
+	chk = httplib_malloc( sizeof(struct lh_chk_t) );
+	if ( chk == NULL ) return false;
+
+	chk->framing = ( conn->request_info.http_version != NULL  &&  ! strcmp( conn->request_info.http_version, "1.1" ) );
+	chk->no_body = ( conn->request_info.request_method != NULL  &&  ! strcmp( conn->request_info.request_method, "HEAD" ) );
+	chk->error   = false;
+	chk->len     = 0;
+
+	if ( ! chk->framing ) conn->must_close = true;
+
+	curtime           = time( NULL );
+	conn->status_code = status;
+	XX_httplib_gmt_time_string( date, sizeof(date), & curtime );
+
+	httplib_printf( ctx, conn, "HTTP/1.1 %d %s\r\n" "Date: %s\r\n", status, httplib_get_response_code_text( ctx, conn, status ), date );
+	if ( static_cache ) XX_httplib_send_static_cache_header( ctx, conn );
+	httplib_printf( ctx, conn,
+			"Content-Type: %s\r\n"
+			"Connection: %s\r\n"
+			"%s"
+			"%s"
+			"\r\n",
+			mime_type,
+			XX_httplib_suggest_connection_header( ctx, conn ),
+			(chk->framing) ? "Transfer-Encoding: chunked\r\n" : "",
+			additional_headers );
+
+	conn->chunk_out = chk;
+
+	return true;
+
+}  /* XX_httplib_start_chunked */
@@ -0,0 +1,48 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_start_chunked_response( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers );
+ *
+ * The function httplib_start_chunked_response() can be used by a request
+ * handler to send a response of which the length is not known in advance.
+ * The response headers are sent by the function, including the headers in
+ * additional_headers which must be either NULL or a string with one or more
+ * CRLF terminated header lines. The body can then be written with
+ * httplib_write_chunk(), httplib_write() or httplib_printf() and must be
+ * finished with httplib_end_chunked(). Because the end of the body is marked
+ * in the data stream, the connection can be kept alive afterwards.
+ *
+ * The function returns 0 when successful and -1 if an error occured.
+ */
+
+int httplib_start_chunked_response( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers ) {
+
+	return ( XX_httplib_start_chunked( ctx, conn, status, mime_type, additional_headers, false ) ) ? 0 : -1;
+
+}  /* httplib_start_chunked_response */
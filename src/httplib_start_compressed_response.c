@@ -0,0 +1,247 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+#include "httplib_utils.h"
+
+static int	select_encoding( const struct lh_ctx_t *ctx, const struct lh_con_t *conn );
+static bool	init_compressor( const struct lh_ctx_t *ctx, struct lh_cmp_t *cmp );
+
+/*
+ * Content codings which can be used to compress a response on the fly, in
+ * order of preference when a client accepts several of them with the same
+ * quality value.
+ */
+
+static const int available_encodings[] = {
+
+#if defined(USE_BROTLI)
+	COMPRESS_BR,
+#endif  /* USE_BROTLI */
+#if defined(USE_ZLIB)
+	COMPRESS_GZIP,
+	COMPRESS_DEFLATE,
+#endif  /* USE_ZLIB */
+	COMPRESS_IDENTITY
+};
+
+/*
+ * int httplib_start_compressed_response( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers );
+ *
+ * The function httplib_start_compressed_response() switches a connection to
+ * on the fly compression of the response body. All data subsequently written
+ * with httplib_write() or httplib_printf() is compressed with the content
+ * coding preferred by the client and sent with chunked transfer encoding. The
+ * response headers are composed by this function, and the caller can add its
+ * own headers through the additional_headers parameter which must be either
+ * NULL or a string with one or more CRLF terminated header lines.
+ *
+ * The headers are not sent until compression_min_size bytes of the body have
+ * been written. A response which is finished with
+ * httplib_end_compressed_response() before that size is reached is sent
+ * uncompressed with a Content-Length header.
+ *
+ * The function returns 0 when successful and -1 if an error occured.
+ */
+
+int httplib_start_compressed_response( struct lh_ctx_t *ctx, struct lh_con_t *conn, int status, const char *mime_type, const char *additional_headers ) {
+
+	struct lh_cmp_t *cmp;
+	char date[64];
+	time_t curtime;
+	size_t size;
+	int len;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->compress != NULL  ||  conn->chunk_out != NULL  ||  status < 100  ||  status > 999 ) return -1;
+
+	if ( mime_type          == NULL ) mime_type          = "text/plain";
+	if ( additional_headers == NULL ) additional_headers = "";
+
+	cmp = httplib_calloc( 1, sizeof(struct lh_cmp_t) );
+	if ( cmp == NULL ) return -1;
+
+	cmp->encoding = select_encoding( ctx, conn );
+	cmp->level    = ctx->compression_level;
+	cmp->min_size = (size_t)ctx->compression_min_size;
+	cmp->chunked  = ( conn->request_info.http_version != NULL  &&  ! strcmp( conn->request_info.http_version, "1.1" ) );
+	cmp->no_body  = ( conn->request_info.request_method != NULL  &&  ! strcmp( conn->request_info.request_method, "HEAD" ) );
+
+	if ( ! init_compressor( ctx, cmp ) ) cmp->encoding = COMPRESS_IDENTITY;
+
+	/*
+	 * Without chunked transfer encoding the end of a body of unknown length
+	 * can only be signalled by closing the connection.
+	 */
+
+	if ( ! cmp->chunked ) conn->must_close = true;
+
+	conn->status_code = status;
+	curtime           = time( NULL );
+	XX_httplib_gmt_time_string( date, sizeof(date), & curtime );
+
+	/*
+	 * Room is reserved after the headers for the Content-Encoding,
+	 * Transfer-Encoding or Content-Length headers which are only known when
+	 * the body is sent.
+	 */
+
+	size         = strlen( mime_type ) + strlen( additional_headers ) + 256;
+	cmp->headers = httplib_malloc( size );
+
+	if ( cmp->headers == NULL ) {
+
+		conn->compress = cmp;
+		XX_httplib_compress_free( conn );
+		return -1;
+	}
+
+	len = snprintf( cmp->headers, size - 96,
+			"HTTP/1.1 %d %s\r\n"
+			"Date: %s\r\n"
+			"Content-Type: %s\r\n"
+			"Vary: Accept-Encoding\r\n"
+			"Connection: %s\r\n"
+			"%s",
+			status, httplib_get_response_code_text( ctx, conn, status ),
+			date,
+			mime_type,
+			XX_httplib_suggest_connection_header( ctx, conn ),
+			additional_headers );
+
+	if ( len < 0  ||  (size_t)len >= size - 96 ) {
+
+		conn->compress = cmp;
+		XX_httplib_compress_free( conn );
+		return -1;
+	}
+
+	cmp->headers_len = (size_t)len;
+	conn->compress   = cmp;
+
+	/*
+	 * When there is no minimum size, or no body at all, there is no reason
+	 * to wait with sending the headers.
+	 */
+
+	if ( cmp->min_size == 0  ||  cmp->no_body ) {
+
+		if ( ! XX_httplib_compress_send( ctx, conn, NULL, 0, false ) ) return -1;
+	}
+
+	return 0;
+
+}  /* httplib_start_compressed_response */
+
+
+
+/*
+ * static int select_encoding( const struct lh_ctx_t *ctx, const struct lh_con_t *conn );
+ *
+ * The function select_encoding() returns the available content coding with
+ * the highest quality value in the Accept-Encoding header of the request.
+ */
+
+static int select_encoding( const struct lh_ctx_t *ctx, const struct lh_con_t *conn ) {
+
+	const char *accept_encoding;
+	int best;
+	int best_quality;
+	int quality;
+	size_t a;
+
+	if ( ctx->compression_level == 0 ) return COMPRESS_IDENTITY;
+
+	accept_encoding = httplib_get_header( conn, "Accept-Encoding" );
+	best            = COMPRESS_IDENTITY;
+	best_quality    = 0;
+
+	for (a=0; a<sizeof(available_encodings)/sizeof(available_encodings[0]); a++) {
+
+		if ( available_encodings[a] == COMPRESS_IDENTITY ) continue;
+
+		quality = XX_httplib_get_encoding_quality( accept_encoding, XX_httplib_compress_name[ available_encodings[a] ] );
+
+		if ( quality > best_quality ) {
+
+			best         = available_encodings[a];
+			best_quality = quality;
+		}
+	}
+
+	return best;
+
+}  /* select_encoding */
+
+
+
+/*
+ * static bool init_compressor( const struct lh_ctx_t *ctx, struct lh_cmp_t *cmp );
+ *
+ * The function init_compressor() initializes the compressor for the content
+ * coding of the response. The function returns false if that is not possible.
+ */
+
+static bool init_compressor( const struct lh_ctx_t *ctx, struct lh_cmp_t *cmp ) {
+
+	UNUSED_PARAMETER(ctx);
+
+	switch ( cmp->encoding ) {
+
+		case COMPRESS_IDENTITY :
+			return true;
+
+#if defined(USE_ZLIB)
+		case COMPRESS_GZIP    :
+		case COMPRESS_DEFLATE :
+
+			/*
+			 * A window size of 15 bits plus 16 gives a gzip wrapper
+			 * around the data, without the 16 a zlib wrapper is used
+			 * which is what HTTP calls "deflate".
+			 */
+
+			if ( deflateInit2( & cmp->zstream, cmp->level, Z_DEFLATED, (cmp->encoding == COMPRESS_GZIP) ? 15+16 : 15, 8, Z_DEFAULT_STRATEGY ) != Z_OK ) return false;
+
+			cmp->zstream_init = true;
+			return true;
+#endif  /* USE_ZLIB */
+
+#if defined(USE_BROTLI)
+		case COMPRESS_BR :
+
+			cmp->brotli = BrotliEncoderCreateInstance( NULL, NULL, NULL );
+			if ( cmp->brotli == NULL ) return false;
+
+			BrotliEncoderSetParameter( cmp->brotli, BROTLI_PARAM_QUALITY, (uint32_t)cmp->level );
+			BrotliEncoderSetParameter( cmp->brotli, BROTLI_PARAM_MODE,    BROTLI_MODE_TEXT     );
+			return true;
+#endif  /* USE_BROTLI */
+
+		default :
+			return false;
+	}
+
+}  /* init_compressor */
@@ -61,7 +61,7 @@ int XX_httplib_stat( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *pa
 	if ( conn != NULL  &&  XX_httplib_is_file_in_memory( ctx, conn, path, filep ) ) {
 
 		/*
-		 * filep->is_directory = 0; filep->gzipped = 0; .. already done by
+		 * filep->is_directory = 0; filep->encoding = 0; .. already done by
 		 * memset
 		 */
 
@@ -33,20 +33,21 @@
  * The function httplib_store_body() stores in incoming body for future
  * processing. The function returns the number of bytes actually read, or a
  * negative number to indicate a failure.
+ *
+ * The body is first written to a temporary file in the same directory which
+ * is renamed to the final name when the whole body has been received. Other
+ * readers of the file therefore never see a partial upload.
  */
 
 int64_t httplib_store_body( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *path ) {
 
-	char buf[MG_BUF_LEN];
+	char tmp_path[PATH_MAX];
 	int64_t len;
 	int ret;
-	int n;
 	struct file fi;
 
 	if ( ctx == NULL ) return -1;
 
-	len = 0;
-
 	if ( conn->consumed_content != 0 ) {
 
 		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: Contents already consumed", __func__ );
@@ -73,28 +74,29 @@ int64_t httplib_store_body( struct lh_ctx_t *ctx, struct lh_con_t *conn, const c
 		return 0;
 	}
 
-	if ( XX_httplib_fopen( ctx, conn, path, "w",  & fi ) == 0 ) return -12;
-
-	ret = httplib_read( ctx, conn, buf, sizeof(buf) );
+	if ( ! XX_httplib_open_temp_file( ctx, conn, path, tmp_path, sizeof(tmp_path), & fi ) ) return -12;
 
-	while ( ret > 0 )  {
+	len = XX_httplib_receive_body( ctx, conn, fi.fp );
 
-		n = (int)fwrite( buf, 1, (size_t)ret, fi.fp );
-		if ( n != ret ) {
+	if ( len < 0 ) {
 
-			XX_httplib_fclose( & fi );
-			XX_httplib_remove_bad_file( ctx, conn, path );
-			return -13;
-		}
-		ret = httplib_read( ctx, conn, buf, sizeof(buf) );
+		XX_httplib_fclose( & fi );
+		XX_httplib_remove_bad_file( ctx, conn, tmp_path );
+		return -13;
 	}
 
 	if ( XX_httplib_fclose( & fi ) != 0 ) {
 
-		XX_httplib_remove_bad_file( ctx, conn, path );
+		XX_httplib_remove_bad_file( ctx, conn, tmp_path );
 		return -14;
 	}
 
+	if ( XX_httplib_rename( tmp_path, path ) != 0 ) {
+
+		XX_httplib_remove_bad_file( ctx, conn, tmp_path );
+		return -15;
+	}
+
 	return len;
 
 }  /* httplib_store_body */
@@ -0,0 +1,130 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static bool	grow_slots( struct lh_tms_t *tms );
+
+/*
+ * uint64_t httplib_timer_add( struct lh_ctx_t *ctx, int delay, int period, httplib_timer_handler handler, void *cbdata );
+ *
+ * The function httplib_timer_add() adds a timer to the timer service of a
+ * server context. The handler is called by the timer thread after delay
+ * milliseconds. When a period in milliseconds is given, the handler is called
+ * again every period as long as it returns true. Periods which were missed
+ * because a handler took too long are skipped instead of being made up for.
+ * The timer thread is only woken up when the new timer fires before the timer
+ * it is waiting for.
+ *
+ * The function returns an identifier which can be passed to
+ * httplib_timer_cancel(), or 0 if the timer could not be added.
+ */
+
+uint64_t httplib_timer_add( struct lh_ctx_t *ctx, int delay, int period, httplib_timer_handler handler, void *cbdata ) {
+
+	struct lh_tms_t *tms;
+	struct lh_tmr_t *tmr;
+	uint32_t slot;
+	uint64_t timer_id;
+
+	if ( ctx == NULL  ||  handler == NULL  ||  delay < 0  ||  period < 0 ) return 0;
+
+	tms = & ctx->timers;
+	if ( ! tms->initialized ) return 0;
+
+	httplib_pthread_mutex_lock( & tms->mutex );
+
+	if ( tms->stop  ||  ( tms->free_slot == TIMER_NONE  &&  ! grow_slots( tms ) ) ) {
+
+		httplib_pthread_mutex_unlock( & tms->mutex );
+		return 0;
+	}
+
+	slot           = tms->free_slot;
+	tmr            = & tms->slots[slot];
+	tms->free_slot = tmr->next_free;
+
+	tmr->due       = XX_httplib_monotonic_msec() + delay;
+	tmr->period    = period;
+	tmr->handler   = handler;
+	tmr->cbdata    = cbdata;
+	tmr->next_free = TIMER_NONE;
+	tmr->in_use    = true;
+	timer_id       = (((uint64_t)tmr->generation) << 32) | slot;
+
+	XX_httplib_timer_schedule( tms, slot );
+
+	if ( tms->heap[0] == slot ) httplib_pthread_cond_broadcast( & tms->cond );
+
+	httplib_pthread_mutex_unlock( & tms->mutex );
+
+	return timer_id;
+
+}  /* httplib_timer_add */
+
+
+
+/*
+ * static bool grow_slots( struct lh_tms_t *tms );
+ *
+ * The function grow_slots() doubles the number of timer slots and the size
+ * of the heap, and puts the new slots in the free list. The function returns
+ * false if no memory could be allocated.
+ */
+
+static bool grow_slots( struct lh_tms_t *tms ) {
+
+	struct lh_tmr_t *slots;
+	uint32_t *heap;
+	uint32_t num_slots;
+	uint32_t a;
+
+	num_slots = ( tms->num_slots > 0 ) ? 2 * tms->num_slots : 64;
+	if ( num_slots <= tms->num_slots  ||  num_slots >= TIMER_NONE ) return false;
+
+	heap = httplib_realloc( tms->heap, num_slots * sizeof(uint32_t) );
+	if ( heap == NULL ) return false;
+
+	tms->heap = heap;
+
+	slots = httplib_realloc( tms->slots, num_slots * sizeof(struct lh_tmr_t) );
+	if ( slots == NULL ) return false;
+
+	for (a=tms->num_slots; a<num_slots; a++) {
+
+		memset( & slots[a], 0, sizeof(struct lh_tmr_t) );
+
+		slots[a].generation = 1;
+		slots[a].heap_pos   = TIMER_NONE;
+		slots[a].next_free  = ( a+1 < num_slots ) ? a+1 : tms->free_slot;
+	}
+
+	tms->free_slot = tms->num_slots;
+	tms->slots     = slots;
+	tms->num_slots = num_slots;
+
+	return true;
+
+}  /* grow_slots */
@@ -0,0 +1,94 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_timer_cancel( struct lh_ctx_t *ctx, uint64_t timer_id );
+ *
+ * The function httplib_timer_cancel() cancels a timer which was added with
+ * httplib_timer_add(). If the handler of the timer is running at the moment,
+ * the function waits until it has returned, so that the callback data can be
+ * released safely afterwards. A handler may cancel its own timer, in which
+ * case the function returns immediately and the timer is not repeated. The
+ * function returns 0 if the timer was cancelled, and -1 if the identifier is
+ * invalid or the timer has already fired for the last time.
+ */
+
+int httplib_timer_cancel( struct lh_ctx_t *ctx, uint64_t timer_id ) {
+
+	struct lh_tms_t *tms;
+	struct lh_tmr_t *tmr;
+	uint32_t slot;
+
+	if ( ctx == NULL  ||  timer_id == 0 ) return -1;
+
+	tms  = & ctx->timers;
+	slot = (uint32_t)(timer_id & 0xFFFFFFFF);
+
+	if ( ! tms->initialized ) return -1;
+
+	httplib_pthread_mutex_lock( & tms->mutex );
+
+	if ( slot >= tms->num_slots  ||  ! tms->slots[slot].in_use  ||  tms->slots[slot].generation != (uint32_t)(timer_id >> 32) ) {
+
+		httplib_pthread_mutex_unlock( & tms->mutex );
+		return -1;
+	}
+
+	/*
+	 * A running timer is freed by the timer thread when its handler
+	 * returns. Clearing the period makes sure it is not scheduled again.
+	 */
+
+	if ( tms->running == slot ) {
+
+		tms->slots[slot].period = 0;
+
+		if ( httplib_pthread_getspecific( XX_httplib_sTlsKey ) != tms->tls ) {
+
+			while ( tms->running == slot ) httplib_pthread_cond_wait( & tms->cond, & tms->mutex );
+		}
+
+		httplib_pthread_mutex_unlock( & tms->mutex );
+		return 0;
+	}
+
+	XX_httplib_timer_unschedule( tms, slot );
+
+	tmr             = & tms->slots[slot];
+	tmr->in_use     = false;
+	tmr->handler    = NULL;
+	tmr->cbdata     = NULL;
+	tmr->generation++;
+	if ( tmr->generation == 0 ) tmr->generation = 1;
+	tmr->next_free  = tms->free_slot;
+	tms->free_slot  = slot;
+
+	httplib_pthread_mutex_unlock( & tms->mutex );
+
+	return 0;
+
+}  /* httplib_timer_cancel */
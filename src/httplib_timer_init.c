@@ -0,0 +1,63 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_timer_init( struct lh_ctx_t *ctx );
+ *
+ * The function XX_httplib_timer_init() initializes the timer service of a
+ * server context and starts the timer thread. No slots are allocated until
+ * the first timer is added. The function returns false if an error occured.
+ */
+
+bool XX_httplib_timer_init( struct lh_ctx_t *ctx ) {
+
+	struct lh_tms_t *tms;
+
+	if ( ctx == NULL ) return false;
+
+	tms = & ctx->timers;
+
+	tms->free_slot = TIMER_NONE;
+	tms->running   = TIMER_NONE;
+
+	if ( httplib_pthread_mutex_init( & tms->mutex, & XX_httplib_pthread_mutex_attr ) ) return false;
+
+	if ( httplib_pthread_cond_init( & tms->cond, NULL ) ) {
+
+		httplib_pthread_mutex_destroy( & tms->mutex );
+		return false;
+	}
+
+	tms->initialized = true;
+
+	if ( XX_httplib_start_thread_with_id( XX_httplib_timer_thread, ctx, & tms->threadid ) != 0 ) return false;
+
+	tms->started = true;
+
+	return true;
+
+}  /* XX_httplib_timer_init */
@@ -0,0 +1,44 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_timer_schedule( struct lh_tms_t *tms, uint32_t slot );
+ *
+ * The function XX_httplib_timer_schedule() puts the timer in a slot in the
+ * heap of the timer service at the position which belongs to its due time.
+ * The heap always has room for all slots. The caller must hold the mutex of
+ * the timer service.
+ */
+
+void XX_httplib_timer_schedule( struct lh_tms_t *tms, uint32_t slot ) {
+
+	tms->heap[tms->heap_len] = slot;
+	tms->heap_len++;
+
+	XX_httplib_timer_sift( tms, tms->heap_len - 1 );
+
+}  /* XX_httplib_timer_schedule */
@@ -0,0 +1,87 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_timer_sift( struct lh_tms_t *tms, uint32_t pos );
+ *
+ * The function XX_httplib_timer_sift() restores the order of the timer heap
+ * after the timer at position pos has been put there or its due time has
+ * changed. The timer is moved up towards the root while it fires before its
+ * parent, and otherwise down while one of its children fires before it. The
+ * positions of all moved timers are updated in their slots. The caller must
+ * hold the mutex of the timer service.
+ */
+
+void XX_httplib_timer_sift( struct lh_tms_t *tms, uint32_t pos ) {
+
+	uint32_t slot;
+	uint32_t parent;
+	uint32_t child;
+	uint32_t first;
+	uint32_t last;
+	uint32_t best;
+	int64_t due;
+
+	slot = tms->heap[pos];
+	due  = tms->slots[slot].due;
+
+	while ( pos > 0 ) {
+
+		parent = (pos - 1) / TIMER_HEAP_ARITY;
+		if ( tms->slots[ tms->heap[parent] ].due <= due ) break;
+
+		tms->heap[pos]                        = tms->heap[parent];
+		tms->slots[ tms->heap[pos] ].heap_pos = pos;
+		pos                                   = parent;
+	}
+
+	while ( true ) {
+
+		first = pos * TIMER_HEAP_ARITY + 1;
+		if ( first >= tms->heap_len ) break;
+
+		last = first + TIMER_HEAP_ARITY;
+		if ( last > tms->heap_len ) last = tms->heap_len;
+
+		best = first;
+
+		for (child=first+1; child<last; child++) {
+
+			if ( tms->slots[ tms->heap[child] ].due < tms->slots[ tms->heap[best] ].due ) best = child;
+		}
+
+		if ( tms->slots[ tms->heap[best] ].due >= due ) break;
+
+		tms->heap[pos]                        = tms->heap[best];
+		tms->slots[ tms->heap[pos] ].heap_pos = pos;
+		pos                                   = best;
+	}
+
+	tms->heap[pos]            = slot;
+	tms->slots[slot].heap_pos = pos;
+
+}  /* XX_httplib_timer_sift */
@@ -0,0 +1,60 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_timer_stop( struct lh_ctx_t *ctx );
+ *
+ * The function XX_httplib_timer_stop() stops the timer thread of a context
+ * and waits until a handler which is running has returned. Timers which have
+ * not fired yet are discarded, and no new timers can be added afterwards.
+ * The memory of the timer service is released with the context. The function
+ * can be called more than once.
+ */
+
+void XX_httplib_timer_stop( struct lh_ctx_t *ctx ) {
+
+	struct lh_tms_t *tms;
+
+	if ( ctx == NULL ) return;
+
+	tms = & ctx->timers;
+	if ( ! tms->initialized ) return;
+
+	httplib_pthread_mutex_lock( & tms->mutex );
+
+	tms->stop = true;
+	httplib_pthread_cond_broadcast( & tms->cond );
+
+	httplib_pthread_mutex_unlock( & tms->mutex );
+
+	if ( tms->started ) {
+
+		httplib_pthread_join( tms->threadid, NULL );
+		tms->started = false;
+	}
+
+}  /* XX_httplib_timer_stop */
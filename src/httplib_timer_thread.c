@@ -0,0 +1,178 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+#include "httplib_pthread.h"
+
+static void	timer_run( struct lh_ctx_t *ctx );
+
+/*
+ * LIBHTTP_THREAD XX_httplib_timer_thread( void *data );
+ *
+ * The function XX_httplib_timer_thread() is the wrapper function around the
+ * timer thread of a context. Calling convention of the function differs
+ * depending on the operating system.
+ */
+
+LIBHTTP_THREAD XX_httplib_timer_thread( void *data ) {
+
+	if ( data != NULL ) timer_run( data );
+
+	return LIBHTTP_THREAD_RETNULL;
+
+}  /* XX_httplib_timer_thread */
+
+
+
+/*
+ * static void timer_run( struct lh_ctx_t *ctx );
+ *
+ * The function timer_run() waits until the first timer in the heap is due,
+ * calls its handler without holding the mutex of the timer service and then
+ * either schedules the timer again for its next period or frees its slot.
+ * The thread sleeps on the condition variable of the timer service with a
+ * timeout which ends when the first timer is due, or without a timeout when
+ * no timers are scheduled. It runs until XX_httplib_timer_stop() is called.
+ */
+
+static void timer_run( struct lh_ctx_t *ctx ) {
+
+	struct httplib_workerTLS tls;
+	struct lh_tms_t *tms;
+	struct lh_tmr_t *tmr;
+	struct timespec abstime;
+	httplib_timer_handler handler;
+	void *cbdata;
+	uint32_t slot;
+	int64_t now;
+	int64_t wait;
+	bool again;
+
+	XX_httplib_set_thread_name( ctx, "timer" );
+
+	tls.thread_idx = (unsigned)httplib_atomic_inc( & XX_httplib_thread_idx_max );
+#if defined(_WIN32)
+	tls.pthread_cond_helper_mutex = CreateEvent( NULL, FALSE, FALSE, NULL );
+#endif
+	httplib_pthread_setspecific( XX_httplib_sTlsKey, &tls );
+
+	if ( ctx->callbacks.init_thread != NULL ) ctx->callbacks.init_thread( ctx, 2 );	/* Timer thread */
+
+	tms = & ctx->timers;
+
+	httplib_pthread_mutex_lock( & tms->mutex );
+
+	tms->tls = & tls;
+
+	while ( ! tms->stop ) {
+
+		if ( tms->heap_len == 0 ) {
+
+			httplib_pthread_cond_wait( & tms->cond, & tms->mutex );
+			continue;
+		}
+
+		slot = tms->heap[0];
+		tmr  = & tms->slots[slot];
+		now  = XX_httplib_monotonic_msec();
+
+		if ( tmr->due > now ) {
+
+			/*
+			 * The condition variable waits for a wall clock time.
+			 * The time is recalculated after every wakeup, so that a
+			 * change of the system clock only affects one wait.
+			 */
+
+			wait = tmr->due - now;
+
+			clock_gettime( CLOCK_REALTIME, & abstime );
+
+			abstime.tv_sec  += (time_t)(wait / 1000);
+			abstime.tv_nsec += (long)((wait % 1000) * 1000000);
+
+			if ( abstime.tv_nsec >= 1000000000 ) {
+
+				abstime.tv_sec++;
+				abstime.tv_nsec -= 1000000000;
+			}
+
+			httplib_pthread_cond_timedwait( & tms->cond, & tms->mutex, & abstime );
+			continue;
+		}
+
+		XX_httplib_timer_unschedule( tms, slot );
+
+		handler      = tmr->handler;
+		cbdata       = tmr->cbdata;
+		tms->running = slot;
+
+		httplib_pthread_mutex_unlock( & tms->mutex );
+
+		again = handler( ctx, cbdata );
+
+		httplib_pthread_mutex_lock( & tms->mutex );
+
+		/*
+		 * The slots may have been moved by httplib_timer_add() while
+		 * the handler was running.
+		 */
+
+		tmr          = & tms->slots[slot];
+		tms->running = TIMER_NONE;
+
+		if ( again  &&  tmr->period > 0  &&  ! tms->stop ) {
+
+			tmr->due += tmr->period;
+
+			now = XX_httplib_monotonic_msec();
+			if ( tmr->due <= now ) tmr->due = now + tmr->period;
+
+			XX_httplib_timer_schedule( tms, slot );
+		}
+
+		else {
+			tmr->in_use    = false;
+			tmr->handler   = NULL;
+			tmr->cbdata    = NULL;
+			tmr->generation++;
+			if ( tmr->generation == 0 ) tmr->generation = 1;
+			tmr->next_free = tms->free_slot;
+			tms->free_slot = slot;
+		}
+
+		httplib_pthread_cond_broadcast( & tms->cond );
+	}
+
+	tms->tls = NULL;
+
+	httplib_pthread_mutex_unlock( & tms->mutex );
+
+#if defined(_WIN32)
+	CloseHandle( tls.pthread_cond_helper_mutex );
+#endif
+	httplib_pthread_setspecific( XX_httplib_sTlsKey, NULL );
+
+}  /* timer_run */
@@ -0,0 +1,54 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_timer_unschedule( struct lh_tms_t *tms, uint32_t slot );
+ *
+ * The function XX_httplib_timer_unschedule() removes the timer in a slot from
+ * the heap of the timer service. The last timer of the heap takes its place
+ * and is moved to the right position. The slot itself stays in use. The
+ * caller must hold the mutex of the timer service.
+ */
+
+void XX_httplib_timer_unschedule( struct lh_tms_t *tms, uint32_t slot ) {
+
+	uint32_t pos;
+
+	pos = tms->slots[slot].heap_pos;
+	if ( pos == TIMER_NONE ) return;
+
+	tms->slots[slot].heap_pos = TIMER_NONE;
+	tms->heap_len--;
+
+	if ( pos == tms->heap_len ) return;
+
+	tms->heap[pos]                        = tms->heap[tms->heap_len];
+	tms->slots[ tms->heap[pos] ].heap_pos = pos;
+
+	XX_httplib_timer_sift( tms, pos );
+
+}  /* XX_httplib_timer_unschedule */
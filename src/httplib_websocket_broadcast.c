@@ -0,0 +1,133 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_websocket_broadcast( const struct lh_ctx_t *ctx, struct lh_wsg_t *group, int opcode, const char *data, size_t data_len );
+ *
+ * The function httplib_websocket_broadcast() sends one websocket message to
+ * all connections of a group. The frame is built only once in a reference
+ * counted buffer and sent with a single call per connection. Plain
+ * connections are written without waiting for the peer. When a receiver is
+ * slow and its socket accepts only part of the frame, the connection keeps a
+ * reference to the frame in its send queue. Connections of the reactor queue
+ * the frame up to the limit of the send queue and the reactor sends it when
+ * the socket becomes writable. On other connections the rest is sent by the
+ * next write on the connection or by httplib_websocket_group_flush(), and
+ * connections which still have data pending from an earlier broadcast, or
+ * which are busy with another write, are skipped for this message. TLS
+ * connections are written in blocking mode, because a TLS record must be
+ * completed with the same data. They are written after all other
+ * connections, so that a slow TLS receiver doesn't delay the others.
+ *
+ * The group is not locked while a connection is written to, so that other
+ * calls which use the group are not blocked by a slow receiver. A connection
+ * which is removed from the group meanwhile is skipped, and the removal waits
+ * until the connection which is being written to is done.
+ *
+ * The message is sent uncompressed, also on connections which negotiated the
+ * permessage-deflate extension, because compressed data depends on the
+ * compressor state of each connection. The function returns the number of
+ * connections to which the message was sent or queued, or -1 if an error
+ * occured.
+ */
+
+int httplib_websocket_broadcast( const struct lh_ctx_t *ctx, struct lh_wsg_t *group, int opcode, const char *data, size_t data_len ) {
+
+	struct lh_wsf_t *frame;
+	struct lh_con_t *conn;
+	struct lh_wsi_t iter;
+	char *buf;
+	size_t header_len;
+	int num_sent;
+	int pass;
+
+	if ( ctx == NULL  ||  group == NULL                ) return -1;
+	if ( data == NULL  &&  data_len > 0                ) return -1;
+	if ( data_len > SIZE_MAX - sizeof(struct lh_wsf_t) - WEBSOCKET_HEADER_MAX ) return -1;
+
+	frame = httplib_malloc( sizeof(struct lh_wsf_t) + WEBSOCKET_HEADER_MAX + data_len );
+	if ( frame == NULL ) return -1;
+
+	buf        = (char *)(frame + 1);
+	header_len = XX_httplib_websocket_frame_header( (unsigned char *)buf, opcode & 0x0F, data_len, 0 );
+
+	if ( data_len > 0 ) memcpy( buf + header_len, data, data_len );
+
+	frame->refcount = 1;
+	frame->len      = header_len + data_len;
+	num_sent        = 0;
+
+	if ( ! XX_httplib_websocket_group_begin( group, & iter ) ) {
+
+		XX_httplib_websocket_frame_release( frame );
+		return -1;
+	}
+
+	/*
+	 * The first pass writes to the plain connections and the second pass
+	 * to the TLS connections.
+	 */
+
+	for (pass=0; pass<2; pass++) {
+
+		iter.pos = 0;
+
+		while ( (conn = XX_httplib_websocket_group_next( group, & iter )) != NULL ) {
+
+			if ( ( conn->ssl != NULL ) != ( pass == 1 ) ) continue;
+
+			if ( conn->ws_reactor != NULL ) {
+
+				if ( ! XX_httplib_websocket_group_lock( group, & iter, conn ) ) continue;
+			}
+
+			else if ( httplib_pthread_mutex_trylock( & conn->mutex ) != 0 ) continue;
+
+			if ( conn->ssl != NULL ) {
+
+				if ( XX_httplib_websocket_send_pending( ctx, conn, true ) == 0  &&  XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, buf, (int64_t)frame->len ) == (int64_t)frame->len ) num_sent++;
+			}
+
+			else if ( conn->ws_reactor != NULL ) {
+
+				if ( XX_httplib_websocket_queue_limit( ctx, conn ) == 0  &&  XX_httplib_websocket_queue_frame( ctx, conn, frame ) == 0 ) num_sent++;
+			}
+
+			else if ( XX_httplib_websocket_send_pending( ctx, conn, false ) == 0  &&  XX_httplib_websocket_queue_frame( ctx, conn, frame ) == 0 ) num_sent++;
+
+			httplib_unlock_connection( conn );
+		}
+	}
+
+	XX_httplib_websocket_group_end( group, & iter );
+
+	XX_httplib_websocket_frame_release( frame );
+
+	return num_sent;
+
+}  /* httplib_websocket_broadcast */
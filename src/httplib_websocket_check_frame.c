@@ -0,0 +1,87 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int XX_httplib_websocket_check_frame( struct lh_ctx_t *ctx, struct lh_con_t *conn, unsigned char mop, uint64_t data_len, bool fragmented, size_t base );
+ *
+ * The function XX_httplib_websocket_check_frame() checks if a received
+ * websocket frame with the given first header byte and payload length is
+ * allowed in the current state of the connection. The flag fragmented tells
+ * if a fragmented message is being reassembled, and base is the length of
+ * that message so far, which counts for the maximum message size. The function returns zero if the frame is valid, or
+ * the status code with which the connection must be closed otherwise.
+ */
+
+int XX_httplib_websocket_check_frame( struct lh_ctx_t *ctx, struct lh_con_t *conn, unsigned char mop, uint64_t data_len, bool fragmented, size_t base ) {
+
+	unsigned char opcode;
+	bool fin;
+
+	opcode = mop & 0x0F;
+	fin    = ( (mop & 0x80) != 0 );
+
+	/*
+	 * Control frames must not be fragmented and have a payload of at
+	 * most 125 bytes. A continuation frame is only allowed after the
+	 * first frame of a fragmented message, and no other message can
+	 * start before the last fragment has been received.
+	 */
+
+	if ( (opcode & 0x08)  &&  ( ! fin  ||  data_len > 125 ) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket error: invalid control frame, closing connection", __func__ );
+		return 1002;
+	}
+
+	if ( ! (opcode & 0x08)  &&  fragmented != (opcode == WEBSOCKET_OPCODE_CONTINUATION) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket error: unexpected %s frame, closing connection", __func__, ( fragmented ) ? "data" : "continuation" );
+		return 1002;
+	}
+
+	/*
+	 * RSV1 marks the first frame of a message which is compressed
+	 * with the permessage-deflate extension. The other RSV bits are
+	 * not used by any extension which can be negotiated.
+	 */
+
+	if ( (mop & 0x70)  &&  ( (mop & 0x70) != WEBSOCKET_RSV1  ||  conn->ws_deflate == NULL  ||  (opcode & 0x08)  ||  opcode == WEBSOCKET_OPCODE_CONTINUATION ) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket error: unexpected RSV bits, closing connection", __func__ );
+		return 1002;
+	}
+
+	if ( ( ctx->websocket_max_message_size > 0  &&  data_len > (uint64_t)ctx->websocket_max_message_size - base )  ||  data_len > SIZE_MAX / 2 - base ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket message too large, closing connection", __func__ );
+		return 1009;
+	}
+
+	return 0;
+
+}  /* XX_httplib_websocket_check_frame */
@@ -29,12 +29,8 @@
  *
  * The function XX_httplib_websocket_client_thread() is the worker thread which
  * connects as a client to a remote websocket server. When finished, the
- * function frees the memory associated with the thread and the connection, but
- * it does not free any context data, because the context can be reused for
- * another connection.
- *
- * To signal the calling application that the context is in use or can be
- * reused, a status flag is set to the appropriate value.
+ * function frees the memory associated with the thread. The connection is
+ * freed by httplib_close_connection() after the thread has been joined.
  */
 
 LIBHTTP_THREAD XX_httplib_websocket_client_thread( void *data ) {
@@ -47,8 +43,6 @@ LIBHTTP_THREAD XX_httplib_websocket_client_thread( void *data ) {
 	if ( (conn  = cdata->conn) == NULL ) return LIBHTTP_THREAD_RETNULL;
 	if ( (ctx   = cdata->ctx ) == NULL ) return LIBHTTP_THREAD_RETNULL;
 
-	ctx->status = CTX_STATUS_RUNNING;
-
 	XX_httplib_set_thread_name( ctx, "ws-client" );
 
 	if ( ctx->callbacks.init_thread != NULL ) ctx->callbacks.init_thread( ctx, 3 );
@@ -57,12 +51,7 @@ LIBHTTP_THREAD XX_httplib_websocket_client_thread( void *data ) {
 
 	if ( cdata->close_handler != NULL ) cdata->close_handler( ctx, conn, cdata->callback_data );
 
-	ctx->workerthreadids = httplib_free( ctx->workerthreadids );
-	conn                 = httplib_free( conn                 );
-	cdata                = httplib_free( cdata                );
-	ctx->user_data       = NULL;
-	ctx->num_threads     = 0;
-	ctx->status          = CTX_STATUS_TERMINATED;
+	cdata = httplib_free( cdata );
 
 	return LIBHTTP_THREAD_RETNULL;
 
@@ -0,0 +1,122 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_websocket_deflate( struct lh_con_t *conn, const char *data, size_t len, const char **out, size_t *out_len );
+ *
+ * The function XX_httplib_websocket_deflate() compresses the payload of an
+ * outgoing websocket message as described in RFC 7692 section 7.2.1. The data
+ * is compressed with a sync flush and the four bytes 0x00 0x00 0xff 0xff at
+ * the end are removed. The result is stored in the compressor output buffer
+ * of the connection and is valid until the next message is compressed. The
+ * caller must hold the connection lock, because the compressor state is
+ * shared by all messages on the connection. The function returns false if an
+ * error occured.
+ */
+
+bool XX_httplib_websocket_deflate( struct lh_con_t *conn, const char *data, size_t len, const char **out, size_t *out_len ) {
+
+#if defined(USE_ZLIB)
+	struct lh_pmd_t *pmd;
+	z_stream *zs;
+	char *buf;
+	size_t size;
+	size_t used;
+	int retval;
+
+	if ( conn == NULL  ||  conn->ws_deflate == NULL  ||  out == NULL  ||  out_len == NULL ) return false;
+
+	pmd = conn->ws_deflate;
+
+	if ( pmd->deflate == NULL ) {
+
+		pmd->deflate = XX_httplib_websocket_zstream_get( pmd->pool, true, pmd->deflate_window_bits, pmd->level );
+		if ( pmd->deflate == NULL ) return false;
+	}
+
+	zs           = & pmd->deflate->zstream;
+	zs->next_in  = (const Bytef *)data;
+	zs->avail_in = (uInt)len;
+	used         = 0;
+
+	do {
+		if ( pmd->deflate_size - used < 64 ) {
+
+			size = ( pmd->deflate_size > 0 ) ? 2 * pmd->deflate_size : 4096;
+			while ( size < len / 2 ) size *= 2;
+
+			buf = httplib_realloc( pmd->deflate_buf, size );
+			if ( buf == NULL ) return false;
+
+			pmd->deflate_buf  = buf;
+			pmd->deflate_size = size;
+		}
+
+		zs->next_out  = (Bytef *)pmd->deflate_buf + used;
+		zs->avail_out = (uInt)(pmd->deflate_size - used);
+
+		retval = deflate( zs, Z_SYNC_FLUSH );
+		if ( retval != Z_OK  &&  retval != Z_BUF_ERROR ) return false;
+
+		used = pmd->deflate_size - zs->avail_out;
+
+	} while ( zs->avail_in > 0  ||  zs->avail_out == 0 );
+
+	if ( used >= 4  &&  ! memcmp( pmd->deflate_buf + used - 4, "\x00\x00\xff\xff", 4 ) ) used -= 4;
+
+	/*
+	 * Without context takeover the next message starts with an empty
+	 * window. A stream from the pool is returned after every message.
+	 */
+
+	if ( pmd->deflate_no_context_takeover ) {
+
+		if ( pmd->pool != NULL ) {
+
+			XX_httplib_websocket_zstream_put( pmd->pool, pmd->deflate );
+			pmd->deflate = NULL;
+		}
+
+		else deflateReset( zs );
+	}
+
+	*out     = pmd->deflate_buf;
+	*out_len = used;
+
+	return true;
+#else  /* USE_ZLIB */
+	UNUSED_PARAMETER( conn    );
+	UNUSED_PARAMETER( data    );
+	UNUSED_PARAMETER( len     );
+	UNUSED_PARAMETER( out     );
+	UNUSED_PARAMETER( out_len );
+
+	return false;
+#endif  /* USE_ZLIB */
+
+}  /* XX_httplib_websocket_deflate */
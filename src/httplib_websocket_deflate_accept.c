@@ -0,0 +1,71 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_websocket_deflate_accept( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *response );
+ *
+ * The function XX_httplib_websocket_deflate_accept() is called by a client
+ * with the value of the Sec-WebSocket-Extensions header of the response to a
+ * websocket upgrade request, or NULL if the server sent no such header. If the
+ * server accepted the permessage-deflate offer of the client, the extension is
+ * set up on the connection. The function returns false if the response is not
+ * valid for the offer which was sent, in which case RFC 7692 requires the
+ * client to fail the connection.
+ */
+
+bool XX_httplib_websocket_deflate_accept( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *response ) {
+
+#if defined(USE_ZLIB)
+	struct lh_pmp_t pmp;
+
+	if ( ctx == NULL  ||  conn == NULL                                        ) return false;
+	if ( response == NULL                                                     ) return true;
+	if ( ! ctx->enable_websocket_compression  ||  ctx->compression_level == 0 ) return false;
+
+	/*
+	 * The client offers client_max_window_bits without a value, so the
+	 * server may answer with a value, but must not leave it empty
+	 */
+
+	if ( strchr( response, ',' ) != NULL                                              ) return false;
+	if ( ! XX_httplib_websocket_deflate_params( response, strlen( response ), & pmp ) ) return false;
+	if ( pmp.client_max_window_bits < 0                                               ) return false;
+
+	return XX_httplib_websocket_deflate_init( ctx, conn, & pmp );
+#else  /* USE_ZLIB */
+	if ( ctx == NULL  ||  conn == NULL ) return false;
+
+	/*
+	 * Without zlib no extension is offered, and the server must not
+	 * respond with one
+	 */
+
+	return ( response == NULL );
+#endif  /* USE_ZLIB */
+
+}  /* XX_httplib_websocket_deflate_accept */
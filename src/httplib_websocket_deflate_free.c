@@ -0,0 +1,53 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_deflate_free( struct lh_con_t *conn );
+ *
+ * The function XX_httplib_websocket_deflate_free() releases the
+ * permessage-deflate state of a websocket connection. The zlib streams are
+ * returned to the pool they came from.
+ */
+
+void XX_httplib_websocket_deflate_free( struct lh_con_t *conn ) {
+
+	struct lh_pmd_t *pmd;
+
+	if ( conn == NULL  ||  conn->ws_deflate == NULL ) return;
+
+	pmd              = conn->ws_deflate;
+	conn->ws_deflate = NULL;
+
+	XX_httplib_websocket_zstream_put( pmd->pool, pmd->deflate );
+	XX_httplib_websocket_zstream_put( pmd->pool, pmd->inflate );
+
+	httplib_free( pmd->deflate_buf );
+	httplib_free( pmd->inflate_buf );
+	httplib_free( pmd );
+
+}  /* XX_httplib_websocket_deflate_free */
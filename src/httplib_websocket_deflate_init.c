@@ -0,0 +1,87 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_websocket_deflate_init( struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_pmp_t *pmp );
+ *
+ * The function XX_httplib_websocket_deflate_init() sets up the
+ * permessage-deflate extension on a websocket connection with the negotiated
+ * parameters. Which parameters apply to the compressor and which to the
+ * decompressor depends on whether the connection belongs to a server or a
+ * client context. When context takeover is used in a direction, the stream
+ * for that direction is created immediately, otherwise it is taken from the
+ * pool for every message. The function returns false if the parameters can't
+ * be supported or no memory is available.
+ */
+
+bool XX_httplib_websocket_deflate_init( struct lh_ctx_t *ctx, struct lh_con_t *conn, const struct lh_pmp_t *pmp ) {
+
+	struct lh_pmd_t *pmd;
+	bool server;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  pmp == NULL ) return false;
+
+	XX_httplib_websocket_deflate_free( conn );
+
+	server = ( ctx->ctx_type == CTX_TYPE_SERVER );
+	pmd    = httplib_calloc( 1, sizeof(struct lh_pmd_t) );
+
+	if ( pmd == NULL ) return false;
+
+	pmd->level                       = ctx->compression_level;
+	pmd->pool                        = ( server ) ? & ctx->ws_zstream_pool : NULL;
+	pmd->deflate_no_context_takeover = ( server ) ? pmp->server_no_context_takeover : pmp->client_no_context_takeover;
+	pmd->inflate_no_context_takeover = ( server ) ? pmp->client_no_context_takeover : pmp->server_no_context_takeover;
+	pmd->deflate_window_bits         = ( server ) ? pmp->server_max_window_bits     : pmp->client_max_window_bits;
+
+	if ( pmd->deflate_window_bits <= 0 ) pmd->deflate_window_bits = 15;
+
+	/*
+	 * zlib can't produce raw deflate data with a window of 256 bytes
+	 */
+
+	if ( pmd->deflate_window_bits < 9 ) {
+
+		httplib_free( pmd );
+		return false;
+	}
+
+	conn->ws_deflate = pmd;
+
+	if ( ! pmd->deflate_no_context_takeover ) pmd->deflate = XX_httplib_websocket_zstream_get( pmd->pool, true,  pmd->deflate_window_bits, pmd->level );
+	if ( ! pmd->inflate_no_context_takeover ) pmd->inflate = XX_httplib_websocket_zstream_get( pmd->pool, false, 0,                        0          );
+
+	if ( ( ! pmd->deflate_no_context_takeover  &&  pmd->deflate == NULL )  ||  ( ! pmd->inflate_no_context_takeover  &&  pmd->inflate == NULL ) ) {
+
+		XX_httplib_websocket_deflate_free( conn );
+		return false;
+	}
+
+	return true;
+
+}  /* XX_httplib_websocket_deflate_init */
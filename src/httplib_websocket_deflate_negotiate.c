@@ -0,0 +1,86 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_websocket_deflate_negotiate( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *offers, char *response, size_t response_len );
+ *
+ * The function XX_httplib_websocket_deflate_negotiate() is called by a server
+ * with the value of the Sec-WebSocket-Extensions header of a websocket
+ * upgrade request. The first permessage-deflate offer which can be supported
+ * is accepted, the extension is set up on the connection and the value for
+ * the Sec-WebSocket-Extensions header of the response is stored in response.
+ * Offers which limit the window of the server to 256 bytes are declined,
+ * because zlib doesn't support that window size. The function returns false
+ * if no offer was accepted, if compression is disabled, or if the library is
+ * built without zlib.
+ */
+
+bool XX_httplib_websocket_deflate_negotiate( struct lh_ctx_t *ctx, struct lh_con_t *conn, const char *offers, char *response, size_t response_len ) {
+
+#if defined(USE_ZLIB)
+	struct lh_pmp_t pmp;
+	const char *end;
+	bool truncated;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  offers == NULL  ||  response == NULL ) return false;
+	if ( ! ctx->enable_websocket_compression  ||  ctx->compression_level == 0    ) return false;
+
+	while ( *offers != '\0' ) {
+
+		end = strchr( offers, ',' );
+		if ( end == NULL ) end = offers + strlen( offers );
+
+		if ( XX_httplib_websocket_deflate_params( offers, (size_t)(end - offers), & pmp )  &&  pmp.server_max_window_bits != 8 ) {
+
+			XX_httplib_snprintf( ctx, conn, & truncated, response, response_len, "permessage-deflate%s%s",
+						( pmp.server_no_context_takeover ) ? "; server_no_context_takeover" : "",
+						( pmp.client_no_context_takeover ) ? "; client_no_context_takeover" : "" );
+
+			if ( ! truncated  &&  pmp.server_max_window_bits > 0 ) {
+
+				XX_httplib_snprintf( ctx, conn, & truncated, response + strlen( response ), response_len - strlen( response ), "; server_max_window_bits=%d", pmp.server_max_window_bits );
+			}
+
+			return ( ! truncated  &&  XX_httplib_websocket_deflate_init( ctx, conn, & pmp ) );
+		}
+
+		offers = ( *end == ',' ) ? end+1 : end;
+	}
+
+	return false;
+#else  /* USE_ZLIB */
+	UNUSED_PARAMETER( ctx          );
+	UNUSED_PARAMETER( conn         );
+	UNUSED_PARAMETER( offers       );
+	UNUSED_PARAMETER( response     );
+	UNUSED_PARAMETER( response_len );
+
+	return false;
+#endif  /* USE_ZLIB */
+
+}  /* XX_httplib_websocket_deflate_negotiate */
@@ -0,0 +1,156 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+static int	window_bits( const char *value, size_t len );
+
+/*
+ * bool XX_httplib_websocket_deflate_params( const char *ext, size_t len, struct lh_pmp_t *pmp );
+ *
+ * The function XX_httplib_websocket_deflate_params() parses one element of a
+ * Sec-WebSocket-Extensions header with a length of len bytes, like
+ * "permessage-deflate; client_max_window_bits; server_max_window_bits=10".
+ * The parameters are stored in pmp. Parameter values may be quoted. The
+ * function returns false if the element is not a permessage-deflate
+ * extension, or if it contains an unknown, duplicate or invalid parameter as
+ * described in RFC 7692 section 7.1.
+ */
+
+bool XX_httplib_websocket_deflate_params( const char *ext, size_t len, struct lh_pmp_t *pmp ) {
+
+	static const char *name = "permessage-deflate";
+	const char *end;
+	const char *param;
+	const char *value;
+	size_t param_len;
+	size_t value_len;
+	int bits;
+
+	if ( ext == NULL  ||  pmp == NULL ) return false;
+
+	memset( pmp, 0, sizeof(struct lh_pmp_t) );
+
+	end = ext + len;
+
+	while ( ext < end  &&  isspace( *(const unsigned char *)ext ) ) ext++;
+	if ( (size_t)(end - ext) < strlen( name )  ||  httplib_strncasecmp( ext, name, strlen( name ) ) ) return false;
+	ext += strlen( name );
+
+	while ( ext < end ) {
+
+		while ( ext < end  &&  isspace( *(const unsigned char *)ext ) ) ext++;
+		if ( ext >= end ) break;
+		if ( *ext != ';' ) return false;
+
+		ext++;
+		while ( ext < end  &&  isspace( *(const unsigned char *)ext ) ) ext++;
+
+		param = ext;
+		while ( ext < end  &&  *ext != '='  &&  *ext != ';'  &&  ! isspace( *(const unsigned char *)ext ) ) ext++;
+		param_len = (size_t)(ext - param);
+
+		while ( ext < end  &&  isspace( *(const unsigned char *)ext ) ) ext++;
+
+		value     = NULL;
+		value_len = 0;
+
+		if ( ext < end  &&  *ext == '=' ) {
+
+			ext++;
+			while ( ext < end  &&  isspace( *(const unsigned char *)ext ) ) ext++;
+
+			if ( ext < end  &&  *ext == '"' ) {
+
+				value = ++ext;
+				while ( ext < end  &&  *ext != '"' ) ext++;
+				if ( ext >= end ) return false;
+				value_len = (size_t)(ext - value);
+				ext++;
+			}
+
+			else {
+				value = ext;
+				while ( ext < end  &&  *ext != ';'  &&  ! isspace( *(const unsigned char *)ext ) ) ext++;
+				value_len = (size_t)(ext - value);
+			}
+		}
+
+		if ( param_len == 26  &&  ! httplib_strncasecmp( param, "server_no_context_takeover", 26 ) ) {
+
+			if ( value != NULL  ||  pmp->server_no_context_takeover ) return false;
+			pmp->server_no_context_takeover = true;
+		}
+
+		else if ( param_len == 26  &&  ! httplib_strncasecmp( param, "client_no_context_takeover", 26 ) ) {
+
+			if ( value != NULL  ||  pmp->client_no_context_takeover ) return false;
+			pmp->client_no_context_takeover = true;
+		}
+
+		else if ( param_len == 22  &&  ! httplib_strncasecmp( param, "server_max_window_bits", 22 ) ) {
+
+			bits = window_bits( value, value_len );
+			if ( bits <= 0  ||  pmp->server_max_window_bits != 0 ) return false;
+			pmp->server_max_window_bits = bits;
+		}
+
+		else if ( param_len == 22  &&  ! httplib_strncasecmp( param, "client_max_window_bits", 22 ) ) {
+
+			bits = ( value != NULL ) ? window_bits( value, value_len ) : -1;
+			if ( bits == 0  ||  pmp->client_max_window_bits != 0 ) return false;
+			pmp->client_max_window_bits = bits;
+		}
+
+		else return false;
+	}
+
+	return true;
+
+}  /* XX_httplib_websocket_deflate_params */
+
+
+
+/*
+ * static int window_bits( const char *value, size_t len );
+ *
+ * The function window_bits() converts the value of a window bits parameter to
+ * a number. The value must be a decimal number from 8 to 15 without leading
+ * zeros. If the value is invalid, zero is returned.
+ */
+
+static int window_bits( const char *value, size_t len ) {
+
+	int bits;
+
+	if ( value == NULL  ||  len < 1  ||  len > 2  ||  value[0] == '0' ) return 0;
+
+	if ( len == 1 ) bits = ( isdigit( *(const unsigned char *)value ) ) ? value[0] - '0' : 0;
+	else            bits = ( isdigit( ((const unsigned char *)value)[0] )  &&  isdigit( ((const unsigned char *)value)[1] ) ) ? 10 * (value[0] - '0') + value[1] - '0' : 0;
+
+	return ( bits >= 8  &&  bits <= 15 ) ? bits : 0;
+
+}  /* window_bits */
@@ -0,0 +1,100 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * size_t XX_httplib_websocket_frame_header( unsigned char *header, int opcode, size_t data_len, uint32_t masking_key );
+ *
+ * The function XX_httplib_websocket_frame_header() builds the header of a
+ * websocket frame in a buffer of at least WEBSOCKET_HEADER_MAX bytes. The
+ * opcode may be combined with the RSV1 bit for compressed messages. A masking
+ * key of zero means that the payload is not masked. The length of the header
+ * is returned.
+ */
+
+size_t XX_httplib_websocket_frame_header( unsigned char *header, int opcode, size_t data_len, uint32_t masking_key ) {
+
+	size_t header_len;
+	uint16_t len;
+	uint32_t len1;
+	uint32_t len2;
+
+	header[0] = (unsigned char)(0x80 | (opcode & (WEBSOCKET_RSV1 | 0x0F)));
+
+	/*
+	 * Frame format: http://tools.ietf.org/html/rfc6455#section-5.2
+	 */
+
+	if ( data_len < 126 ) {
+
+		/*
+		 * inline 7-bit length field
+		 */
+
+		header[1]  = (unsigned char)data_len;
+		header_len = 2;
+	}
+	
+	else if ( data_len <= 65535 ) {
+
+		/*
+		 * 16-bit length field
+		 */
+
+		len        = htons( (uint16_t)data_len );
+		header[1]  = 126;
+		header_len = 4;
+		memcpy( header+2, & len, 2 );
+	}
+	
+	else {
+		/*
+		 * 64-bit length field
+		 */
+
+		len1       = htonl( (uint64_t)data_len >> 32 );
+		len2       = htonl( data_len & 0xFFFFFFFF );
+		header[1]  = 127;
+		header_len = 10;
+		memcpy( header + 2, & len1, 4 );
+		memcpy( header + 6, & len2, 4 );
+	}
+
+	if ( masking_key ) {
+
+		/*
+		 * add mask
+		 */
+
+		header[1] |= 0x80;
+		memcpy( header + header_len, & masking_key, 4 );
+		header_len += 4;
+	}
+
+	return header_len;
+
+}  /* XX_httplib_websocket_frame_header */
@@ -0,0 +1,86 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_websocket_group_add( struct lh_ctx_t *ctx, struct lh_wsg_t *group, struct lh_con_t *conn );
+ *
+ * The function httplib_websocket_group_add() adds a websocket connection of
+ * a server context to a group. A connection may be a member of more than one
+ * group, but only once of each group. The application must remove the
+ * connection from all its groups in the close handler of the connection. The
+ * function returns 0 on success and -1 if an error occured.
+ */
+
+int httplib_websocket_group_add( struct lh_ctx_t *ctx, struct lh_wsg_t *group, struct lh_con_t *conn ) {
+
+	struct lh_con_t **conns;
+	size_t size;
+	size_t a;
+
+	if ( ctx == NULL  ||  group == NULL  ||  conn == NULL ) return -1;
+
+	if ( ctx->ctx_type != CTX_TYPE_SERVER ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: only server connections can be added to a websocket group", __func__ );
+		return -1;
+	}
+
+	httplib_pthread_mutex_lock( & group->mutex );
+
+	for (a=0; a<group->num_conns; a++) {
+
+		if ( group->conns[a] == conn ) {
+
+			httplib_pthread_mutex_unlock( & group->mutex );
+			return 0;
+		}
+	}
+
+	if ( group->num_conns == group->size ) {
+
+		size  = ( group->size > 0 ) ? group->size * 2 : 16;
+		conns = httplib_realloc( group->conns, size * sizeof(struct lh_con_t *) );
+
+		if ( conns == NULL ) {
+
+			httplib_pthread_mutex_unlock( & group->mutex );
+			httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: cannot grow websocket group", __func__ );
+			return -1;
+		}
+
+		group->conns = conns;
+		group->size  = size;
+	}
+
+	group->conns[group->num_conns++] = conn;
+
+	httplib_pthread_mutex_unlock( & group->mutex );
+
+	return 0;
+
+}  /* httplib_websocket_group_add */
@@ -0,0 +1,68 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_websocket_group_begin( struct lh_wsg_t *group, struct lh_wsi_t *iter );
+ *
+ * The function XX_httplib_websocket_group_begin() starts an iteration over
+ * the connections of a websocket group. The connections are copied, and the
+ * iteration is registered in the group, so that connections which are
+ * removed meanwhile are skipped. Each iteration which has been started must
+ * be finished with XX_httplib_websocket_group_end(). The function returns
+ * false if no memory could be allocated for the copy.
+ */
+
+bool XX_httplib_websocket_group_begin( struct lh_wsg_t *group, struct lh_wsi_t *iter ) {
+
+	if ( group == NULL  ||  iter == NULL ) return false;
+
+	memset( iter, 0, sizeof(*iter) );
+
+	httplib_pthread_mutex_lock( & group->mutex );
+
+	if ( group->num_conns > 0 ) {
+
+		iter->conns = httplib_malloc( group->num_conns * sizeof(struct lh_con_t *) );
+
+		if ( iter->conns == NULL ) {
+
+			httplib_pthread_mutex_unlock( & group->mutex );
+			return false;
+		}
+
+		memcpy( iter->conns, group->conns, group->num_conns * sizeof(struct lh_con_t *) );
+		iter->num_conns = group->num_conns;
+	}
+
+	iter->next   = group->iters;
+	group->iters = iter;
+
+	httplib_pthread_mutex_unlock( & group->mutex );
+
+	return true;
+
+}  /* XX_httplib_websocket_group_begin */
@@ -0,0 +1,69 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * struct lh_wsg_t *httplib_websocket_group_create( struct lh_ctx_t *ctx );
+ *
+ * The function httplib_websocket_group_create() creates an empty group of
+ * websocket connections to which frames can be broadcast with the function
+ * httplib_websocket_broadcast(). NULL is returned if the group could not be
+ * created.
+ */
+
+struct lh_wsg_t *httplib_websocket_group_create( struct lh_ctx_t *ctx ) {
+
+	struct lh_wsg_t *group;
+
+	if ( ctx == NULL ) return NULL;
+
+	group = httplib_calloc( 1, sizeof(struct lh_wsg_t) );
+
+	if ( group == NULL ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: cannot allocate websocket group", __func__ );
+		return NULL;
+	}
+
+	if ( httplib_pthread_mutex_init( & group->mutex, & XX_httplib_pthread_mutex_attr ) != 0 ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: cannot initialize mutex of websocket group", __func__ );
+		httplib_free( group );
+		return NULL;
+	}
+
+	if ( httplib_pthread_cond_init( & group->released, NULL ) != 0 ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: cannot initialize condition of websocket group", __func__ );
+		httplib_pthread_mutex_destroy( & group->mutex );
+		httplib_free( group );
+		return NULL;
+	}
+
+	return group;
+
+}  /* httplib_websocket_group_create */
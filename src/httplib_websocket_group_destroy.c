@@ -0,0 +1,50 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * void httplib_websocket_group_destroy( struct lh_ctx_t *ctx, struct lh_wsg_t *group );
+ *
+ * The function httplib_websocket_group_destroy() frees a group of websocket
+ * connections. The connections in the group are not affected. Parts of
+ * broadcast frames which are still pending on them are sent with the next
+ * write on the connection. No broadcast to the group may be running.
+ */
+
+void httplib_websocket_group_destroy( struct lh_ctx_t *ctx, struct lh_wsg_t *group ) {
+
+	UNUSED_PARAMETER(ctx);
+
+	if ( group == NULL ) return;
+
+	httplib_pthread_cond_destroy( & group->released );
+	httplib_pthread_mutex_destroy( & group->mutex );
+
+	if ( group->conns != NULL ) httplib_free( group->conns );
+	httplib_free( group );
+
+}  /* httplib_websocket_group_destroy */
@@ -0,0 +1,64 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_group_end( struct lh_wsg_t *group, struct lh_wsi_t *iter );
+ *
+ * The function XX_httplib_websocket_group_end() finishes an iteration over
+ * the connections of a websocket group which was started with
+ * XX_httplib_websocket_group_begin(). The connection which is still in use
+ * is released and the copy of the connections is freed.
+ */
+
+void XX_httplib_websocket_group_end( struct lh_wsg_t *group, struct lh_wsi_t *iter ) {
+
+	struct lh_wsi_t **walk;
+
+	if ( group == NULL  ||  iter == NULL ) return;
+
+	httplib_pthread_mutex_lock( & group->mutex );
+
+	for (walk=& group->iters; *walk != NULL; walk=& (*walk)->next) {
+
+		if ( *walk == iter ) {
+
+			*walk = iter->next;
+			break;
+		}
+	}
+
+	if ( iter->cur != NULL ) {
+
+		iter->cur = NULL;
+		httplib_pthread_cond_broadcast( & group->released );
+	}
+
+	httplib_pthread_mutex_unlock( & group->mutex );
+
+	iter->conns = httplib_free( iter->conns );
+
+}  /* XX_httplib_websocket_group_end */
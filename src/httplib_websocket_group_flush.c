@@ -0,0 +1,77 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_websocket_group_flush( const struct lh_ctx_t *ctx, struct lh_wsg_t *group );
+ *
+ * The function httplib_websocket_group_flush() tries to send the rest of the
+ * broadcast frames which could only be sent partly to the connections of a
+ * group, without waiting for slow receivers. Connections which are busy
+ * with another write are skipped and counted as pending. The send queues of
+ * connections of the reactor are sent by the reactor itself and are only
+ * counted. The function returns
+ * the number of connections in the group on which data is still pending, or
+ * -1 if an error occured.
+ */
+
+int httplib_websocket_group_flush( const struct lh_ctx_t *ctx, struct lh_wsg_t *group ) {
+
+	struct lh_con_t *conn;
+	struct lh_wsi_t iter;
+	int pending;
+
+	if ( ctx == NULL  ||  group == NULL ) return -1;
+
+	if ( ! XX_httplib_websocket_group_begin( group, & iter ) ) return -1;
+
+	pending = 0;
+
+	while ( (conn = XX_httplib_websocket_group_next( group, & iter )) != NULL ) {
+
+		if ( conn->ws_reactor != NULL ) {
+
+			if ( ! XX_httplib_websocket_group_lock( group, & iter, conn ) ) continue;
+			if ( conn->ws_queue != NULL ) pending++;
+		}
+
+		else if ( httplib_pthread_mutex_trylock( & conn->mutex ) != 0 ) {
+
+			pending++;
+			continue;
+		}
+
+		else if ( XX_httplib_websocket_send_pending( ctx, conn, false ) > 0 ) pending++;
+
+		httplib_unlock_connection( conn );
+	}
+
+	XX_httplib_websocket_group_end( group, & iter );
+
+	return pending;
+
+}  /* httplib_websocket_group_flush */
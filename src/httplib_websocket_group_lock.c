@@ -0,0 +1,64 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_websocket_group_lock( struct lh_wsg_t *group, struct lh_wsi_t *iter, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_websocket_group_lock() locks the connection which
+ * is in use by an iteration over a websocket group and waits until the lock
+ * is free. The thread which holds the lock may be removing the connection
+ * from the group and wait for the iteration itself. The lock is therefore
+ * only tried, and the function gives up and returns false when the
+ * connection has been removed from the group meanwhile. The function returns
+ * true when the connection has been locked.
+ */
+
+bool XX_httplib_websocket_group_lock( struct lh_wsg_t *group, struct lh_wsi_t *iter, struct lh_con_t *conn ) {
+
+	bool removed;
+
+	if ( group == NULL  ||  iter == NULL  ||  conn == NULL ) return false;
+
+	while ( httplib_pthread_mutex_trylock( & conn->mutex ) != 0 ) {
+
+		httplib_pthread_mutex_lock( & group->mutex );
+		removed = iter->removed;
+		httplib_pthread_mutex_unlock( & group->mutex );
+
+		if ( removed ) return false;
+
+		/*
+		 * Other threads hold the lock of a connection only shortly,
+		 * unless they are closing it.
+		 */
+
+		httplib_sleep( 1 );
+	}
+
+	return true;
+
+}  /* XX_httplib_websocket_group_lock */
@@ -0,0 +1,59 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * struct lh_con_t *XX_httplib_websocket_group_next( struct lh_wsg_t *group, struct lh_wsi_t *iter );
+ *
+ * The function XX_httplib_websocket_group_next() releases the connection
+ * which was returned by the previous call and returns the next connection of
+ * an iteration over a websocket group. The connection stays in use until the
+ * next call, and httplib_websocket_group_remove() doesn't return before that
+ * when it removes the connection. The connection is not locked. NULL is
+ * returned when all connections have been returned.
+ */
+
+struct lh_con_t *XX_httplib_websocket_group_next( struct lh_wsg_t *group, struct lh_wsi_t *iter ) {
+
+	if ( group == NULL  ||  iter == NULL ) return NULL;
+
+	httplib_pthread_mutex_lock( & group->mutex );
+
+	if ( iter->cur != NULL ) {
+
+		iter->cur     = NULL;
+		iter->removed = false;
+
+		httplib_pthread_cond_broadcast( & group->released );
+	}
+
+	while ( iter->pos < iter->num_conns  &&  iter->cur == NULL ) iter->cur = iter->conns[iter->pos++];
+
+	httplib_pthread_mutex_unlock( & group->mutex );
+
+	return iter->cur;
+
+}  /* XX_httplib_websocket_group_next */
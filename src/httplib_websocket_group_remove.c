@@ -0,0 +1,93 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_websocket_group_remove( struct lh_ctx_t *ctx, struct lh_wsg_t *group, struct lh_con_t *conn );
+ *
+ * The function httplib_websocket_group_remove() removes a websocket
+ * connection from a group. Broadcasts which are running skip the connection
+ * from now on. If one of them is writing to the connection, the function
+ * waits until it has finished, so that no broadcast to the group uses the
+ * connection anymore when the function returns. This makes it safe to call
+ * from the close handler of the connection, also when the caller holds the
+ * lock of the connection. The order of the other connections in the group may
+ * change. The function returns 0 if the connection was removed and -1 if it
+ * was not a member of the group.
+ */
+
+int httplib_websocket_group_remove( struct lh_ctx_t *ctx, struct lh_wsg_t *group, struct lh_con_t *conn ) {
+
+	struct lh_wsi_t *iter;
+	size_t a;
+	bool busy;
+	int retval;
+
+	UNUSED_PARAMETER(ctx);
+
+	if ( group == NULL  ||  conn == NULL ) return -1;
+
+	retval = -1;
+
+	httplib_pthread_mutex_lock( & group->mutex );
+
+	for (a=0; a<group->num_conns; a++) {
+
+		if ( group->conns[a] == conn ) {
+
+			group->conns[a] = group->conns[--group->num_conns];
+			retval          = 0;
+			break;
+		}
+	}
+
+	for (iter=group->iters; iter != NULL; iter=iter->next) {
+
+		for (a=0; a<iter->num_conns; a++) if ( iter->conns[a] == conn ) iter->conns[a] = NULL;
+
+		if ( iter->cur == conn ) iter->removed = true;
+	}
+
+	/*
+	 * A broadcast which waits for the lock of the connection gives up
+	 * when it sees that the connection has been removed.
+	 */
+
+	do {
+		busy = false;
+
+		for (iter=group->iters; iter != NULL; iter=iter->next) if ( iter->cur == conn ) busy = true;
+
+		if ( busy ) httplib_pthread_cond_wait( & group->released, & group->mutex );
+
+	} while ( busy );
+
+	httplib_pthread_mutex_unlock( & group->mutex );
+
+	return retval;
+
+}  /* httplib_websocket_group_remove */
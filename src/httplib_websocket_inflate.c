@@ -0,0 +1,149 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int XX_httplib_websocket_inflate( struct lh_con_t *conn, const char *data, size_t len, size_t max_len, char **out, size_t *out_len );
+ *
+ * The function XX_httplib_websocket_inflate() decompresses the payload of a
+ * received websocket message which has the RSV1 bit set, as described in RFC
+ * 7692 section 7.2.2. The four bytes 0x00 0x00 0xff 0xff which the sender
+ * removed are added after the payload. The result is stored in the
+ * decompressor output buffer of the connection and is valid until the next
+ * message is decompressed. The output is limited to max_len bytes, unless
+ * max_len is zero, so that a small compressed message can't exhaust the
+ * memory.
+ *
+ * The function returns 0 on success, -1 if the data is not valid compressed
+ * data, -2 if the message is larger than max_len and -3 if no memory is
+ * available.
+ */
+
+int XX_httplib_websocket_inflate( struct lh_con_t *conn, const char *data, size_t len, size_t max_len, char **out, size_t *out_len ) {
+
+#if defined(USE_ZLIB)
+	static const unsigned char tail[4] = { 0x00, 0x00, 0xff, 0xff };
+	struct lh_pmd_t *pmd;
+	z_stream *zs;
+	char *buf;
+	size_t size;
+	size_t used;
+	int retval;
+	int part;
+
+	if ( conn == NULL  ||  conn->ws_deflate == NULL  ||  out == NULL  ||  out_len == NULL ) return -1;
+
+	pmd = conn->ws_deflate;
+
+	if ( pmd->inflate == NULL ) {
+
+		pmd->inflate = XX_httplib_websocket_zstream_get( pmd->pool, false, 0, 0 );
+		if ( pmd->inflate == NULL ) return -3;
+	}
+
+	zs     = & pmd->inflate->zstream;
+	used   = 0;
+	retval = Z_OK;
+
+	for (part=0; part<2; part++) {
+
+		zs->next_in  = ( part == 0 ) ? (const Bytef *)data : tail;
+		zs->avail_in = ( part == 0 ) ? (uInt)len           : sizeof(tail);
+
+		do {
+			if ( pmd->inflate_size == used ) {
+
+				if ( max_len > 0  &&  used > max_len ) return -2;
+
+				size = ( pmd->inflate_size > 0 ) ? 2 * pmd->inflate_size : 4096;
+				while ( size < 2 * len ) size *= 2;
+				if ( max_len > 0  &&  size > max_len + 1 ) size = max_len + 1;
+
+				buf = httplib_realloc( pmd->inflate_buf, size );
+				if ( buf == NULL ) return -3;
+
+				pmd->inflate_buf  = buf;
+				pmd->inflate_size = size;
+			}
+
+			zs->next_out  = (Bytef *)pmd->inflate_buf + used;
+			zs->avail_out = (uInt)(pmd->inflate_size - used);
+
+			retval = inflate( zs, Z_SYNC_FLUSH );
+			used   = pmd->inflate_size - zs->avail_out;
+
+			if ( retval == Z_STREAM_END ) {
+
+				/*
+				 * The sender ended the deflate stream with a final
+				 * block. A following message starts a new stream.
+				 */
+
+				inflateReset( zs );
+				retval = Z_OK;
+				if ( part == 1 ) break;
+			}
+
+			if ( retval == Z_BUF_ERROR  &&  zs->avail_out > 0 ) break;
+			if ( retval != Z_OK         &&  retval != Z_BUF_ERROR ) break;
+
+			if ( max_len > 0  &&  used > max_len ) return -2;
+
+		} while ( zs->avail_in > 0  ||  zs->avail_out == 0 );
+
+		if ( retval != Z_OK  &&  retval != Z_BUF_ERROR ) break;
+	}
+
+	if ( pmd->inflate_no_context_takeover ) {
+
+		if ( pmd->pool != NULL ) {
+
+			XX_httplib_websocket_zstream_put( pmd->pool, pmd->inflate );
+			pmd->inflate = NULL;
+		}
+
+		else inflateReset( zs );
+	}
+
+	if ( retval != Z_OK  &&  retval != Z_BUF_ERROR ) return -1;
+
+	*out     = pmd->inflate_buf;
+	*out_len = used;
+
+	return 0;
+#else  /* USE_ZLIB */
+	UNUSED_PARAMETER( conn    );
+	UNUSED_PARAMETER( data    );
+	UNUSED_PARAMETER( len     );
+	UNUSED_PARAMETER( max_len );
+	UNUSED_PARAMETER( out     );
+	UNUSED_PARAMETER( out_len );
+
+	return -1;
+#endif  /* USE_ZLIB */
+
+}  /* XX_httplib_websocket_inflate */
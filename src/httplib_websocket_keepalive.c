@@ -0,0 +1,193 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+static bool	send_ping( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsf_t *frame );
+
+/*
+ * bool XX_httplib_websocket_keepalive( struct lh_ctx_t *ctx, void *cbdata );
+ *
+ * The function XX_httplib_websocket_keepalive() is the handler of a timer
+ * which repeats every WEBSOCKET_KEEPALIVE_TICK milliseconds while keepalive
+ * pings are enabled. It does nothing until the earliest deadline
+ * of the connections in the keepalive list has passed. Then a ping frame is
+ * sent to every connection which hasn't received data for the time set with
+ * the websocket_ping_interval option. A connection which didn't receive any
+ * data, normally the pong frame, within websocket_pong_timeout milliseconds
+ * after the ping is shut down, so that the thread which serves it closes it.
+ * The earliest deadline of the remaining connections is remembered for the
+ * next call. The frame of the ping is built only once for all connections.
+ * The function returns true to keep the timer running.
+ */
+
+bool XX_httplib_websocket_keepalive( struct lh_ctx_t *ctx, void *cbdata ) {
+
+	struct lh_wka_t *ka;
+	struct lh_wsf_t *frame;
+	struct lh_con_t *conn;
+	int64_t now;
+	int64_t due;
+	int64_t next;
+
+	UNUSED_PARAMETER(cbdata);
+
+	if ( ctx == NULL  ||  ctx->websocket_ping_interval <= 0 ) return false;
+
+	ka  = & ctx->ws_keepalive;
+	now = XX_httplib_monotonic_msec();
+
+	httplib_pthread_mutex_lock( & ka->mutex );
+
+	if ( ka->first == NULL  ||  now < ka->next_check ) {
+
+		httplib_pthread_mutex_unlock( & ka->mutex );
+		return true;
+	}
+
+	frame = NULL;
+	next  = now + ctx->websocket_ping_interval;
+
+	for (conn=ka->first; conn!=NULL; conn=conn->ws_ka_next) {
+
+		if ( conn->ws_ping_sent < 0 ) continue;
+
+		/*
+		 * A ping is outstanding as long as no data was received after
+		 * it was sent.
+		 */
+
+		if ( conn->ws_ping_sent > 0  &&  conn->ws_last_rx < conn->ws_ping_sent ) {
+
+			if ( ctx->websocket_pong_timeout <= 0 ) continue;
+
+			due = conn->ws_ping_sent + ctx->websocket_pong_timeout;
+
+			if ( now >= due ) {
+
+				httplib_cry( LH_DEBUG_INFO, ctx, conn, "%s: websocket peer did not answer ping; closing connection", __func__ );
+
+				conn->ws_ping_sent = -1;
+				ka->num_reaped++;
+
+				shutdown( conn->client.sock, SHUTDOWN_BOTH );
+			}
+
+			else if ( due < next ) next = due;
+
+			continue;
+		}
+
+		due = conn->ws_last_rx + ctx->websocket_ping_interval;
+
+		if ( now < due ) {
+
+			if ( due < next ) next = due;
+			continue;
+		}
+
+		if ( frame == NULL ) {
+
+			frame = httplib_malloc( sizeof(struct lh_wsf_t) + WEBSOCKET_HEADER_MAX );
+
+			if ( frame == NULL ) {
+
+				httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: out of memory for websocket ping", __func__ );
+
+				next = now;
+				break;
+			}
+
+			frame->refcount = 1;
+			frame->len      = XX_httplib_websocket_frame_header( (unsigned char *)(frame + 1), WEBSOCKET_OPCODE_PING, 0, 0 );
+		}
+
+		/*
+		 * A connection which is busy with another write is tried again
+		 * at the next call.
+		 */
+
+		if ( ! send_ping( ctx, conn, frame ) ) {
+
+			next = now;
+			continue;
+		}
+
+		conn->ws_ping_sent = now;
+		ka->num_pings++;
+
+		if ( ctx->websocket_pong_timeout > 0  &&  now + ctx->websocket_pong_timeout < next ) next = now + ctx->websocket_pong_timeout;
+	}
+
+	ka->next_check = next;
+
+	httplib_pthread_mutex_unlock( & ka->mutex );
+
+	if ( frame != NULL ) XX_httplib_websocket_frame_release( frame );
+
+	return true;
+
+}  /* XX_httplib_websocket_keepalive */
+
+
+
+/*
+ * static bool send_ping( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsf_t *frame );
+ *
+ * The function send_ping() sends a ping frame on a websocket connection in
+ * the same way as a broadcast. The frame is queued on plain connections and
+ * written directly on TLS connections. A ping which can't be sent because
+ * older frames are still waiting in the send queue is not retried, because
+ * a peer which doesn't read its data isn't alive either. The function
+ * returns false if the connection is busy with another write.
+ */
+
+static bool send_ping( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsf_t *frame ) {
+
+	if ( httplib_pthread_mutex_trylock( & conn->mutex ) != 0 ) return false;
+
+	if ( conn->must_close ) {
+
+		httplib_unlock_connection( conn );
+		return true;
+	}
+
+	if ( conn->ssl != NULL ) {
+
+		if ( XX_httplib_websocket_send_pending( ctx, conn, true ) == 0 ) XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, (const char *)(frame + 1), (int64_t)frame->len );
+	}
+
+	else if ( conn->ws_reactor != NULL ) {
+
+		if ( XX_httplib_websocket_queue_limit( ctx, conn ) == 0 ) XX_httplib_websocket_queue_frame( ctx, conn, frame );
+	}
+
+	else if ( XX_httplib_websocket_send_pending( ctx, conn, false ) == 0 ) XX_httplib_websocket_queue_frame( ctx, conn, frame );
+
+	httplib_unlock_connection( conn );
+
+	return true;
+
+}  /* send_ping */
@@ -0,0 +1,64 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_keepalive_add( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_websocket_keepalive_add() adds a websocket
+ * connection of the server to the keepalive list of the context. The
+ * connection counts as active from now on. If sending pings is enabled, the
+ * deadline of the list is moved forward when the connection becomes idle
+ * before the connections which are already in the list.
+ */
+
+void XX_httplib_websocket_keepalive_add( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	struct lh_wka_t *ka;
+	int64_t due;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  conn->ws_keepalive ) return;
+
+	ka                 = & ctx->ws_keepalive;
+	conn->ws_last_rx   = XX_httplib_monotonic_msec();
+	conn->ws_ping_sent = 0;
+	due                = conn->ws_last_rx + ctx->websocket_ping_interval;
+
+	httplib_pthread_mutex_lock( & ka->mutex );
+
+	conn->ws_ka_prev   = NULL;
+	conn->ws_ka_next   = ka->first;
+	conn->ws_keepalive = true;
+
+	if ( ka->first != NULL ) ka->first->ws_ka_prev = conn;
+	ka->first = conn;
+	ka->num_conns++;
+
+	if ( ctx->websocket_ping_interval > 0  &&  ( ka->next_check == 0  ||  due < ka->next_check ) ) ka->next_check = due;
+
+	httplib_pthread_mutex_unlock( & ka->mutex );
+
+}  /* XX_httplib_websocket_keepalive_add */
@@ -0,0 +1,60 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_keepalive_remove( struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_websocket_keepalive_remove() removes a websocket
+ * connection from the keepalive list of the context. This must be done
+ * before the socket of the connection is closed, because the master thread
+ * may still send a ping on it or shut it down until then. The caller must not
+ * hold the lock of the connection.
+ */
+
+void XX_httplib_websocket_keepalive_remove( struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	struct lh_wka_t *ka;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  ! conn->ws_keepalive ) return;
+
+	ka = & ctx->ws_keepalive;
+
+	httplib_pthread_mutex_lock( & ka->mutex );
+
+	if ( conn->ws_ka_prev != NULL ) conn->ws_ka_prev->ws_ka_next = conn->ws_ka_next;
+	else                            ka->first                    = conn->ws_ka_next;
+
+	if ( conn->ws_ka_next != NULL ) conn->ws_ka_next->ws_ka_prev = conn->ws_ka_prev;
+
+	conn->ws_ka_prev   = NULL;
+	conn->ws_ka_next   = NULL;
+	conn->ws_keepalive = false;
+	ka->num_conns--;
+
+	httplib_pthread_mutex_unlock( & ka->mutex );
+
+}  /* XX_httplib_websocket_keepalive_remove */
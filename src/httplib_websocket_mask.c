@@ -0,0 +1,149 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+#if defined(__GNUC__)  &&  ( defined(__x86_64__)  ||  defined(__i386__) )
+#include <immintrin.h>
+#if !defined(WEBSOCKET_MASK_AVX2)
+#define WEBSOCKET_MASK_AVX2
+#endif  /* WEBSOCKET_MASK_AVX2 */
+#endif  /* __GNUC__  &&  ( __x86_64__  ||  __i386__ ) */
+
+#if defined(WEBSOCKET_MASK_AVX2)
+static size_t	mask_avx2( unsigned char *out, const unsigned char *in, size_t len, uint32_t key );
+#endif  /* WEBSOCKET_MASK_AVX2 */
+
+/*
+ * void XX_httplib_websocket_mask( char *out, const char *in, size_t len, const unsigned char key[4], size_t phase );
+ *
+ * The function XX_httplib_websocket_mask() applies the masking key of a
+ * websocket frame to len bytes of payload. Because the masking is an XOR
+ * operation, the same function is used for masking and unmasking. Payload
+ * byte i is combined with key[(phase+i) % 4], so that a payload can also be
+ * processed in several parts. The output may be the same buffer as the input.
+ *
+ * For payloads of at least 64 bytes, the bytes up to the first 32 byte
+ * boundary of the output are processed one by one. The key is then rotated to
+ * that position and the bulk of the data is processed with AVX2 instructions
+ * if the processor supports them, with SSE2 instructions if they are
+ * available at compile time, and otherwise in 64 bit words. The last bytes
+ * are again processed one by one.
+ */
+
+void XX_httplib_websocket_mask( char *out, const char *in, size_t len, const unsigned char key[4], size_t phase ) {
+
+	unsigned char *dst;
+	const unsigned char *src;
+	unsigned char rot[4];
+	uint32_t key32;
+	uint64_t key64;
+	uint64_t word;
+	size_t head;
+	size_t i;
+#if defined(__SSE2__)
+	__m128i vkey;
+#endif  /* __SSE2__ */
+
+	if ( out == NULL  ||  in == NULL  ||  key == NULL ) return;
+
+	dst = (unsigned char *)out;
+	src = (const unsigned char *)in;
+	i   = 0;
+
+	/*
+	 * Head: bytes up to the alignment boundary of the output
+	 */
+
+	head = ( len >= 64 ) ? (size_t)(-(uintptr_t)dst & 31) : 0;
+
+	for (; i<head; i++) dst[i] = src[i] ^ key[(phase+i) & 3];
+
+	if ( len - i >= 8 ) {
+
+		rot[0] = key[(phase+i  ) & 3];
+		rot[1] = key[(phase+i+1) & 3];
+		rot[2] = key[(phase+i+2) & 3];
+		rot[3] = key[(phase+i+3) & 3];
+
+		memcpy( & key32, rot, 4 );
+		key64 = ((uint64_t)key32 << 32) | key32;
+
+#if defined(WEBSOCKET_MASK_AVX2)
+		if ( len - i >= 64  &&  __builtin_cpu_supports( "avx2" ) ) i += mask_avx2( dst + i, src + i, len - i, key32 );
+#endif  /* WEBSOCKET_MASK_AVX2 */
+
+#if defined(__SSE2__)
+		vkey = _mm_set1_epi32( (int)key32 );
+
+		for (; i+16<=len; i+=16) _mm_storeu_si128( (__m128i *)(void *)(dst+i), _mm_xor_si128( _mm_loadu_si128( (const __m128i *)(const void *)(src+i) ), vkey ) );
+#endif  /* __SSE2__ */
+
+		for (; i+8<=len; i+=8) {
+
+			memcpy( & word, src+i, 8 );
+			word ^= key64;
+			memcpy( dst+i, & word, 8 );
+		}
+	}
+
+	/*
+	 * Tail: the remaining bytes
+	 */
+
+	for (; i<len; i++) dst[i] = src[i] ^ key[(phase+i) & 3];
+
+}  /* XX_httplib_websocket_mask */
+
+
+
+#if defined(WEBSOCKET_MASK_AVX2)
+
+/*
+ * static size_t mask_avx2( unsigned char *out, const unsigned char *in, size_t len, uint32_t key );
+ *
+ * The function mask_avx2() masks the data in blocks of 32 bytes with AVX2
+ * instructions. The output must be aligned on a 32 byte boundary and the key
+ * must already be rotated to the position of the first byte. The function is
+ * compiled for AVX2 independent of the compiler flags and must only be called
+ * if the processor supports AVX2. The number of bytes processed is returned.
+ */
+
+__attribute__((target("avx2")))
+static size_t mask_avx2( unsigned char *out, const unsigned char *in, size_t len, uint32_t key ) {
+
+	__m256i vkey;
+	size_t i;
+
+	vkey = _mm256_set1_epi32( (int)key );
+
+	for (i=0; i+32<=len; i+=32) _mm256_store_si256( (__m256i *)(void *)(out+i), _mm256_xor_si256( _mm256_loadu_si256( (const __m256i *)(const void *)(in+i) ), vkey ) );
+
+	return i;
+
+}  /* mask_avx2 */
+
+#endif  /* WEBSOCKET_MASK_AVX2 */
@@ -0,0 +1,78 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * size_t XX_httplib_websocket_parse_header( const unsigned char *hdr, size_t len, uint64_t *data_len );
+ *
+ * The function XX_httplib_websocket_parse_header() parses the header of a
+ * received websocket frame from the first len bytes in a buffer. The length
+ * of the header including the masking key is returned and the length of the
+ * payload is stored in data_len. Zero is returned if the header is not
+ * complete yet.
+ *
+ * Frame format: http://tools.ietf.org/html/rfc6455#section-5.2
+ */
+
+size_t XX_httplib_websocket_parse_header( const unsigned char *hdr, size_t len, uint64_t *data_len ) {
+
+	size_t header_len;
+	size_t mask_len;
+	size_t len7;
+
+	if ( len < 2 ) return 0;
+
+	len7     =  hdr[1] & 127;
+	mask_len = (hdr[1] & 128) ? 4 : 0;
+
+	if ( len7 < 126 ) {
+
+		header_len = 2 + mask_len;
+		*data_len  = len7;
+	}
+
+	else if ( len7 == 126 ) {
+
+		header_len = 4 + mask_len;
+		if ( len < header_len ) return 0;
+
+		*data_len  = (((uint64_t)hdr[2]) << 8) + hdr[3];
+	}
+
+	else {
+		header_len = 10 + mask_len;
+		if ( len < header_len ) return 0;
+
+		*data_len  = (((uint64_t)hdr[2]) << 56) + (((uint64_t)hdr[3]) << 48) + (((uint64_t)hdr[4]) << 40) + (((uint64_t)hdr[5]) << 32) +
+			     (((uint64_t)hdr[6]) << 24) + (((uint64_t)hdr[7]) << 16) + (((uint64_t)hdr[8]) <<  8) +  ((uint64_t)hdr[9]);
+	}
+
+	if ( len < header_len ) return 0;
+
+	return header_len;
+
+}  /* XX_httplib_websocket_parse_header */
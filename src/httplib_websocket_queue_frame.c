@@ -0,0 +1,115 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+
+#include "httplib_main.h"
+
+/*
+ * int XX_httplib_websocket_queue_frame( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsf_t *frame );
+ *
+ * The function XX_httplib_websocket_queue_frame() sends a frame on a
+ * websocket connection without blocking. When the send queue is empty, as
+ * much of the frame is sent immediately as the socket accepts. The rest, or
+ * the whole frame if older frames are still waiting, is added to the send
+ * queue with a new reference to the frame. For connections of the reactor the
+ * reactor is told to send the queue when the socket becomes writable, other
+ * connections send it before their next frame. The caller must hold the lock
+ * of the connection and must have checked the limit of the queue.
+ *
+ * The function returns 0 if the frame was sent or queued, and -1 if an error
+ * occured, in which case the connection is shut down.
+ */
+
+int XX_httplib_websocket_queue_frame( const struct lh_ctx_t *ctx, struct lh_con_t *conn, struct lh_wsf_t *frame ) {
+
+	struct lh_wsq_t *entry;
+	struct lh_wsx_t *wsx;
+	int64_t n;
+	bool ok;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  frame == NULL ) return -1;
+
+	n = 0;
+
+	if ( conn->ws_queue == NULL ) {
+
+		n = XX_httplib_send_nonblocking( conn->client.sock, (const char *)(frame + 1), (int64_t)frame->len );
+
+		if ( n < 0 ) {
+
+			conn->must_close = true;
+			shutdown( conn->client.sock, SHUTDOWN_BOTH );
+
+			return -1;
+		}
+
+		if ( (size_t)n == frame->len ) return 0;
+	}
+
+	entry = httplib_malloc( sizeof(struct lh_wsq_t) );
+
+	if ( entry == NULL ) {
+
+		conn->must_close = true;
+		shutdown( conn->client.sock, SHUTDOWN_BOTH );
+
+		return -1;
+	}
+
+	httplib_atomic_inc( & frame->refcount );
+
+	entry->next  = NULL;
+	entry->frame = frame;
+
+	if ( conn->ws_queue_last != NULL ) conn->ws_queue_last->next = entry;
+	else {
+		conn->ws_queue     = entry;
+		conn->ws_queue_off = (size_t)n;
+	}
+
+	conn->ws_queue_last  = entry;
+	conn->ws_queued     += frame->len - (size_t)n;
+
+	if ( ctx->websocket_send_queue_high > 0  &&  conn->ws_queued >= (size_t)ctx->websocket_send_queue_high ) conn->ws_queue_full = true;
+
+	wsx = conn->ws_reactor;
+	if ( wsx == NULL  ||  conn->ws_queue != entry ) return 0;
+
+	httplib_pthread_mutex_lock( & wsx->ctx->thread_mutex );
+
+	wsx->writing = true;
+	ok           = XX_httplib_websocket_reactor_watch( wsx->ctx, wsx );
+
+	httplib_pthread_mutex_unlock( & wsx->ctx->thread_mutex );
+
+	if ( ok ) return 0;
+
+	conn->must_close = true;
+	shutdown( conn->client.sock, SHUTDOWN_BOTH );
+
+	return -1;
+
+}  /* XX_httplib_websocket_queue_frame */
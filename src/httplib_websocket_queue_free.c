@@ -0,0 +1,58 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_queue_free( struct lh_con_t *conn );
+ *
+ * The function XX_httplib_websocket_queue_free() discards all frames in the
+ * send queue of a websocket connection and releases the references to them.
+ * The caller must hold the lock of the connection, or be the only thread
+ * which still uses it.
+ */
+
+void XX_httplib_websocket_queue_free( struct lh_con_t *conn ) {
+
+	struct lh_wsq_t *entry;
+
+	if ( conn == NULL ) return;
+
+	while ( conn->ws_queue != NULL ) {
+
+		entry          = conn->ws_queue;
+		conn->ws_queue = entry->next;
+
+		XX_httplib_websocket_frame_release( entry->frame );
+		httplib_free( entry );
+	}
+
+	conn->ws_queue_last = NULL;
+	conn->ws_queue_off  = 0;
+	conn->ws_queued     = 0;
+
+}  /* XX_httplib_websocket_queue_free */
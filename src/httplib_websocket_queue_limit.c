@@ -0,0 +1,65 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+
+#include "httplib_main.h"
+
+/*
+ * int XX_httplib_websocket_queue_limit( const struct lh_ctx_t *ctx, struct lh_con_t *conn );
+ *
+ * The function XX_httplib_websocket_queue_limit() checks if a new frame may
+ * be added to the send queue of a websocket connection of the reactor. When
+ * the queue holds websocket_send_queue_high bytes or more, the new frame is
+ * either dropped, or the connection is shut down so that the reactor closes
+ * it, depending on the websocket_send_queue_drop option. A frame is always
+ * accepted when the queue is empty, so that messages which are larger than
+ * the high watermark can still be sent. The caller must hold the lock of the
+ * connection.
+ *
+ * The function returns 0 if the frame may be queued, 1 if it must be dropped
+ * and -1 if the connection is being closed.
+ */
+
+int XX_httplib_websocket_queue_limit( const struct lh_ctx_t *ctx, struct lh_con_t *conn ) {
+
+	if ( ctx == NULL  ||  conn == NULL ) return -1;
+	if ( conn->must_close                ) return -1;
+
+	if ( conn->ws_reactor == NULL  ||  conn->ws_queue == NULL  ||  ctx->websocket_send_queue_high <= 0 ) return 0;
+	if ( conn->ws_queued < (size_t)ctx->websocket_send_queue_high                                        ) return 0;
+
+	conn->ws_queue_full = true;
+
+	if ( ctx->websocket_send_queue_drop ) return 1;
+
+	httplib_cry( LH_DEBUG_WARNING, conn->ws_reactor->ctx, conn, "%s: websocket send queue full; closing connection", __func__ );
+
+	conn->must_close = true;
+	shutdown( conn->client.sock, SHUTDOWN_BOTH );
+
+	return -1;
+
+}  /* XX_httplib_websocket_queue_limit */
@@ -0,0 +1,227 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+#if defined(USE_WEBSOCKET_REACTOR)
+static void	relocate( const char **ptr, const char *old_buf, char *new_buf, size_t len );
+#endif  /* USE_WEBSOCKET_REACTOR */
+
+/*
+ * bool XX_httplib_websocket_reactor_add( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_websocket_ready_handler ready_handler, httplib_websocket_data_handler data_handler, httplib_websocket_close_handler close_handler, void *cbdata );
+ *
+ * The function XX_httplib_websocket_reactor_add() hands a websocket
+ * connection for which the handshake has been sent over to the reactor. The
+ * connection structure of the worker thread is reused for the next
+ * connection, so the reactor gets its own compact copy with only the request
+ * headers. The socket and the websocket state move to the copy and the
+ * connection of the worker thread is marked as closed without closing the
+ * socket. The ready handler is called with the new connection, because that
+ * is the connection which is passed to the other handlers later.
+ *
+ * Connections with TLS stay with the worker thread, because a readable
+ * socket doesn't tell if a complete TLS record is available. The function
+ * returns false if the connection was not handed over, and the caller must
+ * then serve the connection itself.
+ */
+
+bool XX_httplib_websocket_reactor_add( struct lh_ctx_t *ctx, struct lh_con_t *conn, httplib_websocket_ready_handler ready_handler, httplib_websocket_data_handler data_handler, httplib_websocket_close_handler close_handler, void *cbdata ) {
+
+#if defined(USE_WEBSOCKET_REACTOR)
+
+	struct lh_con_t *wc;
+	struct lh_wsx_t *wsx;
+	size_t request_len;
+	size_t extra;
+	int a;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  ! ctx->enable_websocket_reactor  ||  conn->ssl != NULL  ||  conn->request_len <= 0 ) return false;
+
+	request_len = (size_t)conn->request_len;
+	extra       = ( conn->data_len > conn->request_len ) ? (size_t)(conn->data_len - conn->request_len) : 0;
+
+	wc = httplib_calloc( 1, sizeof(struct lh_con_t) + sizeof(struct lh_wsx_t) + request_len + 1 );
+	if ( wc == NULL ) return false;
+
+	wsx = (struct lh_wsx_t *)(wc + 1);
+
+	if ( extra > 0 ) {
+
+		wsx->in = httplib_malloc( extra );
+
+		if ( wsx->in == NULL ) {
+
+			httplib_free( wc );
+			return false;
+		}
+
+		memcpy( wsx->in, conn->buf + conn->request_len, extra );
+		wsx->in_len  = extra;
+		wsx->in_size = extra;
+	}
+
+	/*
+	 * The request headers are copied to the new connection and all
+	 * pointers into the old buffer are moved to the copy.
+	 */
+
+	*wc              = *conn;
+	wc->buf          = (char *)(wsx + 1);
+	wc->buf_size     = (int)request_len;
+	wc->buf_offset   = 0;
+	wc->data_len     = (int)request_len;
+	wc->out_buf      = NULL;
+	wc->out_len      = 0;
+	wc->out_hold     = false;
+	wc->compress     = NULL;
+	wc->chunk_out    = NULL;
+	wc->ws_reactor   = wsx;
+	wc->ws_keepalive = false;
+	wc->thread_index = -1;
+
+	memcpy( wc->buf, conn->buf, request_len );
+
+	relocate( & wc->request_info.request_method, conn->buf, wc->buf, request_len );
+	relocate( & wc->request_info.request_uri,    conn->buf, wc->buf, request_len );
+	relocate( & wc->request_info.local_uri,      conn->buf, wc->buf, request_len );
+	relocate( & wc->request_info.uri,            conn->buf, wc->buf, request_len );
+	relocate( & wc->request_info.http_version,   conn->buf, wc->buf, request_len );
+	relocate( & wc->request_info.query_string,   conn->buf, wc->buf, request_len );
+
+	for (a=0; a<wc->request_info.num_headers; a++) {
+
+		relocate( & wc->request_info.http_headers[a].name,  conn->buf, wc->buf, request_len );
+		relocate( & wc->request_info.http_headers[a].value, conn->buf, wc->buf, request_len );
+	}
+
+	if ( wc->path_info != NULL  &&  wc->path_info >= conn->buf  &&  wc->path_info < conn->buf + request_len ) wc->path_info = wc->buf + (wc->path_info - conn->buf);
+
+	httplib_pthread_mutex_init( & wc->mutex, & XX_httplib_pthread_mutex_attr );
+
+	/*
+	 * The worker thread must neither close the socket nor free the state
+	 * which now belongs to the new connection.
+	 */
+
+	conn->request_info.remote_user = NULL;
+	conn->ws_deflate               = NULL;
+	conn->ws_queue                 = NULL;
+	conn->ws_queue_last            = NULL;
+	conn->ws_queue_off             = 0;
+	conn->ws_queued                = 0;
+	conn->client.sock              = INVALID_SOCKET;
+	conn->data_len                 = conn->request_len;
+	conn->must_close               = true;
+
+	wsx->ctx           = ctx;
+	wsx->conn          = wc;
+	wsx->data_handler  = data_handler;
+	wsx->close_handler = close_handler;
+	wsx->cbdata        = cbdata;
+	wsx->last_read     = time( NULL );
+	wsx->paused        = true;
+	wsx->starting      = true;
+
+	if ( ready_handler != NULL ) ready_handler( ctx, wc, cbdata );
+
+	httplib_pthread_mutex_lock( & ctx->thread_mutex );
+
+	wsx->next = ctx->ws_reactor_conns;
+	if ( wsx->next != NULL ) wsx->next->prev = wsx;
+	ctx->ws_reactor_conns = wsx;
+
+	httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+	XX_httplib_websocket_keepalive_add( ctx, wc );
+
+	/*
+	 * Frames which were received together with the upgrade request are
+	 * processed before the reactor starts to watch the socket.
+	 */
+
+	if ( wsx->in_len > 0  &&  ! XX_httplib_websocket_reactor_parse( ctx, wsx, wsx->in, wsx->in_len ) ) {
+
+		XX_httplib_websocket_reactor_close( ctx, wsx );
+		return true;
+	}
+
+	/*
+	 * Reading is paused until the socket is added to the event queue. If
+	 * the frames above were more than the reactor queues for a connection,
+	 * the worker thread which handles them resumes reading later.
+	 */
+
+	httplib_pthread_mutex_lock( & ctx->thread_mutex );
+
+	wsx->starting = false;
+	if ( wsx->queued <= WEBSOCKET_REACTOR_QUEUE_MAX / 2 ) wsx->paused = false;
+
+	if ( ! XX_httplib_websocket_reactor_watch( ctx, wsx ) ) {
+
+		httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+		XX_httplib_websocket_reactor_close( ctx, wsx );
+
+		return true;
+	}
+
+	httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+	return true;
+
+#else  /* USE_WEBSOCKET_REACTOR */
+
+	UNUSED_PARAMETER(ctx);
+	UNUSED_PARAMETER(conn);
+	UNUSED_PARAMETER(ready_handler);
+	UNUSED_PARAMETER(data_handler);
+	UNUSED_PARAMETER(close_handler);
+	UNUSED_PARAMETER(cbdata);
+
+	return false;
+
+#endif  /* USE_WEBSOCKET_REACTOR */
+
+}  /* XX_httplib_websocket_reactor_add */
+
+
+
+#if defined(USE_WEBSOCKET_REACTOR)
+
+/*
+ * static void relocate( const char **ptr, const char *old_buf, char *new_buf, size_t len );
+ *
+ * The function relocate() moves a pointer into the first len bytes of the old
+ * buffer to the same position in the new buffer. Other pointers are not
+ * changed.
+ */
+
+static void relocate( const char **ptr, const char *old_buf, char *new_buf, size_t len ) {
+
+	if ( *ptr != NULL  &&  *ptr >= old_buf  &&  *ptr < old_buf + len ) *ptr = new_buf + (*ptr - old_buf);
+
+}  /* relocate */
+
+#endif  /* USE_WEBSOCKET_REACTOR */
@@ -0,0 +1,54 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_reactor_close( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+ *
+ * The function XX_httplib_websocket_reactor_close() stops the reactor from
+ * reading from and writing to a websocket connection. A worker thread passes the messages
+ * which are still queued to the data handler, then calls the close handler
+ * and frees the connection. The reactor must not use the connection anymore
+ * after calling this function.
+ */
+
+void XX_httplib_websocket_reactor_close( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx ) {
+
+	httplib_pthread_mutex_lock( & ctx->thread_mutex );
+
+	wsx->paused  = true;
+	wsx->writing = false;
+
+	XX_httplib_websocket_reactor_watch( ctx, wsx );
+
+	wsx->closed = true;
+
+	XX_httplib_websocket_reactor_schedule( ctx, wsx );
+
+	httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+}  /* XX_httplib_websocket_reactor_close */
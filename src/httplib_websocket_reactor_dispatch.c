@@ -0,0 +1,107 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+#define DISPATCH_BATCH		(64)
+
+/*
+ * void XX_httplib_websocket_reactor_dispatch( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+ *
+ * The function XX_httplib_websocket_reactor_dispatch() is called by a worker
+ * thread which took a websocket connection of the reactor from the ready
+ * list. The queued messages are passed to the data handler one by one in the
+ * order in which they were received. The drain callback is called at the
+ * position in the queue where the reactor noticed that the send queue of the
+ * connection had drained. When the data handler returns zero, the
+ * socket is shut down so that the reactor closes the connection, and the
+ * remaining messages are discarded. After a batch of messages the connection
+ * goes back to the end of the ready list, so that a busy connection doesn't
+ * keep the worker thread from other connections. The reactor resumes reading
+ * from a paused connection when enough of its messages have been handled,
+ * and a connection which has been closed by the reactor is freed when all
+ * its messages have been handled.
+ */
+
+void XX_httplib_websocket_reactor_dispatch( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx ) {
+
+	struct lh_con_t *conn;
+	struct lh_wsm_t *msg;
+	int num;
+
+	conn = wsx->conn;
+	num  = 0;
+
+	httplib_pthread_mutex_lock( & ctx->thread_mutex );
+
+	while ( wsx->first != NULL  &&  num < DISPATCH_BATCH ) {
+
+		msg        = wsx->first;
+		wsx->first = msg->next;
+
+		if ( wsx->first == NULL ) wsx->last = NULL;
+
+		wsx->queued -= msg->len;
+
+		if ( wsx->paused  &&  ! wsx->starting  &&  ! wsx->closed  &&  wsx->queued <= WEBSOCKET_REACTOR_QUEUE_MAX / 2 ) {
+
+			wsx->paused = false;
+			if ( ! XX_httplib_websocket_reactor_watch( ctx, wsx ) ) wsx->paused = true;
+		}
+
+		httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+		if ( msg->opcode == WEBSOCKET_REACTOR_DRAIN ) {
+
+			if ( ! conn->must_close  &&  ctx->callbacks.websocket_drain != NULL ) ctx->callbacks.websocket_drain( ctx, conn );
+		}
+
+		else if ( ! conn->must_close  &&  wsx->data_handler != NULL  &&  ! wsx->data_handler( ctx, conn, msg->opcode, (char *)(msg + 1), msg->len, wsx->cbdata ) ) {
+
+			conn->must_close = true;
+			shutdown( conn->client.sock, SHUTDOWN_BOTH );
+		}
+
+		httplib_free( msg );
+		num++;
+
+		httplib_pthread_mutex_lock( & ctx->thread_mutex );
+	}
+
+	if ( wsx->first == NULL  &&  wsx->closed ) {
+
+		httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+		XX_httplib_websocket_reactor_free( ctx, wsx );
+
+		return;
+	}
+
+	wsx->scheduled = false;
+	if ( wsx->first != NULL ) XX_httplib_websocket_reactor_schedule( ctx, wsx );
+
+	httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+}  /* XX_httplib_websocket_reactor_dispatch */
@@ -0,0 +1,94 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_reactor_free( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+ *
+ * The function XX_httplib_websocket_reactor_free() calls the close handler of
+ * a websocket connection of the reactor, closes the connection and frees it
+ * with all its buffers and messages which are still queued. The reactor must
+ * not be watching the socket anymore.
+ */
+
+void XX_httplib_websocket_reactor_free( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx ) {
+
+	struct lh_con_t *conn;
+	struct lh_wsm_t *msg;
+	union {
+		const void *	con;
+		void *		var;
+	} ptr;
+
+	conn = wsx->conn;
+
+	if ( wsx->close_handler != NULL ) wsx->close_handler( ctx, conn, wsx->cbdata );
+
+	/*
+	 * Frames which are still queued, like a close frame which was sent
+	 * after a protocol error, are sent as far as the socket accepts them.
+	 */
+
+	httplib_lock_connection( conn );
+	XX_httplib_websocket_send_pending( ctx, conn, false );
+	httplib_unlock_connection( conn );
+
+	XX_httplib_websocket_keepalive_remove( ctx, conn );
+	XX_httplib_close_connection( ctx, conn );
+
+	httplib_pthread_mutex_lock( & ctx->thread_mutex );
+
+	if ( wsx->prev != NULL ) wsx->prev->next      = wsx->next;
+	else                     ctx->ws_reactor_conns = wsx->next;
+
+	if ( wsx->next != NULL ) wsx->next->prev = wsx->prev;
+
+	httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+	while ( wsx->first != NULL ) {
+
+		msg        = wsx->first;
+		wsx->first = msg->next;
+
+		httplib_free( msg );
+	}
+
+	if ( wsx->in  != NULL ) wsx->in  = httplib_free( wsx->in  );
+	if ( wsx->msg != NULL ) wsx->msg = httplib_free( wsx->msg );
+
+	if ( conn->request_info.remote_user != NULL ) {
+
+		ptr.con = conn->request_info.remote_user;
+		httplib_free( ptr.var );
+
+		conn->request_info.remote_user = NULL;
+	}
+
+	httplib_pthread_mutex_destroy( & conn->mutex );
+	httplib_free( conn );
+
+}  /* XX_httplib_websocket_reactor_free */
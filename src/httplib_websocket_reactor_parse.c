@@ -0,0 +1,248 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+static bool	msg_reserve( struct lh_wsx_t *wsx, size_t size );
+
+/*
+ * bool XX_httplib_websocket_reactor_parse( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx, char *buf, size_t len );
+ *
+ * The function XX_httplib_websocket_reactor_parse() processes the data which
+ * the reactor received on a websocket connection. All complete frames in the
+ * buffer are unmasked in place. Fragments are collected until the message is
+ * complete, compressed messages are decompressed, and every complete message
+ * is queued for the data handler. The bytes of an incomplete frame at the end
+ * are kept in the input buffer of the connection, which may also be the
+ * buffer that is passed to the function, and the length of that frame is
+ * remembered when its header is complete.
+ *
+ * The function returns false if the connection must be closed, because of a
+ * protocol error or because a close frame was received.
+ */
+
+bool XX_httplib_websocket_reactor_parse( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx, char *buf, size_t len ) {
+
+	struct lh_con_t *conn;
+	unsigned char mask[4];
+	unsigned char mop;
+	unsigned char opcode;
+	char *data;
+	char *in;
+	uint64_t data_len64;
+	size_t data_len;
+	size_t header_len;
+	size_t pos;
+	size_t left;
+	bool fin;
+	bool ok;
+	int n;
+
+	conn      = wsx->conn;
+	pos       = 0;
+	ok        = true;
+	wsx->need = 0;
+
+	while ( pos < len ) {
+
+		header_len = XX_httplib_websocket_parse_header( (const unsigned char *)buf + pos, len - pos, & data_len64 );
+		if ( header_len == 0 ) break;
+
+		mop    = (unsigned char)buf[pos];
+		opcode = mop & 0x0F;
+		fin    = ( (mop & 0x80) != 0 );
+		n      = XX_httplib_websocket_check_frame( ctx, conn, mop, data_len64, wsx->fragmented, ( wsx->fragmented ) ? wsx->msg_len : 0 );
+
+		if ( n != 0 ) {
+
+			XX_httplib_websocket_send_close( ctx, conn, (uint16_t)n );
+			ok = false;
+			break;
+		}
+
+		data_len = (size_t)data_len64;
+
+		if ( len - pos - header_len < data_len ) {
+
+			wsx->need = header_len + data_len;
+			break;
+		}
+
+		data = buf + pos + header_len;
+
+		if ( buf[pos+1] & 0x80 ) {
+
+			memcpy( mask, data - 4, 4 );
+			XX_httplib_websocket_mask( data, data, data_len, mask, 0 );
+		}
+
+		pos += header_len + data_len;
+
+		if ( ! (opcode & 0x08)  &&  ( ! fin  ||  wsx->fragmented ) ) {
+
+			if ( ! msg_reserve( wsx, wsx->msg_len + data_len ) ) {
+
+				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket out of memory; closing connection", __func__ );
+				ok = false;
+				break;
+			}
+
+			if ( data_len > 0 ) memcpy( wsx->msg + wsx->msg_len, data, data_len );
+			wsx->msg_len += data_len;
+
+			if ( ! fin ) {
+
+				if ( ! wsx->fragmented ) {
+
+					wsx->fragmented = true;
+					wsx->msg_op     = mop & 0x7F;
+				}
+
+				continue;
+			}
+
+			mop             = 0x80 | wsx->msg_op;
+			data            = wsx->msg;
+			data_len        = wsx->msg_len;
+			wsx->msg_len    = 0;
+			wsx->fragmented = false;
+		}
+
+		if ( mop & WEBSOCKET_RSV1 ) {
+
+			n = XX_httplib_websocket_inflate( conn, data, data_len, (size_t)ctx->websocket_max_message_size, & data, & data_len );
+
+			if ( n != 0 ) {
+
+				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket error: %s, closing connection", __func__, ( n == -2 ) ? "decompressed message too large" : ( n == -1 ) ? "invalid compressed data" : "out of memory" );
+				XX_httplib_websocket_send_close( ctx, conn, ( n == -2 ) ? 1009 : ( n == -1 ) ? 1007 : 1011 );
+				ok = false;
+				break;
+			}
+
+			mop &= (unsigned char)~WEBSOCKET_RSV1;
+		}
+
+		if ( ! XX_httplib_websocket_reactor_queue( ctx, wsx, mop, data, data_len ) ) {
+
+			httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket out of memory; closing connection", __func__ );
+			ok = false;
+			break;
+		}
+
+		/*
+		 * The reassembly buffer is not kept for idle connections
+		 */
+
+		if ( wsx->msg != NULL  &&  ! wsx->fragmented ) {
+
+			wsx->msg      = httplib_free( wsx->msg );
+			wsx->msg_size = 0;
+		}
+
+		if ( opcode == WEBSOCKET_OPCODE_CONNECTION_CLOSE ) {
+
+			ok = false;
+			break;
+		}
+	}
+
+	/*
+	 * The rest of the data is kept for the next call
+	 */
+
+	left = len - pos;
+
+	if ( buf == wsx->in ) {
+
+		if ( left > 0  &&  pos > 0 ) memmove( wsx->in, wsx->in + pos, left );
+	}
+
+	else if ( left > 0 ) {
+
+		if ( left > wsx->in_size ) {
+
+			in = httplib_realloc( wsx->in, left );
+
+			if ( in == NULL ) {
+
+				httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket out of memory; closing connection", __func__ );
+				left = 0;
+				ok   = false;
+			}
+
+			else {
+				wsx->in      = in;
+				wsx->in_size = left;
+			}
+		}
+
+		if ( left > 0 ) memcpy( wsx->in, buf + pos, left );
+	}
+
+	wsx->in_len = left;
+
+	if ( wsx->in_len == 0  &&  wsx->in != NULL ) {
+
+		wsx->in      = httplib_free( wsx->in );
+		wsx->in_size = 0;
+	}
+
+	return ok;
+
+}  /* XX_httplib_websocket_reactor_parse */
+
+
+
+/*
+ * static bool msg_reserve( struct lh_wsx_t *wsx, size_t size );
+ *
+ * The function msg_reserve() makes sure that the reassembly buffer for
+ * fragmented messages has room for at least size bytes. The buffer grows at
+ * least by doubling its size and the contents is preserved. The function
+ * returns false if no memory could be allocated.
+ */
+
+static bool msg_reserve( struct lh_wsx_t *wsx, size_t size ) {
+
+	size_t new_size;
+	char *msg;
+
+	if ( wsx->msg != NULL  &&  size <= wsx->msg_size ) return true;
+
+	new_size = ( wsx->msg_size > 0 ) ? 2 * wsx->msg_size : 4096;
+	if ( new_size < size ) new_size = size;
+
+	msg = httplib_realloc( wsx->msg, new_size );
+	if ( msg == NULL ) return false;
+
+	wsx->msg      = msg;
+	wsx->msg_size = new_size;
+
+	return true;
+
+}  /* msg_reserve */
+
@@ -0,0 +1,79 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_websocket_reactor_queue( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx, int opcode, const char *data, size_t len );
+ *
+ * The function XX_httplib_websocket_reactor_queue() adds a copy of a complete
+ * message to the queue of a websocket connection and schedules the
+ * connection for a worker thread. The reactor stops reading from the socket
+ * when too much data is queued. A message with the opcode
+ * WEBSOCKET_REACTOR_DRAIN doesn't come from the peer, but tells the worker
+ * thread to call the drain callback. The function returns false if no memory
+ * could be allocated.
+ */
+
+bool XX_httplib_websocket_reactor_queue( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx, int opcode, const char *data, size_t len ) {
+
+	struct lh_wsm_t *msg;
+	char *payload;
+
+	msg = httplib_malloc( sizeof(struct lh_wsm_t) + len + 1 );
+	if ( msg == NULL ) return false;
+
+	payload = (char *)(msg + 1);
+
+	if ( len > 0 ) memcpy( payload, data, len );
+	payload[len] = '\0';
+
+	msg->next   = NULL;
+	msg->len    = len;
+	msg->opcode = opcode;
+
+	httplib_pthread_mutex_lock( & ctx->thread_mutex );
+
+	if ( wsx->last != NULL ) wsx->last->next = msg;
+	else                     wsx->first      = msg;
+
+	wsx->last    = msg;
+	wsx->queued += len;
+
+	if ( wsx->queued > WEBSOCKET_REACTOR_QUEUE_MAX  &&  ! wsx->paused ) {
+
+		wsx->paused = true;
+		XX_httplib_websocket_reactor_watch( ctx, wsx );
+	}
+
+	XX_httplib_websocket_reactor_schedule( ctx, wsx );
+
+	httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+	return true;
+
+}  /* XX_httplib_websocket_reactor_queue */
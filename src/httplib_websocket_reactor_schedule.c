@@ -0,0 +1,56 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+#include "httplib_pthread.h"
+
+/*
+ * void XX_httplib_websocket_reactor_schedule( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+ *
+ * The function XX_httplib_websocket_reactor_schedule() puts a websocket
+ * connection of the reactor at the end of the ready list and wakes up a
+ * worker thread, unless the connection is already waiting for or being
+ * handled by a worker thread. The caller must hold the thread mutex of the
+ * context.
+ */
+
+void XX_httplib_websocket_reactor_schedule( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx ) {
+
+	if ( wsx->scheduled ) return;
+
+	wsx->scheduled  = true;
+	wsx->ready_next = NULL;
+
+	if ( ctx->ws_ready_last != NULL ) ctx->ws_ready_last->ready_next = wsx;
+	else                              ctx->ws_ready_first            = wsx;
+
+	ctx->ws_ready_last = wsx;
+
+#if !defined(ALTERNATIVE_QUEUE)
+	httplib_pthread_cond_signal( & ctx->sq_full );
+#endif  /* ALTERNATIVE_QUEUE */
+
+}  /* XX_httplib_websocket_reactor_schedule */
@@ -0,0 +1,47 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_reactor_stop( struct lh_ctx_t *ctx );
+ *
+ * The function XX_httplib_websocket_reactor_stop() closes and frees all
+ * websocket connections of the reactor when the server stops. It is called
+ * by the master thread after the reactor and worker threads have ended.
+ * Messages which have not been passed to the data handler yet are discarded.
+ */
+
+void XX_httplib_websocket_reactor_stop( struct lh_ctx_t *ctx ) {
+
+	if ( ctx == NULL ) return;
+
+	ctx->ws_ready_first = NULL;
+	ctx->ws_ready_last  = NULL;
+
+	while ( ctx->ws_reactor_conns != NULL ) XX_httplib_websocket_reactor_free( ctx, ctx->ws_reactor_conns );
+
+}  /* XX_httplib_websocket_reactor_stop */
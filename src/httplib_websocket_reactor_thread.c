@@ -0,0 +1,287 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+#if defined(USE_WEBSOCKET_REACTOR)
+
+#define READ_LOOPS		(16)
+
+static void	expire_connections( struct lh_ctx_t *ctx, time_t now );
+static void	read_connection( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+static void	reactor_run( struct lh_ctx_t *ctx );
+static bool	write_connection( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+
+#endif  /* USE_WEBSOCKET_REACTOR */
+
+/*
+ * LIBHTTP_THREAD XX_httplib_websocket_reactor_thread( void *data );
+ *
+ * The function XX_httplib_websocket_reactor_thread() is the wrapper function
+ * around the websocket reactor thread. Calling convention of the function
+ * differs depending on the operating system.
+ */
+
+LIBHTTP_THREAD XX_httplib_websocket_reactor_thread( void *data ) {
+
+#if defined(USE_WEBSOCKET_REACTOR)
+	if ( data != NULL ) reactor_run( data );
+#else  /* USE_WEBSOCKET_REACTOR */
+	UNUSED_PARAMETER(data);
+#endif  /* USE_WEBSOCKET_REACTOR */
+
+	return LIBHTTP_THREAD_RETNULL;
+
+}  /* XX_httplib_websocket_reactor_thread */
+
+
+
+#if defined(USE_WEBSOCKET_REACTOR)
+
+/*
+ * static void reactor_run( struct lh_ctx_t *ctx );
+ *
+ * The function reactor_run() waits for websocket connections of the reactor
+ * to become readable or writable and reads from them or sends their queued
+ * frames until the server stops. Once per
+ * second connections which haven't received any data for longer than the
+ * websocket timeout are closed.
+ */
+
+static void reactor_run( struct lh_ctx_t *ctx ) {
+
+	struct epoll_event events[WEBSOCKET_REACTOR_EVENTS];
+	struct lh_wsx_t *wsx;
+	time_t last_check;
+	time_t now;
+	int n;
+	int a;
+
+	XX_httplib_set_thread_name( ctx, "wsreactor" );
+
+	last_check = time( NULL );
+
+	while ( ctx->status == CTX_STATUS_RUNNING ) {
+
+		n = epoll_wait( ctx->ws_epoll_fd, events, WEBSOCKET_REACTOR_EVENTS, 200 );
+
+		for (a=0; a<n; a++) {
+
+			wsx = events[a].data.ptr;
+
+			if ( (events[a].events & (EPOLLOUT|EPOLLERR|EPOLLHUP))  &&  ! write_connection( ctx, wsx ) ) continue;
+			if (  events[a].events & (EPOLLIN|EPOLLRDHUP|EPOLLERR|EPOLLHUP) ) read_connection( ctx, wsx );
+		}
+
+		now = time( NULL );
+
+		if ( now != last_check ) {
+
+			last_check = now;
+			expire_connections( ctx, now );
+		}
+	}
+
+}  /* reactor_run */
+
+
+
+/*
+ * static void read_connection( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+ *
+ * The function read_connection() reads the data which is available on a
+ * websocket connection of the reactor without blocking. The data is read
+ * into the receive buffer of the reactor behind the incomplete frame which
+ * was kept from the previous read. Frames which are larger than that buffer
+ * are read directly into the input buffer of the connection instead. The
+ * connection is closed when the peer closed it or an error occured.
+ */
+
+static void read_connection( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx ) {
+
+	char *buf;
+	char *in;
+	size_t off;
+	size_t room;
+	ssize_t n;
+	int loop;
+	bool paused;
+
+	for (loop=0; loop<READ_LOOPS; loop++) {
+
+		off = wsx->in_len;
+
+		if ( wsx->need > WEBSOCKET_REACTOR_BUF_LEN ) {
+
+			if ( wsx->in_size < wsx->need ) {
+
+				in = httplib_realloc( wsx->in, wsx->need );
+
+				if ( in == NULL ) {
+
+					httplib_cry( LH_DEBUG_ERROR, ctx, wsx->conn, "%s: websocket out of memory; closing connection", __func__ );
+					XX_httplib_websocket_reactor_close( ctx, wsx );
+					return;
+				}
+
+				wsx->in      = in;
+				wsx->in_size = wsx->need;
+			}
+
+			buf  = wsx->in;
+			room = wsx->need - off;
+		}
+
+		else {
+			buf  = ctx->ws_reactor_buf;
+			room = WEBSOCKET_REACTOR_BUF_LEN - off;
+
+			if ( off > 0 ) memcpy( buf, wsx->in, off );
+		}
+
+		n = recv( wsx->conn->client.sock, buf + off, room, MSG_DONTWAIT );
+
+		if ( n < 0  &&  ( ERRNO == EAGAIN  ||  ERRNO == EWOULDBLOCK  ||  ERRNO == EINTR ) ) return;
+
+		if ( n <= 0  ||  ! XX_httplib_websocket_reactor_parse( ctx, wsx, buf, off + (size_t)n ) ) {
+
+			XX_httplib_websocket_reactor_close( ctx, wsx );
+			return;
+		}
+
+		wsx->last_read        = time( NULL );
+		wsx->conn->ws_last_rx = XX_httplib_monotonic_msec();
+
+		if ( (size_t)n < room ) return;
+
+		httplib_pthread_mutex_lock( & ctx->thread_mutex );
+		paused = wsx->paused;
+		httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+		if ( paused ) return;
+	}
+
+}  /* read_connection */
+
+
+
+/*
+ * static bool write_connection( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+ *
+ * The function write_connection() sends as much of the send queue of a
+ * websocket connection as the socket accepts. When the queue is empty, the
+ * reactor stops watching the socket for room in the send buffer. When the
+ * queue reached its high watermark earlier and has now drained to the low
+ * watermark, a message is queued which tells a worker thread to call the
+ * drain callback. The function returns false if the connection was closed
+ * because the data could not be sent.
+ */
+
+static bool write_connection( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx ) {
+
+	struct lh_con_t *conn;
+	int retval;
+	bool drained;
+
+	conn    = wsx->conn;
+	drained = false;
+
+	httplib_lock_connection( conn );
+
+	retval = XX_httplib_websocket_send_pending( ctx, conn, false );
+
+	if ( retval >= 0 ) {
+
+		if ( retval == 0 ) {
+
+			httplib_pthread_mutex_lock( & ctx->thread_mutex );
+
+			wsx->writing = false;
+			XX_httplib_websocket_reactor_watch( ctx, wsx );
+
+			httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+		}
+
+		if ( conn->ws_queue_full  &&  conn->ws_queued <= (size_t)ctx->websocket_send_queue_low ) {
+
+			conn->ws_queue_full = false;
+			drained             = ( ctx->callbacks.websocket_drain != NULL );
+		}
+	}
+
+	httplib_unlock_connection( conn );
+
+	if ( retval < 0 ) {
+
+		XX_httplib_websocket_reactor_close( ctx, wsx );
+		return false;
+	}
+
+	if ( drained  &&  ! XX_httplib_websocket_reactor_queue( ctx, wsx, WEBSOCKET_REACTOR_DRAIN, NULL, 0 ) ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, conn, "%s: websocket out of memory; closing connection", __func__ );
+		XX_httplib_websocket_reactor_close( ctx, wsx );
+
+		return false;
+	}
+
+	return true;
+
+}  /* write_connection */
+
+
+
+/*
+ * static void expire_connections( struct lh_ctx_t *ctx, time_t now );
+ *
+ * The function expire_connections() closes the websocket connections of the
+ * reactor which haven't received data for longer than the websocket_timeout
+ * option, or the request_timeout option if no websocket timeout was set.
+ * Connections which are paused because their messages are not handled fast
+ * enough are not expired.
+ */
+
+static void expire_connections( struct lh_ctx_t *ctx, time_t now ) {
+
+	struct lh_wsx_t *wsx;
+	time_t timeout;
+
+	timeout                   = ctx->websocket_timeout / 1000;
+	if ( timeout <= 0 ) timeout = ctx->request_timeout / 1000;
+	if ( timeout <= 0 ) return;
+
+	httplib_pthread_mutex_lock( & ctx->thread_mutex );
+
+	for (wsx=ctx->ws_reactor_conns; wsx!=NULL; wsx=wsx->next) {
+
+		if ( ! wsx->closed  &&  ! wsx->paused  &&  now - wsx->last_read > timeout ) XX_httplib_websocket_reactor_close( ctx, wsx );
+	}
+
+	httplib_pthread_mutex_unlock( & ctx->thread_mutex );
+
+}  /* expire_connections */
+
+#endif  /* USE_WEBSOCKET_REACTOR */
@@ -0,0 +1,90 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+
+#include "httplib_main.h"
+
+/*
+ * bool XX_httplib_websocket_reactor_watch( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx );
+ *
+ * The function XX_httplib_websocket_reactor_watch() brings the events for
+ * which the reactor watches the socket of a websocket connection in line with
+ * the state of the connection. The socket is watched for incoming data when
+ * reading is not paused, and for room in the send buffer when frames wait in
+ * the send queue. A socket for which no events are needed is removed from the
+ * event queue, so that a peer which hangs up doesn't wake the reactor over
+ * and over again. Nothing is changed while the connection is still handed
+ * over to the reactor, or after the reactor has closed it. The caller must
+ * hold the thread mutex of the context.
+ *
+ * The function returns false if the event queue could not be changed.
+ */
+
+bool XX_httplib_websocket_reactor_watch( struct lh_ctx_t *ctx, struct lh_wsx_t *wsx ) {
+
+#if defined(USE_WEBSOCKET_REACTOR)
+
+	struct epoll_event ev;
+	uint32_t events;
+	int op;
+
+	if ( wsx->starting  ||  wsx->closed ) return true;
+
+	events = 0;
+
+	if ( ! wsx->paused ) events |= EPOLLIN | EPOLLRDHUP;
+	if (   wsx->writing ) events |= EPOLLOUT;
+
+	if ( events == wsx->events ) return true;
+
+	if      ( events      == 0 ) op = EPOLL_CTL_DEL;
+	else if ( wsx->events == 0 ) op = EPOLL_CTL_ADD;
+	else                         op = EPOLL_CTL_MOD;
+
+	memset( & ev, 0, sizeof(ev) );
+	ev.events   = events;
+	ev.data.ptr = wsx;
+
+	if ( epoll_ctl( ctx->ws_epoll_fd, op, wsx->conn->client.sock, & ev ) != 0 ) {
+
+		httplib_cry( LH_DEBUG_ERROR, ctx, wsx->conn, "%s: cannot change websocket events in reactor: error %d", __func__, ERRNO );
+		return false;
+	}
+
+	wsx->events = events;
+
+	return true;
+
+#else  /* USE_WEBSOCKET_REACTOR */
+
+	UNUSED_PARAMETER(ctx);
+	UNUSED_PARAMETER(wsx);
+
+	return false;
+
+#endif  /* USE_WEBSOCKET_REACTOR */
+
+}  /* XX_httplib_websocket_reactor_watch */
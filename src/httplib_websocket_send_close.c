@@ -0,0 +1,54 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_send_close( const struct lh_ctx_t *ctx, struct lh_con_t *conn, uint16_t code );
+ *
+ * The function XX_httplib_websocket_send_close() sends a close frame with a
+ * status code to the remote peer. Frames sent by a client are masked.
+ */
+
+void XX_httplib_websocket_send_close( const struct lh_ctx_t *ctx, struct lh_con_t *conn, uint16_t code ) {
+
+	char payload[2];
+	uint32_t masking_key;
+
+	payload[0]  = (char)(code >> 8);
+	payload[1]  = (char)(code & 0xFF);
+	masking_key = 0;
+
+	if ( ctx->ctx_type == CTX_TYPE_CLIENT ) {
+
+		do {
+			masking_key = (uint32_t)httplib_get_random();
+		} while ( masking_key == 0 );
+	}
+
+	XX_httplib_websocket_write_exec( ctx, conn, WEBSOCKET_OPCODE_CONNECTION_CLOSE, payload, 2, masking_key );
+
+}  /* XX_httplib_websocket_send_close */
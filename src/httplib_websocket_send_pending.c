@@ -0,0 +1,193 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+static int	send_batch( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool blocking );
+static int	send_error( struct lh_con_t *conn );
+
+/*
+ * int XX_httplib_websocket_send_pending( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool blocking );
+ *
+ * The function XX_httplib_websocket_send_pending() sends the frames in the
+ * send queue of a connection which could not be sent completely earlier. The
+ * caller must hold the lock of the connection. In blocking mode the function
+ * waits until the whole queue has been sent, otherwise it sends as much as
+ * the socket accepts. On plain sockets up to SENDV_MAX_IOV queued frames are
+ * passed to the kernel with one call, TLS connections send the frames one by
+ * one. The reference to a frame is released when it has been sent
+ * completely. A frame which can't be completed leaves the stream in an
+ * undefined state, and the connection is therefore shut down so that the
+ * reading thread closes it. The function returns 0 if no data is pending
+ * anymore, 1 if data is still pending and -1 if an error occured.
+ */
+
+int XX_httplib_websocket_send_pending( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool blocking ) {
+
+	struct lh_wsq_t *entry;
+	const char *data;
+	int64_t left;
+	int64_t n;
+	int retval;
+
+	if ( ctx == NULL  ||  conn == NULL ) return -1;
+
+	if ( conn->ssl == NULL ) {
+
+		while ( conn->ws_queue != NULL ) {
+
+			retval = send_batch( ctx, conn, blocking );
+			if ( retval != 0 ) return retval;
+		}
+
+		return 0;
+	}
+
+	while ( conn->ws_queue != NULL ) {
+
+		entry = conn->ws_queue;
+		data  = ((const char *)(entry->frame + 1)) + conn->ws_queue_off;
+		left  = (int64_t)(entry->frame->len - conn->ws_queue_off);
+
+		if ( blocking ) n = XX_httplib_push_all(         ctx, NULL, conn->client.sock, conn->ssl, data, left );
+		else            n = XX_httplib_send_nonblocking(                conn->client.sock,            data, left );
+
+		if ( n < 0  ||  ( blocking  &&  n < left ) ) return send_error( conn );
+
+		conn->ws_queue_off += (size_t)n;
+		conn->ws_queued    -= (size_t)n;
+
+		if ( n < left ) return 1;
+
+		conn->ws_queue     = entry->next;
+		conn->ws_queue_off = 0;
+
+		if ( conn->ws_queue == NULL ) conn->ws_queue_last = NULL;
+
+		XX_httplib_websocket_frame_release( entry->frame );
+		httplib_free( entry );
+	}
+
+	return 0;
+
+}  /* XX_httplib_websocket_send_pending */
+
+
+
+/*
+ * static int send_batch( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool blocking );
+ *
+ * The function send_batch() sends the first SENDV_MAX_IOV frames of the send
+ * queue of a plain connection with one call to XX_httplib_sendv() and removes
+ * the frames which were sent completely from the queue. The function
+ * returns 0 if the whole batch was sent, 1 if the socket did not accept all
+ * of it and -1 if an error occured.
+ */
+
+static int send_batch( const struct lh_ctx_t *ctx, struct lh_con_t *conn, bool blocking ) {
+
+	struct lh_out_t out[SENDV_MAX_IOV];
+	struct lh_wsq_t *entry;
+	size_t total;
+	size_t sent;
+	size_t left;
+	int64_t n;
+	int num_out;
+
+	num_out = 0;
+	total   = 0;
+	entry   = conn->ws_queue;
+
+	while ( entry != NULL  &&  num_out < SENDV_MAX_IOV ) {
+
+		out[num_out].base = (const char *)(entry->frame + 1);
+		out[num_out].len  = entry->frame->len;
+
+		if ( num_out == 0 ) {
+
+			out[0].base  = ((const char *)out[0].base) + conn->ws_queue_off;
+			out[0].len  -= conn->ws_queue_off;
+		}
+
+		total += out[num_out].len;
+		num_out++;
+		entry  = entry->next;
+	}
+
+	if ( num_out == 0 ) return 0;
+
+	n = XX_httplib_sendv( ctx, conn->client.sock, out, num_out, blocking );
+
+	if ( n < 0  ||  ( blocking  &&  (size_t)n < total ) ) return send_error( conn );
+
+	sent             = (size_t)n;
+	conn->ws_queued -= sent;
+
+	while ( sent > 0 ) {
+
+		entry = conn->ws_queue;
+		left  = entry->frame->len - conn->ws_queue_off;
+
+		if ( sent < left ) {
+
+			conn->ws_queue_off += sent;
+			return 1;
+		}
+
+		sent               -= left;
+		conn->ws_queue      = entry->next;
+		conn->ws_queue_off  = 0;
+
+		if ( conn->ws_queue == NULL ) conn->ws_queue_last = NULL;
+
+		XX_httplib_websocket_frame_release( entry->frame );
+		httplib_free( entry );
+	}
+
+	return 0;
+
+}  /* send_batch */
+
+
+
+/*
+ * static int send_error( struct lh_con_t *conn );
+ *
+ * The function send_error() discards the send queue of a connection on which
+ * a frame could not be completed and shuts the connection down. The value -1
+ * is returned as a convenience for the caller.
+ */
+
+static int send_error( struct lh_con_t *conn ) {
+
+	XX_httplib_websocket_queue_free( conn );
+	conn->must_close = true;
+
+	shutdown( conn->client.sock, SHUTDOWN_BOTH );
+
+	return -1;
+
+}  /* send_error */
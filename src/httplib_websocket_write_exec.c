@@ -27,94 +27,289 @@
 
 #include "httplib_main.h"
 
+static int	queue_write( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int opcode, const char *data, size_t data_len, uint32_t masking_key );
+
 /*
  * int XX_httplib_websocket_write_exec( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int opcode, const char *data, size_t data_len, uint32_t masking_key );
  *
  * The function XX_httplib_websocket_write_exec() does the heavy lifting in
- * writing data over a websocket connectin to a remote peer.
+ * writing data over a websocket connectin to a remote peer. When a masking
+ * key is given, the payload is masked in blocks of at most
+ * WEBSOCKET_MASK_BLOCK bytes so that large frames do not need a copy of the
+ * whole payload in memory. Text and binary messages are compressed first if
+ * the permessage-deflate extension was negotiated on the connection. The
+ * frames which are still pending on the connection are sent first.
+ *
+ * The header and the payload of a frame are passed to the socket in one call
+ * to avoid a separate small packet for the header. Large payloads on plain
+ * sockets are sent from their own buffer with XX_httplib_sendv(). Small
+ * payloads, and all payloads on TLS connections, are copied up to
+ * WEBSOCKET_COPY_MAX bytes behind the header in a buffer on the stack.
+ *
+ * Connections of the reactor are never written in blocking mode. The frame
+ * is sent as far as the socket accepts it and the rest is left in the send
+ * queue for the reactor. When the send queue is full, the message is either
+ * dropped and zero is returned, or the connection is closed, depending on the
+ * websocket_send_queue_drop option. The number of bytes of the original
+ * payload is returned on success and -1 if an error occured.
  */
 
 int XX_httplib_websocket_write_exec( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int opcode, const char *data, size_t data_len, uint32_t masking_key ) {
 
-	unsigned char header[14];
+	unsigned char header[WEBSOCKET_HEADER_MAX+WEBSOCKET_COPY_MAX];
+	unsigned char key[4];
+	struct lh_out_t out[2];
+	char *masked;
+	size_t payload_len;
 	size_t header_len;
+	size_t block_len;
+	size_t done;
+	size_t pre;
+	int64_t n;
 	int retval;
-	uint16_t len;
-	uint32_t len1;
-	uint32_t len2;
+	bool ok;
 
 	if ( ctx == NULL ) return -1;
 
-	retval     = -1;
-	header_len = 1;
-	header[0]  = 0x80 + (opcode & 0xF);
+	retval      = -1;
+	opcode     &= 0x0F;
+	payload_len = data_len;
+
+	/*
+	 * Note that POSIX/Winsock's send() is threadsafe
+	 * http://stackoverflow.com/questions/1981372/are-parallel-calls-to-send-recv-on-the-same-socket-valid
+	 * but LibHTTP's httplib_printf/httplib_write is not (because of the loop in
+	 * push(), although that is only a problem if the packet is large or
+	 * outgoing buffer is full). The lock is also needed because the
+	 * compressor state of a connection must see the messages in the order in
+	 * which they are sent.
+	 */
+
+	httplib_lock_connection( conn );
 
 	/*
-	 * Frame format: http://tools.ietf.org/html/rfc6455#section-5.2
+	 * The limit of the send queue is checked before the message is
+	 * compressed, because a dropped message must not become part of the
+	 * compressor state.
 	 */
 
-	if ( data_len < 126 ) {
+	if ( conn->ws_reactor != NULL ) {
 
-		/*
-		 * inline 7-bit length field
-		 */
+		retval = XX_httplib_websocket_queue_limit( ctx, conn );
 
-		header[1]  = (unsigned char)data_len;
-		header_len = 2;
+		if ( retval != 0 ) {
+
+			httplib_unlock_connection( conn );
+			return ( retval > 0 ) ? 0 : -1;
+		}
 	}
-	
-	else if ( data_len <= 65535 ) {
 
-		/*
-		 * 16-bit length field
-		 */
+	else if ( XX_httplib_websocket_send_pending( ctx, conn, true ) != 0 ) {
 
-		len        = htons( (uint16_t)data_len );
-		header[1]  = 126;
-		header_len = 4;
-		memcpy( header+2, & len, 2 );
+		httplib_unlock_connection( conn );
+		return -1;
 	}
-	
-	else {
-		/*
-		 * 64-bit length field
-		 */
-
-		len1       = htonl( (uint64_t)data_len >> 32 );
-		len2       = htonl( data_len & 0xFFFFFFFF );
-		header[1]  = 127;
-		header_len = 10;
-		memcpy( header + 2, & len1, 4 );
-		memcpy( header + 6, & len2, 4 );
+
+	if ( conn->ws_deflate != NULL  &&  ! (opcode & 0x08)  &&  data_len >= WEBSOCKET_DEFLATE_MIN ) {
+
+		if ( ! XX_httplib_websocket_deflate( conn, data, data_len, & data, & data_len ) ) {
+
+			httplib_unlock_connection( conn );
+			return -1;
+		}
+
+		opcode |= WEBSOCKET_RSV1;
 	}
 
-	if ( masking_key ) {
+	if ( conn->ws_reactor != NULL ) {
 
-		/*
-		 * add mask
-		 */
+		retval = queue_write( ctx, conn, opcode, data, data_len, masking_key );
+		httplib_unlock_connection( conn );
 
-		header[1] |= 0x80;
-		memcpy( header + header_len, & masking_key, 4 );
-		header_len += 4;
+		return ( retval == 0 ) ? (int)payload_len : -1;
 	}
 
+	header_len = XX_httplib_websocket_frame_header( header, opcode, data_len, masking_key );
+	masked     = NULL;
 
 	/*
-	 * Note that POSIX/Winsock's send() is threadsafe
-	 * http://stackoverflow.com/questions/1981372/are-parallel-calls-to-send-recv-on-the-same-socket-valid
-	 * but LibHTTP's httplib_printf/httplib_write is not (because of the loop in
-	 * push(), although that is only a problem if the packet is large or
-	 * outgoing buffer is full).
+	 * The header always leaves in the same write as the start of the
+	 * payload, so that a small message is one TCP segment or TLS record.
+	 * Masked payloads are built block by block behind the header, large
+	 * payloads on plain sockets are gathered with the header in one call
+	 * and other payloads are copied behind the header as far as they fit.
 	 */
 
-	httplib_lock_connection( conn );
+	if ( masking_key  &&  data_len > 0 ) {
 
-	retval = httplib_write( ctx, conn, header, header_len );
-	if ( data_len > 0 ) retval = httplib_write( ctx, conn, data, data_len );
+		block_len = ( data_len < WEBSOCKET_MASK_BLOCK ) ? data_len : WEBSOCKET_MASK_BLOCK;
+		masked    = httplib_malloc( WEBSOCKET_HEADER_MAX + block_len );
+
+		if ( masked == NULL ) {
+
+			httplib_unlock_connection( conn );
+			return -1;
+		}
+
+		memcpy( key,    & masking_key, 4          );
+		memcpy( masked,   header,      header_len );
+
+		done = 0;
+		pre  = header_len;
+		ok   = true;
+
+		while ( done < data_len ) {
+
+			block_len = data_len - done;
+			if ( block_len > WEBSOCKET_MASK_BLOCK ) block_len = WEBSOCKET_MASK_BLOCK;
+
+			XX_httplib_websocket_mask( masked + pre, data + done, block_len, key, done );
+
+			retval = httplib_write( ctx, conn, masked, pre + block_len );
+			ok     = ( retval == (int)(pre + block_len) );
+
+			if ( ! ok ) break;
+
+			done += block_len;
+			pre   = 0;
+		}
+	}
+
+	else if ( data_len > WEBSOCKET_COPY_MAX  &&  conn->ssl == NULL  &&  conn->throttle <= 0 ) {
+
+		out[0].base = header;
+		out[0].len  = header_len;
+		out[1].base = data;
+		out[1].len  = data_len;
+
+		n      = XX_httplib_sendv( ctx, conn->client.sock, out, 2, true );
+		retval = (int)n;
+		ok     = ( n == (int64_t)(header_len + data_len) );
+	}
+
+	else {
+		block_len = ( data_len < WEBSOCKET_COPY_MAX ) ? data_len : WEBSOCKET_COPY_MAX;
+
+		if ( block_len > 0 ) memcpy( header + header_len, data, block_len );
+
+		retval = httplib_write( ctx, conn, header, header_len + block_len );
+		ok     = ( retval == (int)(header_len + block_len) );
+
+		if ( ok  &&  block_len < data_len ) {
+
+			retval = httplib_write( ctx, conn, data + block_len, data_len - block_len );
+			ok     = ( retval == (int)(data_len - block_len) );
+		}
+	}
+
+	/*
+	 * A write which stopped halfway has left an incomplete frame in the
+	 * stream and is therefore reported as an error.
+	 */
+
+	if      ( ok         ) retval = (int)payload_len;
+	else if ( retval > 0 ) retval = -1;
 
 	httplib_unlock_connection( conn );
 
+	if ( masked != NULL ) masked = httplib_free( masked );
+
 	return retval;
 
 }  /* XX_httplib_websocket_write_exec */
+
+
+
+/*
+ * static int queue_write( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int opcode, const char *data, size_t data_len, uint32_t masking_key );
+ *
+ * The function queue_write() sends a websocket frame on a connection without
+ * blocking. When nothing is waiting in the send queue, the header and the
+ * payload of an unmasked frame are sent directly from their own buffers with
+ * one call to XX_httplib_sendv(). Only the part which the socket did not
+ * accept is copied to a reference counted buffer and passed to the send queue
+ * of the connection. The function returns 0 on success and -1 if an error
+ * occured.
+ */
+
+static int queue_write( const struct lh_ctx_t *ctx, struct lh_con_t *conn, int opcode, const char *data, size_t data_len, uint32_t masking_key ) {
+
+	struct lh_wsf_t *frame;
+	struct lh_out_t out[2];
+	unsigned char header[WEBSOCKET_HEADER_MAX];
+	unsigned char key[4];
+	char *buf;
+	size_t header_len;
+	size_t sent;
+	int64_t n;
+	int retval;
+
+	if ( data_len > SIZE_MAX - sizeof(struct lh_wsf_t) - WEBSOCKET_HEADER_MAX ) return -1;
+
+	if ( masking_key == 0  &&  conn->ws_queue == NULL  &&  conn->ssl == NULL ) {
+
+		header_len  = XX_httplib_websocket_frame_header( header, opcode, data_len, 0 );
+		out[0].base = header;
+		out[0].len  = header_len;
+		out[1].base = data;
+		out[1].len  = data_len;
+
+		n = XX_httplib_sendv( ctx, conn->client.sock, out, ( data_len > 0 ) ? 2 : 1, false );
+
+		if ( n < 0 ) {
+
+			conn->must_close = true;
+			shutdown( conn->client.sock, SHUTDOWN_BOTH );
+
+			return -1;
+		}
+
+		sent = (size_t)n;
+		if ( sent == header_len + data_len ) return 0;
+
+		frame = httplib_malloc( sizeof(struct lh_wsf_t) + header_len + data_len - sent );
+		if ( frame == NULL ) return -1;
+
+		buf = (char *)(frame + 1);
+
+		if ( sent < header_len ) {
+
+			memcpy( buf, header + sent, header_len - sent );
+			if ( data_len > 0 ) memcpy( buf + header_len - sent, data, data_len );
+		}
+
+		else memcpy( buf, data + sent - header_len, header_len + data_len - sent );
+
+		frame->refcount = 1;
+		frame->len      = header_len + data_len - sent;
+	}
+
+	else {
+		frame = httplib_malloc( sizeof(struct lh_wsf_t) + WEBSOCKET_HEADER_MAX + data_len );
+		if ( frame == NULL ) return -1;
+
+		buf        = (char *)(frame + 1);
+		header_len = XX_httplib_websocket_frame_header( (unsigned char *)buf, opcode, data_len, masking_key );
+
+		if ( data_len > 0 ) {
+
+			if ( masking_key ) {
+
+				memcpy( key, & masking_key, 4 );
+				XX_httplib_websocket_mask( buf + header_len, data, data_len, key, 0 );
+			}
+
+			else memcpy( buf + header_len, data, data_len );
+		}
+
+		frame->refcount = 1;
+		frame->len      = header_len + data_len;
+	}
+
+	retval = XX_httplib_websocket_queue_frame( ctx, conn, frame );
+
+	XX_httplib_websocket_frame_release( frame );
+
+	return retval;
+
+}  /* queue_write */
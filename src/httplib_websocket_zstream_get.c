@@ -0,0 +1,101 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * struct lh_wsz_t *XX_httplib_websocket_zstream_get( struct lh_wzp_t *pool, bool deflate, int window_bits, int level );
+ *
+ * The function XX_httplib_websocket_zstream_get() returns a zlib stream for
+ * the permessage-deflate websocket extension. An idle stream of the same kind
+ * and window size is taken from the pool if available, otherwise a new stream
+ * is created. Decompressors always use the maximum window size, because they
+ * can then decode the data of any compressor. The pool may be NULL. The
+ * function returns NULL if no stream could be created.
+ */
+
+struct lh_wsz_t *XX_httplib_websocket_zstream_get( struct lh_wzp_t *pool, bool deflate, int window_bits, int level ) {
+
+#if defined(USE_ZLIB)
+	struct lh_wsz_t *zs;
+	struct lh_wsz_t **prev;
+	int retval;
+
+	if ( ! deflate ) window_bits = MAX_WBITS;
+
+	if ( pool != NULL ) {
+
+		zs = NULL;
+
+		httplib_pthread_mutex_lock( & pool->mutex );
+
+		for (prev=& pool->streams; *prev != NULL; prev=& (*prev)->next) {
+
+			if ( (*prev)->deflate == deflate  &&  (*prev)->window_bits == window_bits ) {
+
+				zs    = *prev;
+				*prev = zs->next;
+				pool->len--;
+				break;
+			}
+		}
+
+		httplib_pthread_mutex_unlock( & pool->mutex );
+
+		if ( zs != NULL ) {
+
+			zs->next = NULL;
+			return zs;
+		}
+	}
+
+	zs = httplib_calloc( 1, sizeof(struct lh_wsz_t) );
+	if ( zs == NULL ) return NULL;
+
+	zs->deflate     = deflate;
+	zs->window_bits = window_bits;
+
+	/*
+	 * Negative window bits select raw deflate data without a zlib header
+	 * and checksum, as required by RFC 7692
+	 */
+
+	if ( deflate ) retval = deflateInit2( & zs->zstream, level, Z_DEFLATED, -window_bits, 8, Z_DEFAULT_STRATEGY );
+	else           retval = inflateInit2( & zs->zstream, -window_bits );
+
+	if ( retval != Z_OK ) zs = httplib_free( zs );
+
+	return zs;
+#else  /* USE_ZLIB */
+	UNUSED_PARAMETER( pool        );
+	UNUSED_PARAMETER( deflate     );
+	UNUSED_PARAMETER( window_bits );
+	UNUSED_PARAMETER( level       );
+
+	return NULL;
+#endif  /* USE_ZLIB */
+
+}  /* XX_httplib_websocket_zstream_get */
@@ -0,0 +1,71 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * void XX_httplib_websocket_zstream_put( struct lh_wzp_t *pool, struct lh_wsz_t *zs );
+ *
+ * The function XX_httplib_websocket_zstream_put() returns a zlib stream which
+ * is no longer used by a websocket connection. The stream is reset and added
+ * to the pool for reuse. If there is no pool or the pool is full, the stream
+ * is destroyed.
+ */
+
+void XX_httplib_websocket_zstream_put( struct lh_wzp_t *pool, struct lh_wsz_t *zs ) {
+
+	if ( zs == NULL ) return;
+
+#if defined(USE_ZLIB)
+	if ( pool != NULL ) {
+
+		if ( zs->deflate ) deflateReset( & zs->zstream );
+		else               inflateReset( & zs->zstream );
+
+		httplib_pthread_mutex_lock( & pool->mutex );
+
+		if ( pool->len < WEBSOCKET_ZSTREAM_POOL_MAX ) {
+
+			zs->next      = pool->streams;
+			pool->streams = zs;
+			pool->len++;
+			zs            = NULL;
+		}
+
+		httplib_pthread_mutex_unlock( & pool->mutex );
+
+		if ( zs == NULL ) return;
+	}
+
+	if ( zs->deflate ) deflateEnd( & zs->zstream );
+	else               inflateEnd( & zs->zstream );
+#else  /* USE_ZLIB */
+	UNUSED_PARAMETER( pool );
+#endif  /* USE_ZLIB */
+
+	httplib_free( zs );
+
+}  /* XX_httplib_websocket_zstream_put */
@@ -69,6 +69,7 @@ static void worker_thread_run( struct worker_thread_args *thread_args ) {
 
 	struct lh_ctx_t *ctx;
 	struct lh_con_t *conn;
+	struct lh_wsx_t *wsx;
 	struct httplib_workerTLS tls;
 #if !defined(NO_SSL)
 	union {
@@ -90,15 +91,14 @@ static void worker_thread_run( struct worker_thread_args *thread_args ) {
 
 	if ( ctx->callbacks.init_thread != NULL ) ctx->callbacks.init_thread( ctx, 1 ); /* call init_thread for a worker thread (type 1) */
 
-	conn = httplib_calloc( 1, sizeof(*conn) + MAX_REQUEST_SIZE );
+	conn = httplib_calloc( 1, sizeof(*conn) );
 	if ( conn == NULL ) httplib_cry( LH_DEBUG_ERROR, ctx, NULL, "%s: cannot create new connection struct, OOM", __func__ );
 	
 	else {
 		httplib_pthread_setspecific( XX_httplib_sTlsKey, &tls );
 
-		conn->buf_size               = MAX_REQUEST_SIZE;
-		conn->buf                    = (char *)(conn+1);
 		conn->thread_index           = thread_args->index;
+		conn->request_timeout        = ctx->request_timeout;
 		conn->request_info.user_data = ctx->user_data;
 
 		/*
@@ -114,7 +114,18 @@ static void worker_thread_run( struct worker_thread_args *thread_args ) {
 		 * produce_socket()
 		 */
 
-		while ( XX_httplib_consume_socket( ctx, &conn->client, conn->thread_index ) ) {
+		while ( XX_httplib_consume_socket( ctx, &conn->client, &wsx, conn->thread_index ) ) {
+
+			/*
+			 * Messages which the websocket reactor received on one of
+			 * its connections are passed to the data handler here.
+			 */
+
+			if ( wsx != NULL ) {
+
+				XX_httplib_websocket_reactor_dispatch( ctx, wsx );
+				continue;
+			}
 
 			conn->conn_birth_time = time( NULL );
 
@@ -134,7 +145,7 @@ static void worker_thread_run( struct worker_thread_args *thread_args ) {
 			if ( conn->client.has_ssl ) {
 
 #ifndef NO_SSL
-				if ( XX_httplib_sslize( ctx, conn, ctx->ssl_ctx, SSL_accept ) ) {
+				if ( XX_httplib_sslize( ctx, conn, ctx->ssl_ctx, NULL, SSL_accept ) ) {
 
 					XX_httplib_ssl_get_client_cert_info(    conn );
 					XX_httplib_process_new_connection( ctx, conn );
@@ -155,6 +166,7 @@ static void worker_thread_run( struct worker_thread_args *thread_args ) {
 			else XX_httplib_process_new_connection( ctx, conn );
 
 			XX_httplib_close_connection( ctx, conn );
+			XX_httplib_buffer_release(   ctx, conn );
 		}
 	}
 
@@ -163,6 +175,7 @@ static void worker_thread_run( struct worker_thread_args *thread_args ) {
 	CloseHandle( tls.pthread_cond_helper_mutex );
 #endif
 	httplib_pthread_mutex_destroy( & conn->mutex );
-	conn = httplib_free( conn );
+	conn->out_buf = httplib_free( conn->out_buf );
+	conn          = httplib_free( conn          );
 
 }  /* worker_thread_run */
@@ -31,72 +31,19 @@
  * The amount of characters written is returned. If an error occurs
  * the value 0 is returned.
  *
- * The function uses throtteling when necessary for a connection. Throtteling
- * uses the wall clock. Although this can be dangerous in some situations where
- * the value of the wall clock is changed externally, it isn't in this case
- * because the throttle function only looks when the time calue changes, but
- * doesn't take the actual value of the clock in the calculation. In the latter
- * case a monotonic clock with guaranteed increase would be a better choice.
+ * When the response has been switched to on the fly compression with
+ * httplib_start_compressed_response(), the data is passed to the compressor
+ * instead of being sent directly. Likewise the data is collected in chunks
+ * after a call to httplib_start_chunked_response().
  */
 
 int httplib_write( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const void *buffie, size_t lennie ) {
 
-	time_t now;
-	int64_t n;
-	int64_t len;
-	int64_t total;
-	int64_t allowed;
-	const char *buf;
-
 	if ( ctx == NULL  ||  conn == NULL  ||  buffie == NULL  ||  lennie == 0 ) return 0;
 
-	buf = buffie;
-	len = lennie;
-
-	if ( conn->throttle > 0 ) {
-
-		now = time( NULL );
-
-		if ( now != conn->last_throttle_time ) {
-
-			conn->last_throttle_time  = now;
-			conn->last_throttle_bytes = 0;
-		}
-
-		allowed = conn->throttle - conn->last_throttle_bytes;
-		if ( allowed > len ) allowed = len;
-
-		total = XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, buf, allowed );
-
-		if ( total == allowed ) {
-
-			buf                        = buf + total;
-			conn->last_throttle_bytes += total;
-
-			while ( total < len  &&  ctx->status == CTX_STATUS_RUNNING ) {
-
-				if ( conn->throttle > len-total ) allowed = len-total;
-				else                              allowed = conn->throttle;
-
-				n = XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, buf, allowed );
-				if ( n != allowed ) {
-				
-					if ( n > 0 ) total += n;	
-					break;
-				}
-
-				sleep( 1 );
-
-				conn->last_throttle_bytes = allowed;
-				conn->last_throttle_time  = time( NULL );
-				buf                       = buf + n;
-				total                    += n;
-			}
-		}
-	}
-	
-	else total = XX_httplib_push_all( ctx, NULL, conn->client.sock, conn->ssl, buf, len );
+	if ( conn->compress  != NULL ) return XX_httplib_compress_write( ctx, conn, buffie, lennie );
+	if ( conn->chunk_out != NULL ) return httplib_write_chunk( ctx, conn, buffie, lennie );
 
-	return (int)total;
+	return XX_httplib_write_raw( ctx, conn, buffie, lennie );
 
 }  /* httplib_write */
@@ -0,0 +1,90 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ============
+ * Release: 2.0
+ */
+
+
+#include "httplib_main.h"
+
+/*
+ * int httplib_write_chunk( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const void *buffie, size_t lennie );
+ *
+ * The function httplib_write_chunk() writes data to the body of a response
+ * which was started with httplib_start_chunked_response(). Small blocks of
+ * data are collected in a buffer which is sent as one chunk when it is full,
+ * to prevent that the client receives many small chunks with a relatively
+ * large framing overhead. If the connection doesn't use chunked transfer
+ * encoding, the function behaves like httplib_write().
+ *
+ * The amount of characters processed is returned. If an error occurs the
+ * value 0 is returned.
+ */
+
+int httplib_write_chunk( const struct lh_ctx_t *ctx, struct lh_con_t *conn, const void *buffie, size_t lennie ) {
+
+	struct lh_chk_t *chk;
+	const char *buf;
+	size_t len;
+	size_t part;
+	bool ok;
+
+	if ( ctx == NULL  ||  conn == NULL  ||  buffie == NULL  ||  lennie == 0  ||  lennie > INT_MAX ) return 0;
+
+	chk = conn->chunk_out;
+	if ( chk == NULL ) return XX_httplib_write_raw( ctx, conn, buffie, lennie );
+
+	if ( chk->error   ) return 0;
+	if ( chk->no_body ) return (int)lennie;
+
+	buf = buffie;
+	len = lennie;
+
+	while ( len > 0 ) {
+
+		part = CHUNK_BUF_LEN - chk->len;
+		if ( part > len ) part = len;
+
+		memcpy( chk->buf + CHUNK_HDR_LEN + chk->len, buf, part );
+		chk->len += part;
+		buf      += part;
+		len      -= part;
+
+		if ( chk->len == CHUNK_BUF_LEN ) {
+
+			if ( chk->framing ) ok = XX_httplib_send_chunk( ctx, conn, chk->buf + CHUNK_HDR_LEN, chk->len, false );
+			else                ok = ( XX_httplib_write_raw( ctx, conn, chk->buf + CHUNK_HDR_LEN, chk->len ) == (int)chk->len );
+
+			chk->len = 0;
+
+			if ( ! ok ) {
+
+				chk->error       = true;
+				conn->must_close = true;
+				return 0;
+			}
+		}
+	}
+
+	return (int)lennie;
+
+}  /* httplib_write_chunk */
@@ -0,0 +1,178 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <stdio.h> 
+#include "libhttp.h"
+#include "../src/httplib_main.h"
+#include "../src/httplib_utils.h"
+
+#define PART_LEN	(256*1024*1024)
+#define BOUNDARY	"----WebKitFormBoundary7MA4YWxkTrZu0gW"
+
+static const char *	naive_search( const char *buf, size_t buf_len, const char *boundary, size_t boundary_len );
+static double		run( const struct lh_fbd_t *fb, const char *data, size_t len, bool naive, size_t *found );
+
+/*
+ * int main( void );
+ *
+ * The main() routine of the benchform program measures the speed of the
+ * boundary search of the multipart/form-data parser on large parts with
+ * random binary data, text with short lines and data which contains many
+ * partial delimiters. The data is searched in blocks of FORM_BUF_LEN bytes
+ * like the parser does, with the byte by byte search used by earlier versions
+ * of the parser as a reference. Both searches must find the delimiter at the
+ * end of the part at the same offset.
+ */
+
+int main( void ) {
+
+	static const char *name[3] = { "binary", "text", "partial delimiters" };
+	struct lh_fbd_t fb;
+	char *data;
+	size_t a;
+	size_t len;
+	size_t found_new;
+	size_t found_old;
+	double t_new;
+	double t_old;
+	int problems;
+	int test;
+
+	problems = 0;
+	len      = PART_LEN + strlen( BOUNDARY ) + 4;
+	data     = malloc( len );
+
+	if ( data == NULL ) return 1;
+
+	XX_httplib_form_boundary_init( & fb, BOUNDARY, strlen( BOUNDARY ) );
+
+	for (test=0; test<3; test++) {
+
+		srand( 1 );
+
+		for (a=0; a<PART_LEN; a++) {
+
+			switch ( test ) {
+
+				case 0  : data[a] = (char)rand();						break;
+				case 1  : data[a] = ( a % 64 < 62 ) ? (char)('a' + rand() % 26) : "\r\n"[a % 64 - 62];	break;
+				default : data[a] = ( a % 16 < 10 ) ? fb.delim[a % 16] : (char)rand();		break;
+			}
+		}
+
+		memcpy( data + PART_LEN, fb.delim, fb.len );
+
+		t_new = run( & fb, data, len, false, & found_new );
+		t_old = run( & fb, data, len, true,  & found_old );
+
+		printf( "%-20s new %8.1f MB/s   old %8.1f MB/s\n", name[test], PART_LEN / t_new / 1e6, PART_LEN / t_old / 1e6 );
+
+		if ( found_new != PART_LEN  ||  found_old != PART_LEN ) {
+
+			printf( "Search ERROR: delimiter found at %lu and %lu instead of %lu\n", (unsigned long)found_new, (unsigned long)found_old, (unsigned long)PART_LEN );
+			problems++;
+		}
+	}
+
+	free( data );
+
+	return ( problems > 0 );
+
+}  /* main (benchform) */
+
+
+
+/*
+ * static double run( const struct lh_fbd_t *fb, const char *data, size_t len, bool naive, size_t *found );
+ *
+ * The function run() searches the data for the first delimiter in blocks of
+ * FORM_BUF_LEN bytes and returns the elapsed time in seconds. The new search
+ * continues after the bytes which it marked as safe. The naive search keeps
+ * the length of the delimiter at the end of each block for the next search,
+ * like the old parser did.
+ */
+
+static double run( const struct lh_fbd_t *fb, const char *data, size_t len, bool naive, size_t *found ) {
+
+	struct timespec start;
+	struct timespec end;
+	const char *next;
+	size_t pos;
+	size_t block;
+	size_t safe;
+
+	clock_gettime( CLOCK_MONOTONIC, & start );
+
+	pos    = 0;
+	*found = len;
+
+	while ( pos < len ) {
+
+		block = len - pos;
+		if ( block > FORM_BUF_LEN ) block = FORM_BUF_LEN;
+
+		if ( naive ) {
+
+			next = naive_search( data + pos, block, fb->delim + 4, fb->len - 4 );
+			safe = ( block > fb->len ) ? block - fb->len : 1;
+		}
+
+		else next = XX_httplib_form_boundary_search( fb, data + pos, block, & safe );
+
+		if ( next != NULL ) {
+
+			*found = (size_t)(next - data);
+			break;
+		}
+
+		pos += ( safe > 0 ) ? safe : block;
+	}
+
+	clock_gettime( CLOCK_MONOTONIC, & end );
+
+	return XX_httplib_difftimespec( & end, & start );
+
+}  /* run */
+
+
+
+/*
+ * static const char *naive_search( const char *buf, size_t buf_len, const char *boundary, size_t boundary_len );
+ *
+ * The function naive_search() is the byte by byte boundary search of earlier
+ * versions of the multipart/form-data parser.
+ */
+
+static const char *naive_search( const char *buf, size_t buf_len, const char *boundary, size_t boundary_len ) {
+
+	int clen = (int)buf_len - (int)boundary_len - 4;
+	int i;
+
+	for (i = 0; i <= clen; i++) {
+		if (!memcmp(buf + i, "\r\n--", 4)) {
+			if (!memcmp(buf + i + 4, boundary, boundary_len)) return buf+i;
+		}
+	}
+	return NULL;
+
+}  /* naive_search */
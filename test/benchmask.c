@@ -0,0 +1,162 @@
+/* 
+ * Copyright (c) 2016 Lammert Bies
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <stdio.h> 
+#include "libhttp.h"
+#include "../src/httplib_main.h"
+#include "../src/httplib_utils.h"
+
+#define DATA_LEN	(64*1024*1024)
+#define ROUNDS		(8)
+
+static void		naive_mask( char *out, const char *in, size_t len, const unsigned char key[4], size_t phase );
+static double		run( char *out, const char *in, size_t len, const unsigned char key[4], bool naive );
+
+/*
+ * int main( void );
+ *
+ * The main() routine of the benchmask program measures the speed of the
+ * websocket masking function on frames of different sizes, with the byte by
+ * byte masking loop used by earlier versions as a reference. Before the
+ * measurement the result of the masking function is compared with the
+ * reference for all combinations of small lengths, buffer alignments and key
+ * phases.
+ */
+
+int main( void ) {
+
+	static const size_t frame[5] = { 16, 125, 1024, 65536, DATA_LEN };
+	static const unsigned char key[4] = { 0x37, 0xfa, 0x21, 0x3d };
+	char *in;
+	char *out;
+	char *ref;
+	size_t a;
+	size_t len;
+	size_t offset;
+	size_t phase;
+	double t_new;
+	double t_old;
+	int problems;
+	int test;
+
+	problems = 0;
+	in       = malloc( DATA_LEN + 64 );
+	out      = malloc( DATA_LEN + 64 );
+	ref      = malloc( DATA_LEN + 64 );
+
+	if ( in == NULL  ||  out == NULL  ||  ref == NULL ) return 1;
+
+	srand( 1 );
+	for (a=0; a<DATA_LEN+64; a++) in[a] = (char)rand();
+
+	for (len=0; len<300; len++) {
+	for (offset=0; offset<32; offset++) {
+	for (phase=0; phase<4; phase++) {
+
+		naive_mask( ref, in + (offset*7) % 32, len, key, phase );
+		XX_httplib_websocket_mask( out + offset, in + (offset*7) % 32, len, key, phase );
+
+		if ( memcmp( ref, out + offset, len ) ) {
+
+			printf( "Mask ERROR: length %lu, offset %lu, phase %lu\n", (unsigned long)len, (unsigned long)offset, (unsigned long)phase );
+			problems++;
+		}
+	}
+	}
+	}
+
+	memcpy( out, in, DATA_LEN );
+	XX_httplib_websocket_mask( out, out, DATA_LEN, key, 0 );
+	XX_httplib_websocket_mask( out, out, DATA_LEN, key, 0 );
+
+	if ( memcmp( in, out, DATA_LEN ) ) {
+
+		printf( "Mask ERROR: masking twice in place does not restore the data\n" );
+		problems++;
+	}
+
+	for (test=0; test<5; test++) {
+
+		t_new = run( out + 1, in, frame[test], key, false );
+		t_old = run( out + 1, in, frame[test], key, true  );
+
+		printf( "%9lu bytes   new %8.1f MB/s   old %8.1f MB/s\n", (unsigned long)frame[test], DATA_LEN * ROUNDS / t_new / 1e6, DATA_LEN * ROUNDS / t_old / 1e6 );
+	}
+
+	free( in  );
+	free( out );
+	free( ref );
+
+	return ( problems > 0 );
+
+}  /* main (benchmask) */
+
+
+
+/*
+ * static double run( char *out, const char *in, size_t len, const unsigned char key[4], bool naive );
+ *
+ * The function run() masks ROUNDS times DATA_LEN bytes in frames of len bytes
+ * and returns the elapsed time in seconds.
+ */
+
+static double run( char *out, const char *in, size_t len, const unsigned char key[4], bool naive ) {
+
+	struct timespec start;
+	struct timespec end;
+	size_t pos;
+	int round;
+
+	clock_gettime( CLOCK_MONOTONIC, & start );
+
+	for (round=0; round<ROUNDS; round++) {
+
+		for (pos=0; pos+len<=DATA_LEN; pos+=len) {
+
+			if ( naive ) naive_mask( out + pos, in + pos, len, key, 0 );
+			else XX_httplib_websocket_mask( out + pos, in + pos, len, key, 0 );
+		}
+	}
+
+	clock_gettime( CLOCK_MONOTONIC, & end );
+
+	return XX_httplib_difftimespec( & end, & start );
+
+}  /* run */
+
+
+
+/*
+ * static void naive_mask( char *out, const char *in, size_t len, const unsigned char key[4], size_t phase );
+ *
+ * The function naive_mask() is the byte by byte masking loop of earlier
+ * versions of the websocket code.
+ */
+
+static void naive_mask( char *out, const char *in, size_t len, const unsigned char key[4], size_t phase ) {
+
+	size_t i;
+
+	for (i=0; i<len; i++) out[i] = in[i] ^ key[(phase+i) % 4];
+
+}  /* naive_mask */
@@ -22,8 +22,8 @@
  */
 
 /**
- * We include the source file so that we have access to the internal private
- * static functions
+ * We include the internal header of the library so that we have access to
+ * the internal functions
  */
 #ifdef _MSC_VER
 #ifndef _CRT_SECURE_NO_WARNINGS
@@ -37,7 +37,7 @@
 #undef MEMORY_DEBUGGING
 #endif
 
-#include "../src/civetweb.c"
+#include "../src/httplib_main.h"
 
 #include <stdlib.h>
 
@@ -667,6 +667,58 @@ START_TEST(test_parse_date_string)
 END_TEST
 
 
+START_TEST(test_buffer_grow_shrink)
+{
+	struct lh_ctx_t ctx;
+	struct lh_con_t conn;
+	int i;
+
+	memset(&ctx, 0, sizeof(ctx));
+	memset(&conn, 0, sizeof(conn));
+	ctx.request_buffer_size = 1024;
+	ctx.max_request_size = 65536;
+
+	/* The first buffer has the configured size */
+	ck_assert(XX_httplib_buffer_grow(&ctx, &conn));
+	ck_assert(conn.buf != NULL);
+	ck_assert_int_eq(conn.buf_size, 1024);
+
+	/* A full buffer doubles in size up to max_request_size, and keeps the
+	 * data which was received already */
+	for (i = 0; i < 6; i++) {
+		memset(conn.buf + conn.data_len,
+		       'a' + i,
+		       (size_t)(conn.buf_size - conn.data_len));
+		conn.data_len = conn.buf_size;
+		ck_assert(XX_httplib_buffer_grow(&ctx, &conn));
+		ck_assert_int_eq(conn.buf_size, 2048 << i);
+		ck_assert_int_eq(conn.data_len, 1024 << i);
+	}
+	ck_assert_int_eq(conn.buf_size, 65536);
+	ck_assert(!XX_httplib_buffer_grow(&ctx, &conn));
+	ck_assert_int_eq(conn.buf[0], 'a');
+	ck_assert_int_eq(conn.buf[1024], 'b');
+	ck_assert_int_eq(conn.buf[16384], 'f');
+
+	/* The buffer can't shrink while it holds more data than fits */
+	XX_httplib_buffer_shrink(&ctx, &conn);
+	ck_assert_int_eq(conn.buf_size, 65536);
+
+	/* After the data has been used, the buffer shrinks back to the
+	 * configured size */
+	conn.data_len = 100;
+	XX_httplib_buffer_shrink(&ctx, &conn);
+	ck_assert_int_eq(conn.buf_size, 1024);
+	ck_assert_int_eq(conn.data_len, 100);
+	ck_assert_int_eq(conn.buf[99], 'a');
+
+	XX_httplib_buffer_release(&ctx, &conn);
+	ck_assert(conn.buf == NULL);
+	ck_assert_int_eq(conn.buf_size, 0);
+}
+END_TEST
+
+
 Suite *
 make_private_suite(void)
 {
@@ -678,6 +730,7 @@ make_private_suite(void)
 	TCase *const tcase_encode_decode = tcase_create("Encode Decode");
 	TCase *const tcase_mask_data = tcase_create("Mask Data");
 	TCase *const tcase_parse_date_string = tcase_create("Date Parsing");
+	TCase *const tcase_buffer = tcase_create("Receive Buffer");
 
 	tcase_add_test(tcase_http_message, test_parse_http_message);
 	tcase_add_test(tcase_http_message, test_should_keep_alive);
@@ -712,6 +765,10 @@ make_private_suite(void)
 	tcase_set_timeout(tcase_mask_data, civetweb_min_test_timeout);
 	suite_add_tcase(suite, tcase_parse_date_string);
 
+	tcase_add_test(tcase_buffer, test_buffer_grow_shrink);
+	tcase_set_timeout(tcase_buffer, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_buffer);
+
 	return suite;
 }
 
@@ -734,6 +791,7 @@ MAIN_PRIVATE(void)
 	test_parse_date_string(0);
 	test_parse_port_string(0);
 	test_parse_http_message(0);
+	test_buffer_grow_shrink(0);
 }
 
 #endif
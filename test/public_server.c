@@ -36,14 +36,16 @@
 #include <sys/stat.h>
 
 #include "public_server.h"
-#include <civetweb.h>
+#include <libhttp.h>
 
 #if defined(_WIN32)
 #include <Windows.h>
 #define test_sleep(x) (Sleep((x)*1000))
+#define test_sleep_ms(x) (Sleep(x))
 #else
 #include <unistd.h>
 #define test_sleep(x) (sleep(x))
+#define test_sleep_ms(x) (usleep((x)*1000))
 #endif
 
 /* This unit test file uses the excellent Check unit testing library.
@@ -2728,6 +2730,1342 @@ START_TEST(test_keep_alive)
 END_TEST
 
 
+static void
+write_test_file(const char *path, int c, size_t len)
+{
+	FILE *f;
+	char buf[256];
+	size_t n;
+
+	memset(buf, c, sizeof(buf));
+	f = fopen(path, "wb");
+	ck_assert(f != NULL);
+	while (len > 0) {
+		n = (len < sizeof(buf)) ? len : sizeof(buf);
+		ck_assert_uint_eq(fwrite(buf, 1, n, f), n);
+		len -= n;
+	}
+	fclose(f);
+}
+
+
+/* Request a static file and return the number of body bytes received. The
+ * Content-Encoding of the response is copied to encoding, or "identity" if
+ * the response has no such header. */
+static int
+get_encoded_file(struct lh_ctx_t *cctx,
+                 int port,
+                 const char *uri,
+                 const char *accept_encoding,
+                 char *encoding,
+                 size_t encoding_len)
+{
+	struct lh_con_t *conn;
+	const struct lh_rqi_t *ri;
+	const char *hdr;
+	char buf[1024];
+	int len, n;
+
+	if (accept_encoding != NULL) {
+		conn = httplib_download(cctx, "127.0.0.1", port, 0,
+		                        "GET %s HTTP/1.1\r\nHost: localhost\r\n"
+		                        "Accept-Encoding: %s\r\n\r\n",
+		                        uri, accept_encoding);
+	} else {
+		conn = httplib_download(cctx, "127.0.0.1", port, 0,
+		                        "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n",
+		                        uri);
+	}
+	ck_assert(conn != NULL);
+	ri = httplib_get_request_info(conn);
+	ck_assert(ri != NULL);
+	ck_assert_str_eq(ri->request_uri, "200");
+
+	/* Every variant depends on Accept-Encoding, also the original file */
+	hdr = httplib_get_header(conn, "Vary");
+	ck_assert(hdr != NULL);
+	ck_assert_str_eq(hdr, "Accept-Encoding");
+
+	hdr = httplib_get_header(conn, "Content-Encoding");
+	snprintf(encoding, encoding_len, "%s", (hdr != NULL) ? hdr : "identity");
+
+	len = 0;
+	while ((n = httplib_read(cctx, conn, buf, sizeof(buf))) > 0) {
+		len += n;
+	}
+
+	hdr = httplib_get_header(conn, "Content-Length");
+	ck_assert(hdr != NULL);
+	ck_assert_int_eq(atoi(hdr), len);
+
+	httplib_close_connection(cctx, conn);
+	return len;
+}
+
+
+START_TEST(test_precompressed_siblings)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8091"},
+	                             {"document_root", "."},
+	                             {"encoding_cache_ttl", "60"},
+	                             {NULL, NULL}};
+	const char *test_file = "test_precompressed.txt";
+	char encoding[32];
+	int len;
+
+	mark_point();
+	write_test_file("test_precompressed.txt", 'a', 1000);
+	write_test_file("test_precompressed.txt.gz", 'g', 300);
+	write_test_file("test_precompressed.txt.br", 'b', 200);
+
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	cctx = httplib_create_client_context(NULL, NULL);
+	ck_assert(cctx != NULL);
+
+	/* No Accept-Encoding header: only identity is acceptable */
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt", NULL,
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "identity");
+	ck_assert_int_eq(len, 1000);
+
+	/* Equal quality: the smallest variant wins */
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt", "gzip, br",
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "br");
+	ck_assert_int_eq(len, 200);
+
+	/* A higher q-value beats a smaller size */
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt",
+	                       "br;q=0.5, gzip;q=0.8",
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "gzip");
+	ck_assert_int_eq(len, 300);
+
+	/* q=0 excludes a coding */
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt",
+	                       "gzip, br;q=0",
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "gzip");
+	ck_assert_int_eq(len, 300);
+
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt",
+	                       "gzip;q=0, br;q=0.000",
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "identity");
+	ck_assert_int_eq(len, 1000);
+
+	/* "*" covers all codings not mentioned explicitly */
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt",
+	                       "*",
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "br");
+	ck_assert_int_eq(len, 200);
+
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt",
+	                       "br;q=0, *;q=0.5",
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "gzip");
+	ck_assert_int_eq(len, 300);
+
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt",
+	                       "identity;q=1, *;q=0",
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "identity");
+	ck_assert_int_eq(len, 1000);
+
+	/* The sibling is replaced while its stat data is still cached: the
+	 * Content-Length must match the file which is actually sent. */
+	write_test_file("test_precompressed.txt.gz", 'G', 5000);
+	len = get_encoded_file(cctx, 8091, "/test_precompressed.txt",
+	                       "gzip",
+	                       encoding, sizeof(encoding));
+	ck_assert_str_eq(encoding, "gzip");
+	ck_assert_int_eq(len, 5000);
+
+	/* Stop the server and clean up */
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+	remove(test_file);
+	remove("test_precompressed.txt.gz");
+	remove("test_precompressed.txt.br");
+}
+END_TEST
+
+
+/* Read the request body with small reads, so that the chunk decoder must
+ * resume in every state, and reply with the number of bytes received and
+ * their sum, or with "error" if httplib_read() failed. */
+static int
+chunked_body_handler(struct lh_ctx_t *ctx, struct lh_con_t *conn, void *cbdata)
+{
+	char buf[7];
+	char reply[64];
+	long total, sum;
+	int n, i;
+
+	(void)cbdata;
+
+	total = 0;
+	sum = 0;
+	while ((n = httplib_read(ctx, conn, buf, sizeof(buf))) > 0) {
+		for (i = 0; i < n; i++) {
+			sum += (unsigned char)buf[i];
+		}
+		total += n;
+	}
+
+	/* The server closes the connection after a malformed body. This must
+	 * be announced, otherwise the client may reuse the connection. */
+	if (n < 0) {
+		snprintf(reply, sizeof(reply), "error");
+	} else {
+		snprintf(reply, sizeof(reply), "%ld %ld", total, sum);
+	}
+
+	httplib_printf(ctx,
+	               conn,
+	               "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n%s\r\n%s",
+	               (int)strlen(reply),
+	               (n < 0) ? "Connection: close\r\n" : "",
+	               reply);
+	return 200;
+}
+
+
+/* Read the request body with httplib_peek_body() and consume it a few bytes
+ * at a time. The reply is the same as of chunked_body_handler(). */
+static int
+chunked_peek_handler(struct lh_ctx_t *ctx, struct lh_con_t *conn, void *cbdata)
+{
+	const char *data;
+	const char *again;
+	char reply[64];
+	size_t len, again_len, i;
+	long total, sum;
+	int ret;
+
+	(void)cbdata;
+
+	total = 0;
+	sum = 0;
+	while ((ret = httplib_peek_body(ctx, conn, &data, &len)) > 0) {
+
+		/* Peeking again without consuming returns the same data */
+		ck_assert_int_eq(httplib_peek_body(ctx, conn, &again, &again_len), 1);
+		ck_assert_ptr_eq(again, data);
+		ck_assert_uint_eq(again_len, len);
+
+		if (len > 3) {
+			len = 3;
+		}
+		for (i = 0; i < len; i++) {
+			sum += (unsigned char)data[i];
+		}
+		total += (long)len;
+		ck_assert_int_eq(httplib_consume_body(ctx, conn, len), 0);
+	}
+
+	if (ret < 0) {
+		snprintf(reply, sizeof(reply), "error");
+	} else {
+		snprintf(reply, sizeof(reply), "%ld %ld", total, sum);
+	}
+
+	httplib_printf(ctx,
+	               conn,
+	               "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n%s\r\n%s",
+	               (int)strlen(reply),
+	               (ret < 0) ? "Connection: close\r\n" : "",
+	               reply);
+	return 200;
+}
+
+
+/* Send a chunked POST request with the body in several parts and a pause
+ * after each part, so that the server receives every part with a separate
+ * read. */
+static void
+send_chunked_request(struct lh_ctx_t *cctx,
+                     struct lh_con_t *conn,
+                     const char *uri,
+                     const char *const *parts)
+{
+	int i;
+
+	ck_assert_int_gt(httplib_printf(cctx,
+	                                conn,
+	                                "POST %s HTTP/1.1\r\nHost: localhost\r\n"
+	                                "Transfer-Encoding: chunked\r\n\r\n",
+	                                uri),
+	                 0);
+	test_sleep_ms(50);
+
+	for (i = 0; parts[i] != NULL; i++) {
+		ck_assert_int_eq(httplib_write(cctx, conn, parts[i], strlen(parts[i])),
+		                 (int)strlen(parts[i]));
+		test_sleep_ms(50);
+	}
+}
+
+
+/* Read the response to a request and return its body as a string */
+static void
+get_response_body(struct lh_ctx_t *cctx,
+                  struct lh_con_t *conn,
+                  char *buf,
+                  size_t buf_len)
+{
+	size_t len;
+	int n;
+
+	ck_assert_int_ge(httplib_get_response(cctx, conn, 10000), 0);
+	ck_assert_str_eq(httplib_get_request_info(conn)->request_uri, "200");
+
+	len = 0;
+	while (len < buf_len - 1
+	       && (n = httplib_read(cctx, conn, buf + len, buf_len - 1 - len)) > 0) {
+		len += (size_t)n;
+	}
+	buf[len] = '\0';
+}
+
+
+START_TEST(test_chunked_request_body)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_con_t *conn;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8092"},
+	                             {"enable_keep_alive", "yes"},
+	                             {NULL, NULL}};
+	char reply[64];
+	char expected[64];
+	long sum;
+	int i, u;
+
+	static const char *const uris[] = {"/chunked", "/peek_chunked", NULL};
+
+	static const char *const extensions[] = {
+	    "5;name=value\r\nhello\r\n6 ; ext=\"quoted;value\"\r\n world\r\n"
+	    "0\r\nX-Trailer: one\r\nX-Other: two\r\n\r\n",
+	    NULL};
+
+	static const char *const split[] = {"5",
+	                                    "\r",
+	                                    "\nhel",
+	                                    "lo\r",
+	                                    "\n6;e",
+	                                    "xt\r\n world",
+	                                    "\r\n0\r",
+	                                    "\nX-Trailer",
+	                                    ": one\r",
+	                                    "\n\r",
+	                                    "\n",
+	                                    NULL};
+
+	static const char *const bad_size[] = {
+	    "5\r\nhello\r\nzz\r\n world\r\n0\r\n\r\n", NULL};
+
+	static const char *const huge_size[] = {
+	    "fffffffffffffffffffff\r\nhello\r\n0\r\n\r\n", NULL};
+
+	static const char *const missing_crlf[] = {
+	    "5\r\nhelloXX6\r\n world\r\n0\r\n\r\n", NULL};
+
+	static const char *const *const errors[] = {bad_size,
+	                                            huge_size,
+	                                            missing_crlf,
+	                                            NULL};
+
+	mark_point();
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	httplib_set_request_handler(ctx, "/chunked", chunked_body_handler, NULL);
+	httplib_set_request_handler(ctx, "/peek_chunked", chunked_peek_handler, NULL);
+	cctx = httplib_create_client_context(NULL, NULL);
+	ck_assert(cctx != NULL);
+
+	sum = 0;
+	for (i = 0; "hello world"[i] != '\0'; i++) {
+		sum += (unsigned char)"hello world"[i];
+	}
+	snprintf(expected, sizeof(expected), "11 %ld", sum);
+
+	for (u = 0; uris[u] != NULL; u++) {
+
+		/* Chunk extensions and trailers are skipped. The trailers must
+		 * be consumed completely, so that the next request on the same
+		 * connection is parsed correctly. */
+		conn = httplib_connect_client(cctx, "127.0.0.1", 8092, 0);
+		ck_assert(conn != NULL);
+		send_chunked_request(cctx, conn, uris[u], extensions);
+		get_response_body(cctx, conn, reply, sizeof(reply));
+		ck_assert_str_eq(reply, expected);
+
+		/* Every CRLF and the trailers are split over several reads */
+		send_chunked_request(cctx, conn, uris[u], split);
+		get_response_body(cctx, conn, reply, sizeof(reply));
+		ck_assert_str_eq(reply, expected);
+		httplib_close_connection(cctx, conn);
+
+		/* Malformed chunk sizes and a missing CRLF after the data are
+		 * errors */
+		for (i = 0; errors[i] != NULL; i++) {
+			conn = httplib_connect_client(cctx, "127.0.0.1", 8092, 0);
+			ck_assert(conn != NULL);
+			send_chunked_request(cctx, conn, uris[u], errors[i]);
+			get_response_body(cctx, conn, reply, sizeof(reply));
+			ck_assert_str_eq(reply, "error");
+			httplib_close_connection(cctx, conn);
+		}
+	}
+
+	/* Stop the server and clean up */
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+}
+END_TEST
+
+
+struct form_test_result {
+	char reply[256];
+	char name[32];
+	size_t len;
+	size_t field_len;
+	unsigned long field_sum;
+};
+
+
+static int
+form_field_found(const char *key,
+                 const char *filename,
+                 char *path,
+                 size_t pathlen,
+                 void *user_data)
+{
+	struct form_test_result *res = (struct form_test_result *)user_data;
+
+	(void)key;
+	(void)filename;
+	(void)path;
+	(void)pathlen;
+
+	res->len = strlen(res->reply);
+	res->field_len = 0;
+	res->field_sum = 0;
+	return FORM_FIELD_STORAGE_GET;
+}
+
+
+/* The value of a field may be passed in several blocks. Only the first block
+ * comes with the name of the field. */
+static int
+form_field_get(const char *key,
+               const char *value,
+               size_t valuelen,
+               void *user_data)
+{
+	struct form_test_result *res = (struct form_test_result *)user_data;
+	size_t i;
+
+	if (res->field_len == 0) {
+		snprintf(res->name, sizeof(res->name), "%s", key);
+	}
+	for (i = 0; i < valuelen; i++) {
+		res->field_sum = res->field_sum * 31 + (unsigned char)value[i];
+	}
+	res->field_len += valuelen;
+
+	/* One line per field, which is rewritten after every block */
+	snprintf(res->reply + res->len,
+	         sizeof(res->reply) - res->len,
+	         "%s %lu %lu\n",
+	         res->name,
+	         (unsigned long)res->field_len,
+	         res->field_sum);
+	return 0;
+}
+
+
+static int
+form_request_handler(struct lh_ctx_t *ctx, struct lh_con_t *conn, void *cbdata)
+{
+	struct httplib_form_data_handler fdh;
+	struct form_test_result res;
+	int ret;
+
+	(void)cbdata;
+
+	memset(&res, 0, sizeof(res));
+	fdh.field_found = form_field_found;
+	fdh.field_get = form_field_get;
+	fdh.field_store = NULL;
+	fdh.user_data = &res;
+
+	ret = httplib_handle_form_request(ctx, conn, &fdh);
+	if (ret < 0) {
+		snprintf(res.reply, sizeof(res.reply), "error\n");
+	}
+
+	httplib_printf(ctx,
+	               conn,
+	               "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n"
+	               "Connection: close\r\n\r\n%s",
+	               (int)strlen(res.reply),
+	               res.reply);
+	return 200;
+}
+
+
+START_TEST(test_multipart_boundary_split)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_con_t *conn;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8093"}, {NULL, NULL}};
+	const char *boundary = "----TestBoundary7MA4YWxkTrZu0gW";
+	const char *second = "second value";
+	char head[128];
+	char tail[256];
+	char reply[256];
+	char expected[256];
+	char *value;
+	size_t head_len, tail_len, value_len, body_len, i;
+	unsigned long sum;
+	int offset;
+
+	mark_point();
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	httplib_set_request_handler(ctx, "/form", form_request_handler, NULL);
+	cctx = httplib_create_client_context(NULL, NULL);
+	ck_assert(cctx != NULL);
+
+	head_len = (size_t)snprintf(head,
+	                            sizeof(head),
+	                            "--%s\r\nContent-Disposition: form-data; "
+	                            "name=\"first\"\r\n\r\n",
+	                            boundary);
+	tail_len = (size_t)snprintf(tail,
+	                            sizeof(tail),
+	                            "\r\n--%s\r\nContent-Disposition: form-data; "
+	                            "name=\"second\"\r\n\r\n%s\r\n--%s--\r\n",
+	                            boundary,
+	                            second,
+	                            boundary);
+
+	/* The parser reads the body in blocks of 64 kB, the first one after the
+	 * CRLF which is prepended to the body. Let the delimiter after the first
+	 * field start at every offset around the end of that block. The value
+	 * contains partial delimiters which must not be taken for the real one.
+	 */
+	value = (char *)malloc(65536 + 64);
+	ck_assert(value != NULL);
+
+	for (offset = -48; offset <= 4; offset++) {
+
+		value_len = (size_t)(65536 - 2 - (int)head_len + offset);
+		for (i = 0; i < value_len; i++) {
+			value[i] = (char)('a' + i % 26);
+		}
+		for (i = 500; i + 40 < value_len; i += 4099) {
+			memcpy(value + i, "\r\n--", 4);
+			memcpy(value + i + 4, boundary, i % strlen(boundary));
+		}
+		memcpy(value + value_len - 20, "\r\n--", 4);
+		memcpy(value + value_len - 16, boundary, 16);
+
+		sum = 0;
+		for (i = 0; i < value_len; i++) {
+			sum = sum * 31 + (unsigned char)value[i];
+		}
+		snprintf(expected,
+		         sizeof(expected),
+		         "first %lu %lu\nsecond %lu ",
+		         (unsigned long)value_len,
+		         sum,
+		         (unsigned long)strlen(second));
+		sum = 0;
+		for (i = 0; second[i] != '\0'; i++) {
+			sum = sum * 31 + (unsigned char)second[i];
+		}
+		snprintf(expected + strlen(expected),
+		         sizeof(expected) - strlen(expected),
+		         "%lu\n",
+		         sum);
+
+		body_len = head_len + value_len + tail_len;
+		conn = httplib_connect_client(cctx, "127.0.0.1", 8093, 0);
+		ck_assert(conn != NULL);
+		httplib_printf(cctx,
+		               conn,
+		               "POST /form HTTP/1.1\r\nHost: localhost\r\n"
+		               "Content-Type: multipart/form-data; boundary=%s\r\n"
+		               "Content-Length: %lu\r\n\r\n",
+		               boundary,
+		               (unsigned long)body_len);
+		ck_assert_int_eq(httplib_write(cctx, conn, head, head_len), (int)head_len);
+		ck_assert_int_eq(httplib_write(cctx, conn, value, value_len),
+		                 (int)value_len);
+		ck_assert_int_eq(httplib_write(cctx, conn, tail, tail_len), (int)tail_len);
+
+		get_response_body(cctx, conn, reply, sizeof(reply));
+		ck_assert_str_eq(reply, expected);
+		httplib_close_connection(cctx, conn);
+	}
+
+	/* Stop the server and clean up */
+	free(value);
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+}
+END_TEST
+
+
+#if defined(USE_ZLIB)
+struct deflate_test_state {
+	char *data;
+	size_t len;
+	size_t size;
+	volatile int messages;
+};
+
+
+static int
+deflate_offer_check(struct lh_ctx_t *ctx, struct lh_con_t *conn, void *cbdata)
+{
+	const char *ext;
+
+	(void)ctx;
+	(void)cbdata;
+
+	/* The client must offer the extension */
+	ext = httplib_get_header(conn, "Sec-WebSocket-Extensions");
+	ck_assert(ext != NULL);
+	ck_assert(strstr(ext, "permessage-deflate") != NULL);
+
+	return 0;
+}
+
+
+static int
+deflate_echo_data(struct lh_ctx_t *ctx,
+                  struct lh_con_t *conn,
+                  int bits,
+                  char *data,
+                  size_t len,
+                  void *cbdata)
+{
+	(void)cbdata;
+
+	if ((bits & 0x0f) == WEBSOCKET_OPCODE_CONNECTION_CLOSE) {
+		return 0;
+	}
+	httplib_websocket_write(ctx, conn, bits & 0x0f, data, len);
+	return 1;
+}
+
+
+static int
+deflate_client_data(struct lh_ctx_t *ctx,
+                    struct lh_con_t *conn,
+                    int bits,
+                    char *data,
+                    size_t len,
+                    void *cbdata)
+{
+	struct deflate_test_state *state;
+
+	(void)conn;
+	(void)cbdata;
+
+	/* The user data of a websocket client is kept in its context */
+	state = (struct deflate_test_state *)httplib_get_user_data(ctx);
+
+	if ((bits & 0x0f) == WEBSOCKET_OPCODE_CONNECTION_CLOSE) {
+		return 0;
+	}
+	ck_assert_uint_le(state->len + len, state->size);
+	memcpy(state->data + state->len, data, len);
+	state->len += len;
+	state->messages++;
+	return 1;
+}
+
+
+/* Send a message to the echo server and wait until it comes back */
+static void
+deflate_round_trip(struct lh_ctx_t *cctx,
+                   struct lh_con_t *conn,
+                   struct deflate_test_state *state,
+                   int opcode,
+                   const char *data,
+                   size_t len)
+{
+	int expected, i;
+
+	state->len = 0;
+	expected = state->messages + 1;
+	ck_assert_int_gt(
+	    httplib_websocket_client_write(cctx, conn, opcode, data, len), 0);
+
+	for (i = 0; i < 1000 && state->messages < expected; i++) {
+		test_sleep_ms(10);
+	}
+	ck_assert_int_eq(state->messages, expected);
+	ck_assert_uint_eq(state->len, len);
+	ck_assert(memcmp(state->data, data, len) == 0);
+}
+#endif
+
+
+START_TEST(test_websocket_deflate)
+{
+#if defined(USE_ZLIB)
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_con_t *conn;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8094"},
+	                             {"websocket_max_message_size", "1048576"},
+	                             {NULL, NULL}};
+	struct deflate_test_state state;
+	const char *ext;
+	char *text;
+	char *binary;
+	size_t i;
+	uint32_t rnd;
+
+	mark_point();
+	memset(&state, 0, sizeof(state));
+	state.size = 1048576;
+	state.data = (char *)malloc(state.size);
+	text = (char *)malloc(200000);
+	binary = (char *)malloc(65536);
+	ck_assert(state.data != NULL && text != NULL && binary != NULL);
+
+	for (i = 0; i < 200000; i++) {
+		text[i] = "The quick brown fox jumps over the lazy dog. "[i % 45];
+	}
+	rnd = 12345;
+	for (i = 0; i < 65536; i++) {
+		rnd = rnd * 1103515245 + 12345;
+		binary[i] = (char)(rnd >> 16);
+	}
+
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	httplib_set_websocket_handler(ctx,
+	                              "/deflate",
+	                              deflate_offer_check,
+	                              NULL,
+	                              deflate_echo_data,
+	                              NULL,
+	                              NULL);
+	cctx = httplib_create_client_context(NULL, NULL);
+	ck_assert(cctx != NULL);
+
+	conn = httplib_connect_websocket_client(cctx,
+	                                        "127.0.0.1",
+	                                        8094,
+	                                        0,
+	                                        "/deflate",
+	                                        NULL,
+	                                        deflate_client_data,
+	                                        NULL,
+	                                        &state);
+	ck_assert(conn != NULL);
+
+	/* The server must accept the offer */
+	ext = httplib_get_header(conn, "Sec-WebSocket-Extensions");
+	ck_assert(ext != NULL);
+	ck_assert(strstr(ext, "permessage-deflate") != NULL);
+
+	/* Short messages are sent uncompressed, larger ones compressed. The
+	 * repeated text messages use the sliding window of the previous one. */
+	deflate_round_trip(cctx, conn, &state, WEBSOCKET_OPCODE_TEXT, "hello", 5);
+	deflate_round_trip(cctx, conn, &state, WEBSOCKET_OPCODE_TEXT, text, 200000);
+	deflate_round_trip(cctx, conn, &state, WEBSOCKET_OPCODE_BINARY, binary, 65536);
+	deflate_round_trip(cctx, conn, &state, WEBSOCKET_OPCODE_TEXT, text, 200000);
+	deflate_round_trip(cctx, conn, &state, WEBSOCKET_OPCODE_TEXT, text + 7, 1000);
+
+	/* Stop the server and clean up */
+	httplib_close_connection(cctx, conn);
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+	free(state.data);
+	free(text);
+	free(binary);
+#endif
+}
+END_TEST
+
+
+struct timer_test_state {
+	volatile int calls;
+	int max_calls;
+	uint64_t id;
+	int cancel_result;
+};
+
+
+static bool
+timer_count_handler(struct lh_ctx_t *ctx, void *cbdata)
+{
+	struct timer_test_state *state = (struct timer_test_state *)cbdata;
+
+	(void)ctx;
+
+	state->calls++;
+	return (state->max_calls == 0 || state->calls < state->max_calls);
+}
+
+
+static bool
+timer_self_cancel_handler(struct lh_ctx_t *ctx, void *cbdata)
+{
+	struct timer_test_state *state = (struct timer_test_state *)cbdata;
+
+	state->calls++;
+	if (state->calls == state->max_calls) {
+		/* Must return immediately instead of waiting for itself */
+		state->cancel_result = httplib_timer_cancel(ctx, state->id);
+	}
+	return true;
+}
+
+
+START_TEST(test_timers)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8095"}, {NULL, NULL}};
+	struct timer_test_state once, periodic, stopped, self, pending, reused;
+	uint64_t stale_id;
+	int calls, i;
+
+	mark_point();
+	memset(&once, 0, sizeof(once));
+	memset(&periodic, 0, sizeof(periodic));
+	memset(&stopped, 0, sizeof(stopped));
+	memset(&self, 0, sizeof(self));
+	memset(&pending, 0, sizeof(pending));
+	memset(&reused, 0, sizeof(reused));
+
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+
+	/* A one-shot timer fires once and can't be cancelled afterwards */
+	once.id = httplib_timer_add(ctx, 50, 0, timer_count_handler, &once);
+	ck_assert(once.id != 0);
+
+	/* A repeating timer is called until it is cancelled */
+	periodic.id = httplib_timer_add(ctx, 10, 20, timer_count_handler, &periodic);
+	ck_assert(periodic.id != 0);
+
+	/* A repeating timer stops when its handler returns false */
+	stopped.max_calls = 3;
+	stopped.id = httplib_timer_add(ctx, 10, 10, timer_count_handler, &stopped);
+	ck_assert(stopped.id != 0);
+
+	/* A handler can cancel its own timer */
+	self.max_calls = 2;
+	self.cancel_result = 1;
+	self.id = httplib_timer_add(ctx, 10, 10, timer_self_cancel_handler, &self);
+	ck_assert(self.id != 0);
+
+	/* A timer which is cancelled before it is due is never called */
+	pending.id = httplib_timer_add(ctx, 200, 0, timer_count_handler, &pending);
+	ck_assert(pending.id != 0);
+	ck_assert_int_eq(httplib_timer_cancel(ctx, pending.id), 0);
+	ck_assert_int_eq(httplib_timer_cancel(ctx, pending.id), -1);
+
+	test_sleep_ms(400);
+
+	ck_assert_int_eq(once.calls, 1);
+	ck_assert_int_eq(httplib_timer_cancel(ctx, once.id), -1);
+
+	ck_assert_int_eq(stopped.calls, 3);
+	ck_assert_int_eq(httplib_timer_cancel(ctx, stopped.id), -1);
+
+	ck_assert_int_eq(self.calls, 2);
+	ck_assert_int_eq(self.cancel_result, 0);
+	ck_assert_int_eq(httplib_timer_cancel(ctx, self.id), -1);
+
+	ck_assert_int_eq(pending.calls, 0);
+
+	ck_assert_int_ge(periodic.calls, 5);
+	ck_assert_int_eq(httplib_timer_cancel(ctx, periodic.id), 0);
+	calls = periodic.calls;
+	test_sleep_ms(100);
+	ck_assert_int_eq(periodic.calls, calls);
+	ck_assert_int_eq(httplib_timer_cancel(ctx, periodic.id), -1);
+
+	/* All timers are gone, so new timers reuse their slots. The ids of
+	 * the old timers must not cancel the new ones. */
+	stale_id = once.id;
+	for (i = 0; i < 5; i++) {
+		reused.id = httplib_timer_add(ctx, 100, 0, timer_count_handler, &reused);
+		ck_assert(reused.id != 0);
+		ck_assert(reused.id != stale_id);
+		ck_assert_int_eq(httplib_timer_cancel(ctx, stale_id), -1);
+		ck_assert_int_eq(httplib_timer_cancel(ctx, periodic.id), -1);
+		ck_assert_int_eq(httplib_timer_cancel(ctx, reused.id), 0);
+		stale_id = reused.id;
+	}
+	reused.id = httplib_timer_add(ctx, 50, 0, timer_count_handler, &reused);
+	ck_assert(reused.id != 0);
+	ck_assert_int_eq(httplib_timer_cancel(ctx, stale_id), -1);
+	test_sleep_ms(200);
+	ck_assert_int_eq(reused.calls, 1);
+
+	/* Stop the server and clean up */
+	httplib_stop(ctx);
+}
+END_TEST
+
+
+START_TEST(test_slow_request_headers)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_con_t *conn;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8096"},
+	                             {"request_timeout", "1000"},
+	                             {NULL, NULL}};
+	struct lh_tmo_t stats;
+	const char *head = "GET / HTTP/1.1\r\nHost: localhost\r\nX-Slow: ";
+	int i;
+
+	mark_point();
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	cctx = httplib_create_client_context(NULL, NULL);
+	ck_assert(cctx != NULL);
+
+	/* A client which sends a header byte every 200 ms never lets a read
+	 * time out, but the headers must be complete within request_timeout.
+	 * The server rejects the incomplete request and closes the connection,
+	 * after which writing fails. */
+	conn = httplib_connect_client(cctx, "127.0.0.1", 8096, 0);
+	ck_assert(conn != NULL);
+	ck_assert_int_eq(httplib_write(cctx, conn, head, strlen(head)),
+	                 (int)strlen(head));
+	for (i = 0; i < 25; i++) {
+		test_sleep_ms(200);
+		if (httplib_write(cctx, conn, "x", 1) != 1) {
+			break;
+		}
+	}
+	ck_assert_int_lt(i, 25);
+	ck_assert_int_ge(httplib_get_response(cctx, conn, 1000), 0);
+	ck_assert_str_eq(httplib_get_request_info(conn)->request_uri, "400");
+	httplib_close_connection(cctx, conn);
+
+	memset(&stats, 0, sizeof(stats));
+	ck_assert_int_eq(httplib_get_timeout_stats(ctx, &stats), 0);
+	ck_assert_uint_eq(stats.header_timeouts, 1);
+	ck_assert_uint_eq(stats.body_timeouts, 0);
+
+	/* Other clients are still served */
+	conn = httplib_download(cctx, "127.0.0.1", 8096, 0,
+	                        "GET /not_there HTTP/1.1\r\nHost: localhost\r\n"
+	                        "Connection: close\r\n\r\n");
+	ck_assert(conn != NULL);
+	ck_assert_str_eq(httplib_get_request_info(conn)->request_uri, "404");
+	httplib_close_connection(cctx, conn);
+
+	/* Stop the server and clean up */
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+}
+END_TEST
+
+
+/* Reply with the client port of the connection, which tells the client if
+ * a request was sent on a new connection. */
+static int
+client_port_handler(struct lh_ctx_t *ctx, struct lh_con_t *conn, void *cbdata)
+{
+	char reply[32];
+
+	(void)cbdata;
+
+	snprintf(reply,
+	         sizeof(reply),
+	         "%d",
+	         httplib_get_request_info(conn)->remote_port);
+	httplib_printf(ctx,
+	               conn,
+	               "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n%s",
+	               (int)strlen(reply),
+	               reply);
+	return 200;
+}
+
+
+static int
+get_client_port(struct lh_ctx_t *cctx, int port)
+{
+	struct lh_con_t *conn;
+	char reply[32];
+
+	conn = httplib_download(cctx, "127.0.0.1", port, 0,
+	                        "GET /port HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	ck_assert(conn != NULL);
+	ck_assert_str_eq(httplib_get_request_info(conn)->request_uri, "200");
+	ck_assert_int_gt(httplib_read(cctx, conn, reply, sizeof(reply) - 1), 0);
+	reply[sizeof(reply) - 1] = '\0';
+	httplib_close_connection(cctx, conn);
+	return atoi(reply);
+}
+
+
+START_TEST(test_client_pool)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_con_t *conn;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8097"},
+	                             {"enable_keep_alive", "yes"},
+	                             {"keep_alive_timeout", "200"},
+	                             {NULL, NULL}};
+	char reply[32];
+	int first, port;
+
+	mark_point();
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	httplib_set_request_handler(ctx, "/port", client_port_handler, NULL);
+	cctx = httplib_create_client_context(NULL, NULL);
+	ck_assert(cctx != NULL);
+
+	/* A closed connection is parked and used again for the same server */
+	first = get_client_port(cctx, 8097);
+	ck_assert_int_gt(first, 0);
+	port = get_client_port(cctx, 8097);
+	ck_assert_int_eq(port, first);
+
+	/* The server closes the idle connection after its keep-alive timeout.
+	 * The parked connection must be discarded and a new one opened. */
+	test_sleep_ms(600);
+	port = get_client_port(cctx, 8097);
+	ck_assert_int_gt(port, 0);
+	ck_assert_int_ne(port, first);
+	first = port;
+
+	test_sleep_ms(600);
+	conn = httplib_connect_client(cctx, "127.0.0.1", 8097, 0);
+	ck_assert(conn != NULL);
+	httplib_printf(cctx, conn, "GET /port HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	get_response_body(cctx, conn, reply, sizeof(reply));
+	ck_assert_int_gt(atoi(reply), 0);
+	ck_assert_int_ne(atoi(reply), first);
+	httplib_close_connection(cctx, conn);
+
+	/* Stop the server and clean up */
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+}
+END_TEST
+
+
+/* Send a request to a server by its name, and return the status code of the
+ * response, or 0 if no connection could be made. */
+static int
+get_status_by_name(struct lh_ctx_t *cctx, const char *host, int port)
+{
+	struct lh_con_t *conn;
+	int status;
+
+	conn = httplib_download(cctx, host, port, 0,
+	                        "GET /port HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	if (conn == NULL) {
+		return 0;
+	}
+	status = atoi(httplib_get_request_info(conn)->request_uri);
+	httplib_close_connection(cctx, conn);
+	return status;
+}
+
+
+START_TEST(test_client_hosts_file)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8098"}, {NULL, NULL}};
+	struct lh_opt_t CLIENT_OPTIONS[] = {{"hosts_file", "test_hosts.txt"},
+	                                    {"resolver_cache_ttl", "60"},
+	                                    {"resolver_negative_ttl", "1"},
+	                                    {"resolver_timeout", "5000"},
+	                                    {"client_pool_max_per_host", "0"},
+	                                    {NULL, NULL}};
+	FILE *f;
+
+	mark_point();
+
+	/* The names use the reserved .invalid domain, so that they are never
+	 * found by a name server and the test works without network access. */
+	f = fopen("test_hosts.txt", "w");
+	ck_assert(f != NULL);
+	fprintf(f, "# test hosts\n127.0.0.1\tcached.invalid other.invalid\n");
+	fclose(f);
+
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	httplib_set_request_handler(ctx, "/port", client_port_handler, NULL);
+	cctx = httplib_create_client_context(NULL, CLIENT_OPTIONS);
+	ck_assert(cctx != NULL);
+
+	ck_assert_int_eq(get_status_by_name(cctx, "cached.invalid", 8098), 200);
+	ck_assert_int_eq(get_status_by_name(cctx, "fresh.invalid", 8098), 0);
+
+	/* Change the hosts file. The address of cached.invalid is taken from
+	 * the cache, and fresh.invalid stays unknown until the negative entry
+	 * has expired. */
+	f = fopen("test_hosts.txt", "w");
+	ck_assert(f != NULL);
+	fprintf(f, "127.0.0.1 fresh.invalid\n");
+	fclose(f);
+
+	ck_assert_int_eq(get_status_by_name(cctx, "cached.invalid", 8098), 200);
+	ck_assert_int_eq(get_status_by_name(cctx, "fresh.invalid", 8098), 0);
+
+	test_sleep_ms(1500);
+	ck_assert_int_eq(get_status_by_name(cctx, "fresh.invalid", 8098), 200);
+	ck_assert_int_eq(get_status_by_name(cctx, "cached.invalid", 8098), 200);
+
+	/* Names which are in neither the hosts file nor the cache fail */
+	ck_assert_int_eq(get_status_by_name(cctx, "other.invalid", 8098), 0);
+	ck_assert_int_eq(get_status_by_name(cctx, "unknown.invalid", 8098), 0);
+
+	/* Stop the server and clean up */
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+	remove("test_hosts.txt");
+}
+END_TEST
+
+
+/* Reply with the query string, padded with dots to the length given in the
+ * query string. Earlier requests take longer to answer than later ones. */
+static int
+pipeline_handler(struct lh_ctx_t *ctx, struct lh_con_t *conn, void *cbdata)
+{
+	const struct lh_rqi_t *ri = httplib_get_request_info(conn);
+	char *body;
+	int seq, size, len;
+
+	(void)cbdata;
+
+	ck_assert(ri->query_string != NULL);
+	ck_assert_int_eq(sscanf(ri->query_string, "seq=%d&size=%d", &seq, &size),
+	                 2);
+	test_sleep_ms(10 * (10 - seq));
+
+	len = (int)strlen(ri->query_string);
+	if (size < len) {
+		size = len;
+	}
+	body = (char *)malloc((size_t)size);
+	ck_assert(body != NULL);
+	memcpy(body, ri->query_string, (size_t)len);
+	memset(body + len, '.', (size_t)(size - len));
+
+	httplib_printf(ctx,
+	               conn,
+	               "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n",
+	               size);
+	if (strcmp(ri->request_method, "HEAD")) {
+		httplib_write(ctx, conn, body, (size_t)size);
+	}
+	free(body);
+	return 200;
+}
+
+
+START_TEST(test_pipelined_requests)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_con_t *conn;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8099"},
+	                             {"enable_keep_alive", "yes"},
+	                             {NULL, NULL}};
+	struct lh_req_t requests[10];
+	char uris[10][64];
+	char buf[1024];
+	char expected[64];
+	const char *status;
+	int sizes[10] = {10, 100000, 0, 20, 0, 70000, 5, 0, 1, 30};
+	int i, n, len, size;
+
+	mark_point();
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	httplib_set_request_handler(ctx, "/pipeline", pipeline_handler, NULL);
+	cctx = httplib_create_client_context(NULL, NULL);
+	ck_assert(cctx != NULL);
+
+	/* Requests 4 and 7 are HEAD requests whose responses have no body.
+	 * The last request gets an error response, after which the server
+	 * closes the connection. */
+	memset(requests, 0, sizeof(requests));
+	for (i = 0; i < 10; i++) {
+		snprintf(uris[i],
+		         sizeof(uris[i]),
+		         "/pipeline?seq=%d&size=%d",
+		         i,
+		         sizes[i]);
+		requests[i].method = (i == 4 || i == 7) ? "HEAD" : "GET";
+		requests[i].uri = (i == 9) ? "/no_such_file" : uris[i];
+		requests[i].host = "localhost";
+	}
+
+	conn = httplib_connect_client(cctx, "127.0.0.1", 8099, 0);
+	ck_assert(conn != NULL);
+	ck_assert_int_eq(httplib_pipeline_send(cctx, conn, requests, 10), 10);
+
+	/* The responses must arrive in the order of the requests */
+	for (i = 0; i < 10; i++) {
+
+		ck_assert_int_ge(httplib_get_response(cctx, conn, 10000), 0);
+		status = httplib_get_request_info(conn)->request_uri;
+
+		len = 0;
+		while ((n = httplib_read(cctx, conn, buf, sizeof(buf))) > 0) {
+			if (len == 0 && i != 9) {
+				snprintf(expected,
+				         sizeof(expected),
+				         "seq=%d&size=%d",
+				         i,
+				         sizes[i]);
+				ck_assert_int_ge(n, (int)strlen(expected));
+				ck_assert(!memcmp(buf, expected, strlen(expected)));
+			}
+			len += n;
+		}
+		ck_assert_int_eq(n, 0);
+
+		if (i == 9) {
+			ck_assert_str_eq(status, "404");
+			continue;
+		}
+		ck_assert_str_eq(status, "200");
+
+		snprintf(expected, sizeof(expected), "seq=%d&size=%d", i, sizes[i]);
+		size = (sizes[i] > (int)strlen(expected)) ? sizes[i]
+		                                          : (int)strlen(expected);
+		if (i == 4 || i == 7) {
+			ck_assert_int_eq(len, 0);
+			ck_assert_int_eq(atoi(httplib_get_header(conn, "Content-Length")),
+			                 size);
+		} else {
+			ck_assert_int_eq(len, size);
+		}
+	}
+	httplib_close_connection(cctx, conn);
+
+	/* Stop the server and clean up */
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+}
+END_TEST
+
+
+/* Reply with the length of the X-Large header of the request */
+static int
+large_header_handler(struct lh_ctx_t *ctx, struct lh_con_t *conn, void *cbdata)
+{
+	const char *value;
+	char reply[32];
+
+	(void)cbdata;
+
+	value = httplib_get_header(conn, "X-Large");
+	snprintf(reply,
+	         sizeof(reply),
+	         "%d",
+	         (value != NULL) ? (int)strlen(value) : -1);
+	httplib_printf(ctx,
+	               conn,
+	               "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n%s",
+	               (int)strlen(reply),
+	               reply);
+	return 200;
+}
+
+
+static void
+send_large_header(struct lh_ctx_t *cctx, struct lh_con_t *conn, size_t len)
+{
+	char *value;
+
+	value = (char *)malloc(len + 1);
+	ck_assert(value != NULL);
+	memset(value, 'v', len);
+	value[len] = '\0';
+	httplib_printf(cctx,
+	               conn,
+	               "GET /large HTTP/1.1\r\nHost: localhost\r\nX-Large: ");
+	ck_assert_int_eq(httplib_write(cctx, conn, value, len), (int)len);
+	httplib_printf(cctx, conn, "\r\n\r\n");
+	free(value);
+}
+
+
+START_TEST(test_large_request_headers)
+{
+	struct lh_ctx_t *ctx;
+	struct lh_ctx_t *cctx;
+	struct lh_con_t *conn;
+	struct lh_opt_t OPTIONS[] = {{"listening_ports", "8100"},
+	                             {"enable_keep_alive", "yes"},
+	                             {"request_buffer_size", "1024"},
+	                             {"max_request_size", "65536"},
+	                             {NULL, NULL}};
+	char reply[32];
+
+	mark_point();
+	ctx = httplib_start(NULL, NULL, OPTIONS);
+	ck_assert(ctx != NULL);
+	httplib_set_request_handler(ctx, "/large", large_header_handler, NULL);
+	cctx = httplib_create_client_context(NULL, NULL);
+	ck_assert(cctx != NULL);
+
+	/* The receive buffer starts at 1 kB and grows for larger requests */
+	conn = httplib_connect_client(cctx, "127.0.0.1", 8100, 0);
+	ck_assert(conn != NULL);
+	send_large_header(cctx, conn, 40000);
+	get_response_body(cctx, conn, reply, sizeof(reply));
+	ck_assert_str_eq(reply, "40000");
+
+	/* The connection can be used for smaller requests afterwards */
+	send_large_header(cctx, conn, 10);
+	get_response_body(cctx, conn, reply, sizeof(reply));
+	ck_assert_str_eq(reply, "10");
+
+	send_large_header(cctx, conn, 20000);
+	get_response_body(cctx, conn, reply, sizeof(reply));
+	ck_assert_str_eq(reply, "20000");
+	httplib_close_connection(cctx, conn);
+
+	/* Requests larger than max_request_size are refused */
+	conn = httplib_connect_client(cctx, "127.0.0.1", 8100, 0);
+	ck_assert(conn != NULL);
+	send_large_header(cctx, conn, 70000);
+	ck_assert_int_ge(httplib_get_response(cctx, conn, 10000), 0);
+	ck_assert_str_eq(httplib_get_request_info(conn)->request_uri, "413");
+	httplib_close_connection(cctx, conn);
+
+	/* Stop the server and clean up */
+	httplib_destroy_client_context(cctx);
+	httplib_stop(ctx);
+}
+END_TEST
+
+
 Suite *
 make_public_server_suite(void)
 {
@@ -2742,6 +4080,16 @@ make_public_server_suite(void)
 	TCase *const tcase_handle_form = tcase_create("Handle Form");
 	TCase *const tcase_http_auth = tcase_create("HTTP Authentication");
 	TCase *const tcase_keep_alive = tcase_create("HTTP Keep Alive");
+	TCase *const tcase_precompressed = tcase_create("Precompressed Files");
+	TCase *const tcase_chunked_body = tcase_create("Chunked Request Body");
+	TCase *const tcase_multipart = tcase_create("Multipart Form Data");
+	TCase *const tcase_ws_deflate = tcase_create("Websocket Compression");
+	TCase *const tcase_timers = tcase_create("Timers");
+	TCase *const tcase_slow_headers = tcase_create("Slow Request Headers");
+	TCase *const tcase_client_pool = tcase_create("Client Connection Pool");
+	TCase *const tcase_hosts_file = tcase_create("Client Hosts File");
+	TCase *const tcase_pipelining = tcase_create("HTTP Pipelining");
+	TCase *const tcase_large_headers = tcase_create("Large Request Headers");
 
 	tcase_add_test(tcase_checktestenv, test_the_test_environment);
 	tcase_set_timeout(tcase_checktestenv, civetweb_min_test_timeout);
@@ -2779,6 +4127,46 @@ make_public_server_suite(void)
 	tcase_set_timeout(tcase_keep_alive, 300);
 	suite_add_tcase(suite, tcase_keep_alive);
 
+	tcase_add_test(tcase_precompressed, test_precompressed_siblings);
+	tcase_set_timeout(tcase_precompressed, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_precompressed);
+
+	tcase_add_test(tcase_chunked_body, test_chunked_request_body);
+	tcase_set_timeout(tcase_chunked_body, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_chunked_body);
+
+	tcase_add_test(tcase_multipart, test_multipart_boundary_split);
+	tcase_set_timeout(tcase_multipart, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_multipart);
+
+	tcase_add_test(tcase_ws_deflate, test_websocket_deflate);
+	tcase_set_timeout(tcase_ws_deflate, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_ws_deflate);
+
+	tcase_add_test(tcase_timers, test_timers);
+	tcase_set_timeout(tcase_timers, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_timers);
+
+	tcase_add_test(tcase_slow_headers, test_slow_request_headers);
+	tcase_set_timeout(tcase_slow_headers, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_slow_headers);
+
+	tcase_add_test(tcase_client_pool, test_client_pool);
+	tcase_set_timeout(tcase_client_pool, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_client_pool);
+
+	tcase_add_test(tcase_hosts_file, test_client_hosts_file);
+	tcase_set_timeout(tcase_hosts_file, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_hosts_file);
+
+	tcase_add_test(tcase_pipelining, test_pipelined_requests);
+	tcase_set_timeout(tcase_pipelining, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_pipelining);
+
+	tcase_add_test(tcase_large_headers, test_large_request_headers);
+	tcase_set_timeout(tcase_large_headers, civetweb_min_test_timeout);
+	suite_add_tcase(suite, tcase_large_headers);
+
 	return suite;
 }
 
@@ -2802,6 +4190,16 @@ MAIN_PUBLIC_SERVER(void)
 	// test_handle_form(0);
 	// test_http_auth(0);
 	test_keep_alive(0);
+	test_precompressed_siblings(0);
+	test_chunked_request_body(0);
+	test_multipart_boundary_split(0);
+	test_websocket_deflate(0);
+	test_timers(0);
+	test_slow_request_headers(0);
+	test_client_pool(0);
+	test_client_hosts_file(0);
+	test_pipelined_requests(0);
+	test_large_request_headers(0);
 
 	printf("\nok: %i\nfailed: %i\n\n", chk_ok, chk_failed);
 }